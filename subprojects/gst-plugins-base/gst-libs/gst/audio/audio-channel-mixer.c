@@ -70,6 +70,16 @@ struct _GstAudioChannelMixer
    * this is matrix * (2^10) as integers */
   gint **matrix_int;
 
+  /* when each output channel takes at most one input channel, the input
+   * channel of each output channel. Unused outputs take channel 0 with a
+   * gain of 0 */
+  gint *route;
+  /* all outputs are a copy of one input */
+  gboolean unity;
+
+  GstAudioChannelMixerFlags flags;
+  gint bps;
+
   MixerFunc func;
 };
 
@@ -95,6 +105,9 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->matrix_int);
   mix->matrix_int = NULL;
 
+  g_free (mix->route);
+  mix->route = NULL;
+
   g_free (mix);
 }
 
@@ -798,6 +811,43 @@ gst_audio_channel_mixer_setup_matrix_int (GstAudioChannelMixer * mix)
   }
 }
 
+/* Check if every output channel is made from at most one input channel,
+ * which is the case for routing, reordering, selecting channels and plain
+ * gains. The output is then a gather of the input instead of a full matrix
+ * multiplication. */
+static void
+gst_audio_channel_mixer_setup_route (GstAudioChannelMixer * mix)
+{
+  gint i, j;
+  gint *route;
+  gboolean unity = TRUE;
+
+  route = g_new (gint, mix->out_channels);
+
+  for (j = 0; j < mix->out_channels; j++) {
+    route[j] = -1;
+    for (i = 0; i < mix->in_channels; i++) {
+      if (mix->matrix[i][j] == 0.0f)
+        continue;
+      if (route[j] != -1) {
+        g_free (route);
+        return;
+      }
+      route[j] = i;
+    }
+    if (route[j] == -1) {
+      /* silent output, the gain in column j of input 0 is 0 */
+      route[j] = 0;
+      unity = FALSE;
+    } else if (mix->matrix[route[j]][j] != 1.0f) {
+      unity = FALSE;
+    }
+  }
+
+  mix->route = route;
+  mix->unity = unity;
+}
+
 static gfloat **
 gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, GstAudioChannelPosition * in_position,
@@ -907,29 +957,179 @@ gst_audio_channel_mixer_mix_##type##_##inlayout##_##outlayout ( \
   } \
 }
 
+/* The gather functions loop over the output channels first so that the
+ * inner loop runs over contiguous memory for planar layouts. They give the
+ * same result as the full matrix functions. */
+#define DEFINE_INTEGER_GATHER_FUNC(bits, resbits, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_gather_int##bits##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const gint##bits * in_data[], \
+    gint##bits * out_data[], gint samples) \
+{ \
+  gint in, out, n; \
+  gint##resbits res, gain; \
+  gint inchannels, outchannels; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (out = 0; out < outchannels; out++) { \
+    in = mix->route[out]; \
+    gain = mix->matrix_int[in][out]; \
+    \
+    for (n = 0; n < samples; n++) { \
+      res = _get_in_data_##inlayout##_gint##bits (in_data, n, in, inchannels) * \
+          gain; \
+      res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT; \
+      *_get_out_data_##outlayout##_gint##bits (out_data, n, out, outchannels) = \
+          CLAMP (res, G_MININT##bits, G_MAXINT##bits); \
+    } \
+  } \
+}
+
+#define DEFINE_FLOAT_GATHER_FUNC(type, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_gather_##type##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const g##type * in_data[], \
+    g##type * out_data[], gint samples) \
+{ \
+  gint in, out, n; \
+  gfloat gain; \
+  gint inchannels, outchannels; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (out = 0; out < outchannels; out++) { \
+    in = mix->route[out]; \
+    gain = mix->matrix[in][out]; \
+    \
+    for (n = 0; n < samples; n++) \
+      *_get_out_data_##outlayout##_g##type (out_data, n, out, outchannels) = \
+          _get_in_data_##inlayout##_g##type (in_data, n, in, inchannels) * \
+          gain; \
+  } \
+}
+
+#define DEFINE_COPY_FUNC(type, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_copy_##type##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const type * in_data[], \
+    type * out_data[], gint samples) \
+{ \
+  gint in, out, n; \
+  gint inchannels, outchannels; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (out = 0; out < outchannels; out++) { \
+    in = mix->route[out]; \
+    \
+    for (n = 0; n < samples; n++) \
+      *_get_out_data_##outlayout##_##type (out_data, n, out, outchannels) = \
+          _get_in_data_##inlayout##_##type (in_data, n, in, inchannels); \
+  } \
+}
+
+static void
+gst_audio_channel_mixer_copy_planar_planar (GstAudioChannelMixer * mix,
+    const gpointer in_data[], gpointer out_data[], gint samples)
+{
+  gint out;
+
+  for (out = 0; out < mix->out_channels; out++) {
+    if (out_data[out] != in_data[mix->route[out]])
+      memcpy (out_data[out], in_data[mix->route[out]], samples * mix->bps);
+  }
+}
+
 DEFINE_GET_DATA_FUNCS (gint16);
 DEFINE_INTEGER_MIX_FUNC (16, 32, interleaved, interleaved);
 DEFINE_INTEGER_MIX_FUNC (16, 32, interleaved, planar);
 DEFINE_INTEGER_MIX_FUNC (16, 32, planar, interleaved);
 DEFINE_INTEGER_MIX_FUNC (16, 32, planar, planar);
+DEFINE_INTEGER_GATHER_FUNC (16, 32, interleaved, interleaved);
+DEFINE_INTEGER_GATHER_FUNC (16, 32, interleaved, planar);
+DEFINE_INTEGER_GATHER_FUNC (16, 32, planar, interleaved);
+DEFINE_INTEGER_GATHER_FUNC (16, 32, planar, planar);
+DEFINE_COPY_FUNC (gint16, interleaved, interleaved);
+DEFINE_COPY_FUNC (gint16, interleaved, planar);
+DEFINE_COPY_FUNC (gint16, planar, interleaved);
 
 DEFINE_GET_DATA_FUNCS (gint32);
 DEFINE_INTEGER_MIX_FUNC (32, 64, interleaved, interleaved);
 DEFINE_INTEGER_MIX_FUNC (32, 64, interleaved, planar);
 DEFINE_INTEGER_MIX_FUNC (32, 64, planar, interleaved);
 DEFINE_INTEGER_MIX_FUNC (32, 64, planar, planar);
+DEFINE_INTEGER_GATHER_FUNC (32, 64, interleaved, interleaved);
+DEFINE_INTEGER_GATHER_FUNC (32, 64, interleaved, planar);
+DEFINE_INTEGER_GATHER_FUNC (32, 64, planar, interleaved);
+DEFINE_INTEGER_GATHER_FUNC (32, 64, planar, planar);
+DEFINE_COPY_FUNC (gint32, interleaved, interleaved);
+DEFINE_COPY_FUNC (gint32, interleaved, planar);
+DEFINE_COPY_FUNC (gint32, planar, interleaved);
 
 DEFINE_GET_DATA_FUNCS (gfloat);
 DEFINE_FLOAT_MIX_FUNC (float, interleaved, interleaved);
 DEFINE_FLOAT_MIX_FUNC (float, interleaved, planar);
 DEFINE_FLOAT_MIX_FUNC (float, planar, interleaved);
 DEFINE_FLOAT_MIX_FUNC (float, planar, planar);
+DEFINE_FLOAT_GATHER_FUNC (float, interleaved, interleaved);
+DEFINE_FLOAT_GATHER_FUNC (float, interleaved, planar);
+DEFINE_FLOAT_GATHER_FUNC (float, planar, interleaved);
+DEFINE_FLOAT_GATHER_FUNC (float, planar, planar);
+DEFINE_COPY_FUNC (gfloat, interleaved, interleaved);
+DEFINE_COPY_FUNC (gfloat, interleaved, planar);
+DEFINE_COPY_FUNC (gfloat, planar, interleaved);
 
 DEFINE_GET_DATA_FUNCS (gdouble);
 DEFINE_FLOAT_MIX_FUNC (double, interleaved, interleaved);
 DEFINE_FLOAT_MIX_FUNC (double, interleaved, planar);
 DEFINE_FLOAT_MIX_FUNC (double, planar, interleaved);
 DEFINE_FLOAT_MIX_FUNC (double, planar, planar);
+DEFINE_FLOAT_GATHER_FUNC (double, interleaved, interleaved);
+DEFINE_FLOAT_GATHER_FUNC (double, interleaved, planar);
+DEFINE_FLOAT_GATHER_FUNC (double, planar, interleaved);
+DEFINE_FLOAT_GATHER_FUNC (double, planar, planar);
+DEFINE_COPY_FUNC (gdouble, interleaved, interleaved);
+DEFINE_COPY_FUNC (gdouble, interleaved, planar);
+DEFINE_COPY_FUNC (gdouble, planar, interleaved);
+
+/* indexed by format (S16, S32, F32, F64) and layout (interleaved_interleaved,
+ * interleaved_planar, planar_interleaved, planar_planar) */
+#define MAKE_FUNCS(kind,i16,i32,f32,f64) \
+static const MixerFunc kind##_funcs[4][4] = { \
+  { (MixerFunc) gst_audio_channel_mixer_##kind##_##i16##_interleaved_interleaved, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##i16##_interleaved_planar, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##i16##_planar_interleaved, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##i16##_planar_planar }, \
+  { (MixerFunc) gst_audio_channel_mixer_##kind##_##i32##_interleaved_interleaved, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##i32##_interleaved_planar, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##i32##_planar_interleaved, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##i32##_planar_planar }, \
+  { (MixerFunc) gst_audio_channel_mixer_##kind##_##f32##_interleaved_interleaved, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##f32##_interleaved_planar, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##f32##_planar_interleaved, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##f32##_planar_planar }, \
+  { (MixerFunc) gst_audio_channel_mixer_##kind##_##f64##_interleaved_interleaved, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##f64##_interleaved_planar, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##f64##_planar_interleaved, \
+    (MixerFunc) gst_audio_channel_mixer_##kind##_##f64##_planar_planar }, \
+}
+
+#define gst_audio_channel_mixer_copy_gint16_planar_planar \
+    gst_audio_channel_mixer_copy_planar_planar
+#define gst_audio_channel_mixer_copy_gint32_planar_planar \
+    gst_audio_channel_mixer_copy_planar_planar
+#define gst_audio_channel_mixer_copy_gfloat_planar_planar \
+    gst_audio_channel_mixer_copy_planar_planar
+#define gst_audio_channel_mixer_copy_gdouble_planar_planar \
+    gst_audio_channel_mixer_copy_planar_planar
+
+MAKE_FUNCS (mix, int16, int32, float, double);
+MAKE_FUNCS (gather, int16, int32, float, double);
+MAKE_FUNCS (copy, gint16, gint32, gfloat, gdouble);
 
 /**
  * gst_audio_channel_mixer_new_with_matrix: (skip):
@@ -953,6 +1153,7 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, gint out_channels, gfloat ** matrix)
 {
   GstAudioChannelMixer *mix;
+  gint format_index = 0, layout_index;
 
   g_return_val_if_fail (format == GST_AUDIO_FORMAT_S16
       || format == GST_AUDIO_FORMAT_S32
@@ -962,6 +1163,7 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
   mix = g_new0 (GstAudioChannelMixer, 1);
   mix->in_channels = in_channels;
   mix->out_channels = out_channels;
+  mix->flags = flags;
 
   if (!matrix) {
     /* Generate (potentially truncated) identity matrix */
@@ -1010,85 +1212,41 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
 
   switch (format) {
     case GST_AUDIO_FORMAT_S16:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_interleaved_interleaved;
-        }
-      }
+      format_index = 0;
       break;
     case GST_AUDIO_FORMAT_S32:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_interleaved_interleaved;
-        }
-      }
+      format_index = 1;
       break;
     case GST_AUDIO_FORMAT_F32:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_interleaved_interleaved;
-        }
-      }
+      format_index = 2;
       break;
     case GST_AUDIO_FORMAT_F64:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_interleaved_interleaved;
-        }
-      }
+      format_index = 3;
       break;
     default:
       g_assert_not_reached ();
       break;
   }
+  mix->bps = GST_AUDIO_FORMAT_INFO_WIDTH (gst_audio_format_get_info (format))
+      / 8;
+
+  layout_index = 0;
+  if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN)
+    layout_index += 2;
+  if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT)
+    layout_index += 1;
+
+  gst_audio_channel_mixer_setup_route (mix);
+
+  if (mix->route && mix->unity) {
+    GST_DEBUG ("copying channels");
+    mix->func = copy_funcs[format_index][layout_index];
+  } else if (mix->route) {
+    GST_DEBUG ("gathering channels");
+    mix->func = gather_funcs[format_index][layout_index];
+  } else {
+    mix->func = mix_funcs[format_index][layout_index];
+  }
   return mix;
 }
 
@@ -1169,6 +1327,47 @@ gst_audio_channel_mixer_is_passthrough (GstAudioChannelMixer * mix)
   return res;
 }
 
+#define INPLACE_CHUNK_SIZE 4096
+
+/* Mix chunks of frames from a copy of the input. As there are no more output
+ * than input channels, a chunk of output never overwrites input of the
+ * next chunks. */
+static void
+gst_audio_channel_mixer_samples_inplace (GstAudioChannelMixer * mix,
+    const gpointer in[], gpointer out[], gint samples)
+{
+  gboolean in_planar, out_planar;
+  gint in_blocks, out_blocks, in_stride, out_stride, chunk, n, c;
+  gpointer *tmp_in, *tmp_out;
+  gint8 *tmp;
+
+  in_planar = mix->flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN;
+  out_planar = mix->flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT;
+
+  in_blocks = in_planar ? mix->in_channels : 1;
+  in_stride = in_planar ? mix->bps : mix->bps * mix->in_channels;
+  out_blocks = out_planar ? mix->out_channels : 1;
+  out_stride = out_planar ? mix->bps : mix->bps * mix->out_channels;
+
+  chunk = MAX (1, INPLACE_CHUNK_SIZE / (mix->bps * mix->in_channels));
+  tmp = g_alloca (chunk * mix->bps * mix->in_channels);
+  tmp_in = g_newa (gpointer, in_blocks);
+  tmp_out = g_newa (gpointer, out_blocks);
+
+  for (n = 0; n < samples; n += chunk) {
+    gint len = MIN (chunk, samples - n);
+
+    for (c = 0; c < in_blocks; c++) {
+      tmp_in[c] = tmp + c * chunk * in_stride;
+      memcpy (tmp_in[c], (gint8 *) in[c] + n * in_stride, len * in_stride);
+    }
+    for (c = 0; c < out_blocks; c++)
+      tmp_out[c] = (gint8 *) out[c] + n * out_stride;
+
+    mix->func (mix, tmp_in, tmp_out, len);
+  }
+}
+
 /**
  * gst_audio_channel_mixer_samples:
  * @mix: a #GstAudioChannelMixer
@@ -1182,6 +1381,10 @@ gst_audio_channel_mixer_is_passthrough (GstAudioChannelMixer * mix)
  * If non-interleaved samples are used, @in and @out must point to an
  * array with pointers to memory blocks, one for each channel.
  *
+ * Since 1.26, the mixing can be done in place, with @out pointing to the
+ * same memory as @in, when there are no more output channels than input
+ * channels and input and output use the same layout.
+ *
  * Perform channel mixing on @in_data and write the result to @out_data.
  * @in_data and @out_data need to be in @format and @layout.
  */
@@ -1191,6 +1394,14 @@ gst_audio_channel_mixer_samples (GstAudioChannelMixer * mix,
 {
   g_return_if_fail (mix != NULL);
   g_return_if_fail (mix->matrix != NULL);
-
-  mix->func (mix, in, out, samples);
+  /* in place needs the same layout and no more output than input channels */
+  g_return_if_fail (samples <= 0 || in[0] != out[0] ||
+      (mix->out_channels <= mix->in_channels &&
+          !(mix->flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) ==
+          !(mix->flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT)));
+
+  if (samples > 0 && in[0] == out[0])
+    gst_audio_channel_mixer_samples_inplace (mix, in, out, samples);
+  else
+    mix->func (mix, in, out, samples);
 }
@@ -29,6 +29,7 @@
 
 #include "audio-converter.h"
 #include "gstaudiopack.h"
+#include "gstaudioutilsprivate.h"
 
 /**
  * SECTION:gstaudioconverter
@@ -132,6 +133,7 @@ struct _GstAudioConverter
 
   /* quant */
   GstAudioQuantize *quant;
+  gboolean quant_stateless;
 
   /* change layout */
   GstAudioFormat chlayout_format;
@@ -146,6 +148,9 @@ struct _GstAudioConverter
   AudioConvertEndianFunc swap_endian;
 
   AudioConvertSamplesFunc convert;
+
+  /* threads for mixing and quantizing */
+  GstAudioTaskRunner *runner;
 };
 
 static GstAudioConverter *
@@ -293,6 +298,7 @@ get_opt_value (GstAudioConverter * convert, const gchar * opt)
 #define DEFAULT_OPT_DITHER_THRESHOLD 20
 #define DEFAULT_OPT_NOISE_SHAPING_METHOD GST_AUDIO_NOISE_SHAPING_NONE
 #define DEFAULT_OPT_QUANTIZATION 1
+#define DEFAULT_OPT_THREADS 1
 
 #define GET_OPT_RESAMPLER_METHOD(c) get_opt_enum(c, \
     GST_AUDIO_CONVERTER_OPT_RESAMPLER_METHOD, GST_TYPE_AUDIO_RESAMPLER_METHOD, \
@@ -309,6 +315,8 @@ get_opt_value (GstAudioConverter * convert, const gchar * opt)
     GST_AUDIO_CONVERTER_OPT_QUANTIZATION, DEFAULT_OPT_QUANTIZATION)
 #define GET_OPT_MIX_MATRIX(c) get_opt_value(c, \
     GST_AUDIO_CONVERTER_OPT_MIX_MATRIX)
+#define GET_OPT_THREADS(c) get_opt_uint(c, \
+    GST_AUDIO_CONVERTER_OPT_THREADS, DEFAULT_OPT_THREADS)
 
 static gboolean
 copy_config (GQuark field_id, const GValue * value, gpointer user_data)
@@ -512,6 +520,77 @@ do_convert_in (AudioChain * chain, gpointer user_data)
   return TRUE;
 }
 
+/* don't bother the other threads with less than this many frames */
+#define MIN_TASK_FRAMES 256
+
+typedef struct
+{
+  GstAudioConverter *convert;
+  gpointer *in, *out;
+  gsize num_samples;
+} AudioTask;
+
+static void
+audio_task_offset (gpointer * res, gpointer * samples, gint blocks,
+    gint stride, gsize offset)
+{
+  gint i;
+
+  for (i = 0; i < blocks; i++)
+    res[i] = (gint8 *) samples[i] + offset * stride;
+}
+
+/* Split @num_samples frames from @in to @out in ranges that are processed
+ * in parallel by @func. Only for steps that handle each frame independently.
+ * Returns FALSE when the caller should process the samples itself. */
+static gboolean
+audio_chain_run_tasks (AudioChain * chain, GstAudioConverter * convert,
+    GstAudioTaskFunc func, gpointer * in, gpointer * out, gsize num_samples)
+{
+  AudioChain *prev = chain->prev;
+  AudioTask *tasks;
+  gpointer *task_data;
+  guint i, n_tasks;
+  gsize offset = 0;
+
+  if (convert->runner == NULL)
+    return FALSE;
+
+  n_tasks = MIN (__gst_audio_task_runner_get_n_threads (convert->runner),
+      num_samples / MIN_TASK_FRAMES);
+  if (n_tasks < 2)
+    return FALSE;
+
+  tasks = g_newa (AudioTask, n_tasks);
+  task_data = g_newa (gpointer, n_tasks);
+
+  for (i = 0; i < n_tasks; i++) {
+    gsize n = num_samples / n_tasks + (i < num_samples % n_tasks ? 1 : 0);
+
+    tasks[i].convert = convert;
+    tasks[i].in = g_newa (gpointer, prev->blocks);
+    tasks[i].out = g_newa (gpointer, chain->blocks);
+    audio_task_offset (tasks[i].in, in, prev->blocks, prev->stride, offset);
+    audio_task_offset (tasks[i].out, out, chain->blocks, chain->stride,
+        offset);
+    tasks[i].num_samples = n;
+    task_data[i] = &tasks[i];
+    offset += n;
+  }
+  __gst_audio_task_runner_run (convert->runner, func, task_data, n_tasks);
+
+  return TRUE;
+}
+
+static void
+mix_task_func (gpointer data)
+{
+  AudioTask *task = data;
+
+  gst_audio_channel_mixer_samples (task->convert->mix, task->in, task->out,
+      task->num_samples);
+}
+
 static gboolean
 do_mix (AudioChain * chain, gpointer user_data)
 {
@@ -523,7 +602,11 @@ do_mix (AudioChain * chain, gpointer user_data)
   out = (chain->allow_ip ? in : audio_chain_alloc_samples (chain, num_samples));
   GST_LOG ("mix %p, %p, %" G_GSIZE_FORMAT, in, out, num_samples);
 
-  gst_audio_channel_mixer_samples (convert->mix, in, out, num_samples);
+  /* the mixer has no state, each frame is mixed on its own. In place, the
+   * output of a range of frames overwrites the input of other ranges */
+  if (in == out || !audio_chain_run_tasks (chain, convert, mix_task_func, in,
+          out, num_samples))
+    gst_audio_channel_mixer_samples (convert->mix, in, out, num_samples);
 
   audio_chain_set_samples (chain, out, num_samples);
 
@@ -572,6 +655,15 @@ do_convert_out (AudioChain * chain, gpointer user_data)
   return TRUE;
 }
 
+static void
+quantize_task_func (gpointer data)
+{
+  AudioTask *task = data;
+
+  gst_audio_quantize_samples (task->convert->quant, task->in, task->out,
+      task->num_samples);
+}
+
 static gboolean
 do_quantize (AudioChain * chain, gpointer user_data)
 {
@@ -583,7 +675,11 @@ do_quantize (AudioChain * chain, gpointer user_data)
   out = (chain->allow_ip ? in : audio_chain_alloc_samples (chain, num_samples));
   GST_LOG ("quantize %p, %p %" G_GSIZE_FORMAT, in, out, num_samples);
 
-  if (in && out)
+  /* dither and noise shaping carry state from one frame to the next and
+   * must run in order */
+  if (in && out && !(convert->quant_stateless && chain->blocks == 1
+          && audio_chain_run_tasks (chain, convert, quantize_task_func, in,
+              out, num_samples)))
     gst_audio_quantize_samples (convert->quant, in, out, num_samples);
 
   audio_chain_set_samples (chain, out, num_samples);
@@ -892,7 +988,9 @@ chain_mix (GstAudioConverter * convert, AudioChain * prev)
 
   if (!convert->mix_passthrough) {
     prev = audio_chain_new (prev, convert);
-    prev->allow_ip = FALSE;
+    /* the mixer can write its output over its input if it is not larger,
+     * but then the frames can't be split over threads anymore */
+    prev->allow_ip = out->channels <= in->channels && convert->runner == NULL;
     prev->pass_alloc = FALSE;
     audio_chain_set_make_func (prev, do_mix, convert, NULL);
   }
@@ -1010,6 +1108,8 @@ chain_quantize (GstAudioConverter * convert, AudioChain * prev)
     convert->quant =
         gst_audio_quantize_new (dither, ns, 0, convert->current_format,
         out->channels, 1U << (32 - out_depth));
+    convert->quant_stateless = dither == GST_AUDIO_DITHER_NONE
+        && ns == GST_AUDIO_NOISE_SHAPING_NONE;
 
     prev = audio_chain_new (prev, convert);
     prev->allow_ip = TRUE;
@@ -1348,6 +1448,7 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
   GstAudioConverter *convert;
   AudioChain *prev;
   const GValue *opt_matrix = NULL;
+  guint n_threads;
 
   g_return_val_if_fail (in_info != NULL, FALSE);
   g_return_val_if_fail (out_info != NULL, FALSE);
@@ -1379,6 +1480,20 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
 
   GST_INFO ("unitsizes: %d -> %d", in_info->bpf, out_info->bpf);
 
+  n_threads = GET_OPT_THREADS (convert);
+  if (n_threads == 0 || n_threads > g_get_num_processors ())
+    n_threads = g_get_num_processors ();
+  if (n_threads > 1) {
+    GST_INFO ("using %u threads", n_threads);
+    convert->runner = __gst_audio_task_runner_new (n_threads);
+    /* let the resampler use the same number of threads unless configured
+     * otherwise */
+    if (!gst_structure_has_field (convert->config,
+            GST_AUDIO_RESAMPLER_OPT_THREADS))
+      gst_structure_set (convert->config, GST_AUDIO_RESAMPLER_OPT_THREADS,
+          G_TYPE_UINT, n_threads, NULL);
+  }
+
   /* step 1, unpack */
   prev = chain_unpack (convert);
   /* step 2, optional convert from S32 to F64 for channel mix */
@@ -1495,6 +1610,8 @@ gst_audio_converter_free (GstAudioConverter * convert)
     gst_audio_channel_mixer_free (convert->mix);
   if (convert->resampler)
     gst_audio_resampler_free (convert->resampler);
+  if (convert->runner)
+    __gst_audio_task_runner_free (convert->runner);
   gst_audio_info_init (&convert->in);
   gst_audio_info_init (&convert->out);
 
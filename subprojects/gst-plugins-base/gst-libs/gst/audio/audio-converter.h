@@ -117,6 +117,20 @@ typedef struct _GstAudioConverter GstAudioConverter;
  */
 #define GST_AUDIO_CONVERTER_OPT_DITHER_THRESHOLD   "GstAudioConverter.dither-threshold"
 
+/**
+ * GST_AUDIO_CONVERTER_OPT_THREADS:
+ *
+ * #G_TYPE_UINT, maximum number of threads to use. Channel mixing and
+ * quantization without dithering or noise shaping are split in ranges of
+ * frames, the resampler splits the channels in groups, see
+ * #GST_AUDIO_RESAMPLER_OPT_THREADS. The output does not change.
+ *
+ * Default 1, 0 for the number of cores.
+ *
+ * Since: 1.26
+ */
+#define GST_AUDIO_CONVERTER_OPT_THREADS   "GstAudioConverter.threads"
+
 /**
  * GstAudioConverterFlags:
  * @GST_AUDIO_CONVERTER_FLAG_NONE: no flag
@@ -21,6 +21,7 @@
 #define __GST_AUDIO_RESAMPLER_PRIVATE_H__
 
 #include "audio-resampler.h"
+#include "gstaudioutilsprivate.h"
 
 /* Contains a collection of all things found in other resamplers:
  * speex (filter construction, optimizations), ffmpeg (fixed phase filter, blackman filter),
@@ -108,6 +109,9 @@ struct _GstAudioResampler
   gsize samples_len;
   gsize samples_avail;
   gpointer *sbuf;
+
+  /* resampling channel groups in parallel */
+  GstAudioTaskRunner *runner;
 };
 
 #endif /* __GST_AUDIO_RESAMPLER_PRIVATE_H__ */
@@ -0,0 +1,391 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__) && defined (__FMA__)
+
+#include <immintrin.h>
+
+/* The integer kernels below only vectorize the accumulation. Integer
+ * addition is associative, so the lane sums are identical to the ones of
+ * the C reference and the final scaling is done the same way as in
+ * audio-resampler.c, which keeps the output bit-exact. */
+
+static inline gfloat
+hsum_ps_avx2 (__m256 v)
+{
+  __m128 s;
+
+  s = _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_shuffle_ps (s, s, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  return _mm_cvtss_f32 (s);
+}
+
+static inline gint32
+hsum_epi32_avx2 (__m256i v)
+{
+  __m128i s;
+
+  s = _mm_add_epi32 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+  s = _mm_add_epi32 (s, _mm_shuffle_epi32 (s, _MM_SHUFFLE (1, 0, 3, 2)));
+  s = _mm_add_epi32 (s, _mm_shuffle_epi32 (s, _MM_SHUFFLE (2, 3, 0, 1)));
+
+  return _mm_cvtsi128_si32 (s);
+}
+
+static inline gint64
+hsum_epi64_avx2 (__m256i v)
+{
+  __m128i s;
+  gint64 res;
+
+  s = _mm_add_epi64 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+  s = _mm_add_epi64 (s, _mm_unpackhi_epi64 (s, s));
+  _mm_storel_epi64 ((__m128i *) & res, s);
+
+  return res;
+}
+
+/* accumulate the 8 signed 32 bit products of a and b into 4 64 bit lanes */
+static inline __m256i
+madd_epi32_avx2 (__m256i sum, __m256i a, __m256i b)
+{
+  sum = _mm256_add_epi64 (sum, _mm256_mul_epi32 (a, b));
+  sum = _mm256_add_epi64 (sum, _mm256_mul_epi32 (_mm256_srli_epi64 (a, 32),
+          _mm256_srli_epi64 (b, 32)));
+  return sum;
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2];
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    sum[0] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 0),
+        _mm256_loadu_ps (b + i + 0), sum[0]);
+    sum[1] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 8),
+        _mm256_loadu_ps (b + i + 8), sum[1]);
+  }
+  for (; i < len; i += 8) {
+    sum[0] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i),
+        _mm256_loadu_ps (b + i), sum[0]);
+  }
+  *o = hsum_ps_avx2 (_mm256_add_ps (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_mul_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_set1_ps (icoeff[0]));
+  *o = hsum_ps_avx2 (_mm256_add_ps (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m256 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_set1_ps (icoeff[0]));
+  sum[0] = _mm256_fmadd_ps (sum[1], _mm256_set1_ps (icoeff[1]), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[2], _mm256_set1_ps (icoeff[2]), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[3], _mm256_set1_ps (icoeff[3]), sum[0]);
+  *o = hsum_ps_avx2 (sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+void
+interpolate_gfloat_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[2];
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_set1_ps (ic[0]);
+  f[1] = _mm256_set1_ps (ic[1]);
+
+  for (i = 0; i < len; i += 8) {
+    _mm256_storeu_ps (o + i,
+        _mm256_fmadd_ps (_mm256_loadu_ps (c[0] + i), f[0],
+            _mm256_mul_ps (_mm256_loadu_ps (c[1] + i), f[1])));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[4], t[2];
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_set1_ps (ic[0]);
+  f[1] = _mm256_set1_ps (ic[1]);
+  f[2] = _mm256_set1_ps (ic[2]);
+  f[3] = _mm256_set1_ps (ic[3]);
+
+  for (i = 0; i < len; i += 8) {
+    t[0] = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    t[1] = _mm256_mul_ps (_mm256_loadu_ps (c[2] + i), f[2]);
+    t[0] = _mm256_fmadd_ps (_mm256_loadu_ps (c[1] + i), f[1], t[0]);
+    t[1] = _mm256_fmadd_ps (_mm256_loadu_ps (c[3] + i), f[3], t[1]);
+    _mm256_storeu_ps (o + i, _mm256_add_ps (t[0], t[1]));
+  }
+}
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __m256i sum;
+
+  sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    sum = _mm256_add_epi32 (sum,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+  }
+  res = hsum_epi32_avx2 (sum);
+
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res[2];
+  __m256i sum[2], t;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+  }
+  res[0] = hsum_epi32_avx2 (sum[0]) >> PRECISION_S16;
+  res[1] = hsum_epi32_avx2 (sum[1]) >> PRECISION_S16;
+
+  res[0] = ((gint32) (gint16) res[0] - (gint32) (gint16) res[1]) * icoeff[0] +
+      ((gint32) (gint16) res[1] << PRECISION_S16);
+  res[0] = (res[0] + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res[0], G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __m256i sum[4], t;
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+    sum[2] = _mm256_add_epi32 (sum[2], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[2] + i))));
+    sum[3] = _mm256_add_epi32 (sum[3], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[3] + i))));
+  }
+  res = (gint32) (gint16) (hsum_epi32_avx2 (sum[0]) >> PRECISION_S16) *
+      (gint32) icoeff[0] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[1]) >> PRECISION_S16) *
+      (gint32) icoeff[1] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[2]) >> PRECISION_S16) *
+      (gint32) icoeff[2] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[3]) >> PRECISION_S16) *
+      (gint32) icoeff[3];
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+static inline void
+inner_product_gint32_full_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i sum;
+
+  sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    sum = madd_epi32_avx2 (sum, _mm256_loadu_si256 ((__m256i *) (a + i)),
+        _mm256_loadu_si256 ((__m256i *) (b + i)));
+  }
+  res = hsum_epi64_avx2 (sum);
+
+  res = (res + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_linear_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res[2];
+  __m256i sum[2], t;
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = madd_epi32_avx2 (sum[0], t,
+        _mm256_loadu_si256 ((__m256i *) (c[0] + i)));
+    sum[1] = madd_epi32_avx2 (sum[1], t,
+        _mm256_loadu_si256 ((__m256i *) (c[1] + i)));
+  }
+  res[0] = hsum_epi64_avx2 (sum[0]) >> PRECISION_S32;
+  res[1] = hsum_epi64_avx2 (sum[1]) >> PRECISION_S32;
+
+  res[0] = ((gint64) (gint32) res[0] - (gint64) (gint32) res[1]) * icoeff[0] +
+      ((gint64) (gint32) res[1] << PRECISION_S32);
+  res[0] = (res[0] + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res[0], G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i sum[4], t;
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum[0] = madd_epi32_avx2 (sum[0], t,
+        _mm256_loadu_si256 ((__m256i *) (c[0] + i)));
+    sum[1] = madd_epi32_avx2 (sum[1], t,
+        _mm256_loadu_si256 ((__m256i *) (c[1] + i)));
+    sum[2] = madd_epi32_avx2 (sum[2], t,
+        _mm256_loadu_si256 ((__m256i *) (c[2] + i)));
+    sum[3] = madd_epi32_avx2 (sum[3], t,
+        _mm256_loadu_si256 ((__m256i *) (c[3] + i)));
+  }
+  res = (gint64) (gint32) (hsum_epi64_avx2 (sum[0]) >> PRECISION_S32) *
+      (gint64) icoeff[0] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[1]) >> PRECISION_S32) *
+      (gint64) icoeff[1] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[2]) >> PRECISION_S32) *
+      (gint64) icoeff[2] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[3]) >> PRECISION_S32) *
+      (gint64) icoeff[3];
+  res = (res + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx2);
+
+#endif
@@ -0,0 +1,218 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx512.h"
+
+#if defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX512F__) && defined (__AVX512BW__)
+
+#include <immintrin.h>
+
+/* n_taps is a multiple of 8, so the 512 bit main loops are followed by a
+ * single 256 bit step that never reads further than the AVX2 kernels do. */
+
+static inline void
+inner_product_gfloat_full_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512 sum;
+  __m256 tail;
+
+  sum = _mm512_setzero_ps ();
+  tail = _mm256_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    sum = _mm512_fmadd_ps (_mm512_loadu_ps (a + i),
+        _mm512_loadu_ps (b + i), sum);
+  }
+  for (; i < len; i += 8) {
+    tail = _mm256_fmadd_ps (_mm256_loadu_ps (a + i),
+        _mm256_loadu_ps (b + i), tail);
+  }
+  sum = _mm512_add_ps (sum, _mm512_castps256_ps512 (tail));
+  *o = _mm512_reduce_add_ps (sum);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0;
+  __m512 sum[2], t;
+  __m256 tail[2], t2;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+  tail[0] = tail[1] = _mm256_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm512_loadu_ps (a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[1] + i), sum[1]);
+  }
+  for (; i < len; i += 8) {
+    t2 = _mm256_loadu_ps (a + i);
+    tail[0] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[0] + i), tail[0]);
+    tail[1] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[1] + i), tail[1]);
+  }
+  sum[0] = _mm512_add_ps (sum[0], _mm512_castps256_ps512 (tail[0]));
+  sum[1] = _mm512_add_ps (sum[1], _mm512_castps256_ps512 (tail[1]));
+
+  sum[0] = _mm512_mul_ps (_mm512_sub_ps (sum[0], sum[1]),
+      _mm512_set1_ps (icoeff[0]));
+  *o = _mm512_reduce_add_ps (_mm512_add_ps (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i = 0, j;
+  __m512 sum[4], t;
+  __m256 tail[4], t2;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_ps ();
+  tail[0] = tail[1] = tail[2] = tail[3] = _mm256_setzero_ps ();
+
+  for (; i + 16 <= len; i += 16) {
+    t = _mm512_loadu_ps (a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm512_fmadd_ps (t, _mm512_loadu_ps (c[3] + i), sum[3]);
+  }
+  for (; i < len; i += 8) {
+    t2 = _mm256_loadu_ps (a + i);
+    tail[0] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[0] + i), tail[0]);
+    tail[1] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[1] + i), tail[1]);
+    tail[2] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[2] + i), tail[2]);
+    tail[3] = _mm256_fmadd_ps (t2, _mm256_loadu_ps (c[3] + i), tail[3]);
+  }
+  for (j = 0; j < 4; j++)
+    sum[j] = _mm512_add_ps (sum[j], _mm512_castps256_ps512 (tail[j]));
+
+  sum[0] = _mm512_mul_ps (sum[0], _mm512_set1_ps (icoeff[0]));
+  sum[0] = _mm512_fmadd_ps (sum[1], _mm512_set1_ps (icoeff[1]), sum[0]);
+  sum[0] = _mm512_fmadd_ps (sum[2], _mm512_set1_ps (icoeff[2]), sum[0]);
+  sum[0] = _mm512_fmadd_ps (sum[3], _mm512_set1_ps (icoeff[3]), sum[0]);
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx512);
+
+/* like the AVX2 versions, the gint16 kernels only vectorize the
+ * accumulation and finish exactly like the C reference */
+
+static inline gint32
+madd_epi16_avx512 (const gint16 * a, const gint16 * b, gint len)
+{
+  gint i = 0;
+  __m512i sum;
+  __m256i tail;
+
+  sum = _mm512_setzero_si512 ();
+  tail = _mm256_setzero_si256 ();
+
+  for (; i + 32 <= len; i += 32) {
+    sum = _mm512_add_epi32 (sum,
+        _mm512_madd_epi16 (_mm512_loadu_si512 ((const void *) (a + i)),
+            _mm512_loadu_si512 ((const void *) (b + i))));
+  }
+  for (; i < len; i += 16) {
+    tail = _mm256_add_epi32 (tail,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+  }
+  sum = _mm512_add_epi32 (sum, _mm512_castsi256_si512 (tail));
+
+  return _mm512_reduce_add_epi32 (sum);
+}
+
+static inline void
+inner_product_gint16_full_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint32 res;
+
+  res = madd_epi16_avx512 (a, b, len);
+
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint32 res[2];
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  res[0] = madd_epi16_avx512 (a, c[0], len) >> PRECISION_S16;
+  res[1] = madd_epi16_avx512 (a, c[1], len) >> PRECISION_S16;
+
+  res[0] = ((gint32) (gint16) res[0] - (gint32) (gint16) res[1]) * icoeff[0] +
+      ((gint32) (gint16) res[1] << PRECISION_S16);
+  res[0] = (res[0] + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res[0], G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint32 res;
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  res = (gint32) (gint16) (madd_epi16_avx512 (a, c[0], len) >> PRECISION_S16) *
+      (gint32) icoeff[0] +
+      (gint32) (gint16) (madd_epi16_avx512 (a, c[1], len) >> PRECISION_S16) *
+      (gint32) icoeff[1] +
+      (gint32) (gint16) (madd_epi16_avx512 (a, c[2], len) >> PRECISION_S16) *
+      (gint32) icoeff[2] +
+      (gint32) (gint16) (madd_epi16_avx512 (a, c[3], len) >> PRECISION_S16) *
+      (gint32) icoeff[3];
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx512);
+
+#endif
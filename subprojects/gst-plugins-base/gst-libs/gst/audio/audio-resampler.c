@@ -105,6 +105,7 @@ static const BlackmanQualityMap blackman_qualities[] = {
 #define DEFAULT_OPT_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
 #define DEFAULT_OPT_FILTER_OVERSAMPLE 8
 #define DEFAULT_OPT_MAX_PHASE_ERROR 0.1
+#define DEFAULT_OPT_THREADS 1
 
 static gdouble
 get_opt_double (GstStructure * options, const gchar * name, gdouble def)
@@ -124,6 +125,15 @@ get_opt_int (GstStructure * options, const gchar * name, gint def)
   return res;
 }
 
+static guint
+get_opt_uint (GstStructure * options, const gchar * name, guint def)
+{
+  guint res;
+  if (!options || !gst_structure_get_uint (options, name, &res))
+    res = def;
+  return res;
+}
+
 static gint
 get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
 {
@@ -160,6 +170,8 @@ get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
     GST_AUDIO_RESAMPLER_OPT_FILTER_OVERSAMPLE, DEFAULT_OPT_FILTER_OVERSAMPLE)
 #define GET_OPT_MAX_PHASE_ERROR(options) get_opt_double(options, \
     GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR, DEFAULT_OPT_MAX_PHASE_ERROR)
+#define GET_OPT_THREADS(options) get_opt_uint(options, \
+    GST_AUDIO_RESAMPLER_OPT_THREADS, DEFAULT_OPT_THREADS)
 
 #include "dbesi0.c"
 #define bessel dbesi0
@@ -829,16 +841,78 @@ static ResampleFunc resample_funcs[] = {
 # endif
 # if defined (__i386__) || defined (__x86_64__)
 #  define CHECK_X86
+# endif
+#endif
+#if defined (__i386__) || defined (__x86_64__)
+# if defined (HAVE_BUILTIN_CPU_SUPPORTS) && (HAVE_AVX2 || HAVE_AVX512)
+#  define CHECK_X86_AVX
+# endif
+# if defined (CHECK_X86) || defined (CHECK_X86_AVX)
 #  include "audio-resampler-x86.h"
 # endif
 #endif
 
+/* SIMD implementations in the order they are applied, each one can only
+ * replace functions of the previous ones. For every level we keep a copy of
+ * the function tables so that GST_AUDIO_RESAMPLER_OPT_SIMD can select a
+ * less capable implementation per resampler. */
+typedef enum
+{
+  SIMD_LEVEL_NONE,
+  SIMD_LEVEL_SSE,
+  SIMD_LEVEL_SSE2,
+  SIMD_LEVEL_SSE41,
+  SIMD_LEVEL_AVX2,
+  SIMD_LEVEL_AVX512,
+  SIMD_LEVEL_NEON,
+  N_SIMD_LEVELS
+} SimdLevel;
+
+static const gchar *simd_level_names[N_SIMD_LEVELS] = {
+  "none", "sse", "sse2", "sse41", "avx2", "avx512", "neon"
+};
+
+static ResampleFunc simd_resample_funcs[N_SIMD_LEVELS]
+    [G_N_ELEMENTS (resample_funcs)];
+static InterpolateFunc simd_interpolate_funcs[N_SIMD_LEVELS]
+    [G_N_ELEMENTS (interpolate_funcs)];
+static SimdLevel simd_level_best = SIMD_LEVEL_NONE;
+
+static SimdLevel
+simd_level_from_name (const gchar * name)
+{
+  gint i;
+
+  for (i = 0; i < N_SIMD_LEVELS; i++) {
+    if (!strcmp (name, simd_level_names[i]))
+      return i;
+  }
+  return SIMD_LEVEL_NONE;
+}
+
+static void
+audio_resampler_check_simd (const gchar * name)
+{
+#ifdef CHECK_X86
+  audio_resampler_check_x86 (name);
+#elif defined (CHECK_X86_AVX)
+  /* without Orc we only know about the AVX levels */
+  if (!strcmp (name, "avx2") || !strcmp (name, "avx512"))
+    audio_resampler_check_x86 (name);
+#endif
+#ifdef CHECK_NEON
+  audio_resampler_check_neon (name);
+#endif
+}
+
 static void
 audio_resampler_init (void)
 {
   static gsize init_gonce = 0;
 
   if (g_once_init_enter (&init_gonce)) {
+    guint simd_mask = 0;
+    gint level;
 
     GST_DEBUG_CATEGORY_INIT (audio_resampler_debug, "audio-resampler", 0,
         "audio-resampler object");
@@ -864,17 +938,38 @@ audio_resampler_init (void)
             name = NULL;
 
           if (name) {
-#ifdef CHECK_X86
-            audio_resampler_check_x86 (name);
-#endif
-#ifdef CHECK_NEON
-            audio_resampler_check_neon (name);
-#endif
+            level = simd_level_from_name (name);
+            if (level != SIMD_LEVEL_NONE)
+              simd_mask |= 1U << level;
           }
         }
       }
     }
 #endif
+#ifdef CHECK_X86_AVX
+    if (audio_resampler_check_x86_cpu ("avx2"))
+      simd_mask |= 1U << SIMD_LEVEL_AVX2;
+    if (audio_resampler_check_x86_cpu ("avx512"))
+      simd_mask |= 1U << SIMD_LEVEL_AVX512;
+#endif
+
+    memcpy (simd_resample_funcs[SIMD_LEVEL_NONE], resample_funcs,
+        sizeof (resample_funcs));
+    memcpy (simd_interpolate_funcs[SIMD_LEVEL_NONE], interpolate_funcs,
+        sizeof (interpolate_funcs));
+
+    for (level = SIMD_LEVEL_NONE + 1; level < N_SIMD_LEVELS; level++) {
+      if (simd_mask & (1U << level)) {
+        audio_resampler_check_simd (simd_level_names[level]);
+        simd_level_best = level;
+      }
+      memcpy (simd_resample_funcs[level], resample_funcs,
+          sizeof (resample_funcs));
+      memcpy (simd_interpolate_funcs[level], interpolate_funcs,
+          sizeof (interpolate_funcs));
+    }
+    GST_DEBUG ("best SIMD level %s", simd_level_names[simd_level_best]);
+
     g_once_init_leave (&init_gonce, 1);
   }
 }
@@ -1012,15 +1107,63 @@ alloc_cache_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
   resampler->cached_phases = resampler->cached_taps_mem;
 }
 
+static SimdLevel
+get_opt_simd (GstStructure * options)
+{
+  const gchar *name;
+  SimdLevel level;
+
+  if (!options
+      || !(name = gst_structure_get_string (options,
+              GST_AUDIO_RESAMPLER_OPT_SIMD)))
+    return simd_level_best;
+
+  level = simd_level_from_name (name);
+  if (level == SIMD_LEVEL_NONE && strcmp (name, "none"))
+    GST_WARNING ("unknown SIMD level %s", name);
+
+  return MIN (level, simd_level_best);
+}
+
+static void
+setup_runner (GstAudioResampler * resampler)
+{
+  guint n_threads = GET_OPT_THREADS (resampler->options);
+
+  if (n_threads == 0 || n_threads > g_get_num_processors ())
+    n_threads = g_get_num_processors ();
+  /* we split on channels, no point in having more threads */
+  n_threads = MIN (n_threads, resampler->blocks);
+
+  if (resampler->runner
+      && __gst_audio_task_runner_get_n_threads (resampler->runner) ==
+      n_threads)
+    return;
+
+  if (resampler->runner) {
+    __gst_audio_task_runner_free (resampler->runner);
+    resampler->runner = NULL;
+  }
+  if (n_threads > 1) {
+    GST_DEBUG ("using %u threads", n_threads);
+    resampler->runner = __gst_audio_task_runner_new (n_threads);
+  }
+}
+
 static void
 setup_functions (GstAudioResampler * resampler)
 {
   gint index, fidx;
+  SimdLevel level;
+
+  setup_runner (resampler);
 
   index = resampler->format_index;
+  level = get_opt_simd (resampler->options);
+  GST_DEBUG ("using SIMD level %s", simd_level_names[level]);
 
   if (resampler->in_rate == resampler->out_rate)
-    resampler->resample = resample_funcs[index];
+    resampler->resample = simd_resample_funcs[level][index];
   else {
     switch (resampler->filter_interpolation) {
       default:
@@ -1037,7 +1180,7 @@ setup_functions (GstAudioResampler * resampler)
         break;
     }
     GST_DEBUG ("using filter interpolate function %d", index + fidx);
-    resampler->interpolate = interpolate_funcs[index + fidx];
+    resampler->interpolate = simd_interpolate_funcs[level][index + fidx];
 
     switch (resampler->method) {
       case GST_AUDIO_RESAMPLER_METHOD_NEAREST:
@@ -1058,7 +1201,7 @@ setup_functions (GstAudioResampler * resampler)
         break;
     }
     GST_DEBUG ("using resample function %d", index);
-    resampler->resample = resample_funcs[index];
+    resampler->resample = simd_resample_funcs[level][index];
   }
 }
 
@@ -1632,6 +1775,8 @@ gst_audio_resampler_free (GstAudioResampler * resampler)
   g_free (resampler->tmp_taps);
   g_free (resampler->samples);
   g_free (resampler->sbuf);
+  if (resampler->runner)
+    __gst_audio_task_runner_free (resampler->runner);
   if (resampler->options)
     gst_structure_free (resampler->options);
   g_free (resampler);
@@ -1725,6 +1870,89 @@ gst_audio_resampler_get_max_latency (GstAudioResampler * resampler)
   return resampler->n_taps / 2;
 }
 
+typedef struct
+{
+  /* copy of the resampler that only handles a group of channels */
+  GstAudioResampler resampler;
+  gpointer *in;
+  gsize in_len;
+  gpointer out[1];
+  gpointer *outp;
+  gsize out_len;
+  gsize consumed;
+} ResampleTask;
+
+static void
+resample_task_func (gpointer data)
+{
+  ResampleTask *task = data;
+
+  task->resampler.resample (&task->resampler, task->in, task->in_len,
+      task->outp, task->out_len, &task->consumed);
+}
+
+static void
+resample_task_init (ResampleTask * task, GstAudioResampler * resampler,
+    gint first, gint n_blocks, gpointer in[], gsize in_len, gpointer out[],
+    gsize out_len)
+{
+  task->resampler = *resampler;
+  task->resampler.blocks = n_blocks;
+  task->in = in + first;
+  task->in_len = in_len;
+  if (resampler->ostride == 1) {
+    task->outp = out + first;
+  } else {
+    /* interleaved output, start at the first channel of the group */
+    task->out[0] = (gint8 *) out[0] + first * resampler->bps;
+    task->outp = task->out;
+  }
+  task->out_len = out_len;
+}
+
+/* Every channel is resampled with the same phases, so the channels can be
+ * split in groups that are handled by different threads on a copy of the
+ * resampler. The output is identical to the single threaded case. */
+static void
+resample_parallel (GstAudioResampler * resampler, gpointer in[],
+    gsize in_len, gpointer out[], gsize out_len, gsize * consumed)
+{
+  guint n_threads = __gst_audio_task_runner_get_n_threads (resampler->runner);
+  gint blocks = resampler->blocks, first = 0, n_tasks, i;
+  ResampleTask *tasks;
+  gpointer *task_data;
+
+  tasks = g_newa (ResampleTask, n_threads + 1);
+  task_data = g_newa (gpointer, n_threads);
+
+  /* the full filter mode fills the shared tap cache on the fly, do the first
+   * channel alone to fill it for all the phases of this run */
+  if (resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL) {
+    resample_task_init (&tasks[n_threads], resampler, 0, 1, in, in_len, out,
+        out_len);
+    resample_task_func (&tasks[n_threads]);
+    first = 1;
+  }
+
+  n_tasks = MIN (n_threads, blocks - first);
+  for (i = 0; i < n_tasks; i++) {
+    gint n_blocks = (blocks - first) / n_tasks +
+        (i < (blocks - first) % n_tasks ? 1 : 0);
+
+    resample_task_init (&tasks[i], resampler, first, n_blocks, in, in_len,
+        out, out_len);
+    task_data[i] = &tasks[i];
+    first += n_blocks;
+  }
+  __gst_audio_task_runner_run (resampler->runner, resample_task_func,
+      task_data, n_tasks);
+
+  /* all groups end with the same state */
+  *consumed = tasks[0].consumed;
+  resampler->samp_index = tasks[0].resampler.samp_index;
+  resampler->samp_phase = tasks[0].resampler.samp_phase;
+}
+
 /**
  * gst_audio_resampler_resample:
  * @resampler: a #GstAudioResampler
@@ -1787,8 +2015,12 @@ gst_audio_resampler_resample (GstAudioResampler * resampler,
   }
 
   /* resample all channels */
-  resampler->resample (resampler, sbuf, samples_avail, out, out_frames,
-      &consumed);
+  if (resampler->runner)
+    resample_parallel (resampler, sbuf, samples_avail, out, out_frames,
+        &consumed);
+  else
+    resampler->resample (resampler, sbuf, samples_avail, out, out_frames,
+        &consumed);
 
   GST_LOG ("in %" G_GSIZE_FORMAT ", avail %" G_GSIZE_FORMAT ", consumed %"
       G_GSIZE_FORMAT, in_frames, samples_avail, consumed);
@@ -164,6 +164,29 @@ typedef enum {
  */
 #define GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR "GstAudioResampler.max-phase-error"
 
+/**
+ * GST_AUDIO_RESAMPLER_OPT_SIMD:
+ *
+ * G_TYPE_STRING: The most capable SIMD implementation the resampler is
+ * allowed to use. One of "none", "sse", "sse2", "sse41", "avx2", "avx512"
+ * or "neon". Implementations that are not supported by the CPU are never
+ * used. By default the best available implementation is used.
+ *
+ * Since: 1.26
+ */
+#define GST_AUDIO_RESAMPLER_OPT_SIMD "GstAudioResampler.simd"
+
+/**
+ * GST_AUDIO_RESAMPLER_OPT_THREADS:
+ *
+ * G_TYPE_UINT, maximum number of threads to use. The channels are split in
+ * groups that are resampled in parallel, the output does not change.
+ * Default 1, 0 for the number of cores.
+ *
+ * Since: 1.26
+ */
+#define GST_AUDIO_RESAMPLER_OPT_THREADS "GstAudioResampler.threads"
+
 /**
  * GstAudioResamplerMethod:
  * @GST_AUDIO_RESAMPLER_METHOD_NEAREST: Duplicates the samples when
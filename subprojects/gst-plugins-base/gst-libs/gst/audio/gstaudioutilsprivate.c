@@ -333,3 +333,140 @@ __gst_audio_restore_thread_priority (gpointer handle)
   return TRUE;
 #endif
 }
+
+/*
+ * Minimal synchronous version of the task runner of GstVideoConverter. The
+ * calling thread performs the first task and waits for the others.
+ */
+struct _GstAudioTaskRunner
+{
+  GstTaskPool *pool;
+  guint n_threads;
+
+  GstVecDeque *tasks;
+  GstVecDeque *work_items;
+
+  GMutex lock;
+};
+
+typedef struct
+{
+  GstAudioTaskFunc func;
+  gpointer user_data;
+} GstAudioTaskWorkItem;
+
+static void
+__gst_audio_task_thread_func (gpointer data)
+{
+  GstAudioTaskRunner *runner = data;
+  GstAudioTaskWorkItem *work_item;
+
+  g_mutex_lock (&runner->lock);
+  work_item = gst_vec_deque_pop_head (runner->work_items);
+  g_mutex_unlock (&runner->lock);
+
+  g_assert (work_item != NULL);
+
+  work_item->func (work_item->user_data);
+}
+
+static void
+__gst_audio_task_runner_join (GstAudioTaskRunner * runner)
+{
+  gboolean joined = FALSE;
+
+  while (!joined) {
+    g_mutex_lock (&runner->lock);
+    if (!(joined = gst_vec_deque_is_empty (runner->tasks))) {
+      gpointer task = gst_vec_deque_pop_head (runner->tasks);
+      g_mutex_unlock (&runner->lock);
+      gst_task_pool_join (runner->pool, task);
+    } else {
+      g_mutex_unlock (&runner->lock);
+    }
+  }
+}
+
+/*
+ * Creates a runner that splits work over at most @n_threads threads,
+ * including the calling one. 0 means the number of processors.
+ */
+GstAudioTaskRunner *
+__gst_audio_task_runner_new (guint n_threads)
+{
+  GstAudioTaskRunner *runner;
+
+  if (n_threads == 0 || n_threads > g_get_num_processors ())
+    n_threads = g_get_num_processors ();
+
+  runner = g_new0 (GstAudioTaskRunner, 1);
+  runner->n_threads = n_threads;
+  runner->pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (runner->pool),
+      n_threads);
+  gst_task_pool_prepare (runner->pool, NULL);
+
+  runner->tasks = gst_vec_deque_new (n_threads);
+  runner->work_items = gst_vec_deque_new (n_threads);
+  g_mutex_init (&runner->lock);
+
+  return runner;
+}
+
+void
+__gst_audio_task_runner_free (GstAudioTaskRunner * runner)
+{
+  __gst_audio_task_runner_join (runner);
+
+  gst_vec_deque_free (runner->work_items);
+  gst_vec_deque_free (runner->tasks);
+  gst_task_pool_cleanup (runner->pool);
+  gst_object_unref (runner->pool);
+  g_mutex_clear (&runner->lock);
+  g_free (runner);
+}
+
+guint
+__gst_audio_task_runner_get_n_threads (GstAudioTaskRunner * runner)
+{
+  return runner->n_threads;
+}
+
+/*
+ * Calls @func for each of the @n_tasks entries of @task_data and returns
+ * when all of them are done. @n_tasks must not be larger than the number
+ * of threads of @runner.
+ */
+void
+__gst_audio_task_runner_run (GstAudioTaskRunner * runner,
+    GstAudioTaskFunc func, gpointer * task_data, guint n_tasks)
+{
+  GstAudioTaskWorkItem *work_items;
+  guint i;
+
+  g_assert (n_tasks <= runner->n_threads);
+
+  if (n_tasks > 1) {
+    work_items = g_newa (GstAudioTaskWorkItem, n_tasks);
+
+    g_mutex_lock (&runner->lock);
+    for (i = 1; i < n_tasks; i++) {
+      gpointer task;
+
+      work_items[i].func = func;
+      work_items[i].user_data = task_data[i];
+      gst_vec_deque_push_tail (runner->work_items, &work_items[i]);
+
+      task = gst_task_pool_push (runner->pool, __gst_audio_task_thread_func,
+          runner, NULL);
+      g_assert (task != NULL);
+      gst_vec_deque_push_tail (runner->tasks, task);
+    }
+    g_mutex_unlock (&runner->lock);
+  }
+
+  if (n_tasks > 0)
+    func (task_data[0]);
+
+  __gst_audio_task_runner_join (runner);
+}
@@ -48,6 +48,25 @@ gboolean __gst_audio_set_thread_priority   (gpointer * handle);
 G_GNUC_INTERNAL
 gboolean __gst_audio_restore_thread_priority (gpointer handle);
 
+/* Splitting converter and resampler work over threads */
+typedef struct _GstAudioTaskRunner GstAudioTaskRunner;
+typedef void (*GstAudioTaskFunc) (gpointer user_data);
+
+G_GNUC_INTERNAL
+GstAudioTaskRunner * __gst_audio_task_runner_new (guint n_threads);
+
+G_GNUC_INTERNAL
+void     __gst_audio_task_runner_free     (GstAudioTaskRunner * runner);
+
+G_GNUC_INTERNAL
+guint    __gst_audio_task_runner_get_n_threads (GstAudioTaskRunner * runner);
+
+G_GNUC_INTERNAL
+void     __gst_audio_task_runner_run      (GstAudioTaskRunner * runner,
+                                           GstAudioTaskFunc func,
+                                           gpointer * task_data,
+                                           guint n_tasks);
+
 G_END_DECLS
 
 #endif
@@ -46,6 +46,20 @@ gboolean __gst_video_rawvideo_convert (GstVideoCodecState * state, GstFormat src
                                        gint64 src_value, GstFormat * dest_format,
                                        gint64 * dest_value);
 
+/* Blending */
+typedef void (*GstVideoBlendMatrixFunc) (guint8 * tmpline, guint width);
+
+G_GNUC_INTERNAL
+GstVideoBlendMatrixFunc __gst_video_blend_get_matrix (gboolean src_rgb,
+                                                      gboolean dest_rgb,
+                                                      gboolean * src_premultiplied_alpha);
+
+G_GNUC_INTERNAL
+void __gst_video_blend_line (gpointer tmpdestline, const guint8 * tmpsrcline,
+                             gint src_width, gint bpp, gint global_alpha_val,
+                             gboolean src_premultiplied_alpha,
+                             gboolean dest_premultiplied_alpha);
+
 G_END_DECLS
 
 #endif
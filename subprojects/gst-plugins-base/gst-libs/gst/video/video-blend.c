@@ -29,6 +29,7 @@
 
 #include "video-blend.h"
 #include "video-orc.h"
+#include "gstvideoutilsprivate.h"
 
 #include <string.h>
 
@@ -282,6 +283,112 @@ G_STMT_START { \
   cb = MIN(c, (max)); \
 } G_STMT_END
 
+/* Returns the function that converts unpacked source lines to the color
+ * space of the destination. Converting premultiplied RGB to YUV also
+ * unpremultiplies, in which case @src_premultiplied_alpha is cleared. */
+GstVideoBlendMatrixFunc
+__gst_video_blend_get_matrix (gboolean src_rgb, gboolean dest_rgb,
+    gboolean * src_premultiplied_alpha)
+{
+  if (src_rgb == dest_rgb)
+    return matrix_identity;
+
+  if (!src_rgb)
+    return matrix_yuv_to_rgb;
+
+  if (*src_premultiplied_alpha) {
+    *src_premultiplied_alpha = FALSE;
+    return matrix_prea_rgb_to_yuv;
+  }
+
+  return matrix_rgb_to_yuv;
+}
+
+#define BLENDLOOP(op, dest_type, max, shift, alpha_val)                                       \
+  G_STMT_START {                                                                              \
+    for (j = 0; j < src_width * 4; j += 4) {                                                  \
+      guint asrc, adst;                                                                       \
+      guint final_alpha;                                                                      \
+      dest_type * dest = (dest_type *) tmpdestline;                                           \
+                                                                                              \
+      asrc = ((guint) tmpsrcline[j]) * alpha_val / max;                                       \
+      asrc = asrc << shift;                                                                   \
+      if (asrc == 0)                                                                          \
+        continue;                                                                             \
+                                                                                              \
+      adst = dest[j];                                                                         \
+      final_alpha = asrc + adst * (max - asrc) / max;                                         \
+      dest[j] = final_alpha;                                                                  \
+      if (final_alpha == 0)                                                                   \
+        final_alpha = 1;                                                                      \
+                                                                                              \
+      BLENDC (op, max, alpha_val, asrc, tmpsrcline[j + 1] << shift, adst, dest[j + 1], final_alpha); \
+      BLENDC (op, max, alpha_val, asrc, tmpsrcline[j + 2] << shift, adst, dest[j + 2], final_alpha); \
+      BLENDC (op, max, alpha_val, asrc, tmpsrcline[j + 3] << shift, adst, dest[j + 3], final_alpha); \
+    }                                                                                         \
+  } G_STMT_END
+
+/* Blends @src_width pixels of the 8 bit AYUV or ARGB @tmpsrcline onto
+ * @tmpdestline, which is in the same color space with either 8 bit (@bpp 4)
+ * or 16 bit (@bpp 8) components. @global_alpha_val is scaled to the
+ * component range of the destination. */
+void
+__gst_video_blend_line (gpointer tmpdestline, const guint8 * tmpsrcline,
+    gint src_width, gint bpp, gint global_alpha_val,
+    gboolean src_premultiplied_alpha, gboolean dest_premultiplied_alpha)
+{
+  gint j;
+
+  if (bpp == 4) {
+    if (G_LIKELY (global_alpha_val == 255)) {
+      if (src_premultiplied_alpha && dest_premultiplied_alpha) {
+        BLENDLOOP (OVER11, guint8, 255, 0, 255);
+      } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
+        BLENDLOOP (OVER01, guint8, 255, 0, 255);
+      } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
+        BLENDLOOP (OVER10_8BIT, guint8, 255, 0, 255);
+      } else {
+        BLENDLOOP (OVER00_8BIT, guint8, 255, 0, 255);
+      }
+    } else {
+      if (src_premultiplied_alpha && dest_premultiplied_alpha) {
+        BLENDLOOP (OVER11, guint8, 255, 0, global_alpha_val);
+      } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
+        BLENDLOOP (OVER01, guint8, 255, 0, global_alpha_val);
+      } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
+        BLENDLOOP (OVER10_8BIT, guint8, 255, 0, global_alpha_val);
+      } else {
+        BLENDLOOP (OVER00_8BIT, guint8, 255, 0, global_alpha_val);
+      }
+    }
+  } else {
+    g_assert (bpp == 8);
+
+    if (G_LIKELY (global_alpha_val == 65535)) {
+      if (src_premultiplied_alpha && dest_premultiplied_alpha) {
+        BLENDLOOP (OVER11, guint16, 65535, 8, 65535);
+      } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
+        BLENDLOOP (OVER01, guint16, 65535, 8, 65535);
+      } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
+        BLENDLOOP (OVER10_16BIT, guint16, 65535, 8, 65535);
+      } else {
+        BLENDLOOP (OVER00_16BIT, guint16, 65535, 8, 65535);
+      }
+    } else {
+      if (src_premultiplied_alpha && dest_premultiplied_alpha) {
+        BLENDLOOP (OVER11, guint16, 65535, 8, global_alpha_val);
+      } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
+        BLENDLOOP (OVER01, guint16, 65535, 8, global_alpha_val);
+      } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
+        BLENDLOOP (OVER10_16BIT, guint16, 65535, 8, global_alpha_val);
+      } else {
+        BLENDLOOP (OVER00_16BIT, guint16, 65535, 8, global_alpha_val);
+      }
+    }
+  }
+}
+
+#undef BLENDLOOP
 
 /**
  * gst_video_blend:
@@ -298,12 +405,12 @@ gboolean
 gst_video_blend (GstVideoFrame * dest,
     GstVideoFrame * src, gint x, gint y, gfloat global_alpha)
 {
-  gint i, j, global_alpha_val, src_width, src_height, dest_width, dest_height;
+  gint i, global_alpha_val, src_width, src_height, dest_width, dest_height;
   gint src_xoff = 0, src_yoff = 0;
   guint8 *tmpdestline = NULL, *tmpsrcline = NULL;
   gboolean src_premultiplied_alpha, dest_premultiplied_alpha;
   gint bpp;
-  void (*matrix) (guint8 * tmpline, guint width);
+  GstVideoBlendMatrixFunc matrix;
   const GstVideoFormatInfo *sinfo, *dinfo, *dunpackinfo, *sunpackinfo;
 
   g_assert (dest != NULL);
@@ -354,19 +461,8 @@ gst_video_blend (GstVideoFrame * dest,
 
   global_alpha_val = (bpp == 4) ? 255.0 * global_alpha : 65535.0 * global_alpha;
 
-  matrix = matrix_identity;
-  if (GST_VIDEO_INFO_IS_RGB (&src->info) != GST_VIDEO_INFO_IS_RGB (&dest->info)) {
-    if (GST_VIDEO_INFO_IS_RGB (&src->info)) {
-      if (src_premultiplied_alpha) {
-        matrix = matrix_prea_rgb_to_yuv;
-        src_premultiplied_alpha = FALSE;
-      } else {
-        matrix = matrix_rgb_to_yuv;
-      }
-    } else {
-      matrix = matrix_yuv_to_rgb;
-    }
-  }
+  matrix = __gst_video_blend_get_matrix (GST_VIDEO_INFO_IS_RGB (&src->info),
+      GST_VIDEO_INFO_IS_RGB (&dest->info), &src_premultiplied_alpha);
 
   /* If we're here we know that the overlay image fully or
    * partially overlaps with the video frame */
@@ -408,79 +504,8 @@ gst_video_blend (GstVideoFrame * dest,
 
     matrix (tmpsrcline, src_width);
 
-#define BLENDLOOP(op, dest_type, max, shift, alpha_val)                                       \
-  G_STMT_START {                                                                              \
-    for (j = 0; j < src_width * 4; j += 4) {                                                  \
-      guint asrc, adst;                                                                       \
-      guint final_alpha;                                                                      \
-      dest_type * dest = (dest_type *) tmpdestline;                                           \
-                                                                                              \
-      asrc = ((guint) tmpsrcline[j]) * alpha_val / max;                                       \
-      asrc = asrc << shift;                                                                   \
-      if (asrc == 0)                                                                          \
-        continue;                                                                             \
-                                                                                              \
-      adst = dest[j];                                                                         \
-      final_alpha = asrc + adst * (max - asrc) / max;                                         \
-      dest[j] = final_alpha;                                                                  \
-      if (final_alpha == 0)                                                                   \
-        final_alpha = 1;                                                                      \
-                                                                                              \
-      BLENDC (op, max, alpha_val, asrc, tmpsrcline[j + 1] << shift, adst, dest[j + 1], final_alpha); \
-      BLENDC (op, max, alpha_val, asrc, tmpsrcline[j + 2] << shift, adst, dest[j + 2], final_alpha); \
-      BLENDC (op, max, alpha_val, asrc, tmpsrcline[j + 3] << shift, adst, dest[j + 3], final_alpha); \
-    }                                                                                         \
-  } G_STMT_END
-
-    if (bpp == 4) {
-      if (G_LIKELY (global_alpha_val == 255)) {
-        if (src_premultiplied_alpha && dest_premultiplied_alpha) {
-          BLENDLOOP (OVER11, guint8, 255, 0, 255);
-        } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
-          BLENDLOOP (OVER01, guint8, 255, 0, 255);
-        } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
-          BLENDLOOP (OVER10_8BIT, guint8, 255, 0, 255);
-        } else {
-          BLENDLOOP (OVER00_8BIT, guint8, 255, 0, 255);
-        }
-      } else {
-        if (src_premultiplied_alpha && dest_premultiplied_alpha) {
-          BLENDLOOP (OVER11, guint8, 255, 0, global_alpha_val);
-        } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
-          BLENDLOOP (OVER01, guint8, 255, 0, global_alpha_val);
-        } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
-          BLENDLOOP (OVER10_8BIT, guint8, 255, 0, global_alpha_val);
-        } else {
-          BLENDLOOP (OVER00_8BIT, guint8, 255, 0, global_alpha_val);
-        }
-      }
-    } else {
-      g_assert (bpp == 8);
-
-      if (G_LIKELY (global_alpha_val == 65535)) {
-        if (src_premultiplied_alpha && dest_premultiplied_alpha) {
-          BLENDLOOP (OVER11, guint16, 65535, 8, 65535);
-        } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
-          BLENDLOOP (OVER01, guint16, 65535, 8, 65535);
-        } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
-          BLENDLOOP (OVER10_16BIT, guint16, 65535, 8, 65535);
-        } else {
-          BLENDLOOP (OVER00_16BIT, guint16, 65535, 8, 65535);
-        }
-      } else {
-        if (src_premultiplied_alpha && dest_premultiplied_alpha) {
-          BLENDLOOP (OVER11, guint16, 65535, 8, global_alpha_val);
-        } else if (!src_premultiplied_alpha && dest_premultiplied_alpha) {
-          BLENDLOOP (OVER01, guint16, 65535, 8, global_alpha_val);
-        } else if (src_premultiplied_alpha && !dest_premultiplied_alpha) {
-          BLENDLOOP (OVER10_16BIT, guint16, 65535, 8, global_alpha_val);
-        } else {
-          BLENDLOOP (OVER00_16BIT, guint16, 65535, 8, global_alpha_val);
-        }
-      }
-    }
-
-#undef BLENDLOOP
+    __gst_video_blend_line (tmpdestline, tmpsrcline, src_width, bpp,
+        global_alpha_val, src_premultiplied_alpha, dest_premultiplied_alpha);
 
     /* undo previous pointer adjustments to pass right pointer to g_free */
     tmpdestline -= bpp * x;
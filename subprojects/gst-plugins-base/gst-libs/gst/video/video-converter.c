@@ -37,6 +37,7 @@
 #include <gst/base/base.h>
 
 #include "video-orc.h"
+#include "gstvideoutilsprivate.h"
 
 /**
  * SECTION:videoconverter
@@ -338,6 +339,19 @@ typedef struct
 typedef void (*FastConvertFunc) (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest, gint plane);
 
+/* an overlay rectangle, clipped to the destination, ready to be blended
+ * into the packed lines */
+typedef struct
+{
+  GstVideoFrame frame;
+  gint x, y;
+  gint width, height;
+  gint src_x, src_y;
+  gint global_alpha;
+  gboolean premultiplied;
+  GstVideoBlendMatrixFunc matrix;
+} OverlayRect;
+
 struct _GstVideoConverter
 {
   gint flags;
@@ -455,6 +469,13 @@ struct _GstVideoConverter
   const GstVideoFrame *src;
   GstVideoFrame *dest;
 
+  /* overlay */
+  GstVideoOverlayComposition *overlay;
+  gboolean overlay_blended;
+  OverlayRect *overlay_rects;
+  guint n_overlay_rects;
+  guint8 **overlay_lines;
+
   /* fastpath */
   GstVideoFormat fformat[4];
   gint fin_x[4];
@@ -661,6 +682,8 @@ static gboolean do_hscale_lines (GstLineCache * cache, gint idx, gint out_line,
 static gboolean do_dither_lines (GstLineCache * cache, gint idx, gint out_line,
     gint in_line, gpointer user_data);
 
+static void video_converter_clear_overlay (GstVideoConverter * convert);
+
 static ConverterAlloc *
 converter_alloc_new (guint stride, guint n_lines, gpointer user_data,
     GDestroyNotify notify)
@@ -774,6 +797,20 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
   return res;
 }
 
+static GstVideoOverlayComposition *
+get_opt_overlay (GstVideoConverter * convert)
+{
+  const GValue *value;
+
+  value = gst_structure_get_value (convert->config,
+      GST_VIDEO_CONVERTER_OPT_OVERLAY_COMPOSITION);
+  if (value == NULL || !G_VALUE_HOLDS (value,
+          GST_TYPE_VIDEO_OVERLAY_COMPOSITION))
+    return NULL;
+
+  return g_value_dup_boxed (value);
+}
+
 #define DEFAULT_OPT_FILL_BORDER TRUE
 #define DEFAULT_OPT_ALPHA_VALUE 1.0
 /* options copy, set, mult */
@@ -2394,6 +2431,10 @@ gst_video_converter_init_from_config (GstVideoConverter * convert)
         out_info->colorimetry.matrix);
     convert->out_info.colorimetry.matrix = GST_VIDEO_COLOR_MATRIX_RGB;
   }
+
+  if (convert->overlay)
+    gst_video_overlay_composition_unref (convert->overlay);
+  convert->overlay = get_opt_overlay (convert);
 }
 
 /**
@@ -2659,6 +2700,16 @@ gst_video_converter_free (GstVideoConverter * convert)
 
   g_free (convert->borderline);
 
+  video_converter_clear_overlay (convert);
+  g_free (convert->overlay_rects);
+  if (convert->overlay_lines) {
+    for (i = 0; i < convert->conversion_runner->n_threads; i++)
+      g_free (convert->overlay_lines[i]);
+    g_free (convert->overlay_lines);
+  }
+  if (convert->overlay)
+    gst_video_overlay_composition_unref (convert->overlay);
+
   if (convert->config)
     gst_structure_free (convert->config);
 
@@ -2795,7 +2846,16 @@ gst_video_converter_frame (GstVideoConverter * convert,
           convert->out_width == 0 || convert->out_height == 0))
     return;
 
+  convert->overlay_blended = FALSE;
   convert->convert (convert, src, dest);
+
+  if (convert->overlay && !convert->overlay_blended) {
+    /* the conversion did not blend the overlay itself, blend it onto the
+     * converted frame */
+    if (convert->conversion_runner->async_tasks)
+      gst_parallelized_task_runner_finish (convert->conversion_runner);
+    gst_video_overlay_composition_blend (convert->overlay, dest);
+  }
 }
 
 /**
@@ -3227,6 +3287,7 @@ do_dither_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
 
 typedef struct
 {
+  GstVideoConverter *convert;
   GstLineCache *pack_lines;
   gint idx;
   gint h_0, h_1;
@@ -3237,10 +3298,142 @@ typedef struct
   GstVideoFrame *dest;
 } ConvertTask;
 
+static void
+video_converter_clear_overlay (GstVideoConverter * convert)
+{
+  guint i;
+
+  for (i = 0; i < convert->n_overlay_rects; i++)
+    gst_video_frame_unmap (&convert->overlay_rects[i].frame);
+  convert->n_overlay_rects = 0;
+}
+
+/* Map the rectangles of the overlay composition so that they can be blended
+ * into the lines before packing. Returns FALSE when this is not possible
+ * because a rectangle covers border lines, which are not produced by the
+ * line pipeline, the composition must then be blended after conversion. */
+static gboolean
+video_converter_prepare_overlay (GstVideoConverter * convert)
+{
+  GstVideoOverlayComposition *comp = convert->overlay;
+  gint bpp = convert->pack_pstride;
+  guint i, n_rects, n_threads;
+
+  /* we blend onto 8 or 16 bit AYUV or ARGB lines */
+  if (bpp != 4 && bpp != 8)
+    return FALSE;
+
+  n_rects = gst_video_overlay_composition_n_rectangles (comp);
+  convert->overlay_rects =
+      g_renew (OverlayRect, convert->overlay_rects, MAX (n_rects, 1));
+
+  for (i = 0; i < n_rects; i++) {
+    GstVideoOverlayRectangle *rect;
+    GstVideoOverlayFormatFlags flags;
+    GstVideoMeta *vmeta;
+    GstVideoInfo info;
+    GstBuffer *pixels;
+    OverlayRect *r;
+    gint x, y, x1, y1;
+    guint width, height;
+
+    rect = gst_video_overlay_composition_get_rectangle (comp, i);
+    gst_video_overlay_rectangle_get_render_rectangle (rect, &x, &y, &width,
+        &height);
+
+    x1 = MIN (x + (gint) width, convert->out_maxwidth);
+    y1 = MIN (y + (gint) height, convert->out_maxheight);
+    if (x1 <= MAX (x, 0) || y1 <= MAX (y, 0))
+      continue;
+
+    if (MAX (y, 0) < convert->out_y
+        || y1 > convert->out_y + convert->out_height)
+      goto not_fused;
+
+    /* we apply the global alpha while blending */
+    flags = gst_video_overlay_rectangle_get_flags (rect);
+    flags |= GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA;
+
+    pixels = gst_video_overlay_rectangle_get_pixels_raw (rect, flags);
+    vmeta = gst_buffer_get_video_meta (pixels);
+    if (vmeta == NULL)
+      goto not_fused;
+
+    gst_video_info_set_format (&info, vmeta->format, vmeta->width,
+        vmeta->height);
+
+    r = &convert->overlay_rects[convert->n_overlay_rects];
+    if (!gst_video_frame_map (&r->frame, &info, pixels, GST_MAP_READ))
+      goto not_fused;
+    convert->n_overlay_rects++;
+
+    r->src_x = MAX (-x, 0);
+    r->src_y = MAX (-y, 0);
+    r->x = MAX (x, 0);
+    r->y = MAX (y, 0);
+    r->width = x1 - r->x;
+    r->height = y1 - r->y;
+    r->global_alpha = (bpp == 4 ? 255.0 : 65535.0) *
+        gst_video_overlay_rectangle_get_global_alpha (rect);
+    r->premultiplied =
+        (flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA) != 0;
+    /* convert the pixels like gst_video_blend() does */
+    r->matrix = __gst_video_blend_get_matrix (GST_VIDEO_INFO_IS_RGB (&info),
+        GST_VIDEO_INFO_IS_RGB (&convert->out_info), &r->premultiplied);
+  }
+
+  if (convert->n_overlay_rects > 0 && convert->overlay_lines == NULL) {
+    n_threads = convert->conversion_runner->n_threads;
+    convert->overlay_lines = g_new (guint8 *, n_threads);
+    for (i = 0; i < n_threads; i++)
+      convert->overlay_lines[i] = g_malloc ((convert->out_maxwidth + 8) * 4);
+  }
+
+  GST_LOG ("blending %u overlay rectangles in the line pass",
+      convert->n_overlay_rects);
+
+  return TRUE;
+
+not_fused:
+  {
+    GST_LOG ("blending overlay composition after conversion");
+    video_converter_clear_overlay (convert);
+    return FALSE;
+  }
+}
+
+/* blend the overlay rectangles into the packed @line of the destination */
+static void
+video_converter_blend_overlay_line (GstVideoConverter * convert, gint idx,
+    guint8 * line, gint y)
+{
+  guint8 *tmpline = convert->overlay_lines[idx];
+  gint bpp = convert->pack_pstride;
+  gboolean dest_premultiplied;
+  guint i;
+
+  dest_premultiplied = GST_VIDEO_INFO_FLAGS (&convert->out_info) &
+      GST_VIDEO_FLAG_PREMULTIPLIED_ALPHA;
+
+  for (i = 0; i < convert->n_overlay_rects; i++) {
+    OverlayRect *r = &convert->overlay_rects[i];
+    const GstVideoFormatInfo *finfo = r->frame.info.finfo;
+
+    if (y < r->y || y >= r->y + r->height)
+      continue;
+
+    finfo->unpack_func (finfo, 0, tmpline, r->frame.data,
+        r->frame.info.stride, r->src_x, y - r->y + r->src_y, r->width);
+    r->matrix (tmpline, r->width);
+    __gst_video_blend_line (line + r->x * bpp, tmpline, r->width, bpp,
+        r->global_alpha, r->premultiplied, dest_premultiplied);
+  }
+}
+
 static void
 convert_generic_task (ConvertTask * task)
 {
-  gint i;
+  gint i, j;
 
   for (i = task->h_0; i < task->h_1; i += task->pack_lines_count) {
     gpointer *lines;
@@ -3250,6 +3443,13 @@ convert_generic_task (ConvertTask * task)
         gst_line_cache_get_lines (task->pack_lines, task->idx, i + task->out_y,
         i, task->pack_lines_count);
 
+    /* blend the overlay while the lines are still hot in the cache */
+    if (task->convert->n_overlay_rects > 0) {
+      for (j = 0; j < task->pack_lines_count; j++)
+        video_converter_blend_overlay_line (task->convert, task->idx,
+            ((guint8 *) lines[j]) - task->lb_width, i + task->out_y + j);
+    }
+
     if (!task->identity_pack) {
       /* take away the border */
       guint8 *l = ((guint8 *) lines[0]) - task->lb_width;
@@ -3313,6 +3513,10 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
   pack_lines = convert->pack_nlines;    /* only 1 for now */
   pstride = convert->pack_pstride;
 
+  video_converter_clear_overlay (convert);
+  if (convert->overlay)
+    convert->overlay_blended = video_converter_prepare_overlay (convert);
+
   lb_width = out_x * pstride;
 
   if (convert->borderline) {
@@ -3331,6 +3535,7 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       GST_ROUND_UP_N ((out_height + n_threads - 1) / n_threads, pack_lines);
 
   for (i = 0; i < n_threads; i++) {
+    tasks[i].convert = convert;
     tasks[i].dest = dest;
     tasks[i].pack_lines = convert->pack_lines[i];
     tasks[i].idx = i;
@@ -8188,6 +8393,44 @@ static const VideoTransform transforms[] = {
       TRUE, TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 };
 
+/* below this share of the destination covered by overlay rectangles, in
+ * percent, copying with an identity fastpath and blending afterwards is
+ * faster than blending in the line pass, see the overlayblend benchmark */
+#define OVERLAY_FUSED_MIN_COVERAGE 75
+
+/* the share of the destination covered by the overlay rectangles in percent,
+ * overlapping rectangles are counted more than once */
+static guint
+video_converter_overlay_coverage (GstVideoConverter * convert)
+{
+  guint64 area = 0, total;
+  guint i, n_rects;
+
+  total = (guint64) convert->out_maxwidth * convert->out_maxheight;
+  if (total == 0)
+    return 0;
+
+  n_rects = gst_video_overlay_composition_n_rectangles (convert->overlay);
+  for (i = 0; i < n_rects; i++) {
+    GstVideoOverlayRectangle *rect;
+    gint x, y, x1, y1;
+    guint width, height;
+
+    rect = gst_video_overlay_composition_get_rectangle (convert->overlay, i);
+    gst_video_overlay_rectangle_get_render_rectangle (rect, &x, &y, &width,
+        &height);
+
+    x1 = MIN (x + (gint) width, convert->out_maxwidth);
+    y1 = MIN (y + (gint) height, convert->out_maxheight);
+    x = MAX (x, 0);
+    y = MAX (y, 0);
+    if (x1 > x && y1 > y)
+      area += (guint64) (x1 - x) * (y1 - y);
+  }
+
+  return MIN (area * 100 / total, 100);
+}
+
 static gboolean
 video_converter_lookup_fastpath (GstVideoConverter * convert)
 {
@@ -8259,6 +8502,19 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
       || convert->out_width < convert->out_maxwidth
       || convert->out_height < convert->out_maxheight;
 
+  /* an identity fastpath only copies the frame and the overlay would then be
+   * blended in a second pass. The line pass does both at once, but unpacking
+   * and packing every line costs more than a copy, so this only pays off when
+   * most of the frame is blended anyway */
+  if (convert->overlay && in_format == out_format && same_size && !crop
+      && !border && convert->in_info.finfo->unpack_func
+      && convert->out_info.finfo->pack_func
+      && video_converter_overlay_coverage (convert) >=
+      OVERLAY_FUSED_MIN_COVERAGE) {
+    GST_LOG ("skipping identity fastpath to blend overlay in the line pass");
+    return FALSE;
+  }
+
   for (i = 0; i < G_N_ELEMENTS (transforms); i++) {
     if (transforms[i].in_format == in_format &&
         transforms[i].out_format == out_format &&
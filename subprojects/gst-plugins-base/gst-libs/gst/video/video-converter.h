@@ -285,6 +285,25 @@ typedef enum {
  */
 #define GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS   "GstVideoConverter.async-tasks"
 
+/**
+ * GST_VIDEO_CONVERTER_OPT_OVERLAY_COMPOSITION:
+ *
+ * #GST_TYPE_VIDEO_OVERLAY_COMPOSITION, a composition to blend onto the
+ * converted frames. When the conversion goes through the generic line
+ * pipeline, the rectangles are blended into each line right before it is
+ * packed, so no extra pass over the destination is needed. Otherwise the
+ * composition is blended onto the destination after the conversion.
+ * When a composition that covers most of the frame is set at construction,
+ * conversions between identical formats use the line pipeline instead of a
+ * plain copy so that copying and blending happen in one pass. Smaller
+ * compositions are blended after a plain copy, which is faster for them.
+ * The composition can be replaced between frames with
+ * gst_video_converter_set_config(). Default %NULL.
+ *
+ * Since: 1.26
+ */
+#define GST_VIDEO_CONVERTER_OPT_OVERLAY_COMPOSITION   "GstVideoConverter.overlay-composition"
+
 typedef struct _GstVideoConverter GstVideoConverter;
 
 GST_VIDEO_API
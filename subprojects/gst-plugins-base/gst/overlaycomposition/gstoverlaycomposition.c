@@ -202,6 +202,10 @@ gst_overlay_composition_change_state (GstElement * element,
       }
       gst_caps_replace (&self->caps, NULL);
       gst_segment_init (&self->segment, GST_FORMAT_UNDEFINED);
+      if (self->convert) {
+        gst_video_converter_free (self->convert);
+        self->convert = NULL;
+      }
       break;
     default:
       break;
@@ -384,6 +388,10 @@ gst_overlay_composition_sink_event (GstPad * pad, GstObject * parent,
       GstCaps *caps;
 
       gst_event_parse_caps (event, &caps);
+      if (self->convert) {
+        gst_video_converter_free (self->convert);
+        self->convert = NULL;
+      }
       if (!gst_video_info_from_caps (&self->info, caps)) {
         gst_event_unref (event);
         ret = FALSE;
@@ -670,6 +678,110 @@ gst_overlay_composition_src_query (GstPad * pad, GstObject * parent,
   return ret;
 }
 
+/* below this share of the frame covered by the composition, in percent, a
+ * plain copy followed by a blend of the rectangles is faster than blending
+ * while copying. Matches the threshold of the video converter. */
+#define BLEND_COPY_MIN_COVERAGE 75
+
+/* the share of the frame covered by @compo in percent, overlapping
+ * rectangles are counted more than once */
+static guint
+gst_overlay_composition_coverage (GstOverlayComposition * self,
+    GstVideoOverlayComposition * compo)
+{
+  gint frame_width = GST_VIDEO_INFO_WIDTH (&self->info);
+  gint frame_height = GST_VIDEO_INFO_HEIGHT (&self->info);
+  guint64 area = 0;
+  guint i, n;
+
+  if (frame_width == 0 || frame_height == 0)
+    return 0;
+
+  n = gst_video_overlay_composition_n_rectangles (compo);
+  for (i = 0; i < n; i++) {
+    GstVideoOverlayRectangle *rect;
+    gint x, y, x1, y1;
+    guint width, height;
+
+    rect = gst_video_overlay_composition_get_rectangle (compo, i);
+    gst_video_overlay_rectangle_get_render_rectangle (rect, &x, &y, &width,
+        &height);
+
+    x1 = MIN (x + (gint) width, frame_width);
+    y1 = MIN (y + (gint) height, frame_height);
+    x = MAX (x, 0);
+    y = MAX (y, 0);
+    if (x1 > x && y1 > y)
+      area += (guint64) (x1 - x) * (y1 - y);
+  }
+
+  return MIN (area * 100 / ((guint64) frame_width * frame_height), 100);
+}
+
+/* Blending into a buffer that is not writable would first copy the whole
+ * frame and then blend onto the copy. When the composition covers most of
+ * the frame, let a converter between identical formats write the copy and
+ * blend the composition into each line before packing it, so the frame is
+ * only walked once. For smaller compositions the unpacking and packing of
+ * every line costs more than it saves, so this is only used above
+ * BLEND_COPY_MIN_COVERAGE. The composition must be in the configuration when
+ * the converter is created, otherwise it picks the plain copy fastpath and
+ * blends afterwards. */
+static GstBuffer *
+gst_overlay_composition_blend_copy (GstOverlayComposition * self,
+    GstBuffer * buffer, GstVideoOverlayComposition * compo)
+{
+  GstVideoFrame in_frame, out_frame;
+  GstVideoMeta *vmeta;
+  GstBuffer *outbuf;
+
+  if (!self->convert) {
+    self->convert = gst_video_converter_new (&self->info, &self->info,
+        gst_structure_new ("GstVideoConverter",
+            GST_VIDEO_CONVERTER_OPT_OVERLAY_COMPOSITION,
+            GST_TYPE_VIDEO_OVERLAY_COMPOSITION, compo,
+            GST_VIDEO_CONVERTER_OPT_CHROMA_MODE, GST_TYPE_VIDEO_CHROMA_MODE,
+            GST_VIDEO_CHROMA_MODE_NONE, GST_VIDEO_CONVERTER_OPT_MATRIX_MODE,
+            GST_TYPE_VIDEO_MATRIX_MODE, GST_VIDEO_MATRIX_MODE_NONE,
+            GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+            GST_VIDEO_GAMMA_MODE_NONE, GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE,
+            GST_TYPE_VIDEO_PRIMARIES_MODE, GST_VIDEO_PRIMARIES_MODE_NONE,
+            GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+            GST_VIDEO_DITHER_NONE, NULL));
+    if (!self->convert)
+      return NULL;
+  } else {
+    gst_video_converter_set_config (self->convert,
+        gst_structure_new ("GstVideoConverter",
+            GST_VIDEO_CONVERTER_OPT_OVERLAY_COMPOSITION,
+            GST_TYPE_VIDEO_OVERLAY_COMPOSITION, compo, NULL));
+  }
+
+  if (!gst_video_frame_map (&in_frame, &self->info, buffer, GST_MAP_READ))
+    return NULL;
+
+  outbuf = gst_buffer_new_allocate (NULL, self->info.size, NULL);
+  gst_buffer_copy_into (outbuf, buffer,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS | GST_BUFFER_COPY_META,
+      0, -1);
+  /* the new buffer uses the default layout of the caps */
+  while ((vmeta = gst_buffer_get_video_meta (outbuf)))
+    gst_buffer_remove_meta (outbuf, (GstMeta *) vmeta);
+
+  if (!gst_video_frame_map (&out_frame, &self->info, outbuf, GST_MAP_WRITE)) {
+    gst_video_frame_unmap (&in_frame);
+    gst_buffer_unref (outbuf);
+    return NULL;
+  }
+
+  gst_video_converter_frame (self->convert, &in_frame, &out_frame);
+
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+
+  return outbuf;
+}
+
 static GstFlowReturn
 gst_overlay_composition_sink_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer)
@@ -751,6 +863,20 @@ gst_overlay_composition_sink_chain (GstPad * pad, GstObject * parent,
   } else {
     GstVideoFrame frame;
 
+    if (!gst_buffer_is_writable (buffer) &&
+        gst_overlay_composition_coverage (self, compo) >=
+        BLEND_COPY_MIN_COVERAGE) {
+      GstBuffer *outbuf;
+
+      outbuf = gst_overlay_composition_blend_copy (self, buffer, compo);
+      if (outbuf) {
+        GST_LOG_OBJECT (self->sinkpad, "Blended while copying");
+        gst_video_overlay_composition_unref (compo);
+        gst_buffer_unref (buffer);
+        return gst_pad_push (self->srcpad, outbuf);
+      }
+    }
+
     buffer = gst_buffer_make_writable (buffer);
     if (!gst_video_frame_map (&frame, &self->info, buffer, GST_MAP_READWRITE)) {
       gst_video_overlay_composition_unref (compo);
@@ -41,6 +41,9 @@ struct _GstOverlayComposition {
   GstVideoInfo info;
   guint window_width, window_height;
   gboolean attach_compo_to_buffer;
+
+  /* copies and blends frames that are not writable */
+  GstVideoConverter *convert;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (overlaycomposition);
@@ -97,6 +97,13 @@
  * buffers to the clients. This behaviour can be disabled by setting the sync
  * property to FALSE. Multisocketsink will by default not do QoS and will never
  * drop late buffers.
+ *
+ * By default every buffer is sent to a client with a separate system call.
+ * With the #GstMultiSocketSink:batch-size property, all buffers that are
+ * already queued for a client when its socket becomes writable are sent
+ * together, so the number of system calls per client does not grow with the
+ * number of buffers. With #GstMultiSocketSink:zero-copy, buffers backed by
+ * file descriptor memory are sent with sendfile() without mapping them.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -105,9 +112,17 @@
 
 #include <glib/gi18n-lib.h>
 #include <gst/net/gstnetcontrolmessagemeta.h>
+#include <gst/allocators/gstfdmemory.h>
 
 #include <string.h>
 
+#ifdef HAVE_SENDFILE
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/sendfile.h>
+#endif
+
 #include "gstmultisocketsink.h"
 #include "gsttcpelements.h"
 
@@ -140,12 +155,20 @@ enum
 
 #define DEFAULT_SEND_DISPATCHED FALSE
 #define DEFAULT_SEND_MESSAGES   FALSE
+#define DEFAULT_BATCH_SIZE      1
+#define DEFAULT_ZERO_COPY       FALSE
+
+/* maximum number of buffers and memories sent with one system call */
+#define MAX_BATCH_SIZE          64
+#define MAX_BATCH_VECTORS       64
 
 enum
 {
   PROP_0,
   PROP_SEND_DISPATCHED,
   PROP_SEND_MESSAGES,
+  PROP_BATCH_SIZE,
+  PROP_ZERO_COPY,
   PROP_LAST
 };
 
@@ -264,6 +287,40 @@ gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
           "If GstNetworkMessage events should be pushed", DEFAULT_SEND_MESSAGES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiSocketSink:batch-size:
+   *
+   * Maximum number of buffers that are sent to a client with a single
+   * system call. When a client's socket becomes writable, up to this many
+   * of the buffers already queued for it are gathered into one vectored
+   * write. Buffers carrying #GstNetControlMessageMeta are always sent on
+   * their own. 1 sends every buffer separately.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch Size",
+          "Maximum number of queued buffers sent to a client with one "
+          "system call", 1, MAX_BATCH_SIZE, DEFAULT_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiSocketSink:zero-copy:
+   *
+   * Send buffers consisting of a single file descriptor backed memory, for
+   * example from memfd or file backed allocators, with sendfile() instead
+   * of mapping them and copying the data into the socket. Other buffers,
+   * and file descriptors that don't support sendfile(), are sent normally.
+   *
+   * This is only supported on Linux.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_ZERO_COPY,
+      g_param_spec_boolean ("zero-copy", "Zero Copy",
+          "Send file descriptor backed buffers with sendfile()",
+          DEFAULT_ZERO_COPY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstMultiSocketSink::add:
    * @gstmultisocketsink: the multisocketsink element to emit this signal on
@@ -451,6 +508,8 @@ gst_multi_socket_sink_init (GstMultiSocketSink * this)
   this->cancellable = g_cancellable_new ();
   this->send_dispatched = DEFAULT_SEND_DISPATCHED;
   this->send_messages = DEFAULT_SEND_MESSAGES;
+  this->batch_size = DEFAULT_BATCH_SIZE;
+  this->zero_copy = DEFAULT_ZERO_COPY;
 }
 
 static void
@@ -774,21 +833,118 @@ gst_buffer_get_cmsg_list (GstBuffer * buf, GSocketControlMessage ** msgs,
 
 #define CMSG_MAX 255
 
+#ifdef HAVE_SENDFILE
+/* Sends the remaining data of a buffer consisting of a single fd memory with
+ * sendfile(). Returns -1 with errno set to EINVAL or ENOSYS if the fd can't be
+ * used with sendfile() */
+static gssize
+gst_multi_socket_sink_sendfile (GstMultiSocketSink * sink, GSocket * sock,
+    GstMemory * mem, gsize offset, GError ** err)
+{
+  sigset_t pipe_mask, old_mask;
+  off_t file_offset;
+  gssize ret;
+  gint errsv;
+
+  file_offset = mem->offset + offset;
+
+  /* unlike send(), sendfile() has no MSG_NOSIGNAL. Block SIGPIPE while
+   * sending and consume it again if the connection was closed */
+  sigemptyset (&pipe_mask);
+  sigaddset (&pipe_mask, SIGPIPE);
+  pthread_sigmask (SIG_BLOCK, &pipe_mask, &old_mask);
+
+  do {
+    ret = sendfile (g_socket_get_fd (sock), gst_fd_memory_get_fd (mem),
+        &file_offset, mem->size - offset);
+  } while (ret < 0 && errno == EINTR);
+  errsv = errno;
+
+  if (ret < 0 && errsv == EPIPE && !sigismember (&old_mask, SIGPIPE)) {
+    struct timespec no_wait = { 0, 0 };
+
+    while (sigtimedwait (&pipe_mask, NULL, &no_wait) < 0 && errno == EINTR);
+  }
+  pthread_sigmask (SIG_SETMASK, &old_mask, NULL);
+
+  if (ret < 0) {
+    if (errsv != EINVAL && errsv != ENOSYS)
+      g_set_error (err, G_IO_ERROR, g_io_error_from_errno (errsv),
+          "Error sending data: %s", g_strerror (errsv));
+    errno = errsv;
+  }
+
+  return ret;
+}
+#endif
+
+/* Sends the buffers in @sending, starting at @bufoffset in the first one.
+ * Up to batch-size buffers are gathered into one write, the number of
+ * buffers that were included is returned in @n_buffers */
 static gssize
 gst_multi_socket_sink_write (GstMultiSocketSink * sink,
-    GSocket * sock, GstBuffer * buffer, gsize bufoffset,
+    GSocket * sock, GSList * sending, gsize bufoffset, guint * n_buffers,
     GCancellable * cancellable, GError ** err)
 {
-  GstMapInfo maps[8];
-  GOutputVector vec[8];
-  guint mems_mapped;
+  GstMapInfo maps[MAX_BATCH_VECTORS];
+  GOutputVector vec[MAX_BATCH_VECTORS];
+  GstBuffer *head = GST_BUFFER (sending->data);
+  guint mems_mapped, i;
+  gsize mapped_size;
   gssize wrote;
   GSocketControlMessage *cmsgs[CMSG_MAX];
   gsize msg_count;
 
-  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
+  *n_buffers = 1;
+
+#ifdef HAVE_SENDFILE
+  if (sink->zero_copy && gst_buffer_n_memory (head) == 1
+      && gst_is_fd_memory (gst_buffer_peek_memory (head, 0))
+      && gst_buffer_get_size (head) > bufoffset) {
+    wrote = gst_multi_socket_sink_sendfile (sink, sock,
+        gst_buffer_peek_memory (head, 0), bufoffset, err);
+    if (wrote >= 0 || (errno != EINVAL && errno != ENOSYS))
+      return wrote;
+
+    GST_LOG_OBJECT (sink, "sendfile not supported for this memory");
+  }
+#endif
+
+  msg_count = gst_buffer_get_cmsg_list (head, cmsgs, CMSG_MAX);
+
+  /* only map 8 memories of a buffer at once, like when not batching */
+  mems_mapped = map_n_memory_output_vector (head, bufoffset, vec, maps, 8);
+
+  /* add the following buffers as long as the complete first buffer was
+   * mapped, and none of them needs control messages */
+  mapped_size = 0;
+  for (i = 0; i < mems_mapped; i++)
+    mapped_size += vec[i].size;
+
+  if (msg_count == 0 && mapped_size == gst_buffer_get_size (head) - bufoffset) {
+    GSList *walk;
+
+    for (walk = sending->next; walk && *n_buffers < sink->batch_size;
+        walk = walk->next) {
+      GstBuffer *buf = GST_BUFFER (walk->data);
+      guint n_mem = gst_buffer_n_memory (buf);
+
+      if (n_mem == 0 || gst_buffer_get_size (buf) == 0)
+        break;
+      if (mems_mapped + n_mem > MAX_BATCH_VECTORS)
+        break;
+      if (gst_buffer_get_cmsg_list (buf, cmsgs, CMSG_MAX) > 0)
+        break;
+
+      mems_mapped += map_n_memory_output_vector (buf, 0, vec + mems_mapped,
+          maps + mems_mapped, n_mem);
+      (*n_buffers)++;
+    }
+  }
 
-  msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
+  if (*n_buffers > 1)
+    GST_LOG_OBJECT (sink, "sending %u buffers with %u memories", *n_buffers,
+        mems_mapped);
 
   wrote =
       g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count, 0,
@@ -797,6 +953,41 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
   return wrote;
 }
 
+/* Moves the next buffer from the global queue to the client's sending
+ * queue */
+static void
+gst_multi_socket_sink_client_take_buffer (GstMultiSocketSink * sink,
+    GstSocketClient * client)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+  GstBuffer *buf;
+  GstClockTime timestamp;
+
+  /* grab buffer */
+  buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
+  mhclient->bufpos--;
+
+  /* update stats */
+  timestamp = GST_BUFFER_TIMESTAMP (buf);
+  if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
+    mhclient->first_buffer_ts = timestamp;
+  if (timestamp != -1)
+    mhclient->last_buffer_ts = timestamp;
+
+  /* decrease flushcount */
+  if (mhclient->flushcount != -1)
+    mhclient->flushcount--;
+
+  GST_LOG_OBJECT (sink, "%s client %p at position %d",
+      mhclient->debug, client, mhclient->bufpos);
+
+  /* queueing a buffer will ref it */
+  mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+}
+
 /* Handle a write on a client,
  * which indicates a read request from a client.
  *
@@ -817,6 +1008,10 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
  * When the sending returns a partial buffer we stop sending more data as
  * the next send operation could block.
  *
+ * With batch-size > 1, the buffers that are available in the global queue
+ * are moved to the mhclient->sending queue before sending so that they can
+ * be written with a single system call.
+ *
  * This functions returns FALSE if some error occurred.
  */
 static gboolean
@@ -829,9 +1024,6 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   GError *err = NULL;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
   GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
-  GstMultiHandleSinkClass *mhsinkclass =
-      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
-
 
   now = g_get_real_time () * GST_USECOND;
   now_monotonic = g_get_monotonic_time () * GST_USECOND;
@@ -854,8 +1046,6 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         return TRUE;
       } else {
         /* client can pick a buffer from the global queue */
-        GstBuffer *buf;
-        GstClockTime timestamp;
 
         /* for new connections, we need to find a good spot in the
          * bufqueue to start streaming from */
@@ -878,42 +1068,34 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         if (mhclient->flushcount == 0)
           goto flushed;
 
-        /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
-
-        /* update stats */
-        timestamp = GST_BUFFER_TIMESTAMP (buf);
-        if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
-          mhclient->first_buffer_ts = timestamp;
-        if (timestamp != -1)
-          mhclient->last_buffer_ts = timestamp;
-
-        /* decrease flushcount */
-        if (mhclient->flushcount != -1)
-          mhclient->flushcount--;
-
-        GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
-
-        /* queueing a buffer will ref it */
-        mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+        gst_multi_socket_sink_client_take_buffer (sink, client);
 
         /* need to start from the first byte for this new buffer */
         mhclient->bufoffset = 0;
       }
     }
 
+    /* queue the other buffers that are available already so they can be
+     * sent together */
+    if (sink->batch_size > 1 && mhclient->sending) {
+      guint n_queued = g_slist_length (mhclient->sending);
+
+      while (n_queued < sink->batch_size && mhclient->bufpos != -1
+          && mhclient->flushcount != 0) {
+        gst_multi_socket_sink_client_take_buffer (sink, client);
+        n_queued = g_slist_length (mhclient->sending);
+      }
+    }
+
     /* see if we need to send something */
     if (mhclient->sending) {
       gssize wrote;
-      GstBuffer *head;
-
-      /* pick first buffer from list */
-      head = GST_BUFFER (mhclient->sending->data);
+      guint n_buffers;
+      gsize left;
 
-      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket, head,
-          mhclient->bufoffset, sink->cancellable, &err);
+      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket,
+          mhclient->sending, mhclient->bufoffset, &n_buffers,
+          sink->cancellable, &err);
 
       if (wrote < 0) {
         /* hmm error.. */
@@ -929,13 +1111,21 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           goto write_error;
         }
       } else {
-        if (wrote < (gst_buffer_get_size (head) - mhclient->bufoffset)) {
-          /* partial write, try again now */
-          GST_LOG_OBJECT (sink,
-              "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
-              mhclient->handle.socket, wrote);
-          mhclient->bufoffset += wrote;
-        } else {
+        /* remove all buffers that were written completely */
+        left = wrote;
+        while (n_buffers > 0) {
+          GstBuffer *head = GST_BUFFER (mhclient->sending->data);
+          gsize remaining = gst_buffer_get_size (head) - mhclient->bufoffset;
+
+          if (left < remaining) {
+            /* partial write, try again now */
+            GST_LOG_OBJECT (sink,
+                "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
+                mhclient->handle.socket, wrote);
+            mhclient->bufoffset += left;
+            break;
+          }
+
           if (sink->send_dispatched) {
             gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
                 gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
@@ -948,6 +1138,9 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           gst_buffer_unref (head);
           /* make sure we start from byte 0 for the next buffer */
           mhclient->bufoffset = 0;
+
+          left -= remaining;
+          n_buffers--;
         }
         /* update stats */
         mhclient->bytes_sent += wrote;
@@ -1183,6 +1376,12 @@ gst_multi_socket_sink_set_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       sink->send_messages = g_value_get_boolean (value);
       break;
+    case PROP_BATCH_SIZE:
+      sink->batch_size = g_value_get_uint (value);
+      break;
+    case PROP_ZERO_COPY:
+      sink->zero_copy = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1202,6 +1401,12 @@ gst_multi_socket_sink_get_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       g_value_set_boolean (value, sink->send_messages);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, sink->batch_size);
+      break;
+    case PROP_ZERO_COPY:
+      g_value_set_boolean (value, sink->zero_copy);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -70,6 +70,8 @@ struct _GstMultiSocketSink {
   GCancellable *cancellable;
   gboolean send_messages;
   gboolean send_dispatched;
+  guint batch_size;
+  gboolean zero_copy;
 };
 
 struct _GstMultiSocketSinkClass {
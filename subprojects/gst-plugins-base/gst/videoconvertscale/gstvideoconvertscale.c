@@ -110,8 +110,32 @@ typedef struct
 
   gint borders_h;
   gint borders_w;
+
+  /* frame pipelining */
+  guint n_frame_threads;
+  guint n_frame_slots;
+  GPtrArray *frame_converters;
+  GstTaskPool *frame_pool;
+  GQueue pending_frames;
+  guint frame_slot;
+  /* convert the next frame right away, after pushing the pending ones */
+  gboolean sync_frame;
+  /* flow return of pending frames pushed outside of the chain function */
+  GstFlowReturn pending_ret;
 } GstVideoConvertScalePrivate;
 
+/* a frame that is being converted on the frame pool */
+typedef struct
+{
+  GstVideoConverter *convert;
+  GstBuffer *inbuf;
+  GstBuffer *outbuf;
+  GstVideoFrame in_frame;
+  GstVideoFrame out_frame;
+  gboolean mapped;
+  gpointer handle;
+} GstVideoConvertScaleFrame;
+
 #define gst_video_convert_scale_parent_class parent_class
 G_DEFINE_TYPE_WITH_PRIVATE (GstVideoConvertScale, gst_video_convert_scale,
     GST_TYPE_VIDEO_FILTER);
@@ -139,6 +163,7 @@ GST_DEBUG_CATEGORY_STATIC (CAT_PERFORMANCE);
 #define DEFAULT_PROP_GAMMA_MODE GST_VIDEO_GAMMA_MODE_NONE
 #define DEFAULT_PROP_PRIMARIES_MODE GST_VIDEO_PRIMARIES_MODE_NONE
 #define DEFAULT_PROP_N_THREADS 1
+#define DEFAULT_PROP_N_FRAME_THREADS 1
 
 static GQuark _colorspace_quark;
 
@@ -162,6 +187,7 @@ enum
   PROP_GAMMA_MODE,
   PROP_PRIMARIES_MODE,
   PROP_CONVERTER_CONFIG,
+  PROP_N_FRAME_THREADS,
 };
 
 #undef GST_VIDEO_SIZE_RANGE
@@ -256,8 +282,24 @@ static gboolean gst_video_convert_scale_transform_meta (GstBaseTransform *
 static gboolean gst_video_convert_scale_set_info (GstVideoFilter * filter,
     GstCaps * in, GstVideoInfo * in_info, GstCaps * out,
     GstVideoInfo * out_info);
+static GstFlowReturn
+gst_video_convert_scale_submit_input_buffer (GstBaseTransform * trans,
+    gboolean is_discont, GstBuffer * input);
+static GstFlowReturn gst_video_convert_scale_generate_output (GstBaseTransform
+    * trans, GstBuffer ** outbuf);
+static gboolean gst_video_convert_scale_sink_event (GstBaseTransform * trans,
+    GstEvent * event);
+static gboolean gst_video_convert_scale_query (GstBaseTransform * trans,
+    GstPadDirection direction, GstQuery * query);
+static gboolean gst_video_convert_scale_propose_allocation (GstBaseTransform *
+    trans, GstQuery * decide_query, GstQuery * query);
+static gboolean gst_video_convert_scale_decide_allocation (GstBaseTransform *
+    trans, GstQuery * query);
+static gboolean gst_video_convert_scale_stop (GstBaseTransform * trans);
 static GstFlowReturn gst_video_convert_scale_transform_frame (GstVideoFilter *
     filter, GstVideoFrame * in, GstVideoFrame * out);
+static void gst_video_convert_scale_push_pending_frames (GstVideoConvertScale *
+    self);
 
 static void gst_video_convert_scale_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
@@ -395,6 +437,24 @@ gst_video_convert_scale_class_init (GstVideoConvertScaleClass * klass)
           " This configuration, if set, takes precedence over the other similar conversion properties.",
           GST_TYPE_STRUCTURE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoConvertScale:n-frame-threads:
+   *
+   * Maximum number of frames to convert at the same time, 0 for the number
+   * of processors. With more than 1, frames are converted concurrently on a
+   * pool of threads and pushed in order, which adds latency of
+   * n-frame-threads - 1 frames. This scales better than #GstVideoConvertScale:n-threads
+   * for small frames, where splitting a single frame over threads costs more
+   * than it gains.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_N_FRAME_THREADS,
+      g_param_spec_uint ("n-frame-threads", "Frame Threads",
+          "Maximum number of frames to convert in parallel (0 = number of "
+          "processors)", 0, G_MAXUINT, DEFAULT_PROP_N_FRAME_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
 
   gst_element_class_set_static_metadata (element_class,
       "Video colorspace converter and scaler",
@@ -421,6 +481,18 @@ gst_video_convert_scale_class_init (GstVideoConvertScaleClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_convert_scale_src_event);
   trans_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_video_convert_scale_transform_meta);
+  trans_class->submit_input_buffer =
+      GST_DEBUG_FUNCPTR (gst_video_convert_scale_submit_input_buffer);
+  trans_class->generate_output =
+      GST_DEBUG_FUNCPTR (gst_video_convert_scale_generate_output);
+  trans_class->sink_event =
+      GST_DEBUG_FUNCPTR (gst_video_convert_scale_sink_event);
+  trans_class->query = GST_DEBUG_FUNCPTR (gst_video_convert_scale_query);
+  trans_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_scale_propose_allocation);
+  trans_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_scale_decide_allocation);
+  trans_class->stop = GST_DEBUG_FUNCPTR (gst_video_convert_scale_stop);
 
   filter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_convert_scale_set_info);
   filter_class->transform_frame =
@@ -455,6 +527,10 @@ gst_video_convert_scale_init (GstVideoConvertScale * self)
 
   priv->converter_config = NULL;
   priv->converter_config_changed = FALSE;
+
+  priv->n_frame_threads = DEFAULT_PROP_N_FRAME_THREADS;
+  g_queue_init (&priv->pending_frames);
+  priv->pending_ret = GST_FLOW_OK;
 }
 
 static void
@@ -464,6 +540,12 @@ gst_video_convert_scale_finalize (GstVideoConvertScale * self)
 
   if (priv->convert)
     gst_video_converter_free (priv->convert);
+  if (priv->frame_converters)
+    g_ptr_array_unref (priv->frame_converters);
+  if (priv->frame_pool) {
+    gst_task_pool_cleanup (priv->frame_pool);
+    gst_object_unref (priv->frame_pool);
+  }
 
   if (priv->converter_config)
     gst_structure_free (priv->converter_config);
@@ -537,6 +619,9 @@ gst_video_convert_scale_set_property (GObject * object, guint prop_id,
       priv->converter_config = g_value_dup_boxed (value);
       priv->converter_config_changed = TRUE;
       break;
+    case PROP_N_FRAME_THREADS:
+      priv->n_frame_threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -603,6 +688,9 @@ gst_video_convert_scale_get_property (GObject * object, guint prop_id,
     case PROP_CONVERTER_CONFIG:
       g_value_set_boxed (value, priv->converter_config);
       break;
+    case PROP_N_FRAME_THREADS:
+      g_value_set_uint (value, priv->n_frame_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -754,6 +842,59 @@ gst_video_convert_scale_get_converter_config (GstVideoConvertScale * self,
   return gst_structure_copy (priv->converter_config);
 }
 
+/* Every frame converted at the same time needs its own converter, the one
+ * of the first slot is priv->convert */
+static void
+gst_video_convert_scale_setup_frame_threads (GstVideoConvertScale * self,
+    const GstVideoInfo * in_info, const GstVideoInfo * out_info)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  guint i, n_slots;
+
+  GST_OBJECT_LOCK (self);
+  n_slots = priv->n_frame_threads;
+  GST_OBJECT_UNLOCK (self);
+
+  if (n_slots == 0)
+    n_slots = g_get_num_processors ();
+
+  if (priv->frame_converters)
+    g_ptr_array_set_size (priv->frame_converters, 0);
+
+  if (priv->convert == NULL || n_slots <= 1) {
+    priv->n_frame_slots = 1;
+    return;
+  }
+
+  if (priv->frame_converters == NULL)
+    priv->frame_converters =
+        g_ptr_array_new_with_free_func ((GDestroyNotify)
+        gst_video_converter_free);
+
+  for (i = 1; i < n_slots; i++) {
+    GstVideoConverter *convert;
+
+    convert = gst_video_converter_new ((GstVideoInfo *) in_info,
+        (GstVideoInfo *) out_info,
+        gst_structure_copy (gst_video_converter_get_config (priv->convert)));
+    if (convert == NULL)
+      break;
+    g_ptr_array_add (priv->frame_converters, convert);
+  }
+  priv->n_frame_slots = priv->frame_converters->len + 1;
+  priv->frame_slot = 0;
+
+  if (priv->frame_pool == NULL) {
+    priv->frame_pool = gst_shared_task_pool_new ();
+    gst_task_pool_prepare (priv->frame_pool, NULL);
+  }
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+      (priv->frame_pool), priv->n_frame_slots);
+
+  GST_DEBUG_OBJECT (self, "converting up to %u frames in parallel",
+      priv->n_frame_slots);
+}
+
 static gboolean
 gst_video_convert_scale_set_info (GstVideoFilter * filter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info)
@@ -764,6 +905,10 @@ gst_video_convert_scale_set_info (GstVideoFilter * filter, GstCaps * in,
   GstVideoInfo tmp_info;
   GstStructure *options;
 
+  /* a reconfiguration can happen while frames are still being converted
+   * with the old converters, push these with the old caps first */
+  gst_video_convert_scale_push_pending_frames (self);
+
   if (priv->convert) {
     gst_video_converter_free (priv->convert);
     priv->convert = NULL;
@@ -943,6 +1088,8 @@ gst_video_convert_scale_set_info (GstVideoFilter * filter, GstCaps * in,
       goto no_convert;
   }
 
+  gst_video_convert_scale_setup_frame_threads (self, in_info, out_info);
+
   GST_DEBUG_OBJECT (filter, "converting format %s -> %s",
       gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (in_info)),
       gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (out_info)));
@@ -1788,6 +1935,23 @@ gst_video_convert_scale_fixate_caps (GstBaseTransform * base,
   return othercaps;
 }
 
+static void
+gst_video_convert_scale_update_converter (GstVideoConvertScale * self)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (self);
+  GstStructure *options =
+      gst_video_convert_scale_get_converter_config (self, &filter->out_info);
+
+  gst_video_converter_free (priv->convert);
+  priv->convert =
+      gst_video_converter_new (&filter->in_info, &filter->out_info, options);
+  gst_video_convert_scale_setup_frame_threads (self, &filter->in_info,
+      &filter->out_info);
+
+  priv->converter_config_changed = FALSE;
+}
+
 #define GET_LINE(frame, line) \
     (gpointer)(((guint8*)(GST_VIDEO_FRAME_PLANE_DATA (frame, 0))) + \
      GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0) * (line))
@@ -1801,23 +1965,329 @@ gst_video_convert_scale_transform_frame (GstVideoFilter * filter,
 
   GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter, "doing video scaling");
 
+  if (priv->converter_config_changed)
+    gst_video_convert_scale_update_converter (GST_VIDEO_CONVERT_SCALE (filter));
+
+  gst_video_converter_frame (priv->convert, in_frame, out_frame);
+
+  return ret;
+}
+
+static void
+gst_video_convert_scale_convert_frame_func (gpointer user_data)
+{
+  GstVideoConvertScaleFrame *frame = user_data;
+
+  gst_video_converter_frame (frame->convert, &frame->in_frame,
+      &frame->out_frame);
+}
+
+/* wait for @frame to be converted and return its output buffer */
+static GstBuffer *
+gst_video_convert_scale_finish_frame (GstVideoConvertScale * self,
+    GstVideoConvertScaleFrame * frame)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  GstBuffer *outbuf = frame->outbuf;
+
+  if (frame->handle)
+    gst_task_pool_join (priv->frame_pool, frame->handle);
+
+  if (frame->mapped) {
+    gst_video_frame_unmap (&frame->out_frame);
+    gst_video_frame_unmap (&frame->in_frame);
+  }
+  gst_buffer_unref (frame->inbuf);
+  g_free (frame);
+
+  return outbuf;
+}
+
+/* finish all pending frames in order and push them when @push is TRUE,
+ * discard them otherwise */
+static GstFlowReturn
+gst_video_convert_scale_drain_frames (GstVideoConvertScale * self,
+    gboolean push)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  GstVideoConvertScaleFrame *frame;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (!g_queue_is_empty (&priv->pending_frames))
+    GST_DEBUG_OBJECT (self, "%s %u pending frames", push ? "pushing" :
+        "discarding", g_queue_get_length (&priv->pending_frames));
+
+  while ((frame = g_queue_pop_head (&priv->pending_frames))) {
+    GstBuffer *outbuf = gst_video_convert_scale_finish_frame (self, frame);
+
+    if (push && ret == GST_FLOW_OK)
+      ret = gst_pad_push (GST_BASE_TRANSFORM_SRC_PAD (self), outbuf);
+    else
+      gst_buffer_unref (outbuf);
+  }
+
+  return ret;
+}
+
+/* push the pending frames from outside of the chain function, an error is
+ * returned from the next chain call */
+static void
+gst_video_convert_scale_push_pending_frames (GstVideoConvertScale * self)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  GstFlowReturn ret;
+
+  ret = gst_video_convert_scale_drain_frames (self, TRUE);
+  if (ret != GST_FLOW_OK && priv->pending_ret == GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (self, "pushing pending frames failed: %s",
+        gst_flow_get_name (ret));
+    priv->pending_ret = ret;
+  }
+}
+
+static GstFlowReturn
+gst_video_convert_scale_submit_input_buffer (GstBaseTransform * trans,
+    gboolean is_discont, GstBuffer * input)
+{
+  GstVideoConvertScale *self = GST_VIDEO_CONVERT_SCALE_CAST (trans);
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  GstFlowReturn ret;
+
+  if (priv->pending_ret != GST_FLOW_OK) {
+    ret = priv->pending_ret;
+    priv->pending_ret = GST_FLOW_OK;
+    gst_buffer_unref (input);
+    return ret;
+  }
+
+  /* basetransform marks the next output buffer as DISCONT, which would be
+   * an older pending frame. Push the pending frames and convert this one
+   * right away instead. Also push them before a reconfiguration, which
+   * replaces the converters they are using. */
+  priv->sync_frame = is_discont;
+  if (is_discont
+      || gst_pad_needs_reconfigure (GST_BASE_TRANSFORM_SRC_PAD (trans))) {
+    ret = gst_video_convert_scale_drain_frames (self, TRUE);
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (input);
+      return ret;
+    }
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->submit_input_buffer (trans,
+      is_discont, input);
+}
+
+static GstFlowReturn
+gst_video_convert_scale_generate_output (GstBaseTransform * trans,
+    GstBuffer ** outbuf)
+{
+  GstVideoConvertScale *self = GST_VIDEO_CONVERT_SCALE_CAST (trans);
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (trans);
+  GstVideoConvertScaleFrame *frame;
+  GstBuffer *inbuf, *buf = NULL;
+  GstFlowReturn ret;
+
+  if (priv->n_frame_slots <= 1 || !filter->negotiated ||
+      gst_base_transform_is_passthrough (trans) || (priv->sync_frame &&
+          g_queue_is_empty (&priv->pending_frames)))
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (trans,
+        outbuf);
+
+  inbuf = trans->queued_buf;
+  trans->queued_buf = NULL;
+  if (inbuf == NULL)
+    return GST_FLOW_OK;
+
+  /* wait for the converters before changing them */
   if (priv->converter_config_changed) {
-    GstStructure *options =
-        gst_video_convert_scale_get_converter_config (GST_VIDEO_CONVERT_SCALE
-        (filter), &filter->out_info);
+    ret = gst_video_convert_scale_drain_frames (self, TRUE);
+    if (ret != GST_FLOW_OK)
+      goto error;
+  }
+  if (priv->converter_config_changed)
+    gst_video_convert_scale_update_converter (self);
+
+  ret = GST_BASE_TRANSFORM_GET_CLASS (trans)->prepare_output_buffer (trans,
+      inbuf, &buf);
+  if (ret != GST_FLOW_OK || buf == NULL)
+    goto error;
+
+  frame = g_new0 (GstVideoConvertScaleFrame, 1);
+  frame->inbuf = inbuf;
+  frame->outbuf = buf;
+  frame->convert = priv->frame_slot == 0 ? priv->convert :
+      g_ptr_array_index (priv->frame_converters, priv->frame_slot - 1);
+  priv->frame_slot = (priv->frame_slot + 1) % priv->n_frame_slots;
+
+  if (gst_video_frame_map (&frame->in_frame, &filter->in_info, inbuf,
+          GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_NO_REF)) {
+    if (gst_video_frame_map (&frame->out_frame, &filter->out_info, buf,
+            GST_MAP_WRITE | GST_VIDEO_FRAME_MAP_FLAG_NO_REF)) {
+      frame->mapped = TRUE;
+    } else {
+      gst_video_frame_unmap (&frame->in_frame);
+    }
+  }
 
-    gst_video_converter_free (priv->convert);
-    priv->convert =
-        gst_video_converter_new (&filter->in_info, &filter->out_info, options);
+  if (frame->mapped) {
+    GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, self, "doing video scaling");
+    frame->handle = gst_task_pool_push (priv->frame_pool,
+        gst_video_convert_scale_convert_frame_func, frame, NULL);
+    if (frame->handle == NULL)
+      gst_video_convert_scale_convert_frame_func (frame);
+  } else {
+    GST_ELEMENT_WARNING (self, CORE, NOT_IMPLEMENTED, (NULL),
+        ("invalid video buffer received"));
+  }
 
-    priv->converter_config_changed = FALSE;
+  g_queue_push_tail (&priv->pending_frames, frame);
+
+  /* output the oldest frame once all slots are in use */
+  if (g_queue_get_length (&priv->pending_frames) == priv->n_frame_slots)
+    *outbuf = gst_video_convert_scale_finish_frame (self,
+        g_queue_pop_head (&priv->pending_frames));
+
+  return GST_FLOW_OK;
+
+error:
+  {
+    gst_buffer_unref (inbuf);
+    return ret;
   }
+}
 
-  gst_video_converter_frame (priv->convert, in_frame, out_frame);
+static gboolean
+gst_video_convert_scale_sink_event (GstBaseTransform * trans, GstEvent * event)
+{
+  GstVideoConvertScale *self = GST_VIDEO_CONVERT_SCALE_CAST (trans);
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+
+  /* pending frames must go before serialized events */
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP) {
+    gst_video_convert_scale_drain_frames (self, FALSE);
+    priv->pending_ret = GST_FLOW_OK;
+  } else if (GST_EVENT_IS_SERIALIZED (event)) {
+    gst_video_convert_scale_push_pending_frames (self);
+
+    /* there is no next chain call to return an error from */
+    if (GST_EVENT_TYPE (event) == GST_EVENT_EOS &&
+        (priv->pending_ret == GST_FLOW_NOT_LINKED ||
+            priv->pending_ret < GST_FLOW_EOS))
+      GST_ELEMENT_FLOW_ERROR (self, priv->pending_ret);
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (trans, event);
+}
+
+static gboolean
+gst_video_convert_scale_query (GstBaseTransform * trans,
+    GstPadDirection direction, GstQuery * query)
+{
+  GstVideoConvertScale *self = GST_VIDEO_CONVERT_SCALE_CAST (trans);
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (trans);
+  gboolean ret;
+
+  if (direction == GST_PAD_SINK && GST_QUERY_IS_SERIALIZED (query))
+    gst_video_convert_scale_push_pending_frames (self);
+
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->query (trans, direction,
+      query);
+
+  /* we keep up to n_frame_slots - 1 frames */
+  if (ret && direction == GST_PAD_SRC &&
+      GST_QUERY_TYPE (query) == GST_QUERY_LATENCY &&
+      priv->n_frame_slots > 1 && !gst_base_transform_is_passthrough (trans) &&
+      filter->out_info.fps_n > 0) {
+    GstClockTime min, max, latency;
+    gboolean live;
+
+    latency = gst_util_uint64_scale_int (GST_SECOND * (priv->n_frame_slots -
+            1), filter->out_info.fps_d, filter->out_info.fps_n);
+
+    gst_query_parse_latency (query, &live, &min, &max);
+    GST_DEBUG_OBJECT (self, "adding latency %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (latency));
+    min += latency;
+    if (max != GST_CLOCK_TIME_NONE)
+      max += latency;
+    gst_query_set_latency (query, live, min, max);
+  }
 
   return ret;
 }
 
+static gboolean
+gst_video_convert_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (trans);
+
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  /* the pending frames hold on to input buffers too, passthrough has no
+   * pending frames */
+  if (decide_query != NULL && priv->n_frame_slots > 1 &&
+      gst_query_get_n_allocation_pools (query) > 0) {
+    GstBufferPool *pool;
+    guint size, min, max;
+
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    min += priv->n_frame_slots - 1;
+    if (max != 0)
+      max += priv->n_frame_slots - 1;
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+    if (pool)
+      gst_object_unref (pool);
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_video_convert_scale_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (trans);
+
+  /* the pending frames hold on to output buffers */
+  if (priv->n_frame_slots > 1 && gst_query_get_n_allocation_pools (query) > 0) {
+    GstBufferPool *pool;
+    guint size, min, max;
+
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    min += priv->n_frame_slots - 1;
+    if (max != 0)
+      max += priv->n_frame_slots - 1;
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+    if (pool)
+      gst_object_unref (pool);
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (trans,
+      query);
+}
+
+static gboolean
+gst_video_convert_scale_stop (GstBaseTransform * trans)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (trans);
+
+  gst_video_convert_scale_drain_frames (GST_VIDEO_CONVERT_SCALE_CAST (trans),
+      FALSE);
+  priv->pending_ret = GST_FLOW_OK;
+  priv->sync_frame = FALSE;
+
+  if (GST_BASE_TRANSFORM_CLASS (parent_class)->stop)
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->stop (trans);
+
+  return TRUE;
+}
+
 static gboolean
 gst_video_convert_scale_src_event (GstBaseTransform * trans, GstEvent * event)
 {
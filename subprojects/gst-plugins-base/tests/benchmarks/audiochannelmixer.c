@@ -0,0 +1,152 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Mixes stereo to 5.1, 5.1 to stereo and selects 2 out of 64 channels with
+ * the audio channel mixer, for each sample format and layout. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_SECONDS 60
+#define BLOCK_FRAMES 4800
+
+static const GstAudioChannelPosition stereo[] = {
+  GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+  GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+};
+
+static const GstAudioChannelPosition surround[] = {
+  GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+  GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+  GST_AUDIO_CHANNEL_POSITION_FRONT_CENTER,
+  GST_AUDIO_CHANNEL_POSITION_LFE1,
+  GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+  GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT,
+};
+
+static GstAudioChannelMixer *
+make_mixer (GstAudioChannelMixerFlags flags, GstAudioFormat format,
+    gint in_channels, gint out_channels)
+{
+  gfloat **matrix;
+  gint i;
+
+  if (in_channels == 2)
+    return gst_audio_channel_mixer_new (flags, format, 2,
+        (GstAudioChannelPosition *) stereo, 6,
+        (GstAudioChannelPosition *) surround);
+  if (in_channels == 6)
+    return gst_audio_channel_mixer_new (flags, format, 6,
+        (GstAudioChannelPosition *) surround, 2,
+        (GstAudioChannelPosition *) stereo);
+
+  /* select channels 10 and 11 */
+  matrix = g_new (gfloat *, in_channels);
+  for (i = 0; i < in_channels; i++)
+    matrix[i] = g_new0 (gfloat, out_channels);
+  matrix[10][0] = 1.0f;
+  matrix[11][1] = 1.0f;
+
+  return gst_audio_channel_mixer_new_with_matrix (flags, format, in_channels,
+      out_channels, matrix);
+}
+
+static void
+run_test (GstAudioFormat format, gboolean planar, gint in_channels,
+    gint out_channels, guint seconds)
+{
+  GstAudioChannelMixer *mix;
+  GstAudioChannelMixerFlags flags = 0;
+  gint bps =
+      GST_AUDIO_FORMAT_INFO_WIDTH (gst_audio_format_get_info (format)) / 8;
+  gpointer in, out, *in_planes, *out_planes;
+  GstClockTime start, end;
+  guint i, n_blocks = seconds * 48000 / BLOCK_FRAMES;
+
+  if (planar)
+    flags = GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN |
+        GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT;
+
+  mix = make_mixer (flags, format, in_channels, out_channels);
+
+  in = g_malloc0 (BLOCK_FRAMES * in_channels * bps);
+  out = g_malloc0 (BLOCK_FRAMES * out_channels * bps);
+  in_planes = g_new (gpointer, in_channels);
+  out_planes = g_new (gpointer, out_channels);
+
+  for (i = 0; i < (planar ? in_channels : 1); i++)
+    in_planes[i] = (guint8 *) in + i * BLOCK_FRAMES * bps;
+  for (i = 0; i < (planar ? out_channels : 1); i++)
+    out_planes[i] = (guint8 *) out + i * BLOCK_FRAMES * bps;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_blocks; i++)
+    gst_audio_channel_mixer_samples (mix, in_planes, out_planes, BLOCK_FRAMES);
+  end = gst_util_get_timestamp ();
+
+  g_print ("%-4s %-11s %2d -> %d: %" GST_TIME_FORMAT " for %us of audio, "
+      "%.1fx realtime\n", gst_audio_format_to_string (format),
+      planar ? "planar" : "interleaved", in_channels, out_channels,
+      GST_TIME_ARGS (end - start), seconds,
+      (gdouble) n_blocks * BLOCK_FRAMES * GST_SECOND / 48000 / (end - start));
+
+  g_free (in_planes);
+  g_free (out_planes);
+  g_free (in);
+  g_free (out);
+  gst_audio_channel_mixer_free (mix);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  const GstAudioFormat formats[] = { GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32,
+    GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64
+  };
+  const gint cases[][2] = { {2, 6}, {6, 2}, {64, 2} };
+  guint seconds = DEFAULT_SECONDS;
+  guint f, c, planar;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 2) {
+    g_print ("usage: %s [<seconds of audio>]\n", argv[0]);
+    exit (-1);
+  }
+  if (argc == 2)
+    seconds = atoi (argv[1]);
+
+  if (seconds == 0) {
+    g_print ("seconds of audio must be greater than 0\n");
+    exit (-2);
+  }
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++)
+    for (planar = 0; planar < 2; planar++)
+      for (c = 0; c < G_N_ELEMENTS (cases); c++)
+        run_test (formats[f], planar, cases[c][0], cases[c][1], seconds);
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Resamples a mono 48kHz signal to 44.1kHz with every SIMD implementation of
+ * the audio resampler, for each sample format and filter mode. Levels that
+ * are not supported by the CPU fall back to the best available one. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_SECONDS 60
+#define BLOCK_FRAMES 4800
+
+static const gchar *levels[] = {
+  "none", "sse", "sse2", "sse41", "avx2", "avx512", "neon"
+};
+
+static void
+run_test (GstAudioFormat format, GstAudioResamplerFilterMode mode,
+    GstAudioResamplerFilterInterpolation interpolation, const gchar * simd,
+    guint seconds)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gpointer in, out, in_planes[1], out_planes[1];
+  GstClockTime start, end;
+  guint64 in_frames = 0;
+  gsize out_frames;
+  guint i, n_blocks = seconds * 48000 / BLOCK_FRAMES;
+  gdouble *src;
+
+  options = gst_structure_new_empty ("resampler");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 48000, 44100, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_SIMD, G_TYPE_STRING, simd,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      mode, GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, interpolation, NULL);
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, 1, 48000, 44100, options);
+  gst_structure_free (options);
+
+  src = g_new (gdouble, BLOCK_FRAMES);
+  for (i = 0; i < BLOCK_FRAMES; i++)
+    src[i] = 0.5 * sin (2.0 * G_PI * 1000.0 * i / 48000.0);
+
+  in = g_malloc (BLOCK_FRAMES * GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8);
+  out = g_malloc (2 * BLOCK_FRAMES * GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8);
+  for (i = 0; i < BLOCK_FRAMES; i++) {
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) in)[i] = src[i] * G_MAXINT16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        ((gint32 *) in)[i] = src[i] * G_MAXINT32;
+        break;
+      default:
+        ((gfloat *) in)[i] = src[i];
+        break;
+    }
+  }
+
+  in_planes[0] = in;
+  out_planes[0] = out;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_blocks; i++) {
+    out_frames = gst_audio_resampler_get_out_frames (resampler, BLOCK_FRAMES);
+    gst_audio_resampler_resample (resampler, in_planes, BLOCK_FRAMES,
+        out_planes, out_frames);
+    in_frames += BLOCK_FRAMES;
+  }
+  end = gst_util_get_timestamp ();
+
+  g_print ("%-4s %-12s %-7s: %" GST_TIME_FORMAT " for %us of audio, "
+      "%.1fx realtime\n", gst_audio_format_to_string (format),
+      mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL ? "full" :
+      interpolation == GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR ?
+      "linear" : "cubic", simd, GST_TIME_ARGS (end - start), seconds,
+      (gdouble) in_frames * GST_SECOND / 48000 / (end - start));
+
+  g_free (src);
+  g_free (in);
+  g_free (out);
+  gst_audio_resampler_free (resampler);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  const GstAudioFormat formats[] = { GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32,
+    GST_AUDIO_FORMAT_F32
+  };
+  guint seconds = DEFAULT_SECONDS;
+  guint f, l;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 2) {
+    g_print ("usage: %s [<seconds of audio>]\n", argv[0]);
+    exit (-1);
+  }
+  if (argc == 2)
+    seconds = atoi (argv[1]);
+
+  if (seconds == 0) {
+    g_print ("seconds of audio must be greater than 0\n");
+    exit (-2);
+  }
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    for (l = 0; l < G_N_ELEMENTS (levels); l++)
+      run_test (formats[f], GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+          GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE, levels[l], seconds);
+    for (l = 0; l < G_N_ELEMENTS (levels); l++)
+      run_test (formats[f], GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+          GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR, levels[l], seconds);
+    for (l = 0; l < G_N_ELEMENTS (levels); l++)
+      run_test (formats[f], GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+          GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC, levels[l], seconds);
+  }
+
+  return 0;
+}
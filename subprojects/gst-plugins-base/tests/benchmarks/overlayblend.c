@@ -0,0 +1,190 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Compares copying a frame and blending an overlay composition onto the copy
+ * with blending while copying in an identity video converter, for
+ * compositions covering a growing share of the frame. The share where the
+ * second one starts to win is the coverage threshold used by the video
+ * converter and the overlaycomposition element. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define DEFAULT_FRAMES 200
+#define WIDTH 1920
+#define HEIGHT 1080
+
+static GstVideoOverlayComposition *
+make_composition (guint coverage)
+{
+  GstVideoOverlayComposition *comp;
+  GstVideoOverlayRectangle *rect;
+  GstBuffer *pixels;
+  guint width, height;
+
+  /* a full width band at the bottom, like subtitles */
+  width = WIDTH;
+  height = MAX (HEIGHT * coverage / 100, 1);
+
+  pixels = gst_buffer_new_and_alloc (width * height * 4);
+  gst_buffer_memset (pixels, 0, 0x80, width * height * 4);
+  gst_buffer_add_video_meta (pixels, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, width, height);
+
+  rect = gst_video_overlay_rectangle_new_raw (pixels, 0, HEIGHT - height,
+      width, height, GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  gst_buffer_unref (pixels);
+  comp = gst_video_overlay_composition_new (rect);
+  gst_video_overlay_rectangle_unref (rect);
+
+  return comp;
+}
+
+static GstClockTime
+run_copy_then_blend (GstVideoInfo * info, GstBuffer * src,
+    GstVideoOverlayComposition * comp, guint n_frames)
+{
+  GstClockTime start;
+  guint i;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_frames; i++) {
+    GstBuffer *buf;
+    GstVideoFrame frame;
+
+    /* what the element does for a buffer that is not writable */
+    buf = gst_buffer_make_writable (gst_buffer_ref (src));
+    gst_video_frame_map (&frame, info, buf, GST_MAP_READWRITE);
+    gst_video_overlay_composition_blend (comp, &frame);
+    gst_video_frame_unmap (&frame);
+    gst_buffer_unref (buf);
+  }
+
+  return gst_util_get_timestamp () - start;
+}
+
+static GstClockTime
+run_blend_while_copying (GstVideoInfo * info, GstBuffer * src,
+    GstVideoOverlayComposition * comp, guint n_frames)
+{
+  GstVideoOverlayComposition *full;
+  GstVideoConverter *convert;
+  GstVideoFrame in_frame, out_frame;
+  GstClockTime start, elapsed;
+  guint i;
+
+  /* the converter only uses the line pass for identity conversions when the
+   * composition at construction covers most of the frame, and keeps using it
+   * when the composition is replaced afterwards */
+  full = make_composition (100);
+  convert = gst_video_converter_new (info, info,
+      gst_structure_new ("GstVideoConverter",
+          GST_VIDEO_CONVERTER_OPT_OVERLAY_COMPOSITION,
+          GST_TYPE_VIDEO_OVERLAY_COMPOSITION, full,
+          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+          GST_VIDEO_DITHER_NONE, NULL));
+  gst_video_overlay_composition_unref (full);
+  gst_video_converter_set_config (convert,
+      gst_structure_new ("GstVideoConverter",
+          GST_VIDEO_CONVERTER_OPT_OVERLAY_COMPOSITION,
+          GST_TYPE_VIDEO_OVERLAY_COMPOSITION, comp, NULL));
+
+  gst_video_frame_map (&in_frame, info, src, GST_MAP_READ);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_frames; i++) {
+    GstBuffer *buf;
+
+    buf = gst_buffer_new_allocate (NULL, info->size, NULL);
+    gst_video_frame_map (&out_frame, info, buf, GST_MAP_WRITE);
+    gst_video_converter_frame (convert, &in_frame, &out_frame);
+    gst_video_frame_unmap (&out_frame);
+    gst_buffer_unref (buf);
+  }
+  elapsed = gst_util_get_timestamp () - start;
+
+  gst_video_frame_unmap (&in_frame);
+  gst_video_converter_free (convert);
+
+  return elapsed;
+}
+
+static void
+run_test (GstVideoFormat format, guint coverage, guint n_frames)
+{
+  GstVideoOverlayComposition *comp;
+  GstVideoInfo info;
+  GstBuffer *src;
+  GstClockTime copy_blend, fused;
+
+  gst_video_info_set_format (&info, format, WIDTH, HEIGHT);
+  src = gst_buffer_new_and_alloc (info.size);
+  gst_buffer_memset (src, 0, 0x40, info.size);
+
+  comp = make_composition (coverage);
+
+  copy_blend = run_copy_then_blend (&info, src, comp, n_frames);
+  fused = run_blend_while_copying (&info, src, comp, n_frames);
+
+  g_print ("%-5s %3u%% covered: copy+blend %" GST_TIME_FORMAT
+      ", blend while copying %" GST_TIME_FORMAT " (%.2fx)\n",
+      gst_video_format_to_string (format), coverage,
+      GST_TIME_ARGS (copy_blend / n_frames), GST_TIME_ARGS (fused / n_frames),
+      (gdouble) copy_blend / fused);
+
+  gst_video_overlay_composition_unref (comp);
+  gst_buffer_unref (src);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  const GstVideoFormat formats[] = { GST_VIDEO_FORMAT_I420,
+    GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_BGRA
+  };
+  const guint coverages[] = { 5, 10, 25, 50, 60, 70, 75, 80, 90, 100 };
+  guint n_frames = DEFAULT_FRAMES;
+  guint f, c;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 2) {
+    g_print ("usage: %s [<frames>]\n", argv[0]);
+    exit (-1);
+  }
+  if (argc == 2)
+    n_frames = atoi (argv[1]);
+
+  if (n_frames == 0) {
+    g_print ("frames must be greater than 0\n");
+    exit (-2);
+  }
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++)
+    for (c = 0; c < G_N_ELEMENTS (coverages); c++)
+      run_test (formats[f], coverages[c], n_frames);
+
+  return 0;
+}
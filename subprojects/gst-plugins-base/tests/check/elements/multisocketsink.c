@@ -307,6 +307,49 @@ GST_START_TEST (test_sending_buffers_with_9_gstmemories)
 
 GST_END_TEST;
 
+GST_START_TEST (test_sending_buffers_batched)
+{
+  TestSinkAndSocket tsas = { 0 };
+  GstBuffer *buffer;
+  int i;
+  const char *numbers[9] = { "one", "two", "three", "four", "five", "six",
+    "seven", "eight", "nine"
+  };
+  const char numbers_concat[] = "onetwothreefourfivesixseveneightnine";
+  gchar data[sizeof (numbers_concat)];
+  int len = sizeof (numbers_concat) - 1;
+  int round;
+
+  setup_sink_with_socket (&tsas);
+  g_object_set (tsas.sink, "batch-size", 4, NULL);
+
+  /* queue up buffers with one and several memories, whatever was queued
+   * when the socket becomes writable is sent in batches */
+  for (round = 0; round < 3; round++) {
+    for (i = 0; i < G_N_ELEMENTS (numbers); i++) {
+      buffer = gst_buffer_new ();
+      gst_buffer_append_memory (buffer,
+          gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+              (gpointer) numbers[i], 2, 0, 2, NULL, NULL));
+      gst_buffer_append_memory (buffer,
+          gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+              (gpointer) (numbers[i] + 2), strlen (numbers[i]) - 2, 0,
+              strlen (numbers[i]) - 2, NULL, NULL));
+      fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+    }
+  }
+
+  for (round = 0; round < 3; round++) {
+    fail_unless (read_handle_n_bytes_exactly (tsas.srcsocket, data, len));
+    fail_unless (strncmp (data, numbers_concat, len) == 0);
+  }
+  wait_bytes_served (tsas.sink, 3 * len);
+
+  teardown_sink_with_socket (&tsas);
+}
+
+GST_END_TEST;
+
 /* from the given two data buffers, create two streamheader buffers and
  * some caps that match it, and store them in the given pointers
  * returns  one ref to each of the buffers and the caps */
@@ -982,6 +1025,7 @@ multisocketsink_suite (void)
   tcase_add_test (tc_chain, test_no_clients);
   tcase_add_test (tc_chain, test_add_client);
   tcase_add_test (tc_chain, test_sending_buffers_with_9_gstmemories);
+  tcase_add_test (tc_chain, test_sending_buffers_batched);
   tcase_add_test (tc_chain, test_streamheader);
   tcase_add_test (tc_chain, test_change_streamheader);
   tcase_add_test (tc_chain, test_burst_client_bytes);
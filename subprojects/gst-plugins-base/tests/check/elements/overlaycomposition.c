@@ -146,8 +146,8 @@ GST_START_TEST (render_fallback)
   buffer = create_video_frame ();
   overlay = create_overlay_frame (0x80ffffff);
   rect =
-      gst_video_overlay_rectangle_new_raw (overlay, 32, 32, OVERLAY_WIDTH,
-      OVERLAY_HEIGHT, GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+      gst_video_overlay_rectangle_new_raw (overlay, x, y, width, height,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
   gst_buffer_unref (overlay);
   comp = gst_video_overlay_composition_new (rect);
   gst_video_overlay_rectangle_unref (rect);
@@ -332,6 +332,103 @@ GST_START_TEST (render_meta)
 
 GST_END_TEST;
 
+static void
+check_render_not_writable (const gchar * format, gint x, gint y, guint width,
+    guint height)
+{
+  GstHarness *h;
+  GstVideoOverlayComposition *comp;
+  GstVideoOverlayRectangle *rect;
+  GstBuffer *buffer, *outbuf, *expected, *overlay;
+  GstVideoFrame frame;
+  GstVideoInfo info;
+  GstCaps *caps;
+  GstMapInfo map, out_map;
+  State s = { 0, };
+  gsize i;
+
+  h = gst_harness_new ("overlaycomposition");
+
+  g_signal_connect (h->element, "draw", G_CALLBACK (on_draw), &s);
+  g_signal_connect (h->element, "caps-changed", G_CALLBACK (on_caps_changed),
+      &s);
+
+  overlay = create_overlay_frame (0xffff0000);
+  rect =
+      gst_video_overlay_rectangle_new_raw (overlay, x, y, width, height,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  gst_buffer_unref (overlay);
+  comp = gst_video_overlay_composition_new (rect);
+  gst_video_overlay_rectangle_unref (rect);
+
+  s.comp = comp;
+  s.expected_window_width = VIDEO_WIDTH;
+  s.expected_window_height = VIDEO_HEIGHT;
+
+  caps = gst_caps_new_simple ("video/x-raw",
+      "format", G_TYPE_STRING, format,
+      "width", G_TYPE_INT, VIDEO_WIDTH,
+      "height", G_TYPE_INT, VIDEO_HEIGHT,
+      "framerate", GST_TYPE_FRACTION, 30, 1, NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_harness_set_src_caps (h, caps);
+
+  buffer = gst_buffer_new_and_alloc (info.size);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = (i * 7) & 0xff;
+  gst_buffer_unmap (buffer, &map);
+
+  /* what blending onto a copy gives */
+  expected = gst_buffer_copy_deep (buffer);
+  fail_unless (gst_video_frame_map (&frame, &info, expected,
+          GST_MAP_READWRITE));
+  fail_unless (gst_video_overlay_composition_blend (comp, &frame));
+  gst_video_frame_unmap (&frame);
+
+  /* keep a reference so that the element can't blend in place */
+  fail_unless_equals_int (gst_harness_push (h, gst_buffer_ref (buffer)),
+      GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+  fail_unless (outbuf != buffer);
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], (i * 7) & 0xff);
+  gst_buffer_unmap (buffer, &map);
+
+  gst_buffer_map (expected, &map, GST_MAP_READ);
+  gst_buffer_map (outbuf, &out_map, GST_MAP_READ);
+  fail_unless_equals_int (out_map.size, map.size);
+  for (i = 0; i < map.size; i++)
+    fail_unless (out_map.data[i] == map.data[i],
+        "Expected %02x but got %02x at offset %" G_GSIZE_FORMAT " for %s",
+        map.data[i], out_map.data[i], i, format);
+  gst_buffer_unmap (outbuf, &out_map);
+  gst_buffer_unmap (expected, &map);
+
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (expected);
+  gst_buffer_unref (buffer);
+
+  gst_video_overlay_composition_unref (s.comp);
+  gst_harness_teardown (h);
+}
+
+GST_START_TEST (render_not_writable)
+{
+  /* a small composition is blended after copying */
+  check_render_not_writable ("I420", 32, 32, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+  /* one that covers the frame is blended while copying, for a format that
+   * has an identity copy fastpath */
+  check_render_not_writable ("I420", 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+  /* and a format that only has the generic line pass */
+  check_render_not_writable ("v308", 0, 0, VIDEO_WIDTH, VIDEO_HEIGHT);
+  check_render_not_writable ("v308", 32, 32, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+}
+
+GST_END_TEST;
+
 static Suite *
 overlaycomposition_suite (void)
 {
@@ -343,6 +440,7 @@ overlaycomposition_suite (void)
   tcase_add_test (tc, render_fallback);
   tcase_add_test (tc, render_fallback_2);
   tcase_add_test (tc, render_meta);
+  tcase_add_test (tc, render_not_writable);
 
   return s;
 }
@@ -150,6 +150,204 @@ GST_START_TEST (test_negotiate_alternate)
 
 GST_END_TEST;
 
+/* the luma of frame @i, each frame is a different shade of gray */
+#define FRAME_LUMA(i) (16 + (i) * 15)
+
+static GstBuffer *
+create_frame (GstVideoFormat format, gint width, gint height, gint i)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstBuffer *buf;
+  guint p;
+
+  gst_video_info_set_format (&info, format, width, height);
+  buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  fail_unless (gst_video_frame_map (&frame, &info, buf, GST_MAP_WRITE));
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&frame); p++) {
+    memset (GST_VIDEO_FRAME_PLANE_DATA (&frame, p), p == 0 ? FRAME_LUMA (i) :
+        128, GST_VIDEO_FRAME_PLANE_STRIDE (&frame, p) *
+        GST_VIDEO_FRAME_COMP_HEIGHT (&frame, p));
+  }
+  gst_video_frame_unmap (&frame);
+
+  GST_BUFFER_PTS (buf) = gst_util_uint64_scale_int (i * GST_SECOND, 1, 30);
+  GST_BUFFER_DURATION (buf) = gst_util_uint64_scale_int (GST_SECOND, 1, 30);
+
+  return buf;
+}
+
+/* checks that all pixels of @buf come from frame @i */
+static void
+check_frame_pixels (GstBuffer * buf, GstVideoInfo * info, gint i)
+{
+  GstVideoFrame frame;
+  gint x, y;
+
+  fail_unless (gst_video_frame_map (&frame, info, buf, GST_MAP_READ));
+
+  for (y = 0; y < GST_VIDEO_INFO_HEIGHT (info); y++) {
+    const guint8 *line = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame,
+        0) + y * GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0);
+
+    for (x = 0; x < GST_VIDEO_INFO_WIDTH (info); x++) {
+      if (GST_VIDEO_INFO_FORMAT (info) == GST_VIDEO_FORMAT_RGBA) {
+        /* limited range gray to full range RGB */
+        gint gray = (FRAME_LUMA (i) - 16) * 255 / 219;
+
+        fail_unless (ABS (line[4 * x] - gray) <= 2 &&
+            ABS (line[4 * x + 1] - gray) <= 2 &&
+            ABS (line[4 * x + 2] - gray) <= 2 && line[4 * x + 3] == 255,
+            "frame %d: pixel %d,%d is %u,%u,%u,%u", i, x, y, line[4 * x],
+            line[4 * x + 1], line[4 * x + 2], line[4 * x + 3]);
+      } else {
+        fail_unless_equals_int (line[x], FRAME_LUMA (i));
+      }
+    }
+  }
+
+  gst_video_frame_unmap (&frame);
+}
+
+static void
+push_frames (GstHarness * h, GstVideoFormat format, gint width, gint height,
+    gint first, gint last)
+{
+  gint i;
+
+  for (i = first; i < last; i++) {
+    fail_unless_equals_int (gst_harness_push (h, create_frame (format, width,
+                height, i)), GST_FLOW_OK);
+  }
+}
+
+static void
+pull_frames (GstHarness * h, GstVideoFormat format, gint width, gint height,
+    gint first, gint last)
+{
+  GstVideoInfo info;
+  GstBuffer *buf;
+  gint i;
+
+  gst_video_info_set_format (&info, format, width, height);
+
+  for (i = first; i < last; i++) {
+    buf = gst_harness_pull (h);
+    fail_unless (buf != NULL);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buf),
+        gst_util_uint64_scale_int (i * GST_SECOND, 1, 30));
+    fail_unless_equals_int (gst_buffer_get_size (buf),
+        GST_VIDEO_INFO_SIZE (&info));
+    check_frame_pixels (buf, &info, i);
+    gst_buffer_unref (buf);
+  }
+}
+
+GST_START_TEST (test_frame_threads)
+{
+  GstHarness *h;
+  GstCaps *caps;
+  GstQuery *query;
+  guint min;
+
+  h = gst_harness_new_parse ("videoconvert n-frame-threads=4");
+  gst_harness_set_sink_caps_str (h, "video/x-raw,format=RGBA");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=I420,width=64,height=48,framerate=30/1");
+
+  /* up to 3 frames are pending while the next ones are converted */
+  push_frames (h, GST_VIDEO_FORMAT_I420, 64, 48, 0, 8);
+  fail_unless_equals_int (gst_harness_buffers_received (h), 5);
+  fail_unless_equals_uint64 (gst_harness_query_latency (h),
+      gst_util_uint64_scale_int (3 * GST_SECOND, 1, 30));
+
+  /* EOS pushes the pending frames */
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  fail_unless_equals_int (gst_harness_buffers_received (h), 8);
+  pull_frames (h, GST_VIDEO_FORMAT_RGBA, 64, 48, 0, 8);
+
+  /* the pending frames hold on to input buffers too */
+  caps = gst_caps_from_string
+      ("video/x-raw,format=I420,width=64,height=48,framerate=30/1");
+  query = gst_query_new_allocation (caps, TRUE);
+  fail_unless (gst_pad_peer_query (h->srcpad, query));
+  fail_unless (gst_query_get_n_allocation_pools (query) > 0);
+  gst_query_parse_nth_allocation_pool (query, 0, NULL, NULL, &min, NULL);
+  fail_unless (min >= 3);
+  gst_query_unref (query);
+  gst_caps_unref (caps);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_frame_threads_flush)
+{
+  GstHarness *h;
+  GstSegment segment;
+
+  h = gst_harness_new_parse ("videoconvert n-frame-threads=4");
+  gst_harness_set_sink_caps_str (h, "video/x-raw,format=RGBA");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=I420,width=64,height=48,framerate=30/1");
+
+  push_frames (h, GST_VIDEO_FORMAT_I420, 64, 48, 0, 2);
+  fail_unless_equals_int (gst_harness_buffers_received (h), 0);
+
+  /* flushing drops the pending frames */
+  fail_unless (gst_harness_push_event (h, gst_event_new_flush_start ()));
+  fail_unless (gst_harness_push_event (h, gst_event_new_flush_stop (TRUE)));
+  fail_unless_equals_int (gst_harness_buffers_received (h), 0);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_harness_push_event (h, gst_event_new_segment (&segment)));
+  push_frames (h, GST_VIDEO_FORMAT_I420, 64, 48, 10, 14);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  fail_unless_equals_int (gst_harness_buffers_received (h), 4);
+  pull_frames (h, GST_VIDEO_FORMAT_RGBA, 64, 48, 10, 14);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_frame_threads_reconfigure)
+{
+  GstHarness *h;
+
+  h = gst_harness_new_parse ("videoconvert n-frame-threads=4");
+  gst_harness_set_sink_caps_str (h, "video/x-raw,format=RGBA");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=I420,width=64,height=48,framerate=30/1");
+
+  push_frames (h, GST_VIDEO_FORMAT_I420, 64, 48, 0, 3);
+  fail_unless_equals_int (gst_harness_buffers_received (h), 0);
+
+  /* new caps push the pending frames with the old caps */
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,format=I420,width=32,height=24,framerate=30/1");
+  fail_unless_equals_int (gst_harness_buffers_received (h), 3);
+
+  push_frames (h, GST_VIDEO_FORMAT_I420, 32, 24, 3, 6);
+  fail_unless_equals_int (gst_harness_buffers_received (h), 3);
+
+  /* and so does a reconfiguration from downstream, before switching to
+   * passthrough here */
+  gst_harness_set_sink_caps_str (h, "video/x-raw,format=I420");
+  push_frames (h, GST_VIDEO_FORMAT_I420, 32, 24, 6, 7);
+  fail_unless_equals_int (gst_harness_buffers_received (h), 7);
+
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  pull_frames (h, GST_VIDEO_FORMAT_RGBA, 64, 48, 0, 3);
+  pull_frames (h, GST_VIDEO_FORMAT_RGBA, 32, 24, 3, 6);
+  pull_frames (h, GST_VIDEO_FORMAT_I420, 32, 24, 6, 7);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 videoconvert_suite (void)
 {
@@ -160,6 +358,9 @@ videoconvert_suite (void)
 
   tcase_add_test (tc_chain, test_template_formats);
   tcase_add_test (tc_chain, test_negotiate_alternate);
+  tcase_add_test (tc_chain, test_frame_threads);
+  tcase_add_test (tc_chain, test_frame_threads_flush);
+  tcase_add_test (tc_chain, test_frame_threads_reconfigure);
 
   return s;
 }
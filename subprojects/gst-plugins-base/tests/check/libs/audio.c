@@ -29,6 +29,7 @@
 
 #include <gst/audio/audio.h>
 #include <string.h>
+#include <math.h>
 
 static GstBuffer *
 make_buffer (guint8 ** _data)
@@ -1678,6 +1679,367 @@ GST_START_TEST (test_audio_meta_serialize_65_chans)
 
 GST_END_TEST;
 
+#define RESAMPLER_IN_FRAMES 4800
+
+static gpointer
+resample_with_simd (GstAudioFormat format, const gchar * simd,
+    GstAudioResamplerFilterMode mode,
+    GstAudioResamplerFilterInterpolation interpolation, gconstpointer in,
+    gsize * out_frames)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  gpointer out, in_planes[1], out_planes[1];
+  gint bps = GST_AUDIO_FORMAT_INFO_WIDTH (gst_audio_format_get_info (format))
+      / 8;
+
+  options = gst_structure_new_empty ("resampler");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, 48000, 44100, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_SIMD, G_TYPE_STRING, simd,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      mode, GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, interpolation, NULL);
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, 1, 48000, 44100, options);
+  fail_unless (resampler != NULL);
+  gst_structure_free (options);
+
+  *out_frames = gst_audio_resampler_get_out_frames (resampler,
+      RESAMPLER_IN_FRAMES);
+  out = g_malloc0 (*out_frames * bps);
+
+  in_planes[0] = (gpointer) in;
+  out_planes[0] = out;
+  gst_audio_resampler_resample (resampler, in_planes, RESAMPLER_IN_FRAMES,
+      out_planes, *out_frames);
+  gst_audio_resampler_free (resampler);
+
+  return out;
+}
+
+GST_START_TEST (test_audio_resampler_simd)
+{
+  /* only the levels whose kernels were built, the others would fall back
+   * to a lower level */
+  const gchar *levels[] = { "none",
+#ifdef HAVE_AUDIO_RESAMPLER_SSE
+    "sse",
+#endif
+#ifdef HAVE_AUDIO_RESAMPLER_SSE2
+    "sse2",
+#endif
+#ifdef HAVE_AUDIO_RESAMPLER_SSE41
+    "sse41",
+#endif
+#ifdef HAVE_AUDIO_RESAMPLER_AVX2
+    "avx2",
+#endif
+#ifdef HAVE_AUDIO_RESAMPLER_AVX512
+    "avx512",
+#endif
+#ifdef HAVE_ARM_NEON
+    "neon",
+#endif
+  };
+  const GstAudioFormat formats[] = { GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32,
+    GST_AUDIO_FORMAT_F32
+  };
+  const struct
+  {
+    GstAudioResamplerFilterMode mode;
+    GstAudioResamplerFilterInterpolation interpolation;
+  } filters[] = {
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE},
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR},
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC},
+  };
+  gint16 in_s16[RESAMPLER_IN_FRAMES];
+  gint32 in_s32[RESAMPLER_IN_FRAMES];
+  gfloat in_f32[RESAMPLER_IN_FRAMES];
+  gboolean exact = FALSE;
+  gint i, f, m, l;
+
+  for (i = 0; i < RESAMPLER_IN_FRAMES; i++) {
+    gdouble v = 0.5 * sin (2.0 * G_PI * 997.0 * i / 48000.0) +
+        0.25 * sin (2.0 * G_PI * 15011.0 * i / 48000.0);
+
+    in_s16[i] = v * G_MAXINT16;
+    in_s32[i] = v * G_MAXINT32;
+    in_f32[i] = v;
+  }
+
+  /* The AVX kernels only vectorize the accumulation of the integer inner
+   * products and must produce the same samples as the C code. The older
+   * SSE kernels round partial sums and are only compared with a
+   * tolerance. */
+#if defined (HAVE_BUILTIN_CPU_SUPPORTS) && defined (HAVE_IMMINTRIN_H) && \
+    (defined (__i386__) || defined (__x86_64__))
+  __builtin_cpu_init ();
+  exact = __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+#endif
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    gconstpointer in;
+
+    switch (formats[f]) {
+      case GST_AUDIO_FORMAT_S16:
+        in = in_s16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        in = in_s32;
+        break;
+      default:
+        in = in_f32;
+        break;
+    }
+
+    for (m = 0; m < G_N_ELEMENTS (filters); m++) {
+      gpointer ref;
+      gsize ref_frames;
+
+      ref = resample_with_simd (formats[f], "none", filters[m].mode,
+          filters[m].interpolation, in, &ref_frames);
+      fail_unless (ref_frames > 0);
+
+      for (l = 0; l < G_N_ELEMENTS (levels); l++) {
+        gpointer out;
+        gsize out_frames;
+        gboolean level_exact = !strcmp (levels[l], "none") || (exact
+            && (!strcmp (levels[l], "avx2") || !strcmp (levels[l], "avx512")));
+
+        GST_DEBUG ("format %s, filter %d, simd %s",
+            gst_audio_format_to_string (formats[f]), m, levels[l]);
+
+        out = resample_with_simd (formats[f], levels[l], filters[m].mode,
+            filters[m].interpolation, in, &out_frames);
+        fail_unless_equals_int (out_frames, ref_frames);
+
+        for (i = 0; i < out_frames; i++) {
+          switch (formats[f]) {
+            case GST_AUDIO_FORMAT_S16:{
+              gint16 a = ((gint16 *) ref)[i], b = ((gint16 *) out)[i];
+
+              if (level_exact)
+                fail_unless_equals_int (a, b);
+              else
+                fail_unless (ABS (a - b) <= 8, "%d: %d != %d", i, a, b);
+              break;
+            }
+            case GST_AUDIO_FORMAT_S32:{
+              gint64 a = ((gint32 *) ref)[i], b = ((gint32 *) out)[i];
+
+              if (level_exact)
+                fail_unless_equals_int64 (a, b);
+              else
+                fail_unless (ABS (a - b) <= 8,
+                    "%d: %" G_GINT64_FORMAT " != %" G_GINT64_FORMAT, i, a, b);
+              break;
+            }
+            default:{
+              gfloat a = ((gfloat *) ref)[i], b = ((gfloat *) out)[i];
+
+              fail_unless (fabsf (a - b) <= 1e-5, "%d: %f != %f", i, a, b);
+              break;
+            }
+          }
+        }
+        g_free (out);
+      }
+      g_free (ref);
+    }
+  }
+}
+
+GST_END_TEST;
+
+/* output 0 takes input 5, output 1 takes half of input 2 and output 2 is
+ * silent */
+static gfloat **
+make_route_matrix (void)
+{
+  gfloat **matrix;
+  gint c;
+
+  matrix = g_new (gfloat *, 8);
+  for (c = 0; c < 8; c++)
+    matrix[c] = g_new0 (gfloat, 3);
+  matrix[5][0] = 1.0f;
+  matrix[2][1] = 0.5f;
+
+  return matrix;
+}
+
+/* several chunks of the in-place mixing, and a partial one at the end */
+#define ROUTE_FRAMES 4000
+
+GST_START_TEST (test_audio_channel_mixer_route)
+{
+  GstAudioChannelMixer *mix;
+  gint16 *in_s16, *out_s16;
+  gfloat *in_f32[8], *out_f32[3];
+  gpointer in[8], out[3];
+  gint i, c;
+
+  in_s16 = g_new (gint16, 8 * ROUTE_FRAMES);
+  out_s16 = g_new (gint16, 3 * ROUTE_FRAMES);
+  for (c = 0; c < 8; c++)
+    in_f32[c] = g_new (gfloat, ROUTE_FRAMES);
+  for (c = 0; c < 3; c++)
+    out_f32[c] = g_new (gfloat, ROUTE_FRAMES);
+
+  for (i = 0; i < ROUTE_FRAMES; i++) {
+    for (c = 0; c < 8; c++) {
+      in_s16[i * 8 + c] = (c + 1) * 1000 + i;
+      in_f32[c][i] = (c + 1) / 10.0f + i / 10000.0f;
+    }
+  }
+
+  mix = gst_audio_channel_mixer_new_with_matrix (0, GST_AUDIO_FORMAT_S16, 8,
+      3, make_route_matrix ());
+  in[0] = in_s16;
+  out[0] = out_s16;
+  gst_audio_channel_mixer_samples (mix, in, out, ROUTE_FRAMES);
+  for (i = 0; i < ROUTE_FRAMES; i++) {
+    fail_unless_equals_int (out_s16[i * 3 + 0], 6000 + i);
+    fail_unless_equals_int (out_s16[i * 3 + 1], (3000 + i + 1) / 2);
+    fail_unless_equals_int (out_s16[i * 3 + 2], 0);
+  }
+
+  /* in place */
+  out[0] = in_s16;
+  gst_audio_channel_mixer_samples (mix, in, out, ROUTE_FRAMES);
+  fail_unless (memcmp (in_s16, out_s16, 3 * ROUTE_FRAMES * sizeof (gint16))
+      == 0);
+  gst_audio_channel_mixer_free (mix);
+
+  mix = gst_audio_channel_mixer_new_with_matrix
+      (GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN |
+      GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT, GST_AUDIO_FORMAT_F32,
+      8, 3, make_route_matrix ());
+  for (c = 0; c < 8; c++)
+    in[c] = in_f32[c];
+  for (c = 0; c < 3; c++)
+    out[c] = out_f32[c];
+  gst_audio_channel_mixer_samples (mix, in, out, ROUTE_FRAMES);
+  for (i = 0; i < ROUTE_FRAMES; i++) {
+    fail_unless_equals_float (out_f32[0][i], in_f32[5][i]);
+    fail_unless_equals_float (out_f32[1][i], in_f32[2][i] * 0.5f);
+    fail_unless_equals_float (out_f32[2][i], 0.0f);
+  }
+
+  /* in place, the output planes are the first input planes */
+  for (c = 0; c < 3; c++)
+    out[c] = in_f32[c];
+  gst_audio_channel_mixer_samples (mix, in, out, ROUTE_FRAMES);
+  for (c = 0; c < 3; c++) {
+    fail_unless (memcmp (in_f32[c], out_f32[c],
+            ROUTE_FRAMES * sizeof (gfloat)) == 0);
+  }
+  gst_audio_channel_mixer_free (mix);
+
+  g_free (in_s16);
+  g_free (out_s16);
+  for (c = 0; c < 8; c++)
+    g_free (in_f32[c]);
+  for (c = 0; c < 3; c++)
+    g_free (out_f32[c]);
+}
+
+GST_END_TEST;
+
+#define CONVERTER_IN_FRAMES 4800
+
+static gpointer
+convert_with_threads (guint threads, const GstAudioInfo * in_info,
+    const GstAudioInfo * out_info, gconstpointer in, gsize * out_frames)
+{
+  GstAudioConverter *convert;
+  GstStructure *config;
+  gpointer out, in_planes[1], out_planes[1];
+  gsize frames;
+  gint i;
+
+  config = gst_structure_new ("converter",
+      GST_AUDIO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads, NULL);
+  convert = gst_audio_converter_new (GST_AUDIO_CONVERTER_FLAG_NONE,
+      (GstAudioInfo *) in_info, (GstAudioInfo *) out_info, config);
+  fail_unless (convert != NULL);
+
+  frames = gst_audio_converter_get_out_frames (convert, CONVERTER_IN_FRAMES);
+  out = g_malloc0 ((2 * frames + 1) * GST_AUDIO_INFO_BPF (out_info));
+
+  /* convert twice to also check the state kept between calls */
+  *out_frames = 0;
+  for (i = 0; i < 2; i++) {
+    in_planes[0] = (gpointer) in;
+    out_planes[0] =
+        (guint8 *) out + *out_frames * GST_AUDIO_INFO_BPF (out_info);
+    frames = gst_audio_converter_get_out_frames (convert, CONVERTER_IN_FRAMES);
+    fail_unless (gst_audio_converter_samples (convert,
+            GST_AUDIO_CONVERTER_FLAG_NONE, in_planes, CONVERTER_IN_FRAMES,
+            out_planes, frames));
+    *out_frames += frames;
+  }
+  gst_audio_converter_free (convert);
+
+  return out;
+}
+
+GST_START_TEST (test_audio_converter_threads)
+{
+  static const GstAudioChannelPosition pos[] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_CENTER,
+    GST_AUDIO_CHANNEL_POSITION_LFE1,
+    GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_SIDE_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_SIDE_RIGHT,
+  };
+  const gint out_channels[] = { 2, 8 };
+  GstAudioInfo in_info, out_info;
+  gfloat *in;
+  gint i, c, o;
+
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_F32, 48000, 8, pos);
+
+  in = g_new (gfloat, CONVERTER_IN_FRAMES * 8);
+  for (i = 0; i < CONVERTER_IN_FRAMES; i++)
+    for (c = 0; c < 8; c++)
+      in[i * 8 + c] =
+          0.5 * sin (2.0 * G_PI * (500.0 + 100.0 * c) * i / 48000.0);
+
+  /* mixing to stereo or resampling 8 channels, followed by quantization to
+   * 16 bits must not change when split over threads */
+  for (o = 0; o < G_N_ELEMENTS (out_channels); o++) {
+    gpointer ref, out;
+    gsize ref_frames, out_frames;
+
+    gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_S16,
+        out_channels[o] == 2 ? 48000 : 44100, out_channels[o], pos);
+
+    ref = convert_with_threads (1, &in_info, &out_info, in, &ref_frames);
+    out = convert_with_threads (4, &in_info, &out_info, in, &out_frames);
+
+    fail_unless_equals_int (out_frames, ref_frames);
+    fail_unless (memcmp (ref, out,
+            ref_frames * GST_AUDIO_INFO_BPF (&out_info)) == 0);
+
+    g_free (ref);
+    g_free (out);
+  }
+  g_free (in);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1718,6 +2080,9 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
   tcase_add_test (tc_chain, test_audio_meta_serialize);
   tcase_add_test (tc_chain, test_audio_meta_serialize_65_chans);
+  tcase_add_test (tc_chain, test_audio_resampler_simd);
+  tcase_add_test (tc_chain, test_audio_channel_mixer_route);
+  tcase_add_test (tc_chain, test_audio_converter_threads);
 
   return s;
 }
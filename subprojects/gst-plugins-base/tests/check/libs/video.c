@@ -2793,6 +2793,93 @@ GST_START_TEST (test_video_convert)
 
 GST_END_TEST;
 
+static void
+check_video_convert_overlay (GstVideoFormat out_format, gint dest_y,
+    gint dest_height, gint render_y)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe, refframe;
+  GstBuffer *inbuffer, *outbuffer, *refbuffer, *pixels;
+  GstVideoOverlayComposition *comp;
+  GstVideoOverlayRectangle *rect;
+  GstVideoConverter *convert;
+  GstMapInfo map;
+  guint i;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_I420, 320,
+          240));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = i * 7;
+  gst_buffer_unmap (inbuffer, &map);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  fail_unless (gst_video_info_set_format (&outinfo, out_format, 160, 120));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  refbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+  gst_video_frame_map (&refframe, &outinfo, refbuffer, GST_MAP_WRITE);
+
+  /* semi-transparent overlay, partially left of the video and scaled */
+  pixels = gst_buffer_new_and_alloc (40 * 30 * 4);
+  gst_buffer_map (pixels, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = i * 13;
+  gst_buffer_unmap (pixels, &map);
+  gst_buffer_add_video_meta (pixels, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, 40, 30);
+  rect = gst_video_overlay_rectangle_new_raw (pixels, -10, render_y, 60, 45,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  comp = gst_video_overlay_composition_new (rect);
+  gst_video_overlay_rectangle_unref (rect);
+  gst_buffer_unref (pixels);
+
+  /* convert, then blend */
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DEST_Y, G_TYPE_INT, dest_y,
+          GST_VIDEO_CONVERTER_OPT_DEST_HEIGHT, G_TYPE_INT, dest_height, NULL));
+  gst_video_converter_frame (convert, &inframe, &refframe);
+  gst_video_converter_free (convert);
+  fail_unless (gst_video_overlay_composition_blend (comp, &refframe));
+
+  /* blend as part of the conversion */
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DEST_Y, G_TYPE_INT, dest_y,
+          GST_VIDEO_CONVERTER_OPT_DEST_HEIGHT, G_TYPE_INT, dest_height,
+          GST_VIDEO_CONVERTER_OPT_OVERLAY_COMPOSITION,
+          GST_TYPE_VIDEO_OVERLAY_COMPOSITION, comp, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&refframe);
+
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (refbuffer, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (outbuffer, &map);
+
+  gst_video_overlay_composition_unref (comp);
+  gst_buffer_unref (refbuffer);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_START_TEST (test_video_convert_overlay)
+{
+  /* blended in the line pass */
+  check_video_convert_overlay (GST_VIDEO_FORMAT_BGRx, 0, 120, 20);
+  check_video_convert_overlay (GST_VIDEO_FORMAT_I420, 0, 120, 20);
+  check_video_convert_overlay (GST_VIDEO_FORMAT_AYUV64, 0, 120, 20);
+  /* overlay on the border lines, blended after conversion */
+  check_video_convert_overlay (GST_VIDEO_FORMAT_BGRx, 30, 60, 10);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_convert_with_config_update)
 {
   GstVideoInfo ininfo, outinfo;
@@ -4370,6 +4457,7 @@ video_suite (void)
   tcase_add_test (tc_chain, test_info_dma_drm);
   tcase_add_test (tc_chain, test_video_meta_serialize);
   tcase_add_test (tc_chain, test_video_convert_with_config_update);
+  tcase_add_test (tc_chain, test_video_convert_overlay);
 
   return s;
 }
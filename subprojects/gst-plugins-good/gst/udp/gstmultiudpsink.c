@@ -28,6 +28,12 @@
  * multiudpsink is a network sink that sends UDP packets to multiple
  * clients.
  * It can be combined with rtp payload encoders to implement RTP streaming.
+ *
+ * When the #GstMultiUDPSink:gso property is enabled, consecutive packets of
+ * the same size going to the same client are handed to the kernel as a single
+ * send which is then split into the individual packets by UDP generic
+ * segmentation offload (Linux only). This considerably lowers the CPU usage
+ * when sending bursts of packets, e.g. buffer lists from RTP payloaders.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -44,6 +50,10 @@
 
 #include <gio/gnetworking.h>
 
+#ifndef G_PLATFORM_WIN32
+#include <netinet/udp.h>
+#endif
+
 #include "gst/net/net.h"
 #include "gst/glib-compat-private.h"
 
@@ -52,6 +62,91 @@ GST_DEBUG_CATEGORY_STATIC (multiudpsink_debug);
 
 #define UDP_MAX_SIZE 65507
 
+/* maximum number of segments the kernel accepts in a single GSO send */
+#define UDP_MAX_SEGMENTS 64
+
+#ifdef UDP_SEGMENT
+GType gst_udp_segment_message_get_type (void);
+
+#define GST_TYPE_UDP_SEGMENT_MESSAGE         (gst_udp_segment_message_get_type ())
+#define GST_UDP_SEGMENT_MESSAGE(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_UDP_SEGMENT_MESSAGE, GstUDPSegmentMessage))
+
+typedef struct _GstUDPSegmentMessage GstUDPSegmentMessage;
+typedef struct _GstUDPSegmentMessageClass GstUDPSegmentMessageClass;
+
+struct _GstUDPSegmentMessageClass
+{
+  GSocketControlMessageClass parent_class;
+
+};
+
+/* Tells the kernel to split the datagram into segments of gso_size bytes */
+struct _GstUDPSegmentMessage
+{
+  GSocketControlMessage parent;
+
+  guint16 gso_size;
+};
+
+G_DEFINE_TYPE (GstUDPSegmentMessage, gst_udp_segment_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_segment_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (guint16);
+}
+
+static int
+gst_udp_segment_message_get_level (GSocketControlMessage * message)
+{
+  return SOL_UDP;
+}
+
+static int
+gst_udp_segment_message_get_msg_type (GSocketControlMessage * message)
+{
+  return UDP_SEGMENT;
+}
+
+static void
+gst_udp_segment_message_serialize (GSocketControlMessage * message,
+    gpointer data)
+{
+  GstUDPSegmentMessage *msg = GST_UDP_SEGMENT_MESSAGE (message);
+
+  memcpy (data, &msg->gso_size, sizeof (guint16));
+}
+
+static void
+gst_udp_segment_message_init (GstUDPSegmentMessage * message)
+{
+}
+
+static void
+gst_udp_segment_message_class_init (GstUDPSegmentMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_udp_segment_message_get_size;
+  scm_class->get_level = gst_udp_segment_message_get_level;
+  scm_class->get_type = gst_udp_segment_message_get_msg_type;
+  scm_class->serialize = gst_udp_segment_message_serialize;
+}
+
+static GSocketControlMessage *
+gst_udp_segment_message_new (guint16 gso_size)
+{
+  GstUDPSegmentMessage *msg;
+
+  msg = g_object_new (GST_TYPE_UDP_SEGMENT_MESSAGE, NULL);
+  msg->gso_size = gso_size;
+
+  return G_SOCKET_CONTROL_MESSAGE (msg);
+}
+#endif
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -92,6 +187,7 @@ enum
 #define DEFAULT_BUFFER_SIZE        0
 #define DEFAULT_BIND_ADDRESS       NULL
 #define DEFAULT_BIND_PORT          0
+#define DEFAULT_GSO                FALSE
 
 enum
 {
@@ -114,7 +210,10 @@ enum
   PROP_SEND_DUPLICATES,
   PROP_BUFFER_SIZE,
   PROP_BIND_ADDRESS,
-  PROP_BIND_PORT
+  PROP_BIND_PORT,
+  PROP_GSO,
+  PROP_GSO_SENDS,
+  PROP_GSO_SEGMENTS
 };
 
 static void gst_multiudpsink_finalize (GObject * object);
@@ -351,6 +450,51 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
           "Port to bind the socket to", 0, G_MAXUINT16,
           DEFAULT_BIND_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiUDPSink:gso:
+   *
+   * Coalesce consecutive packets of the same size going to the same client
+   * into a single send and let the kernel split them again with UDP generic
+   * segmentation offload (UDP_SEGMENT). Only the last packet of such a
+   * group may be smaller than the others.
+   *
+   * If the kernel or the network device does not support this, packets are
+   * sent one by one again. This is only supported on Linux.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_GSO,
+      g_param_spec_boolean ("gso", "GSO",
+          "Coalesce equally sized packets to the same client into a single "
+          "send using UDP generic segmentation offload", DEFAULT_GSO,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+
+  /**
+   * GstMultiUDPSink:gso-sends:
+   *
+   * Number of sends that coalesced multiple packets with UDP generic
+   * segmentation offload.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_GSO_SENDS,
+      g_param_spec_uint64 ("gso-sends", "GSO sends",
+          "Number of sends that coalesced multiple packets", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiUDPSink:gso-segments:
+   *
+   * Total number of packets that were sent as part of a coalesced send.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_GSO_SEGMENTS,
+      g_param_spec_uint64 ("gso-segments", "GSO segments",
+          "Total number of packets sent as part of a coalesced send", 0,
+          G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
 
   gst_element_class_set_static_metadata (gstelement_class, "UDP packet sender",
@@ -419,6 +563,7 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   sink->qos_dscp = DEFAULT_QOS_DSCP;
   sink->send_duplicates = DEFAULT_SEND_DUPLICATES;
   sink->multi_iface = g_strdup (DEFAULT_MULTICAST_IFACE);
+  sink->gso = DEFAULT_GSO;
 
   gst_multiudpsink_create_cancellable (sink);
 
@@ -557,6 +702,12 @@ gst_multiudpsink_finalize (GObject * object)
   sink->maps = NULL;
   g_free (sink->messages);
   sink->messages = NULL;
+  g_free (sink->gso_messages);
+  sink->gso_messages = NULL;
+  g_free (sink->gso_first);
+  sink->gso_first = NULL;
+  g_free (sink->gso_controls);
+  sink->gso_controls = NULL;
 
   g_free (sink->bind_address);
   sink->bind_address = NULL;
@@ -714,6 +865,199 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
   return GST_FLOW_OK;
 }
 
+#ifdef UDP_SEGMENT
+/* Coalesces consecutive messages to the same address into single messages
+ * for UDP generic segmentation offload. All coalesced messages must have the
+ * same size, except for the last one which may be smaller. The messages are
+ * only merged if their vectors are contiguous, which is the case for the
+ * messages of one client in gst_multiudpsink_render_buffers().
+ * Returns the number of resulting messages in sink->gso_messages, with
+ * sink->gso_first[i] being the index of the first original message that is
+ * part of gso_messages[i] */
+static guint
+gst_multiudpsink_coalesce_messages (GstMultiUDPSink * sink,
+    GstOutputMessage * messages, guint num_messages)
+{
+  GSocketControlMessage *last_control = NULL;
+  guint i, n;
+
+  if (sink->n_gso_messages < num_messages) {
+    sink->n_gso_messages = GST_ROUND_UP_16 (num_messages);
+    g_free (sink->gso_messages);
+    sink->gso_messages = g_new (GstOutputMessage, sink->n_gso_messages);
+    g_free (sink->gso_first);
+    sink->gso_first = g_new (guint, sink->n_gso_messages + 1);
+    g_free (sink->gso_controls);
+    sink->gso_controls = g_new (GSocketControlMessage *, sink->n_gso_messages);
+  }
+
+  for (i = 0, n = 0; i < num_messages; n++) {
+    GstOutputMessage *first = &messages[i];
+    GstOutputMessage *out = &sink->gso_messages[n];
+    gsize segment_size, total_size;
+    guint num_vectors, k;
+
+    segment_size = total_size = gst_udp_calc_message_size (first);
+    num_vectors = first->num_vectors;
+
+    for (k = i + 1; segment_size > 0 && k < num_messages
+        && k - i < UDP_MAX_SEGMENTS; k++) {
+      GstOutputMessage *msg = &messages[k];
+      gsize size;
+
+      if (msg->address != first->address
+          || msg->vectors != first->vectors + num_vectors)
+        break;
+
+      size = gst_udp_calc_message_size (msg);
+      if (size == 0 || size > segment_size || total_size + size > UDP_MAX_SIZE)
+        break;
+
+      total_size += size;
+      num_vectors += msg->num_vectors;
+
+      /* only the last segment can be smaller */
+      if (size < segment_size) {
+        k++;
+        break;
+      }
+    }
+
+    *out = *first;
+    out->num_vectors = num_vectors;
+    out->bytes_sent = 0;
+    sink->gso_first[n] = i;
+
+    if (k - i > 1) {
+      GstUDPSegmentMessage *last = (GstUDPSegmentMessage *) last_control;
+
+      if (last == NULL || last->gso_size != segment_size)
+        last_control = gst_udp_segment_message_new (segment_size);
+      else
+        g_object_ref (last_control);
+
+      sink->gso_controls[n] = last_control;
+      out->control_messages = &sink->gso_controls[n];
+      out->num_control_messages = 1;
+    } else {
+      sink->gso_controls[n] = NULL;
+    }
+
+    i = k;
+  }
+  sink->gso_first[n] = num_messages;
+
+  return n;
+}
+
+/* Errors that indicate that the kernel or the device can't do UDP GSO for
+ * the given messages at all, in which case we stop trying */
+static gboolean
+gst_multiudpsink_is_gso_error (GError * err)
+{
+  return g_error_matches (err, G_IO_ERROR, G_IO_ERROR_FAILED)
+      || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)
+      || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED)
+      || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE);
+}
+#endif
+
+/* Like gst_multiudpsink_send_messages() but coalesces messages with UDP
+ * generic segmentation offload if enabled. Sending falls back to one message
+ * per packet if the kernel refuses coalesced sends. */
+static GstFlowReturn
+gst_multiudpsink_send_messages_coalesced (GstMultiUDPSink * sink,
+    GSocket * socket, GstOutputMessage * messages, guint num_messages)
+{
+#ifdef UDP_SEGMENT
+  GstFlowReturn flow_ret = GST_FLOW_OK;
+  GstOutputMessage *gso_msgs;
+  guint num_gso_msgs, i, j, k;
+
+  if (!sink->gso || !sink->gso_supported || num_messages < 2)
+    goto no_gso;
+
+  num_gso_msgs =
+      gst_multiudpsink_coalesce_messages (sink, messages, num_messages);
+  if (num_gso_msgs == num_messages)
+    goto no_gso;
+
+  GST_LOG_OBJECT (sink, "coalesced %u messages into %u", num_messages,
+      num_gso_msgs);
+
+  gso_msgs = sink->gso_messages;
+
+  i = 0;
+  while (i < num_gso_msgs) {
+    GError *err = NULL;
+    gint ret;
+
+    ret = g_socket_send_messages (socket, gso_msgs + i, num_gso_msgs - i, 0,
+        sink->cancellable, &err);
+
+    if (G_UNLIKELY (ret < 0)) {
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_clear_error (&err);
+
+        flow_ret = gst_base_sink_wait_preroll (GST_BASE_SINK (sink));
+
+        if (flow_ret == GST_FLOW_OK)
+          continue;
+
+        break;
+      }
+
+      if (sink->gso_controls[i] != NULL && gst_multiudpsink_is_gso_error (err)) {
+        GST_WARNING_OBJECT (sink, "Disabling UDP GSO after failed send: %s",
+            err->message);
+        sink->gso_supported = FALSE;
+      }
+      g_clear_error (&err);
+
+      /* send everything that is left one by one, which also takes care of
+       * any error handling */
+      flow_ret = gst_multiudpsink_send_messages (sink, socket,
+          messages + sink->gso_first[i], num_messages - sink->gso_first[i]);
+      break;
+    }
+
+    i += ret;
+  }
+
+  /* update the original messages so the stats are correct */
+  for (j = 0; j < i; j++) {
+    GstOutputMessage *msg = &gso_msgs[j];
+    gsize total_size = 0;
+
+    for (k = sink->gso_first[j]; k < sink->gso_first[j + 1]; k++) {
+      messages[k].bytes_sent = gst_udp_calc_message_size (&messages[k]);
+      total_size += messages[k].bytes_sent;
+    }
+
+    if (msg->bytes_sent != total_size) {
+      for (k = sink->gso_first[j]; k < sink->gso_first[j + 1]; k++)
+        messages[k].bytes_sent = 0;
+      continue;
+    }
+
+    if (sink->gso_controls[j] != NULL) {
+      sink->gso_sends++;
+      sink->gso_segments += sink->gso_first[j + 1] - sink->gso_first[j];
+    }
+  }
+
+  for (j = 0; j < num_gso_msgs; j++) {
+    if (sink->gso_controls[j])
+      g_object_unref (sink->gso_controls[j]);
+  }
+
+  return flow_ret;
+
+no_gso:
+#endif
+  return gst_multiudpsink_send_messages (sink, socket, messages, num_messages);
+}
+
 static GstFlowReturn
 gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     guint num_buffers, guint8 * mem_nums, guint total_mem_num)
@@ -812,21 +1156,21 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
 
   /* no IPv4 socket? Send it all from the IPv6 socket then.. */
   if (sink->used_socket == NULL) {
-    flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
-        msgs, num_msgs);
+    flow_ret = gst_multiudpsink_send_messages_coalesced (sink,
+        sink->used_socket_v6, msgs, num_msgs);
   } else {
     guint num_msgs_v4 = num_buffers * num_addr_v4;
     guint num_msgs_v6 = num_buffers * num_addr_v6;
 
     /* our client list is sorted with IPv4 clients first and IPv6 ones last */
-    flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket,
-        msgs, num_msgs_v4);
+    flow_ret = gst_multiudpsink_send_messages_coalesced (sink,
+        sink->used_socket, msgs, num_msgs_v4);
 
     if (flow_ret != GST_FLOW_OK)
       goto cancelled;
 
-    flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
-        msgs + num_msgs_v4, num_msgs_v6);
+    flow_ret = gst_multiudpsink_send_messages_coalesced (sink,
+        sink->used_socket_v6, msgs + num_msgs_v4, num_msgs_v6);
   }
 
   if (flow_ret != GST_FLOW_OK)
@@ -1094,6 +1438,9 @@ gst_multiudpsink_set_property (GObject * object, guint prop_id,
     case PROP_BIND_PORT:
       udpsink->bind_port = g_value_get_int (value);
       break;
+    case PROP_GSO:
+      udpsink->gso = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1167,6 +1514,15 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BIND_PORT:
       g_value_set_int (value, udpsink->bind_port);
       break;
+    case PROP_GSO:
+      g_value_set_boolean (value, udpsink->gso);
+      break;
+    case PROP_GSO_SENDS:
+      g_value_set_uint64 (value, udpsink->gso_sends);
+      break;
+    case PROP_GSO_SEGMENTS:
+      g_value_set_uint64 (value, udpsink->gso_segments);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1437,6 +1793,23 @@ gst_multiudpsink_start (GstBaseSink * bsink)
   sink->bytes_to_serve = 0;
   sink->bytes_served = 0;
 
+  /* check if the kernel knows about UDP GSO at all */
+  sink->gso_supported = FALSE;
+  sink->gso_sends = 0;
+  sink->gso_segments = 0;
+#ifdef UDP_SEGMENT
+  {
+    GSocket *socket = sink->used_socket ? sink->used_socket :
+        sink->used_socket_v6;
+    gint gso_size;
+
+    if (g_socket_get_option (socket, SOL_UDP, UDP_SEGMENT, &gso_size, NULL))
+      sink->gso_supported = TRUE;
+    else
+      GST_INFO_OBJECT (sink, "UDP GSO not supported by the kernel");
+  }
+#endif
+
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket);
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket_v6);
 
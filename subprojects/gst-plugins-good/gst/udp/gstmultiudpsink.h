@@ -82,6 +82,12 @@ struct _GstMultiUDPSink {
   GstOutputMessage *messages;
   guint             n_messages;
 
+  /* scratch space for coalescing messages with UDP GSO */
+  GstOutputMessage *gso_messages;
+  guint             n_gso_messages;
+  guint            *gso_first;
+  GSocketControlMessage **gso_controls;
+
   /* properties */
   guint64        bytes_to_serve;
   guint64        bytes_served;
@@ -102,6 +108,11 @@ struct _GstMultiUDPSink {
   gint           buffer_size;
   gchar         *bind_address;
   gint           bind_port;
+
+  gboolean       gso;
+  gboolean       gso_supported;
+  guint64        gso_sends;
+  guint64        gso_segments;
 };
 
 struct _GstMultiUDPSinkClass {
@@ -113,6 +113,7 @@
 #include <sys/socket.h>
 #endif
 
+#include <errno.h>
 #include <string.h>
 #include "gstudpelements.h"
 #include "gstudpsrc.h"
@@ -572,6 +573,7 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
 #define UDP_DEFAULT_MTU                (1492)
 #define UDP_DEFAULT_MULTICAST_SOURCE   NULL
+#define UDP_DEFAULT_BATCH_SIZE         1
 
 enum
 {
@@ -596,6 +598,7 @@ enum
   PROP_MTU,
   PROP_SOCKET_TIMESTAMP,
   PROP_MULTICAST_SOURCE,
+  PROP_BATCH_SIZE,
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -604,10 +607,16 @@ static GstCaps *gst_udpsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_udpsrc_close (GstUDPSrc * src);
 static gboolean gst_udpsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_udpsrc_unlock_stop (GstBaseSrc * bsrc);
+static GstFlowReturn gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset,
+    guint length, GstBuffer ** buf);
 static GstFlowReturn gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf);
 
 static void gst_udpsrc_finalize (GObject * object);
 
+#ifdef HAVE_RECVMMSG
+static void gst_udpsrc_batch_free (GstUDPSrcBatch * batch);
+#endif
+
 static void gst_udpsrc_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_udpsrc_get_property (GObject * object, guint prop_id,
@@ -798,6 +807,30 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           UDP_DEFAULT_MULTICAST_SOURCE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstUDPSrc:batch-size:
+   *
+   * Maximum number of packets to receive with a single system call. When
+   * bigger than 1, all packets that are available after a wakeup are read
+   * at once with recvmmsg() and pushed downstream as a #GstBufferList,
+   * each buffer keeping its own sender address meta.
+   *
+   * Every packet slot keeps an additional buffer for packets bigger than
+   * the #GstUDPSrc:mtu around, so large values increase memory usage.
+   *
+   * Only supported on systems providing recvmmsg(), elsewhere packets are
+   * always received one by one.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch Size",
+          "Maximum number of packets to receive with a single system call "
+          "and push downstream as a buffer list (1 = disabled)", 1, 1024,
+          UDP_DEFAULT_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -812,6 +845,7 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
   gstbasesrc_class->unlock_stop = gst_udpsrc_unlock_stop;
   gstbasesrc_class->get_caps = gst_udpsrc_getcaps;
   gstbasesrc_class->decide_allocation = gst_udpsrc_decide_allocation;
+  gstbasesrc_class->create = gst_udpsrc_create;
 
   gstpushsrc_class->fill = gst_udpsrc_fill;
 
@@ -840,6 +874,7 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
   udpsrc->mtu = UDP_DEFAULT_MTU;
+  udpsrc->batch_size = UDP_DEFAULT_BATCH_SIZE;
   udpsrc->source_list =
       g_ptr_array_new_with_free_func ((GDestroyNotify) g_free);
 
@@ -884,6 +919,12 @@ gst_udpsrc_finalize (GObject * object)
     gst_memory_unref (udpsrc->extra_mem);
   udpsrc->extra_mem = NULL;
 
+#ifdef HAVE_RECVMMSG
+  if (udpsrc->batch)
+    gst_udpsrc_batch_free (udpsrc->batch);
+  udpsrc->batch = NULL;
+#endif
+
   g_ptr_array_unref (udpsrc->source_list);
   g_free (udpsrc->multicast_source);
 
@@ -936,81 +977,61 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   src->cancellable = NULL;
 }
 
-static GstFlowReturn
-gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
+/* Whether control messages need to be retrieved along with the packets */
+static gboolean
+gst_udpsrc_want_control_messages (GstUDPSrc * udpsrc)
 {
-  GstUDPSrc *udpsrc;
-  GSocketAddress *saddr = NULL;
-  GSocketAddress **p_saddr;
-  gint flags = G_SOCKET_MSG_NONE;
-  gboolean try_again;
-  GError *err = NULL;
-  gssize res;
-  gsize offset;
-  GSocketControlMessage **msgs = NULL;
-  GSocketControlMessage ***p_msgs;
-  gint n_msgs = 0, i;
-  GstMapInfo info;
-  GstMapInfo extra_info;
-  GInputVector ivec[2];
-
-  udpsrc = GST_UDPSRC_CAST (psrc);
+  gboolean res;
 
   /* optimization: use messages only in multicast mode and
    * if we can't let the kernel do the filtering for us */
-  p_msgs =
-      (g_inet_address_get_is_multicast (g_inet_socket_address_get_address
-          (udpsrc->addr))) ? &msgs : NULL;
+  res =
+      g_inet_address_get_is_multicast (g_inet_socket_address_get_address
+      (udpsrc->addr));
 #ifdef IP_MULTICAST_ALL
   if (g_inet_address_get_family (g_inet_socket_address_get_address
           (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
-    p_msgs = NULL;
+    res = FALSE;
 #endif
 #ifdef SO_TIMESTAMPNS
   if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
-    p_msgs = &msgs;
+    res = TRUE;
 #endif
 
-  /* Retrieve sender address unless we've been configured not to do so */
-  p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
+  return res;
+}
 
-  if (!gst_buffer_map (outbuf, &info, GST_MAP_READWRITE))
-    goto buffer_map_error;
+/* Allocates the memory that is used in case the data size exceeds the mtu */
+static GstMemory *
+gst_udpsrc_alloc_extra_mem (GstUDPSrc * udpsrc)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  GstMemory *mem;
 
-  ivec[0].buffer = info.data;
-  ivec[0].size = info.size;
+  pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (udpsrc));
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_get_allocator (config, &allocator, &params);
 
-  /* Prepare memory in case the data size exceeds mtu */
-  if (udpsrc->extra_mem == NULL) {
-    GstBufferPool *pool;
-    GstStructure *config;
-    GstAllocator *allocator = NULL;
-    GstAllocationParams params;
-
-    pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (psrc));
-    config = gst_buffer_pool_get_config (pool);
-    gst_buffer_pool_config_get_allocator (config, &allocator, &params);
-
-    udpsrc->extra_mem =
-        gst_allocator_alloc (allocator, MAX_IPV4_UDP_PACKET_SIZE, &params);
-
-    gst_object_unref (pool);
-    gst_structure_free (config);
-    if (allocator)
-      gst_object_unref (allocator);
-  }
+  mem = gst_allocator_alloc (allocator, MAX_IPV4_UDP_PACKET_SIZE, &params);
 
-  if (!gst_memory_map (udpsrc->extra_mem, &extra_info, GST_MAP_READWRITE))
-    goto memory_map_error;
+  gst_object_unref (pool);
+  gst_structure_free (config);
+  if (allocator)
+    gst_object_unref (allocator);
 
-  ivec[1].buffer = extra_info.data;
-  ivec[1].size = extra_info.size;
+  return mem;
+}
 
-retry:
-  if (saddr != NULL) {
-    g_object_unref (saddr);
-    saddr = NULL;
-  }
+/* Waits until data is available on the socket, posting a timeout message
+ * whenever the configured timeout expires */
+static GstFlowReturn
+gst_udpsrc_wait (GstUDPSrc * udpsrc)
+{
+  GError *err = NULL;
+  gboolean try_again;
 
   do {
     gint64 timeout;
@@ -1044,122 +1065,206 @@ retry:
     }
   } while (G_UNLIKELY (try_again));
 
-  res =
-      g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
-      p_msgs, &n_msgs, &flags, udpsrc->cancellable, &err);
+  return GST_FLOW_OK;
 
-  if (G_UNLIKELY (res < 0)) {
-    /* G_IO_ERROR_HOST_UNREACHABLE for a UDP socket means that a packet sent
-     * with udpsink generated a "port unreachable" ICMP response. We ignore
-     * that and try again.
-     * On Windows we get G_IO_ERROR_CONNECTION_CLOSED instead */
-    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
-        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED)) {
-      g_clear_error (&err);
-      goto retry;
-    }
-    goto receive_error;
+  /* ERRORS */
+select_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("select error: %s", err->message));
+    g_clear_error (&err);
+    return GST_FLOW_ERROR;
+  }
+stopped:
+  {
+    GST_DEBUG ("stop called");
+    g_clear_error (&err);
+    return GST_FLOW_FLUSHING;
   }
+}
 
-  /* Retry if multicast and the destination address is not ours. We don't want
-   * to receive arbitrary packets */
-  if (p_msgs) {
-    GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
-    gboolean skip_packet = FALSE;
-    gsize iaddr_size = g_inet_address_get_native_size (iaddr);
-    const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+/* Handles the control messages received along with a packet. Returns %TRUE
+ * if the packet is not for us and has to be dropped */
+static gboolean
+gst_udpsrc_handle_control_messages (GstUDPSrc * udpsrc, GstBuffer * outbuf,
+    GSocketControlMessage ** msgs, gint n_msgs)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean skip_packet = FALSE;
+  gsize iaddr_size = g_inet_address_get_native_size (iaddr);
+  const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+  gint i;
 
-    for (i = 0; i < n_msgs && !skip_packet; i++) {
+  for (i = 0; i < n_msgs && !skip_packet; i++) {
 #ifdef IP_PKTINFO
-      if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
+    if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
 
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
 #endif
 #ifdef IPV6_PKTINFO
-      if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
+    if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
 
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
 #endif
 #ifdef IP_RECVDSTADDR
-      if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
-        GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
+    if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
+      GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
 
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
 #endif
 #ifdef SO_TIMESTAMPNS
-      if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
-        GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
-        GstClock *clock;
-        GstClockTime socket_ts;
-
-        socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
-        GST_TRACE_OBJECT (udpsrc,
-            "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
-            GST_TIME_ARGS (socket_ts));
-
-        clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
-        if (clock != NULL) {
-          gint64 adjust_dts, cur_sys_time, delta;
-          GstClockTime base_time, cur_gst_clk_time, running_time;
-
+    if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
+      GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
+      GstClock *clock;
+      GstClockTime socket_ts;
+
+      socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
+      GST_TRACE_OBJECT (udpsrc,
+          "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
+          GST_TIME_ARGS (socket_ts));
+
+      clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+      if (clock != NULL) {
+        gint64 adjust_dts, cur_sys_time, delta;
+        GstClockTime base_time, cur_gst_clk_time, running_time;
+
+        /*
+         * We use g_get_real_time as the time reference for SCM timestamps
+         * is always CLOCK_REALTIME.
+         */
+        cur_sys_time = g_get_real_time () * GST_USECOND;
+        cur_gst_clk_time = gst_clock_get_time (clock);
+
+        delta = (gint64) cur_sys_time - (gint64) socket_ts;
+        if (delta < 0) {
+          /*
+           * The current system time will always be greater than the SCM
+           * timestamp as the packet would have been timestamped at least
+           * some clock cycles before. If it is not, then the system time
+           * was adjusted. Since we cannot rely on the delta calculation in
+           * such a case, set the DTS to current pipeline clock when this
+           * happens.
+           */
+          GST_LOG_OBJECT (udpsrc,
+              "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+          GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+        } else {
+          base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+          running_time = cur_gst_clk_time - base_time;
+          adjust_dts = (gint64) running_time - delta;
           /*
-           * We use g_get_real_time as the time reference for SCM timestamps
-           * is always CLOCK_REALTIME.
+           * If the system time was adjusted much further ahead, we might
+           * end up with delta > cur_gst_clk_time. Set the DTS to current
+           * pipeline clock for this scenario as well.
            */
-          cur_sys_time = g_get_real_time () * GST_USECOND;
-          cur_gst_clk_time = gst_clock_get_time (clock);
-
-          delta = (gint64) cur_sys_time - (gint64) socket_ts;
-          if (delta < 0) {
-            /*
-             * The current system time will always be greater than the SCM
-             * timestamp as the packet would have been timestamped at least
-             * some clock cycles before. If it is not, then the system time
-             * was adjusted. Since we cannot rely on the delta calculation in
-             * such a case, set the DTS to current pipeline clock when this
-             * happens.
-             */
+          if (adjust_dts < 0) {
             GST_LOG_OBJECT (udpsrc,
-                "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+                "Current system time much ahead in time, setting DTS to pipeline clock");
             GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
           } else {
-            base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
-            running_time = cur_gst_clk_time - base_time;
-            adjust_dts = (gint64) running_time - delta;
-            /*
-             * If the system time was adjusted much further ahead, we might
-             * end up with delta > cur_gst_clk_time. Set the DTS to current
-             * pipeline clock for this scenario as well.
-             */
-            if (adjust_dts < 0) {
-              GST_LOG_OBJECT (udpsrc,
-                  "Current system time much ahead in time, setting DTS to pipeline clock");
-              GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-            } else {
-              GST_BUFFER_DTS (outbuf) = adjust_dts;
-              GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
-                  GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
-            }
+            GST_BUFFER_DTS (outbuf) = adjust_dts;
+            GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
           }
-          g_object_unref (clock);
-        } else {
-          GST_ERROR_OBJECT (udpsrc,
-              "Failed to get element clock, not setting DTS");
         }
+        g_object_unref (clock);
+      } else {
+        GST_ERROR_OBJECT (udpsrc,
+            "Failed to get element clock, not setting DTS");
       }
+    }
 #endif
+  }
+
+  return skip_packet;
+}
+
+static GstFlowReturn
+gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
+{
+  GstUDPSrc *udpsrc;
+  GSocketAddress *saddr = NULL;
+  GSocketAddress **p_saddr;
+  gint flags = G_SOCKET_MSG_NONE;
+  GError *err = NULL;
+  GstFlowReturn ret;
+  gssize res;
+  gsize offset;
+  GSocketControlMessage **msgs = NULL;
+  GSocketControlMessage ***p_msgs;
+  gint n_msgs = 0, i;
+  GstMapInfo info;
+  GstMapInfo extra_info;
+  GInputVector ivec[2];
+
+  udpsrc = GST_UDPSRC_CAST (psrc);
+
+  p_msgs = gst_udpsrc_want_control_messages (udpsrc) ? &msgs : NULL;
+
+  /* Retrieve sender address unless we've been configured not to do so */
+  p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
+
+  if (!gst_buffer_map (outbuf, &info, GST_MAP_READWRITE))
+    goto buffer_map_error;
+
+  ivec[0].buffer = info.data;
+  ivec[0].size = info.size;
+
+  /* Prepare memory in case the data size exceeds mtu */
+  if (udpsrc->extra_mem == NULL)
+    udpsrc->extra_mem = gst_udpsrc_alloc_extra_mem (udpsrc);
+
+  if (!gst_memory_map (udpsrc->extra_mem, &extra_info, GST_MAP_READWRITE))
+    goto memory_map_error;
+
+  ivec[1].buffer = extra_info.data;
+  ivec[1].size = extra_info.size;
+
+retry:
+  if (saddr != NULL) {
+    g_object_unref (saddr);
+    saddr = NULL;
+  }
+
+  ret = gst_udpsrc_wait (udpsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto wait_error;
+
+  res =
+      g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
+      p_msgs, &n_msgs, &flags, udpsrc->cancellable, &err);
+
+  if (G_UNLIKELY (res < 0)) {
+    /* G_IO_ERROR_HOST_UNREACHABLE for a UDP socket means that a packet sent
+     * with udpsink generated a "port unreachable" ICMP response. We ignore
+     * that and try again.
+     * On Windows we get G_IO_ERROR_CONNECTION_CLOSED instead */
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED)) {
+      g_clear_error (&err);
+      goto retry;
     }
+    goto receive_error;
+  }
+
+  /* Retry if multicast and the destination address is not ours. We don't want
+   * to receive arbitrary packets */
+  if (p_msgs) {
+    gboolean skip_packet;
+
+    skip_packet =
+        gst_udpsrc_handle_control_messages (udpsrc, outbuf, msgs, n_msgs);
 
     for (i = 0; i < n_msgs; i++) {
       g_object_unref (msgs[i]);
@@ -1216,22 +1321,11 @@ memory_map_error:
         ("Failed to map memory"));
     return GST_FLOW_ERROR;
   }
-select_error:
-  {
-    gst_buffer_unmap (outbuf, &info);
-    gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
-        ("select error: %s", err->message));
-    g_clear_error (&err);
-    return GST_FLOW_ERROR;
-  }
-stopped:
+wait_error:
   {
     gst_buffer_unmap (outbuf, &info);
     gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_DEBUG ("stop called");
-    g_clear_error (&err);
-    return GST_FLOW_FLUSHING;
+    return ret;
   }
 receive_error:
   {
@@ -1258,6 +1352,373 @@ skip_error:
   }
 }
 
+#ifdef HAVE_RECVMMSG
+/* Space reserved per packet for control messages in batched mode, enough for
+ * the packet info and the receive timestamp */
+#define UDP_BATCH_CONTROL_SIZE 256
+/* Maximum number of control messages handled per packet */
+#define UDP_BATCH_MAX_CONTROL_MESSAGES 8
+
+struct _GstUDPSrcBatch
+{
+  guint size;
+
+  /* per packet, kept around between calls until they're filled */
+  GstBuffer **bufs;
+  GstMemory **extra_mems;
+
+  GstMapInfo *infos;
+  GstMapInfo *extra_infos;
+  struct mmsghdr *msgs;
+  struct iovec *iovs;
+  struct sockaddr_storage *addrs;
+  guint8 *control;
+};
+
+static void
+gst_udpsrc_batch_free (GstUDPSrcBatch * batch)
+{
+  guint i;
+
+  for (i = 0; i < batch->size; i++) {
+    if (batch->bufs[i])
+      gst_buffer_unref (batch->bufs[i]);
+    if (batch->extra_mems[i])
+      gst_memory_unref (batch->extra_mems[i]);
+  }
+
+  g_free (batch->bufs);
+  g_free (batch->extra_mems);
+  g_free (batch->infos);
+  g_free (batch->extra_infos);
+  g_free (batch->msgs);
+  g_free (batch->iovs);
+  g_free (batch->addrs);
+  g_free (batch->control);
+  g_free (batch);
+}
+
+static GstUDPSrcBatch *
+gst_udpsrc_batch_new (guint size)
+{
+  GstUDPSrcBatch *batch = g_new0 (GstUDPSrcBatch, 1);
+
+  batch->size = size;
+  batch->bufs = g_new0 (GstBuffer *, size);
+  batch->extra_mems = g_new0 (GstMemory *, size);
+  batch->infos = g_new0 (GstMapInfo, size);
+  batch->extra_infos = g_new0 (GstMapInfo, size);
+  batch->msgs = g_new0 (struct mmsghdr, size);
+  batch->iovs = g_new0 (struct iovec, 2 * size);
+  batch->addrs = g_new0 (struct sockaddr_storage, size);
+  batch->control = g_malloc0 (UDP_BATCH_CONTROL_SIZE * size);
+
+  return batch;
+}
+
+static gint
+gst_udpsrc_batch_parse_control_messages (struct msghdr *hdr,
+    GSocketControlMessage ** msgs)
+{
+  struct cmsghdr *cmsg;
+  gint n_msgs = 0;
+
+  if (hdr->msg_controllen == 0)
+    return 0;
+
+  for (cmsg = CMSG_FIRSTHDR (hdr);
+      cmsg != NULL && n_msgs < UDP_BATCH_MAX_CONTROL_MESSAGES;
+      cmsg = CMSG_NXTHDR (hdr, cmsg)) {
+    GSocketControlMessage *msg;
+
+    msg = g_socket_control_message_deserialize (cmsg->cmsg_level,
+        cmsg->cmsg_type, cmsg->cmsg_len - ((gchar *) CMSG_DATA (cmsg) -
+            (gchar *) cmsg), CMSG_DATA (cmsg));
+    if (msg != NULL)
+      msgs[n_msgs++] = msg;
+  }
+
+  return n_msgs;
+}
+
+/* Prepares all packet slots of the batch for receiving */
+static GstFlowReturn
+gst_udpsrc_batch_map (GstUDPSrc * udpsrc, GstUDPSrcBatch * batch,
+    GstBufferPool * pool)
+{
+  GstFlowReturn ret;
+  guint i;
+
+  for (i = 0; i < batch->size; i++) {
+    if (batch->bufs[i] == NULL) {
+      ret = gst_buffer_pool_acquire_buffer (pool, &batch->bufs[i], NULL);
+      if (G_UNLIKELY (ret != GST_FLOW_OK))
+        goto acquire_failed;
+    }
+
+    if (batch->extra_mems[i] == NULL)
+      batch->extra_mems[i] = gst_udpsrc_alloc_extra_mem (udpsrc);
+
+    if (!gst_buffer_map (batch->bufs[i], &batch->infos[i], GST_MAP_READWRITE))
+      goto map_failed;
+
+    if (!gst_memory_map (batch->extra_mems[i], &batch->extra_infos[i],
+            GST_MAP_READWRITE)) {
+      gst_buffer_unmap (batch->bufs[i], &batch->infos[i]);
+      goto map_failed;
+    }
+
+    batch->iovs[2 * i].iov_base = batch->infos[i].data;
+    batch->iovs[2 * i].iov_len = batch->infos[i].size;
+    batch->iovs[2 * i + 1].iov_base = batch->extra_infos[i].data;
+    batch->iovs[2 * i + 1].iov_len = batch->extra_infos[i].size;
+  }
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("Failed to map memory"));
+    ret = GST_FLOW_ERROR;
+    goto acquire_failed;
+  }
+acquire_failed:
+  {
+    while (i > 0) {
+      i--;
+      gst_buffer_unmap (batch->bufs[i], &batch->infos[i]);
+      gst_memory_unmap (batch->extra_mems[i], &batch->extra_infos[i]);
+    }
+    return ret;
+  }
+}
+
+static void
+gst_udpsrc_batch_unmap (GstUDPSrcBatch * batch, guint start)
+{
+  guint i;
+
+  for (i = start; i < batch->size; i++) {
+    gst_buffer_unmap (batch->bufs[i], &batch->infos[i]);
+    gst_memory_unmap (batch->extra_mems[i], &batch->extra_infos[i]);
+  }
+}
+
+/* Receives up to batch-size packets with a single recvmmsg() call once data
+ * is available on the socket. The packets are pushed downstream as a buffer
+ * list, each buffer carrying its own sender address meta and DTS */
+static GstFlowReturn
+gst_udpsrc_create_batch (GstUDPSrc * udpsrc, GstBuffer ** buf)
+{
+  GstUDPSrcBatch *batch;
+  GstBufferPool *pool;
+  GstBufferList *list = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+  gboolean want_msgs;
+  gint fd, n_received, errsv = 0;
+  guint i;
+
+  if (udpsrc->batch == NULL || udpsrc->batch->size != udpsrc->batch_size) {
+    if (udpsrc->batch)
+      gst_udpsrc_batch_free (udpsrc->batch);
+    udpsrc->batch = gst_udpsrc_batch_new (udpsrc->batch_size);
+  }
+  batch = udpsrc->batch;
+
+  want_msgs = gst_udpsrc_want_control_messages (udpsrc);
+  fd = g_socket_get_fd (udpsrc->used_socket);
+
+  pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (udpsrc));
+  if (pool == NULL)
+    goto no_pool;
+
+  do {
+    GstClock *clock;
+    GstClockTime dts = GST_CLOCK_TIME_NONE;
+
+    ret = gst_udpsrc_batch_map (udpsrc, batch, pool);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      goto done;
+
+  retry:
+    ret = gst_udpsrc_wait (udpsrc);
+    if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+      gst_udpsrc_batch_unmap (batch, 0);
+      goto done;
+    }
+
+    for (i = 0; i < batch->size; i++) {
+      struct msghdr *hdr = &batch->msgs[i].msg_hdr;
+
+      hdr->msg_name =
+          udpsrc->retrieve_sender_address ? &batch->addrs[i] : NULL;
+      hdr->msg_namelen =
+          udpsrc->retrieve_sender_address ? sizeof (batch->addrs[i]) : 0;
+      hdr->msg_iov = &batch->iovs[2 * i];
+      hdr->msg_iovlen = 2;
+      hdr->msg_control =
+          want_msgs ? &batch->control[i * UDP_BATCH_CONTROL_SIZE] : NULL;
+      hdr->msg_controllen = want_msgs ? UDP_BATCH_CONTROL_SIZE : 0;
+      hdr->msg_flags = 0;
+      batch->msgs[i].msg_len = 0;
+    }
+
+    n_received = recvmmsg (fd, batch->msgs, batch->size, MSG_DONTWAIT, NULL);
+    if (G_UNLIKELY (n_received < 0)) {
+      errsv = errno;
+
+      /* ECONNREFUSED/EHOSTUNREACH for a UDP socket means that a packet sent
+       * with udpsink generated an ICMP error response. We ignore that and
+       * try again, just like in the non-batched case */
+      if (errsv == EINTR || errsv == EAGAIN || errsv == EWOULDBLOCK
+          || errsv == ECONNREFUSED || errsv == EHOSTUNREACH)
+        goto retry;
+      gst_udpsrc_batch_unmap (batch, 0);
+      goto receive_error;
+    }
+
+    gst_udpsrc_batch_unmap (batch, 0);
+
+    GST_LOG_OBJECT (udpsrc, "received %d packets in one go", n_received);
+
+    /* all packets arrived within a single wakeup, give them the same
+     * capture time unless a more accurate socket timestamp is available */
+    clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+    if (clock != NULL) {
+      GstClockTime now, base_time;
+
+      now = gst_clock_get_time (clock);
+      base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+      if (now > base_time)
+        dts = now - base_time;
+      else
+        dts = 0;
+      gst_object_unref (clock);
+    }
+
+    for (i = 0; i < (guint) n_received; i++) {
+      GstBuffer *outbuf = batch->bufs[i];
+      gsize res = batch->msgs[i].msg_len;
+      gsize offset;
+
+      if (want_msgs) {
+        GSocketControlMessage *msgs[UDP_BATCH_MAX_CONTROL_MESSAGES];
+        gboolean skip_packet;
+        gint n_msgs, j;
+
+        n_msgs =
+            gst_udpsrc_batch_parse_control_messages (&batch->msgs[i].msg_hdr,
+            msgs);
+        skip_packet =
+            gst_udpsrc_handle_control_messages (udpsrc, outbuf, msgs, n_msgs);
+
+        for (j = 0; j < n_msgs; j++)
+          g_object_unref (msgs[j]);
+
+        if (skip_packet) {
+          GST_DEBUG_OBJECT (udpsrc,
+              "Dropping packet for a different multicast address");
+          /* keep the buffer for the next round */
+          GST_BUFFER_DTS (outbuf) = GST_CLOCK_TIME_NONE;
+          continue;
+        }
+      }
+
+      if (res > udpsrc->mtu) {
+        gst_buffer_append_memory (outbuf, batch->extra_mems[i]);
+        batch->extra_mems[i] = NULL;
+      }
+
+      offset = udpsrc->skip_first_bytes;
+
+      if (G_UNLIKELY (offset > 0 && res < offset)) {
+        /* don't keep a buffer with the extra memory attached around */
+        gst_buffer_unref (outbuf);
+        batch->bufs[i] = NULL;
+        goto skip_error;
+      }
+
+      gst_buffer_resize (outbuf, offset, res - offset);
+
+      /* use buffer metadata so receivers can also track the address */
+      if (batch->msgs[i].msg_hdr.msg_namelen > 0) {
+        GSocketAddress *saddr;
+
+        saddr = g_socket_address_new_from_native (&batch->addrs[i],
+            batch->msgs[i].msg_hdr.msg_namelen);
+        if (saddr) {
+          gst_buffer_add_net_address_meta (outbuf, saddr);
+          g_object_unref (saddr);
+        }
+      }
+
+      if (!GST_BUFFER_DTS_IS_VALID (outbuf))
+        GST_BUFFER_DTS (outbuf) = dts;
+
+      GST_LOG_OBJECT (udpsrc, "read packet of %d bytes", (int) res);
+
+      if (list == NULL)
+        list = gst_buffer_list_new_sized (n_received);
+      gst_buffer_list_add (list, outbuf);
+      batch->bufs[i] = NULL;
+    }
+  } while (list == NULL);
+
+  if (gst_buffer_list_length (list) == 1) {
+    *buf = gst_buffer_ref (gst_buffer_list_get (list, 0));
+    gst_buffer_list_unref (list);
+  } else {
+    gst_base_src_submit_buffer_list (GST_BASE_SRC_CAST (udpsrc), list);
+    *buf = NULL;
+  }
+
+done:
+  gst_object_unref (pool);
+
+  return ret;
+
+  /* ERRORS */
+no_pool:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("No buffer pool configured"));
+    return GST_FLOW_ERROR;
+  }
+receive_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("receive error: %s", g_strerror (errsv)));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+skip_error:
+  {
+    if (list)
+      gst_buffer_list_unref (list);
+    GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+        ("UDP buffer to small to skip header"));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+}
+#endif
+
+static GstFlowReturn
+gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset, guint length,
+    GstBuffer ** buf)
+{
+#ifdef HAVE_RECVMMSG
+  GstUDPSrc *udpsrc = GST_UDPSRC_CAST (bsrc);
+
+  if (udpsrc->batch_size > 1)
+    return gst_udpsrc_create_batch (udpsrc, buf);
+#endif
+
+  return GST_BASE_SRC_CLASS (parent_class)->create (bsrc, offset, length, buf);
+}
+
 static gboolean
 gst_udpsrc_set_uri (GstUDPSrc * src, const gchar * uri, GError ** error)
 {
@@ -1441,6 +1902,9 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
       }
       GST_OBJECT_UNLOCK (udpsrc);
       break;
+    case PROP_BATCH_SIZE:
+      udpsrc->batch_size = g_value_get_uint (value);
+      break;
     default:
       break;
   }
@@ -1512,6 +1976,9 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_string (value, udpsrc->multicast_source);
       GST_OBJECT_UNLOCK (udpsrc);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->batch_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2085,6 +2552,13 @@ gst_udpsrc_change_state (GstElement * element, GstStateChange transition)
     goto failure;
 
   switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+#ifdef HAVE_RECVMMSG
+      if (src->batch)
+        gst_udpsrc_batch_free (src->batch);
+      src->batch = NULL;
+#endif
+      break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       gst_udpsrc_close (src);
       break;
@@ -43,6 +43,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstUDPSrc GstUDPSrc;
 typedef struct _GstUDPSrcClass GstUDPSrcClass;
+typedef struct _GstUDPSrcBatch GstUDPSrcBatch;
 
 
 /**
@@ -98,6 +99,11 @@ struct _GstUDPSrc {
   /* Extra memory for buffers with a size superior to max_packet_size */
   GstMemory *extra_mem;
 
+  /* Batched receiving, maximum number of packets per call and the
+   * receive state kept around between calls */
+  guint      batch_size;	/* hot */
+  GstUDPSrcBatch *batch;
+
   gchar     *uri;
   GPtrArray *source_list;
 };
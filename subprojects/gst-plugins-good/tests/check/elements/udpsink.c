@@ -244,6 +244,85 @@ GST_START_TEST (test_udpsink_dscp)
 
 GST_END_TEST;
 
+GST_START_TEST (test_multiudpsink_gso)
+{
+  static const gsize sizes[] = { 1036, 1036, 1036, 500, 1036, 1036 };
+  GstElement *sink;
+  GstPad *srcpad;
+  GstSegment segment;
+  GstBufferList *list;
+  GSocket *socket;
+  GSocketAddress *addr, *bound_addr;
+  GInetAddress *ia;
+  GError *err = NULL;
+  guint64 gso_sends, gso_segments;
+  gchar data[2048];
+  guint port, i;
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, &err);
+  fail_unless (socket != NULL && err == NULL);
+  g_socket_set_timeout (socket, 5);
+
+  ia = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  addr = g_inet_socket_address_new (ia, 0);
+  fail_unless (g_socket_bind (socket, addr, FALSE, &err));
+  g_object_unref (addr);
+  g_object_unref (ia);
+
+  bound_addr = g_socket_get_local_address (socket, &err);
+  fail_unless (bound_addr != NULL);
+  port =
+      g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (bound_addr));
+  g_object_unref (bound_addr);
+
+  sink = gst_check_setup_element ("multiudpsink");
+  g_object_set (sink, "gso", TRUE, NULL);
+  g_signal_emit_by_name (sink, "add", "127.0.0.1", port, NULL);
+
+  srcpad = gst_check_setup_src_pad_by_name (sink, &srctemplate, "sink");
+
+  gst_element_set_state (sink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("gso"));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    GstBuffer *buf = gst_buffer_new_allocate (NULL, sizes[i], NULL);
+
+    gst_buffer_memset (buf, 0, i, sizes[i]);
+    gst_buffer_list_add (list, buf);
+  }
+  fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+
+  /* no matter whether the kernel supports GSO, the receiver must get each
+   * packet separately */
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    gssize len;
+
+    len = g_socket_receive (socket, data, sizeof (data), NULL, &err);
+    fail_unless_equals_int (len, sizes[i]);
+    fail_unless_equals_int (data[0], i);
+    fail_unless_equals_int (data[len - 1], i);
+  }
+
+  /* the first four packets can be coalesced, then the last two */
+  g_object_get (sink, "gso-sends", &gso_sends, "gso-segments", &gso_segments,
+      NULL);
+  fail_unless (gso_sends == 0 || gso_sends == 2);
+  fail_unless (gso_segments == 0 || gso_segments == G_N_ELEMENTS (sizes));
+
+  gst_check_teardown_pad_by_name (sink, "sink");
+  gst_check_teardown_element (sink);
+
+  g_object_unref (socket);
+}
+
+GST_END_TEST;
+
 static Suite *
 udpsink_suite (void)
 {
@@ -256,6 +335,7 @@ udpsink_suite (void)
   tcase_add_test (tc_chain, test_udpsink_bufferlist);
   tcase_add_test (tc_chain, test_udpsink_client_add_remove);
   tcase_add_test (tc_chain, test_udpsink_dscp);
+  tcase_add_test (tc_chain, test_multiudpsink_gso);
 
   return s;
 }
@@ -16,7 +16,12 @@
  * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
  * Boston, MA 02110-1301, USA.
  */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include <gst/check/gstcheck.h>
+#include <gst/net/gstnetaddressmeta.h>
 #include <gio/gio.h>
 #include <stdlib.h>
 
@@ -26,8 +31,8 @@ static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_STATIC_CAPS_ANY);
 
 static gboolean
-udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
-    GstPad ** sinkpad, GSocketAddress ** sa)
+udpsrc_setup_with_batch_size (GstElement ** udpsrc, GSocket ** socket,
+    GstPad ** sinkpad, GSocketAddress ** sa, guint batch_size, GstState state)
 {
   GInetAddress *ia;
   int port = 0;
@@ -35,13 +40,13 @@ udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
 
   *udpsrc = gst_check_setup_element ("udpsrc");
   fail_unless (*udpsrc != NULL);
-  g_object_set (*udpsrc, "port", 0, NULL);
+  g_object_set (*udpsrc, "port", 0, "batch-size", batch_size, NULL);
 
   *sinkpad = gst_check_setup_sink_pad_by_name (*udpsrc, &sinktemplate, "src");
   fail_unless (*sinkpad != NULL);
   gst_pad_set_active (*sinkpad, TRUE);
 
-  gst_element_set_state (*udpsrc, GST_STATE_PLAYING);
+  gst_element_set_state (*udpsrc, state);
   g_object_get (*udpsrc, "port", &port, NULL);
   GST_INFO ("udpsrc port = %d", port);
 
@@ -63,6 +68,14 @@ udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
   return TRUE;
 }
 
+static gboolean
+udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
+    GstPad ** sinkpad, GSocketAddress ** sa)
+{
+  return udpsrc_setup_with_batch_size (udpsrc, socket, sinkpad, sa, 1,
+      GST_STATE_PLAYING);
+}
+
 GST_START_TEST (test_udpsrc_empty_packet)
 {
   GSocketAddress *sa = NULL;
@@ -247,6 +260,113 @@ send_failure:
 
 GST_END_TEST;
 
+static guint n_lists;
+static guint max_list_len;
+
+static GstPadProbeReturn
+count_buffer_lists (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+
+  g_mutex_lock (&check_mutex);
+  n_lists++;
+  max_list_len = MAX (max_list_len, gst_buffer_list_length (list));
+  g_mutex_unlock (&check_mutex);
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_udpsrc_batch)
+{
+  GSocketAddress *sa = NULL;
+  GstElement *udpsrc = NULL;
+  GSocket *socket = NULL;
+  GstPad *sinkpad = NULL;
+  static const gsize sizes[] = { 100, 48000, 1400, 1600, 200 };
+  gchar data[48000];
+  int i, len = 0;
+  gssize sent;
+  GError *err = NULL;
+
+  for (i = 0; i < G_N_ELEMENTS (data); ++i)
+    data[i] = i & 0xff;
+
+  n_lists = max_list_len = 0;
+
+  /* the packets are queued on the socket before udpsrc starts reading, so
+   * that they are received in batches */
+  if (!udpsrc_setup_with_batch_size (&udpsrc, &socket, &sinkpad, &sa, 4,
+          GST_STATE_PAUSED))
+    goto no_socket;
+
+  gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      count_buffer_lists, NULL, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    if ((sent = g_socket_send_to (socket, sa, data, sizes[i], NULL,
+                &err)) == -1)
+      goto send_failure;
+    fail_unless_equals_int (sent, sizes[i]);
+  }
+
+  GST_INFO ("sent some packets");
+
+  gst_element_set_state (udpsrc, GST_STATE_PLAYING);
+
+  g_mutex_lock (&check_mutex);
+  len = g_list_length (buffers);
+  while (len < G_N_ELEMENTS (sizes)) {
+    g_cond_wait (&check_cond, &check_mutex);
+    len = g_list_length (buffers);
+    GST_INFO ("%u buffers", len);
+  }
+
+  /* all packets must arrive in order, with their content, sender address
+   * and a timestamp, no matter how they were batched */
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    GstBuffer *buf = GST_BUFFER (g_list_nth_data (buffers, i));
+    GstNetAddressMeta *meta;
+
+    fail_unless_equals_int (gst_buffer_get_size (buf), sizes[i]);
+    fail_unless (gst_buffer_memcmp (buf, 0, data, sizes[i]) == 0);
+    fail_unless (GST_BUFFER_DTS_IS_VALID (buf));
+
+    meta = gst_buffer_get_net_address_meta (buf);
+    fail_unless (meta != NULL);
+    fail_unless (G_IS_INET_SOCKET_ADDRESS (meta->addr));
+  }
+
+#ifdef HAVE_RECVMMSG
+  /* the first batch-size packets were pushed downstream in one list */
+  fail_unless (n_lists >= 1);
+  fail_unless_equals_int (max_list_len, 4);
+#endif
+
+  g_list_foreach (buffers, (GFunc) gst_buffer_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  g_mutex_unlock (&check_mutex);
+
+no_socket:
+send_failure:
+  if (err) {
+    GST_WARNING ("Socket send error, skipping test: %s", err->message);
+    g_clear_error (&err);
+  }
+
+  gst_element_set_state (udpsrc, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (udpsrc, "src");
+  gst_check_teardown_element (udpsrc);
+
+  g_object_unref (socket);
+  g_object_unref (sa);
+}
+
+GST_END_TEST;
+
 static void
 on_multicast_source_updated (GObject * src, GParamSpec * pspec, guint * count)
 {
@@ -305,6 +425,7 @@ udpsrc_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_udpsrc_empty_packet);
   tcase_add_test (tc_chain, test_udpsrc);
+  tcase_add_test (tc_chain, test_udpsrc_batch);
   tcase_add_test (tc_chain, test_udpsrc_multicast_source);
 
   return s;
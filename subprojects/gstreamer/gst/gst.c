@@ -535,6 +535,9 @@ init_pre (GOptionContext * context, GOptionGroup * group, gpointer data,
     return TRUE;
   }
 
+  /* must come before anything allocates events, messages or structures */
+  _priv_gst_arena_initialize ();
+
   priv_gst_clock_init ();
 
   find_executable_path ();
@@ -663,6 +666,7 @@ init_post (GOptionContext * context, GOptionGroup * group, gpointer data,
 
   _priv_gst_mini_object_initialize ();
   _priv_gst_quarks_initialize ();
+  _priv_gst_affinity_initialize ();
   _priv_gst_allocator_initialize ();
   _priv_gst_memory_initialize ();
   _priv_gst_format_initialize ();
@@ -1121,6 +1125,7 @@ gst_deinit (void)
 
   _priv_gst_registry_cleanup ();
   _priv_gst_allocator_cleanup ();
+  _priv_gst_affinity_cleanup ();
 
   /* We want to destroy tracers as late as possible for the leaks tracer
    * but still need to keep the caps system alive as it may have to use
@@ -114,6 +114,8 @@ G_GNUC_INTERNAL  gboolean _priv_plugin_deps_env_vars_changed (GstPlugin * plugin
 G_GNUC_INTERNAL  gboolean _priv_plugin_deps_files_changed (GstPlugin * plugin);
 
 /* init functions called from gst_init(). */
+G_GNUC_INTERNAL  void  _priv_gst_arena_initialize (void);
+G_GNUC_INTERNAL  void  _priv_gst_affinity_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_quarks_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_mini_object_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_memory_initialize (void);
@@ -138,7 +140,31 @@ G_GNUC_INTERNAL  void  _priv_gst_toc_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_date_time_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_plugin_feature_rank_initialize (void);
 
+/* per-thread arena for small objects, see gstarena.c */
+G_GNUC_INTERNAL  gboolean _priv_gst_arena_is_enabled (void);
+G_GNUC_INTERNAL  gpointer _priv_gst_arena_alloc0 (gsize size);
+G_GNUC_INTERNAL  void     _priv_gst_arena_free (gpointer mem);
+
+/* CPU affinity and NUMA nodes of streaming threads, see gstaffinity.c */
+#define GST_CPU_SET_MAX 1024
+
+typedef struct {
+  guint64 bits[GST_CPU_SET_MAX / 64];
+} GstCpuSet;
+
+G_GNUC_INTERNAL  gboolean _priv_gst_cpu_set_parse (GstCpuSet * set, const gchar * list);
+G_GNUC_INTERNAL  gchar *  _priv_gst_cpu_set_to_string (const GstCpuSet * set);
+G_GNUC_INTERNAL  gboolean _priv_gst_thread_get_affinity (GstCpuSet * set);
+G_GNUC_INTERNAL  gboolean _priv_gst_thread_set_affinity (const GstCpuSet * set);
+G_GNUC_INTERNAL  void     _priv_gst_thread_reset_affinity (void);
+G_GNUC_INTERNAL  void     _priv_gst_affinity_bin_changed (gboolean set);
+G_GNUC_INTERNAL  gboolean _priv_gst_affinity_is_used (void);
+G_GNUC_INTERNAL  gint     _priv_gst_numa_get_current_node (void);
+G_GNUC_INTERNAL  gint     _priv_gst_numa_get_thread_node (void);
+G_GNUC_INTERNAL  gboolean _priv_gst_numa_bind_memory (gpointer mem, gsize size, gint node);
+
 /* cleanup functions called from gst_deinit(). */
+G_GNUC_INTERNAL  void  _priv_gst_affinity_cleanup (void);
 G_GNUC_INTERNAL  void  _priv_gst_allocator_cleanup (void);
 G_GNUC_INTERNAL  void  _priv_gst_caps_features_cleanup (void);
 G_GNUC_INTERNAL  void  _priv_gst_caps_cleanup (void);
@@ -204,10 +230,10 @@ gchar *priv_gst_string_take_and_wrap (gchar * s);
 
 /* registry cache backends */
 G_GNUC_INTERNAL
-gboolean		priv_gst_registry_binary_read_cache	(GstRegistry * registry, const char *location);
+gboolean		priv_gst_registry_binary_read_cache	(GstRegistry * registry, const char *location, guint64 * manifest_hash);
 
 G_GNUC_INTERNAL
-gboolean		priv_gst_registry_binary_write_cache	(GstRegistry * registry, GList * plugins, const char *location);
+gboolean		priv_gst_registry_binary_write_cache	(GstRegistry * registry, GList * plugins, const char *location, guint64 manifest_hash);
 
 
 G_GNUC_INTERNAL
@@ -0,0 +1,519 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gstaffinity.c: CPU affinity and NUMA placement of streaming threads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Streaming threads can be pinned to a set of CPUs, either all of them with
+ * the GST_TASK_CPU_AFFINITY environment variable or those of a bin with the
+ * GstBin:cpu-affinity property. CPU sets use the cpulist format of the Linux
+ * kernel, e.g. "0-15,32-47".
+ *
+ * The NUMA node of a CPU is read from /sys/devices/system/node the first time
+ * it is needed. GST_NUMA_TOPOLOGY replaces it with a list of cpulists
+ * separated by ';', one per node, so that multi-node setups can be tested on
+ * any machine, e.g. "0-3;4-7" for two nodes of 4 CPUs.
+ *
+ * Only Linux is supported. Everywhere else setting the affinity fails and
+ * the NUMA node is always -1.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define _GNU_SOURCE 1
+
+#include "gst_private.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_SCHED_AFFINITY
+#include <sched.h>
+#endif
+
+#ifdef HAVE_MBIND
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define GST_CAT_DEFAULT GST_CAT_SCHEDULING
+
+/* MPOL_PREFERRED from linux/mempolicy.h */
+#define NUMA_MPOL_PREFERRED 1
+
+/* what was last applied to a thread by us */
+enum
+{
+  THREAD_AFFINITY_UNTOUCHED = 0,
+  THREAD_AFFINITY_DEFAULT,
+  THREAD_AFFINITY_CUSTOM
+};
+
+static GPrivate thread_affinity = G_PRIVATE_INIT (NULL);
+
+/* the affinity of the thread calling gst_init(), restored on pool threads
+ * that were pinned by a bin during an earlier run */
+static GstCpuSet process_affinity;
+static gboolean have_process_affinity = FALSE;
+
+/* from GST_TASK_CPU_AFFINITY */
+static GstCpuSet default_affinity;
+static gboolean have_default_affinity = FALSE;
+
+/* number of bins with a cpu-affinity */
+static gint n_affinity_bins = 0;
+/* set once a thread was pinned by a bin */
+static gint threads_pinned = 0;
+
+/* the CPU sets threads were pinned to by a bin, threads that have one of
+ * them without being pinned themselves inherited it from their creator */
+static GMutex pinned_sets_lock;
+static GArray *pinned_sets = NULL;
+
+/* node of every CPU, -1 when unknown */
+static gint16 cpu_nodes[GST_CPU_SET_MAX];
+
+static inline void
+cpu_set_add (GstCpuSet * set, guint cpu)
+{
+  set->bits[cpu / 64] |= G_GUINT64_CONSTANT (1) << (cpu % 64);
+}
+
+static inline gboolean
+cpu_set_has (const GstCpuSet * set, guint cpu)
+{
+  return (set->bits[cpu / 64] >> (cpu % 64)) & 1;
+}
+
+static gboolean
+parse_cpu (const gchar ** str, guint * cpu)
+{
+  gchar *end;
+  guint64 val;
+
+  while (g_ascii_isspace (**str))
+    (*str)++;
+  if (!g_ascii_isdigit (**str))
+    return FALSE;
+
+  val = g_ascii_strtoull (*str, &end, 10);
+  if (val >= GST_CPU_SET_MAX)
+    return FALSE;
+
+  *cpu = val;
+  *str = end;
+  while (g_ascii_isspace (**str))
+    (*str)++;
+
+  return TRUE;
+}
+
+/* parses a cpulist like "0-3,8,10-11" into @set. Returns %FALSE for an invalid
+ * or empty list. */
+gboolean
+_priv_gst_cpu_set_parse (GstCpuSet * set, const gchar * list)
+{
+  const gchar *str = list;
+  gboolean empty = TRUE;
+
+  memset (set, 0, sizeof (GstCpuSet));
+
+  if (list == NULL)
+    return FALSE;
+
+  while (*str) {
+    guint first, last, cpu;
+
+    if (!parse_cpu (&str, &first))
+      return FALSE;
+    last = first;
+
+    if (*str == '-') {
+      str++;
+      if (!parse_cpu (&str, &last) || last < first)
+        return FALSE;
+    }
+
+    for (cpu = first; cpu <= last; cpu++)
+      cpu_set_add (set, cpu);
+    empty = FALSE;
+
+    if (*str == ',')
+      str++;
+    else if (*str != '\0')
+      return FALSE;
+  }
+
+  return !empty;
+}
+
+/* formats @set as a cpulist, the reverse of _priv_gst_cpu_set_parse() */
+gchar *
+_priv_gst_cpu_set_to_string (const GstCpuSet * set)
+{
+  GString *str = g_string_new (NULL);
+  guint cpu = 0;
+
+  while (cpu < GST_CPU_SET_MAX) {
+    guint last;
+
+    if (!cpu_set_has (set, cpu)) {
+      cpu++;
+      continue;
+    }
+
+    last = cpu;
+    while (last + 1 < GST_CPU_SET_MAX && cpu_set_has (set, last + 1))
+      last++;
+
+    if (str->len)
+      g_string_append_c (str, ',');
+    if (last == cpu)
+      g_string_append_printf (str, "%u", cpu);
+    else
+      g_string_append_printf (str, "%u-%u", cpu, last);
+
+    cpu = last + 1;
+  }
+
+  return g_string_free (str, FALSE);
+}
+
+/* the CPUs the calling thread is allowed to run on */
+gboolean
+_priv_gst_thread_get_affinity (GstCpuSet * set)
+{
+  memset (set, 0, sizeof (GstCpuSet));
+
+#ifdef HAVE_SCHED_AFFINITY
+  {
+    cpu_set_t cpus;
+    guint cpu;
+
+    CPU_ZERO (&cpus);
+    if (sched_getaffinity (0, sizeof (cpus), &cpus) != 0)
+      return FALSE;
+
+    for (cpu = 0; cpu < GST_CPU_SET_MAX && cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET (cpu, &cpus))
+        cpu_set_add (set, cpu);
+    }
+    return TRUE;
+  }
+#else
+  return FALSE;
+#endif
+}
+
+static gboolean
+thread_apply_affinity (const GstCpuSet * set)
+{
+#ifdef HAVE_SCHED_AFFINITY
+  cpu_set_t cpus;
+  guint cpu;
+
+  CPU_ZERO (&cpus);
+  for (cpu = 0; cpu < GST_CPU_SET_MAX && cpu < CPU_SETSIZE; cpu++) {
+    if (cpu_set_has (set, cpu))
+      CPU_SET (cpu, &cpus);
+  }
+
+  if (sched_setaffinity (0, sizeof (cpus), &cpus) != 0) {
+    GST_WARNING ("failed to set thread affinity: %s", g_strerror (errno));
+    return FALSE;
+  }
+  return TRUE;
+#else
+  GST_WARNING ("thread affinity is not supported on this platform");
+  return FALSE;
+#endif
+}
+
+static gboolean
+cpu_set_equal (const GstCpuSet * a, const GstCpuSet * b)
+{
+  return memcmp (a, b, sizeof (GstCpuSet)) == 0;
+}
+
+/* finds @set in pinned_sets, must be called with pinned_sets_lock */
+static gboolean
+pinned_sets_contain (const GstCpuSet * set)
+{
+  guint i;
+
+  if (pinned_sets == NULL)
+    return FALSE;
+
+  for (i = 0; i < pinned_sets->len; i++) {
+    if (cpu_set_equal (&g_array_index (pinned_sets, GstCpuSet, i), set))
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/* pins the calling thread to @set */
+gboolean
+_priv_gst_thread_set_affinity (const GstCpuSet * set)
+{
+  if (!thread_apply_affinity (set))
+    return FALSE;
+
+  g_private_set (&thread_affinity,
+      GINT_TO_POINTER (THREAD_AFFINITY_CUSTOM));
+
+  g_mutex_lock (&pinned_sets_lock);
+  if (!pinned_sets_contain (set)) {
+    if (pinned_sets == NULL)
+      pinned_sets = g_array_new (FALSE, FALSE, sizeof (GstCpuSet));
+    g_array_append_vals (pinned_sets, set, 1);
+  }
+  g_mutex_unlock (&pinned_sets_lock);
+  g_atomic_int_set (&threads_pinned, 1);
+
+  return TRUE;
+}
+
+/* called when the cpu-affinity of a bin is set (@set is %TRUE) or unset */
+void
+_priv_gst_affinity_bin_changed (gboolean set)
+{
+  if (set)
+    g_atomic_int_inc (&n_affinity_bins);
+  else
+    g_atomic_int_add (&n_affinity_bins, -1);
+}
+
+/* whether streaming threads are pinned at all, either by a bin or by
+ * GST_TASK_CPU_AFFINITY */
+gboolean
+_priv_gst_affinity_is_used (void)
+{
+  return have_default_affinity || g_atomic_int_get (&n_affinity_bins) > 0;
+}
+
+/* called when a task starts running on a thread. Applies the default affinity
+ * of GST_TASK_CPU_AFFINITY, or undoes the pinning of a bin when a pooled
+ * thread is reused for another task. New threads inherit the affinity of
+ * the thread that created them, so a thread we never touched can still have
+ * the CPU set of a bin, that one is restored too. Any other affinity was set
+ * by the application and is left alone. */
+void
+_priv_gst_thread_reset_affinity (void)
+{
+  gint state = GPOINTER_TO_INT (g_private_get (&thread_affinity));
+
+  if (have_default_affinity) {
+    if (state != THREAD_AFFINITY_DEFAULT &&
+        thread_apply_affinity (&default_affinity))
+      g_private_set (&thread_affinity,
+          GINT_TO_POINTER (THREAD_AFFINITY_DEFAULT));
+  } else if (have_process_affinity && g_atomic_int_get (&threads_pinned)) {
+    if (state != THREAD_AFFINITY_CUSTOM) {
+      GstCpuSet current;
+      gboolean inherited;
+
+      if (!_priv_gst_thread_get_affinity (&current) ||
+          cpu_set_equal (&current, &process_affinity))
+        return;
+
+      g_mutex_lock (&pinned_sets_lock);
+      inherited = pinned_sets_contain (&current);
+      g_mutex_unlock (&pinned_sets_lock);
+
+      if (!inherited)
+        return;
+    }
+
+    if (thread_apply_affinity (&process_affinity))
+      g_private_set (&thread_affinity,
+          GINT_TO_POINTER (THREAD_AFFINITY_UNTOUCHED));
+  }
+}
+
+static void
+topology_add_node (gint node, const gchar * cpulist)
+{
+  GstCpuSet set;
+  guint cpu;
+
+  if (!_priv_gst_cpu_set_parse (&set, cpulist))
+    return;
+
+  for (cpu = 0; cpu < GST_CPU_SET_MAX; cpu++) {
+    if (cpu_set_has (&set, cpu))
+      cpu_nodes[cpu] = node;
+  }
+}
+
+static gpointer
+topology_load (gpointer data)
+{
+  const gchar *env;
+  guint cpu;
+
+  for (cpu = 0; cpu < GST_CPU_SET_MAX; cpu++)
+    cpu_nodes[cpu] = -1;
+
+  env = g_getenv ("GST_NUMA_TOPOLOGY");
+  if (env != NULL && *env != '\0') {
+    gchar **nodes = g_strsplit (env, ";", -1);
+    gint node;
+
+    GST_INFO ("using NUMA topology from environment: %s", env);
+    for (node = 0; nodes[node]; node++)
+      topology_add_node (node, nodes[node]);
+    g_strfreev (nodes);
+  } else {
+    GDir *dir;
+    const gchar *name;
+
+    if ((dir = g_dir_open ("/sys/devices/system/node", 0, NULL)) == NULL)
+      return NULL;
+
+    while ((name = g_dir_read_name (dir))) {
+      gchar *path, *cpulist;
+      gint node;
+
+      if (!g_str_has_prefix (name, "node") || !g_ascii_isdigit (name[4]))
+        continue;
+      node = atoi (name + 4);
+
+      path = g_build_filename ("/sys/devices/system/node", name, "cpulist",
+          NULL);
+      if (g_file_get_contents (path, &cpulist, NULL, NULL)) {
+        topology_add_node (node, g_strstrip (cpulist));
+        g_free (cpulist);
+      }
+      g_free (path);
+    }
+    g_dir_close (dir);
+  }
+
+  return NULL;
+}
+
+static inline gint
+cpu_get_node (guint cpu)
+{
+  static GOnce topology_once = G_ONCE_INIT;
+
+  g_once (&topology_once, topology_load, NULL);
+
+  return cpu < GST_CPU_SET_MAX ? cpu_nodes[cpu] : -1;
+}
+
+/* the NUMA node of the CPU the calling thread is running on, -1 if unknown */
+gint
+_priv_gst_numa_get_current_node (void)
+{
+#ifdef HAVE_SCHED_AFFINITY
+  gint cpu = sched_getcpu ();
+
+  if (cpu >= 0)
+    return cpu_get_node (cpu);
+#endif
+  return -1;
+}
+
+/* the NUMA node of the calling thread. When its affinity is restricted to a
+ * single node, that is the node, otherwise the node of the CPU it is running
+ * on right now. */
+gint
+_priv_gst_numa_get_thread_node (void)
+{
+  GstCpuSet set;
+  gint node = -1;
+  guint cpu;
+
+  if (!_priv_gst_thread_get_affinity (&set))
+    return -1;
+
+  for (cpu = 0; cpu < GST_CPU_SET_MAX; cpu++) {
+    gint n;
+
+    if (!cpu_set_has (&set, cpu))
+      continue;
+
+    n = cpu_get_node (cpu);
+    if (node == -1) {
+      node = n;
+    } else if (n != node) {
+      node = _priv_gst_numa_get_current_node ();
+      break;
+    }
+  }
+
+  return node;
+}
+
+/* prefers @node for the pages of @mem. They are only placed when first
+ * touched, so this has to be called before writing to @mem. */
+gboolean
+_priv_gst_numa_bind_memory (gpointer mem, gsize size, gint node)
+{
+#ifdef HAVE_MBIND
+  gulong mask[GST_CPU_SET_MAX / (8 * sizeof (gulong))] = { 0, };
+
+  if (node < 0 || node >= GST_CPU_SET_MAX)
+    return FALSE;
+
+  mask[node / (8 * sizeof (gulong))] |= 1UL << (node % (8 * sizeof (gulong)));
+
+  if (syscall (__NR_mbind, mem, size, NUMA_MPOL_PREFERRED, mask,
+          (gulong) GST_CPU_SET_MAX, 0) != 0) {
+    GST_DEBUG ("failed to bind %p to node %d: %s", mem, node,
+        g_strerror (errno));
+    return FALSE;
+  }
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+void
+_priv_gst_affinity_initialize (void)
+{
+  const gchar *env;
+
+  have_process_affinity = _priv_gst_thread_get_affinity (&process_affinity);
+
+  env = g_getenv ("GST_TASK_CPU_AFFINITY");
+  if (env != NULL && *env != '\0' && strcmp (env, "no") != 0) {
+    if (_priv_gst_cpu_set_parse (&default_affinity, env)) {
+      GST_INFO ("pinning streaming threads to CPUs %s", env);
+      have_default_affinity = TRUE;
+    } else {
+      GST_WARNING ("invalid GST_TASK_CPU_AFFINITY: %s", env);
+    }
+  }
+}
+
+void
+_priv_gst_affinity_cleanup (void)
+{
+  g_mutex_lock (&pinned_sets_lock);
+  if (pinned_sets) {
+    g_array_free (pinned_sets, TRUE);
+    pinned_sets = NULL;
+  }
+  g_mutex_unlock (&pinned_sets_lock);
+}
@@ -49,6 +49,12 @@
 #include "glib-compat-private.h"
 #include "gstmemory.h"
 
+#if defined(HAVE_MBIND) && defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#include <unistd.h>
+#define HAVE_NUMA_SYSMEM 1
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (gst_allocator_debug);
 #define GST_CAT_DEFAULT gst_allocator_debug
 
@@ -370,6 +376,9 @@ typedef struct
 
   gpointer user_data;
   GDestroyNotify notify;
+
+  /* size of the mapping when the block was placed on a NUMA node */
+  gsize map_size;
 } GstMemorySystem;
 
 typedef struct
@@ -398,6 +407,7 @@ _sysmem_init (GstMemorySystem * mem, GstMemoryFlags flags,
   mem->data = data;
   mem->user_data = user_data;
   mem->notify = notify;
+  mem->map_size = 0;
 }
 
 /* create a new memory block that manages the given memory */
@@ -415,13 +425,49 @@ _sysmem_new (GstMemoryFlags flags,
   return mem;
 }
 
+#ifdef HAVE_NUMA_SYSMEM
+/* minimum size of blocks placed on the NUMA node of the allocating thread,
+ * from GST_SYSMEM_NUMA, 0 when disabled */
+static gsize sysmem_numa_min_size = 0;
+
+/* map the block and prefer the node of the calling thread for its pages,
+ * which are only placed when first touched, usually by the producer */
+static GstMemorySystem *
+_sysmem_numa_alloc (gsize * slice_size)
+{
+  static gboolean warned = FALSE;
+  gsize map_size;
+  gpointer block;
+  gint node;
+
+  if ((node = _priv_gst_numa_get_current_node ()) < 0)
+    return NULL;
+
+  map_size = GST_ROUND_UP_N (*slice_size, (gsize) getpagesize ());
+  block = mmap (NULL, map_size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (block == MAP_FAILED)
+    return NULL;
+
+  if (!_priv_gst_numa_bind_memory (block, map_size, node) && !warned) {
+    /* the pages still end up on the node of the first touch */
+    GST_CAT_INFO (GST_CAT_MEMORY, "could not bind memory to NUMA node %d",
+        node);
+    warned = TRUE;
+  }
+
+  *slice_size = map_size;
+  return block;
+}
+#endif
+
 /* allocate the memory and structure in one block */
 static GstMemorySystem *
 _sysmem_new_block (GstMemoryFlags flags,
     gsize maxsize, gsize align, gsize offset, gsize size)
 {
-  GstMemorySystem *mem;
-  gsize aoffset, slice_size, padding;
+  GstMemorySystem *mem = NULL;
+  gsize aoffset, slice_size, padding, map_size = 0;
   guint8 *data;
 
   /* ensure configured alignment */
@@ -431,7 +477,17 @@ _sysmem_new_block (GstMemoryFlags flags,
   /* alloc header and data in one block */
   slice_size = sizeof (GstMemorySystem) + maxsize;
 
-  mem = g_malloc (slice_size);
+#ifdef HAVE_NUMA_SYSMEM
+  if (G_UNLIKELY (sysmem_numa_min_size != 0)
+      && slice_size >= sysmem_numa_min_size) {
+    map_size = slice_size;
+    if ((mem = _sysmem_numa_alloc (&map_size)) == NULL)
+      map_size = 0;
+  }
+#endif
+
+  if (mem == NULL)
+    mem = g_malloc (slice_size);
   if (mem == NULL)
     return NULL;
 
@@ -453,6 +509,7 @@ _sysmem_new_block (GstMemoryFlags flags,
 
   _sysmem_init (mem, flags, NULL, data, maxsize,
       align, offset, size, NULL, NULL);
+  mem->map_size = map_size;
 
   return mem;
 }
@@ -542,6 +599,13 @@ default_free (GstAllocator * allocator, GstMemory * mem)
   if (dmem->notify)
     dmem->notify (dmem->user_data);
 
+#ifdef HAVE_NUMA_SYSMEM
+  if (dmem->map_size) {
+    munmap (mem, dmem->map_size);
+    return;
+  }
+#endif
+
 #ifdef USE_POISONING
   /* just poison the structs, not all the data */
   memset (mem, 0xff, sizeof (GstMemorySystem));
@@ -606,6 +670,19 @@ _priv_gst_allocator_initialize (void)
   GST_CAT_DEBUG (GST_CAT_MEMORY, "memory alignment: %" G_GSIZE_FORMAT,
       gst_memory_alignment);
 
+#ifdef HAVE_NUMA_SYSMEM
+  {
+    const gchar *env = g_getenv ("GST_SYSMEM_NUMA");
+
+    if (env != NULL)
+      sysmem_numa_min_size = g_ascii_strtoull (env, NULL, 10);
+    if (sysmem_numa_min_size)
+      GST_CAT_INFO (GST_CAT_MEMORY, "placing blocks of at least %"
+          G_GSIZE_FORMAT " bytes on the NUMA node of the allocating thread",
+          sysmem_numa_min_size);
+  }
+#endif
+
   _sysmem_allocator = g_object_new (gst_allocator_sysmem_get_type (), NULL);
 
   /* Clear floating flag */
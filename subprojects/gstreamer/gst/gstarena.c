@@ -0,0 +1,299 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gstarena.c: per-thread cache for small core objects
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Events, queries, messages and structures are allocated and freed at a high
+ * rate, often on different threads. When GST_MINIOBJECT_ARENA is set to a
+ * number of blocks, their memory comes from this allocator instead:
+ *
+ * - Sizes are rounded up to one of ARENA_N_CLASSES size classes. Every block
+ *   starts with a small header that stores its class, so that blocks can be
+ *   freed without knowing their size. Larger requests use g_malloc() with the
+ *   same header.
+ * - Every thread keeps a free list per class and allocates from it without
+ *   any locking. Blocks are put on the free list of the thread that frees
+ *   them.
+ * - When a free list gets too long, a magazine of blocks is moved to a
+ *   global depot, and threads with an empty free list take a magazine from
+ *   there, so that blocks flow from consumer back to producer threads with
+ *   one lock operation per magazine.
+ * - New blocks are carved from slabs of one magazine. Slabs are never
+ *   returned to the system, as blocks of a slab can be cached by any thread.
+ *
+ * Allocations and frees are reported with the "arena-alloc" and "arena-free"
+ * tracer hooks, which the leaks tracer uses to keep track of the blocks.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gst_private.h"
+#include "gsttracerutils.h"
+
+#include <string.h>
+
+#define ARENA_HEADER_SIZE 16
+#define ARENA_CLASS_SHIFT 6
+#define ARENA_N_CLASSES 16
+/* 64, 128, ... 1024 bytes, including the header */
+#define ARENA_CLASS_SIZE(c) (((gsize) (c) + 1) << ARENA_CLASS_SHIFT)
+#define ARENA_LARGE ARENA_N_CLASSES
+
+#define ARENA_HEADER(mem) ((guint8 *) (mem) - ARENA_HEADER_SIZE)
+#define ARENA_MEM(block) ((guint8 *) (block) + ARENA_HEADER_SIZE)
+
+typedef struct _ArenaBlock ArenaBlock;
+
+/* the header of a block, the link is only used while on a free list */
+struct _ArenaBlock
+{
+  guint32 n_class;
+  guint32 pad_;
+  ArenaBlock *next;
+};
+
+typedef struct _ArenaMagazine ArenaMagazine;
+
+struct _ArenaMagazine
+{
+  ArenaMagazine *next;
+  ArenaBlock *blocks;
+  guint n_blocks;
+};
+
+typedef struct
+{
+  ArenaBlock *free[ARENA_N_CLASSES];
+  guint n_free[ARENA_N_CLASSES];
+} ArenaThreadCache;
+
+G_STATIC_ASSERT (sizeof (ArenaBlock) <= ARENA_HEADER_SIZE);
+
+static guint arena_magazine_size = 0;
+
+static GMutex arena_lock;
+static ArenaMagazine *arena_depot[ARENA_N_CLASSES];
+/* all slabs, only to keep them reachable */
+static GSList *arena_slabs = NULL;
+
+static void arena_thread_cache_free (gpointer data);
+static GPrivate arena_thread_cache = G_PRIVATE_INIT (arena_thread_cache_free);
+/* set as the cache of a thread once its cache was freed on thread exit, so
+ * that frees from other thread-local destructors don't create a new one */
+static ArenaThreadCache arena_exited_cache;
+
+void
+_priv_gst_arena_initialize (void)
+{
+  const gchar *env;
+
+  env = g_getenv ("GST_MINIOBJECT_ARENA");
+  if (env != NULL && *env != '\0')
+    arena_magazine_size = MIN (g_ascii_strtoull (env, NULL, 10), 65536);
+}
+
+gboolean
+_priv_gst_arena_is_enabled (void)
+{
+  return arena_magazine_size > 0;
+}
+
+/* with arena_lock */
+static void
+arena_depot_push (guint n_class, ArenaBlock * blocks, guint n_blocks)
+{
+  ArenaMagazine *mag = g_new (ArenaMagazine, 1);
+
+  mag->blocks = blocks;
+  mag->n_blocks = n_blocks;
+  mag->next = arena_depot[n_class];
+  arena_depot[n_class] = mag;
+}
+
+static void
+arena_thread_cache_free (gpointer data)
+{
+  ArenaThreadCache *cache = data;
+  guint i;
+
+  if (cache == &arena_exited_cache)
+    return;
+
+  /* the blocks of an exiting thread can still be used by the others */
+  g_mutex_lock (&arena_lock);
+  for (i = 0; i < ARENA_N_CLASSES; i++) {
+    if (cache->free[i])
+      arena_depot_push (i, cache->free[i], cache->n_free[i]);
+  }
+  g_mutex_unlock (&arena_lock);
+
+  g_free (cache);
+  g_private_set (&arena_thread_cache, &arena_exited_cache);
+}
+
+/* returns NULL when the calling thread is exiting and its cache was freed */
+static inline ArenaThreadCache *
+arena_get_thread_cache (void)
+{
+  ArenaThreadCache *cache = g_private_get (&arena_thread_cache);
+
+  if (G_UNLIKELY (cache == NULL)) {
+    cache = g_new0 (ArenaThreadCache, 1);
+    g_private_set (&arena_thread_cache, cache);
+  } else if (G_UNLIKELY (cache == &arena_exited_cache)) {
+    cache = NULL;
+  }
+  return cache;
+}
+
+/* refills the empty free list of @n_class from the depot or a new slab */
+static void
+arena_refill (ArenaThreadCache * cache, guint n_class)
+{
+  ArenaMagazine *mag;
+  gsize block_size;
+  guint8 *slab;
+  guint i;
+
+  g_mutex_lock (&arena_lock);
+  mag = arena_depot[n_class];
+  if (mag) {
+    arena_depot[n_class] = mag->next;
+    g_mutex_unlock (&arena_lock);
+
+    cache->free[n_class] = mag->blocks;
+    cache->n_free[n_class] = mag->n_blocks;
+    g_free (mag);
+    return;
+  }
+
+  block_size = ARENA_CLASS_SIZE (n_class);
+  slab = g_malloc (block_size * arena_magazine_size);
+  arena_slabs = g_slist_prepend (arena_slabs, slab);
+  g_mutex_unlock (&arena_lock);
+
+  for (i = 0; i < arena_magazine_size; i++) {
+    ArenaBlock *block = (ArenaBlock *) (slab + i * block_size);
+
+    block->n_class = n_class;
+    block->next = i + 1 < arena_magazine_size ?
+        (ArenaBlock *) (slab + (i + 1) * block_size) : NULL;
+  }
+  cache->free[n_class] = (ArenaBlock *) slab;
+  cache->n_free[n_class] = arena_magazine_size;
+}
+
+/* Allocates @size bytes of zeroed memory from the calling thread's cache when
+ * GST_MINIOBJECT_ARENA is set, or with g_malloc0() otherwise. The memory must
+ * be freed with _priv_gst_arena_free(). */
+gpointer
+_priv_gst_arena_alloc0 (gsize size)
+{
+  ArenaThreadCache *cache;
+  ArenaBlock *block;
+  guint n_class;
+  gpointer mem;
+
+  if (arena_magazine_size == 0)
+    return g_malloc0 (size);
+
+  n_class = (size + ARENA_HEADER_SIZE - 1) >> ARENA_CLASS_SHIFT;
+  if (G_LIKELY (n_class < ARENA_N_CLASSES))
+    cache = arena_get_thread_cache ();
+  else
+    cache = NULL;
+
+  if (G_UNLIKELY (cache == NULL)) {
+    /* too large, or the thread is exiting */
+    block = g_malloc (ARENA_HEADER_SIZE + size);
+    block->n_class = ARENA_LARGE;
+  } else {
+    if (G_UNLIKELY (cache->free[n_class] == NULL))
+      arena_refill (cache, n_class);
+
+    block = cache->free[n_class];
+    cache->free[n_class] = block->next;
+    cache->n_free[n_class]--;
+  }
+
+  mem = ARENA_MEM (block);
+  memset (mem, 0, size);
+
+  GST_TRACER_ARENA_ALLOC (mem, size);
+
+  return mem;
+}
+
+/* Frees @mem, allocated with _priv_gst_arena_alloc0(), by putting it on the
+ * calling thread's cache. */
+void
+_priv_gst_arena_free (gpointer mem)
+{
+  ArenaThreadCache *cache;
+  ArenaBlock *block;
+  guint n_class;
+
+  if (arena_magazine_size == 0) {
+    g_free (mem);
+    return;
+  }
+
+  if (mem == NULL)
+    return;
+
+  GST_TRACER_ARENA_FREE (mem);
+
+  block = (ArenaBlock *) ARENA_HEADER (mem);
+  n_class = block->n_class;
+  if (G_UNLIKELY (n_class == ARENA_LARGE)) {
+    g_free (block);
+    return;
+  }
+
+  cache = arena_get_thread_cache ();
+  if (G_UNLIKELY (cache == NULL)) {
+    /* the thread is exiting, hand the block to the depot directly */
+    block->next = NULL;
+    g_mutex_lock (&arena_lock);
+    arena_depot_push (n_class, block, 1);
+    g_mutex_unlock (&arena_lock);
+    return;
+  }
+
+  block->next = cache->free[n_class];
+  cache->free[n_class] = block;
+
+  /* give a magazine back so that other threads can use it */
+  if (G_UNLIKELY (++cache->n_free[n_class] >= 2 * arena_magazine_size)) {
+    ArenaBlock *blocks = block, *last = block;
+    guint i;
+
+    for (i = 1; i < arena_magazine_size; i++)
+      last = last->next;
+    cache->free[n_class] = last->next;
+    cache->n_free[n_class] -= arena_magazine_size;
+    last->next = NULL;
+
+    g_mutex_lock (&arena_lock);
+    arena_depot_push (n_class, blocks, arena_magazine_size);
+    g_mutex_unlock (&arena_lock);
+  }
+}
@@ -172,6 +172,10 @@ struct _GstBinPrivate
   gboolean posted_eos;
   gboolean posted_playing;
   GstElementFlags suppressed_flags;
+
+  /* CPUs to pin the streaming threads of our children to */
+  gchar *cpu_affinity;
+  GstCpuSet cpu_set;
 };
 
 typedef struct
@@ -246,12 +250,14 @@ enum
 
 #define DEFAULT_ASYNC_HANDLING	FALSE
 #define DEFAULT_MESSAGE_FORWARD	FALSE
+#define DEFAULT_CPU_AFFINITY	NULL
 
 enum
 {
   PROP_0,
   PROP_ASYNC_HANDLING,
   PROP_MESSAGE_FORWARD,
+  PROP_CPU_AFFINITY,
   PROP_LAST
 };
 
@@ -445,6 +451,31 @@ gst_bin_class_init (GstBinClass * klass)
           "Forwards all children messages",
           DEFAULT_MESSAGE_FORWARD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBin:cpu-affinity:
+   *
+   * Pin the streaming threads of the elements in the bin to a set of CPUs,
+   * given as a list of CPUs and CPU ranges such as "0-15,32-47". The thread
+   * is pinned when its task posts the %GST_STREAM_STATUS_TYPE_ENTER message,
+   * and the "cpu-affinity" and "numa-node" fields of that message are updated
+   * accordingly. When bins are nested, the innermost bin with a cpu-affinity
+   * wins.
+   *
+   * Threads of tasks running on a shared #GstTaskPool, like the cooperative
+   * tasks of a #GstWorkStealingTaskPool, are not pinned. The default for all
+   * other streaming threads can be set with the `GST_TASK_CPU_AFFINITY`
+   * environment variable.
+   *
+   * This is only supported on Linux.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_CPU_AFFINITY,
+      g_param_spec_string ("cpu-affinity", "CPU Affinity",
+          "CPUs to pin the streaming threads to, e.g. \"0-15,32-47\" "
+          "(NULL = don't pin)", DEFAULT_CPU_AFFINITY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->dispose = gst_bin_dispose;
 
   gst_element_class_set_static_metadata (gstelement_class, "Generic bin",
@@ -521,6 +552,10 @@ gst_bin_dispose (GObject * object)
   gst_object_replace ((GstObject **) provided_clock_p, NULL);
   gst_object_replace ((GstObject **) clock_provider_p, NULL);
   bin_remove_messages (bin, NULL, GST_MESSAGE_ANY);
+  if (bin->priv->cpu_affinity) {
+    _priv_gst_affinity_bin_changed (FALSE);
+    g_clear_pointer (&bin->priv->cpu_affinity, g_free);
+  }
   GST_OBJECT_UNLOCK (object);
 
   while (bin->children) {
@@ -567,6 +602,27 @@ gst_bin_set_property (GObject * object, guint prop_id,
       gstbin->priv->message_forward = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_CPU_AFFINITY:
+    {
+      const gchar *cpu_affinity = g_value_get_string (value);
+      GstCpuSet cpu_set;
+
+      if (cpu_affinity && !_priv_gst_cpu_set_parse (&cpu_set, cpu_affinity)) {
+        g_warning ("%s: invalid cpu-affinity '%s'",
+            GST_OBJECT_NAME (gstbin), cpu_affinity);
+        break;
+      }
+
+      GST_OBJECT_LOCK (gstbin);
+      if ((gstbin->priv->cpu_affinity != NULL) != (cpu_affinity != NULL))
+        _priv_gst_affinity_bin_changed (cpu_affinity != NULL);
+      g_free (gstbin->priv->cpu_affinity);
+      gstbin->priv->cpu_affinity = g_strdup (cpu_affinity);
+      if (cpu_affinity)
+        gstbin->priv->cpu_set = cpu_set;
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -592,6 +648,11 @@ gst_bin_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, gstbin->priv->message_forward);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_CPU_AFFINITY:
+      GST_OBJECT_LOCK (gstbin);
+      g_value_set_string (value, gstbin->priv->cpu_affinity);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3690,6 +3751,88 @@ gst_bin_update_context_unlocked (GstBin * bin, GstContext * context)
  *
  * OTHER: post upwards.
  */
+/* an inner bin with its own cpu-affinity already pinned the thread */
+static gboolean
+bin_has_inner_cpu_affinity (GstBin * bin, GstObject * src)
+{
+  GstObject *parent;
+  gboolean result = FALSE;
+
+  parent = src ? gst_object_get_parent (src) : NULL;
+  while (parent && parent != GST_OBJECT_CAST (bin)) {
+    GstObject *next;
+
+    if (GST_IS_BIN (parent)) {
+      GST_OBJECT_LOCK (parent);
+      result = GST_BIN_CAST (parent)->priv->cpu_affinity != NULL;
+      GST_OBJECT_UNLOCK (parent);
+      if (result)
+        break;
+    }
+    next = gst_object_get_parent (parent);
+    gst_object_unref (parent);
+    parent = next;
+  }
+  if (parent)
+    gst_object_unref (parent);
+
+  return result;
+}
+
+/* called from the streaming thread when its task posts the ENTER
+ * stream-status message */
+static GstMessage *
+bin_apply_cpu_affinity (GstBin * bin, GstMessage * message)
+{
+  const GValue *val;
+  GstTask *task;
+  GstCpuSet cpu_set;
+  gboolean own_thread;
+  gchar *cpulist;
+
+  GST_OBJECT_LOCK (bin);
+  if (G_LIKELY (bin->priv->cpu_affinity == NULL)) {
+    GST_OBJECT_UNLOCK (bin);
+    return message;
+  }
+  cpu_set = bin->priv->cpu_set;
+  GST_OBJECT_UNLOCK (bin);
+
+  val = gst_message_get_stream_status_object (message);
+  if (val == NULL || !G_VALUE_HOLDS (val, GST_TYPE_TASK) ||
+      (task = g_value_get_object (val)) == NULL)
+    return message;
+
+  /* only tasks that own their thread are pinned, the thread of a cooperative
+   * task is only set while it runs an iteration and shared with others */
+  GST_OBJECT_LOCK (task);
+  own_thread = task->thread == g_thread_self ();
+  GST_OBJECT_UNLOCK (task);
+  if (!own_thread)
+    return message;
+
+  if (bin_has_inner_cpu_affinity (bin, GST_MESSAGE_SRC (message)))
+    return message;
+
+  if (!_priv_gst_thread_set_affinity (&cpu_set))
+    return message;
+
+  if (!_priv_gst_thread_get_affinity (&cpu_set))
+    return message;
+
+  cpulist = _priv_gst_cpu_set_to_string (&cpu_set);
+  GST_DEBUG_OBJECT (bin, "pinned streaming thread of %" GST_PTR_FORMAT
+      " to CPUs %s", task, cpulist);
+
+  message = gst_message_make_writable (message);
+  gst_structure_set (gst_message_writable_structure (message),
+      "cpu-affinity", G_TYPE_STRING, cpulist,
+      "numa-node", G_TYPE_INT, _priv_gst_numa_get_thread_node (), NULL);
+  g_free (cpulist);
+
+  return message;
+}
+
 static void
 gst_bin_handle_message_func (GstBin * bin, GstMessage * message)
 {
@@ -4024,6 +4167,16 @@ gst_bin_handle_message_func (GstBin * bin, GstMessage * message)
 
       break;
     }
+    case GST_MESSAGE_STREAM_STATUS:
+    {
+      GstStreamStatusType status;
+
+      gst_message_parse_stream_status (message, &status, NULL);
+      if (status == GST_STREAM_STATUS_TYPE_ENTER)
+        message = bin_apply_cpu_affinity (bin, message);
+
+      goto forward;
+    }
     case GST_MESSAGE_HAVE_CONTEXT:{
       GstContext *context;
 
@@ -70,7 +70,7 @@
 #endif
 #include <sys/types.h>
 
-#include "gstvecdeque.h"
+#include "gstatomicqueue.h"
 #include "gstinfo.h"
 #include "gstquark.h"
 #include "gstvalue.h"
@@ -91,9 +91,13 @@ GST_DEBUG_CATEGORY_STATIC (gst_buffer_pool_debug);
 
 struct _GstBufferPoolPrivate
 {
+  /* free buffers, pushed and popped without taking a lock */
+  GstAtomicQueue *queue;
+  /* only used when acquire_buffer needs to wait for a buffer, releasing
+   * takes the lock only when there are waiters */
   GMutex queue_lock;
   GCond queue_cond;
-  GstVecDeque *queue;
+  gint waiters;
 
   GRecMutex rec_lock;
 
@@ -159,7 +163,7 @@ gst_buffer_pool_init (GstBufferPool * pool)
 
   g_rec_mutex_init (&priv->rec_lock);
 
-  priv->queue = gst_vec_deque_new (16);
+  priv->queue = gst_atomic_queue_new (16);
   g_mutex_init (&priv->queue_lock);
   g_cond_init (&priv->queue_cond);
 
@@ -205,7 +209,7 @@ gst_buffer_pool_finalize (GObject * object)
 
   GST_DEBUG_OBJECT (pool, "%p finalize", pool);
 
-  gst_vec_deque_free (priv->queue);
+  gst_atomic_queue_unref (priv->queue);
   g_mutex_clear (&priv->queue_lock);
   g_cond_clear (&priv->queue_cond);
   gst_structure_free (priv->config);
@@ -381,6 +385,21 @@ default_free_buffer (GstBufferPool * pool, GstBuffer * buffer)
   gst_buffer_unref (buffer);
 }
 
+/* wake up a thread waiting in acquire_buffer after a buffer was queued or
+ * freed. A waiter registers itself with the queue lock before checking the
+ * queue, so it either sees the change or gets signalled. */
+static inline void
+wakeup_waiters (GstBufferPool * pool)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+
+  if (g_atomic_int_get (&priv->waiters) > 0) {
+    g_mutex_lock (&priv->queue_lock);
+    g_cond_signal (&priv->queue_cond);
+    g_mutex_unlock (&priv->queue_lock);
+  }
+}
+
 static void
 do_free_buffer (GstBufferPool * pool, GstBuffer * buffer)
 {
@@ -397,9 +416,7 @@ do_free_buffer (GstBufferPool * pool, GstBuffer * buffer)
   if (G_LIKELY (pclass->free_buffer))
     pclass->free_buffer (pool, buffer);
 
-  g_mutex_lock (&priv->queue_lock);
-  g_cond_signal (&priv->queue_cond);
-  g_mutex_unlock (&priv->queue_lock);
+  wakeup_waiters (pool);
 }
 
 /* must be called with the lock */
@@ -411,14 +428,10 @@ default_stop (GstBufferPool * pool)
   gboolean cleared;
 
   /* clear the pool */
-  g_mutex_lock (&priv->queue_lock);
-  while ((buffer = gst_vec_deque_pop_head (priv->queue))) {
-    g_mutex_unlock (&priv->queue_lock);
+  while ((buffer = gst_atomic_queue_pop (priv->queue)))
     do_free_buffer (pool, buffer);
-    g_mutex_lock (&priv->queue_lock);
-  }
-  cleared = priv->cur_buffers == 0;
-  g_mutex_unlock (&priv->queue_lock);
+
+  cleared = g_atomic_int_get (&priv->cur_buffers) == 0;
   return cleared;
 }
 
@@ -1099,14 +1112,12 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
   GstFlowReturn result;
   GstBufferPoolPrivate *priv = pool->priv;
 
-  g_mutex_lock (&priv->queue_lock);
   while (TRUE) {
     if (G_UNLIKELY (GST_BUFFER_POOL_IS_FLUSHING (pool)))
       goto flushing;
 
     /* try to get a buffer from the queue */
-    *buffer = gst_vec_deque_pop_head (priv->queue);
-    g_mutex_unlock (&priv->queue_lock);
+    *buffer = gst_atomic_queue_pop (priv->queue);
 
     if (G_LIKELY (*buffer)) {
       result = GST_FLOW_OK;
@@ -1133,13 +1144,16 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
 
     /* now we wait for a buffer release or flushing */
     g_mutex_lock (&priv->queue_lock);
-    while (gst_vec_deque_get_length (priv->queue) == 0
+    g_atomic_int_inc (&priv->waiters);
+    while (gst_atomic_queue_length (priv->queue) == 0
         && !GST_BUFFER_POOL_IS_FLUSHING (pool)
         && g_atomic_int_get (&priv->cur_buffers) >= priv->max_buffers) {
       GST_LOG_OBJECT (pool, "waiting for free buffers or flushing");
       g_cond_wait (&priv->queue_cond, &priv->queue_lock);
       GST_LOG_OBJECT (pool, "waited for free buffers or flushing");
     }
+    g_atomic_int_add (&priv->waiters, -1);
+    g_mutex_unlock (&priv->queue_lock);
   }
 
   return result;
@@ -1147,7 +1161,6 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
   /* ERRORS */
 flushing:
   {
-    g_mutex_unlock (&priv->queue_lock);
     GST_DEBUG_OBJECT (pool, "we are flushing");
     return GST_FLOW_FLUSHING;
   }
@@ -1291,10 +1304,8 @@ default_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
     goto not_writable;
 
   /* keep it around in our queue */
-  g_mutex_lock (&pool->priv->queue_lock);
-  gst_vec_deque_push_tail (pool->priv->queue, buffer);
-  g_cond_signal (&pool->priv->queue_cond);
-  g_mutex_unlock (&pool->priv->queue_lock);
+  gst_atomic_queue_push (pool->priv->queue, buffer);
+  wakeup_waiters (pool);
 
   return;
 
@@ -1320,10 +1331,6 @@ not_writable:
 discard:
   {
     do_free_buffer (pool, buffer);
-
-    g_mutex_lock (&pool->priv->queue_lock);
-    g_cond_signal (&pool->priv->queue_cond);
-    g_mutex_unlock (&pool->priv->queue_lock);
     return;
   }
 }
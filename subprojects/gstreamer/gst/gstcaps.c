@@ -136,11 +136,69 @@ GstCaps *_gst_caps_none;
 
 GST_DEFINE_MINI_OBJECT_TYPE (GstCaps, gst_caps);
 
+/* caps cache
+ *
+ * Optional memoization of gst_caps_intersect_full() and gst_caps_is_subset(),
+ * enabled by setting GST_CAPS_CACHE to the maximum number of entries. Both
+ * are pure functions of their arguments, so entries never become stale and
+ * only the least recently used entry is evicted when the cache is full.
+ * Keys are compared in order, including the order of fields and list values,
+ * since the result of an intersection depends on it.
+ * Arguments are copied into the cache, unless they are static caps, since the
+ * caller might still modify them, and results are handed out as copies for
+ * the same reason.
+ */
+typedef enum
+{
+  CAPS_CACHE_INTERSECT_ZIG_ZAG = GST_CAPS_INTERSECT_ZIG_ZAG,
+  CAPS_CACHE_INTERSECT_FIRST = GST_CAPS_INTERSECT_FIRST,
+  CAPS_CACHE_IS_SUBSET
+} CapsCacheOp;
+
+typedef struct
+{
+  CapsCacheOp op;
+  guint hash;
+  GstCaps *caps1;
+  GstCaps *caps2;
+  /* the intersection, NULL for subset checks */
+  GstCaps *result;
+  gboolean is_subset;
+  /* in caps_cache_lru */
+  GList link;
+} CapsCacheEntry;
+
+static GMutex caps_cache_lock;
+static guint caps_cache_max_entries = 0;
+static GHashTable *caps_cache = NULL;
+/* most recently used entries first */
+static GQueue caps_cache_lru = G_QUEUE_INIT;
+
+static void caps_cache_entry_free (CapsCacheEntry * entry);
+static guint caps_cache_entry_hash (gconstpointer key);
+static gboolean caps_cache_entry_equal (gconstpointer a, gconstpointer b);
+static gboolean caps_cache_lookup (CapsCacheOp op, const GstCaps * caps1,
+    const GstCaps * caps2, guint * hash, GstCaps ** result,
+    gboolean * is_subset);
+static void caps_cache_insert (CapsCacheOp op, guint hash,
+    const GstCaps * caps1, const GstCaps * caps2, const GstCaps * result,
+    gboolean is_subset);
+
 void
 _priv_gst_caps_initialize (void)
 {
+  const gchar *env;
+
   _gst_caps_type = gst_caps_get_type ();
 
+  env = g_getenv ("GST_CAPS_CACHE");
+  if (env != NULL && *env != '\0')
+    caps_cache_max_entries = g_ascii_strtoull (env, NULL, 10);
+  if (caps_cache_max_entries > 0) {
+    caps_cache = g_hash_table_new_full (caps_cache_entry_hash,
+        caps_cache_entry_equal, (GDestroyNotify) caps_cache_entry_free, NULL);
+  }
+
   _gst_caps_any = gst_caps_new_any ();
   _gst_caps_none = gst_caps_new_empty ();
 
@@ -151,6 +209,13 @@ _priv_gst_caps_initialize (void)
 void
 _priv_gst_caps_cleanup (void)
 {
+  if (caps_cache) {
+    g_hash_table_unref (caps_cache);
+    caps_cache = NULL;
+    g_queue_init (&caps_cache_lru);
+    caps_cache_max_entries = 0;
+  }
+
   gst_caps_unref (_gst_caps_any);
   _gst_caps_any = NULL;
   gst_caps_unref (_gst_caps_none);
@@ -1309,31 +1374,15 @@ gst_caps_is_always_compatible (const GstCaps * caps1, const GstCaps * caps2)
   return gst_caps_is_subset (caps1, caps2);
 }
 
-/**
- * gst_caps_is_subset:
- * @subset: a #GstCaps
- * @superset: a potentially greater #GstCaps
- *
- * Checks if all caps represented by @subset are also represented by @superset.
- *
- * Returns: %TRUE if @subset is a subset of @superset
- */
-gboolean
-gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
+static gboolean
+gst_caps_is_subset_uncached (const GstCaps * subset,
+    const GstCaps * superset)
 {
   GstStructure *s1, *s2;
   GstCapsFeatures *f1, *f2;
   gboolean ret = TRUE;
   gint i, j;
 
-  g_return_val_if_fail (subset != NULL, FALSE);
-  g_return_val_if_fail (superset != NULL, FALSE);
-
-  if (CAPS_IS_EMPTY (subset) || CAPS_IS_ANY (superset))
-    return TRUE;
-  if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
-    return FALSE;
-
   for (i = GST_CAPS_LEN (subset) - 1; i >= 0; i--) {
     s1 = gst_caps_get_structure_unchecked (subset, i);
     f1 = gst_caps_get_features_unchecked (subset, i);
@@ -1365,6 +1414,42 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   return ret;
 }
 
+/**
+ * gst_caps_is_subset:
+ * @subset: a #GstCaps
+ * @superset: a potentially greater #GstCaps
+ *
+ * Checks if all caps represented by @subset are also represented by @superset.
+ *
+ * Returns: %TRUE if @subset is a subset of @superset
+ */
+gboolean
+gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
+{
+  gboolean ret;
+  guint hash;
+
+  g_return_val_if_fail (subset != NULL, FALSE);
+  g_return_val_if_fail (superset != NULL, FALSE);
+
+  if (CAPS_IS_EMPTY (subset) || CAPS_IS_ANY (superset))
+    return TRUE;
+  if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
+    return FALSE;
+
+  if (G_LIKELY (caps_cache == NULL))
+    return gst_caps_is_subset_uncached (subset, superset);
+
+  if (caps_cache_lookup (CAPS_CACHE_IS_SUBSET, subset, superset, &hash, NULL,
+          &ret))
+    return ret;
+
+  ret = gst_caps_is_subset_uncached (subset, superset);
+  caps_cache_insert (CAPS_CACHE_IS_SUBSET, hash, subset, superset, NULL, ret);
+
+  return ret;
+}
+
 /**
  * gst_caps_is_subset_structure:
  * @caps: a #GstCaps
@@ -1523,6 +1608,288 @@ gst_caps_is_strictly_equal (const GstCaps * caps1, const GstCaps * caps2)
   return TRUE;
 }
 
+/* caps cache */
+
+static gboolean
+caps_cache_hash_field (GQuark field_id, const GValue * value, gpointer user_data)
+{
+  guint *hash = user_data;
+
+  *hash = *hash * 31 + field_id;
+
+  /* only the cheap to hash values, the equality check does the rest */
+  if (G_VALUE_TYPE (value) == G_TYPE_INT)
+    *hash = *hash * 31 + g_value_get_int (value);
+  else if (G_VALUE_TYPE (value) == G_TYPE_STRING && g_value_get_string (value))
+    *hash = *hash * 31 + g_str_hash (g_value_get_string (value));
+
+  return TRUE;
+}
+
+static guint
+caps_cache_hash_caps (const GstCaps * caps)
+{
+  GstStructure *s;
+  GstCapsFeatures *f;
+  guint i, n, hash;
+
+  if (CAPS_IS_ANY (caps))
+    return 1;
+
+  hash = n = GST_CAPS_LEN (caps);
+  for (i = 0; i < n; i++) {
+    s = gst_caps_get_structure_unchecked (caps, i);
+    f = gst_caps_get_features_unchecked (caps, i);
+
+    hash = hash * 31 + gst_structure_get_name_id (s);
+    if (f)
+      hash = hash * 31 + gst_caps_features_get_size (f);
+    gst_structure_foreach (s, caps_cache_hash_field, &hash);
+  }
+
+  return hash;
+}
+
+static guint
+caps_cache_entry_hash (gconstpointer key)
+{
+  return ((const CapsCacheEntry *) key)->hash;
+}
+
+static gboolean caps_cache_structure_equal (const GstStructure * s1,
+    const GstStructure * s2);
+static gboolean caps_cache_caps_equal (const GstCaps * caps1,
+    const GstCaps * caps2);
+
+/* Unlike gst_value_compare(), this also requires lists to have the same
+ * order. The result of an intersection keeps the order of the list values,
+ * so caps that only differ in that order must not share an entry. */
+static gboolean
+caps_cache_value_equal (const GValue * value1, const GValue * value2)
+{
+  guint i, n;
+
+  if (G_VALUE_TYPE (value1) != G_VALUE_TYPE (value2))
+    return FALSE;
+
+  if (GST_VALUE_HOLDS_LIST (value1)) {
+    n = gst_value_list_get_size (value1);
+    if (n != gst_value_list_get_size (value2))
+      return FALSE;
+    for (i = 0; i < n; i++) {
+      if (!caps_cache_value_equal (gst_value_list_get_value (value1, i),
+              gst_value_list_get_value (value2, i)))
+        return FALSE;
+    }
+    return TRUE;
+  }
+
+  if (GST_VALUE_HOLDS_ARRAY (value1)) {
+    n = gst_value_array_get_size (value1);
+    if (n != gst_value_array_get_size (value2))
+      return FALSE;
+    for (i = 0; i < n; i++) {
+      if (!caps_cache_value_equal (gst_value_array_get_value (value1, i),
+              gst_value_array_get_value (value2, i)))
+        return FALSE;
+    }
+    return TRUE;
+  }
+
+  if (GST_VALUE_HOLDS_STRUCTURE (value1)) {
+    return caps_cache_structure_equal (gst_value_get_structure (value1),
+        gst_value_get_structure (value2));
+  }
+
+  if (GST_VALUE_HOLDS_CAPS (value1)) {
+    return caps_cache_caps_equal (gst_value_get_caps (value1),
+        gst_value_get_caps (value2));
+  }
+
+  return gst_value_compare (value1, value2) == GST_VALUE_EQUAL;
+}
+
+/* fields are compared in order, see caps_cache_value_equal() */
+static gboolean
+caps_cache_structure_equal (const GstStructure * s1, const GstStructure * s2)
+{
+  const gchar *name;
+  guint i, n;
+
+  if (s1 == s2)
+    return TRUE;
+
+  if (s1 == NULL || s2 == NULL)
+    return FALSE;
+
+  if (gst_structure_get_name_id (s1) != gst_structure_get_name_id (s2))
+    return FALSE;
+
+  n = gst_structure_n_fields (s1);
+  if (n != gst_structure_n_fields (s2))
+    return FALSE;
+
+  for (i = 0; i < n; i++) {
+    name = gst_structure_nth_field_name (s1, i);
+    if (strcmp (name, gst_structure_nth_field_name (s2, i)) != 0)
+      return FALSE;
+    if (!caps_cache_value_equal (gst_structure_get_value (s1, name),
+            gst_structure_get_value (s2, name)))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+caps_cache_caps_equal (const GstCaps * caps1, const GstCaps * caps2)
+{
+  GstCapsFeatures *f1, *f2;
+  guint i, j, n;
+
+  if (caps1 == caps2)
+    return TRUE;
+
+  if (caps1 == NULL || caps2 == NULL)
+    return FALSE;
+
+  if (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2))
+    return CAPS_IS_ANY (caps1) && CAPS_IS_ANY (caps2);
+
+  n = GST_CAPS_LEN (caps1);
+  if (n != GST_CAPS_LEN (caps2))
+    return FALSE;
+
+  for (i = 0; i < n; i++) {
+    f1 = gst_caps_get_features_unchecked (caps1, i);
+    if (!f1)
+      f1 = GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY;
+    f2 = gst_caps_get_features_unchecked (caps2, i);
+    if (!f2)
+      f2 = GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY;
+
+    if (gst_caps_features_is_any (f1) != gst_caps_features_is_any (f2) ||
+        gst_caps_features_get_size (f1) != gst_caps_features_get_size (f2))
+      return FALSE;
+    for (j = 0; j < gst_caps_features_get_size (f1); j++) {
+      if (strcmp (gst_caps_features_get_nth (f1, j),
+              gst_caps_features_get_nth (f2, j)) != 0)
+        return FALSE;
+    }
+
+    if (!caps_cache_structure_equal (gst_caps_get_structure_unchecked (caps1,
+                i), gst_caps_get_structure_unchecked (caps2, i)))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+caps_cache_entry_equal (gconstpointer a, gconstpointer b)
+{
+  const CapsCacheEntry *ea = a, *eb = b;
+
+  return ea->op == eb->op && ea->hash == eb->hash &&
+      caps_cache_caps_equal (ea->caps1, eb->caps1) &&
+      caps_cache_caps_equal (ea->caps2, eb->caps2);
+}
+
+static void
+caps_cache_entry_free (CapsCacheEntry * entry)
+{
+  gst_caps_unref (entry->caps1);
+  gst_caps_unref (entry->caps2);
+  if (entry->result)
+    gst_caps_unref (entry->result);
+  g_free (entry);
+}
+
+/* static caps are never modified or freed, so they don't need a copy */
+static GstCaps *
+caps_cache_key_copy (const GstCaps * caps)
+{
+  if (GST_MINI_OBJECT_FLAG_IS_SET (caps, GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED))
+    return gst_caps_ref ((GstCaps *) caps);
+
+  return gst_caps_copy (caps);
+}
+
+/* Looks up the result of @op for @caps1 and @caps2. Returns %TRUE and a copy
+ * of the intersection in @result, or the subset check in @is_subset, when
+ * found. @hash is set to the hash of the entry for caps_cache_insert(). */
+static gboolean
+caps_cache_lookup (CapsCacheOp op, const GstCaps * caps1,
+    const GstCaps * caps2, guint * hash, GstCaps ** result,
+    gboolean * is_subset)
+{
+  CapsCacheEntry key, *entry;
+  GstCaps *cached = NULL;
+
+  key.op = op;
+  key.hash = (caps_cache_hash_caps (caps1) * 31 +
+      caps_cache_hash_caps (caps2)) * 31 + op;
+  key.caps1 = (GstCaps *) caps1;
+  key.caps2 = (GstCaps *) caps2;
+  *hash = key.hash;
+
+  g_mutex_lock (&caps_cache_lock);
+  entry = g_hash_table_lookup (caps_cache, &key);
+  if (entry) {
+    g_queue_unlink (&caps_cache_lru, &entry->link);
+    g_queue_push_head_link (&caps_cache_lru, &entry->link);
+    if (entry->result)
+      cached = gst_caps_ref (entry->result);
+    if (is_subset)
+      *is_subset = entry->is_subset;
+  }
+  g_mutex_unlock (&caps_cache_lock);
+
+  GST_TRACER_CAPS_CACHE_LOOKUP (caps1, caps2, entry != NULL);
+
+  if (cached) {
+    *result = gst_caps_copy (cached);
+    gst_caps_unref (cached);
+  }
+
+  return entry != NULL;
+}
+
+static void
+caps_cache_insert (CapsCacheOp op, guint hash, const GstCaps * caps1,
+    const GstCaps * caps2, const GstCaps * result, gboolean is_subset)
+{
+  CapsCacheEntry *entry;
+
+  entry = g_new0 (CapsCacheEntry, 1);
+  entry->op = op;
+  entry->hash = hash;
+  entry->caps1 = caps_cache_key_copy (caps1);
+  entry->caps2 = caps_cache_key_copy (caps2);
+  entry->result = result ? gst_caps_copy (result) : NULL;
+  entry->is_subset = is_subset;
+  entry->link.data = entry;
+
+  g_mutex_lock (&caps_cache_lock);
+  /* another thread might have been faster */
+  if (g_hash_table_contains (caps_cache, entry)) {
+    g_mutex_unlock (&caps_cache_lock);
+    caps_cache_entry_free (entry);
+    return;
+  }
+
+  g_hash_table_add (caps_cache, entry);
+  g_queue_push_head_link (&caps_cache_lru, &entry->link);
+
+  while (caps_cache_lru.length > caps_cache_max_entries) {
+    CapsCacheEntry *oldest = caps_cache_lru.tail->data;
+
+    g_queue_unlink (&caps_cache_lru, &oldest->link);
+    g_hash_table_remove (caps_cache, oldest);
+  }
+  g_mutex_unlock (&caps_cache_lock);
+}
+
 /* intersect operation */
 
 /**
@@ -1739,6 +2106,16 @@ gst_caps_intersect_first (GstCaps * caps1, GstCaps * caps2)
   return dest;
 }
 
+static GstCaps *
+gst_caps_intersect_uncached (GstCaps * caps1, GstCaps * caps2,
+    GstCapsIntersectMode mode)
+{
+  if (mode == GST_CAPS_INTERSECT_FIRST)
+    return gst_caps_intersect_first (caps1, caps2);
+
+  return gst_caps_intersect_zig_zag (caps1, caps2);
+}
+
 /**
  * gst_caps_intersect_full:
  * @caps1: a #GstCaps to intersect
@@ -1755,6 +2132,9 @@ GstCaps *
 gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
     GstCapsIntersectMode mode)
 {
+  GstCaps *result;
+  guint hash;
+
   g_return_val_if_fail (GST_IS_CAPS (caps1), NULL);
   g_return_val_if_fail (GST_IS_CAPS (caps2), NULL);
 
@@ -1774,15 +2154,22 @@ gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
   if (G_UNLIKELY (CAPS_IS_ANY (caps2)))
     return gst_caps_ref (caps1);
 
-  switch (mode) {
-    case GST_CAPS_INTERSECT_FIRST:
-      return gst_caps_intersect_first (caps1, caps2);
-    default:
-      g_warning ("Unknown caps intersect mode: %d", mode);
-      /* fallthrough */
-    case GST_CAPS_INTERSECT_ZIG_ZAG:
-      return gst_caps_intersect_zig_zag (caps1, caps2);
+  if (mode != GST_CAPS_INTERSECT_FIRST && mode != GST_CAPS_INTERSECT_ZIG_ZAG) {
+    g_warning ("Unknown caps intersect mode: %d", mode);
+    mode = GST_CAPS_INTERSECT_ZIG_ZAG;
   }
+
+  if (G_LIKELY (caps_cache == NULL))
+    return gst_caps_intersect_uncached (caps1, caps2, mode);
+
+  if (caps_cache_lookup ((CapsCacheOp) mode, caps1, caps2, &hash, &result,
+          NULL))
+    return result;
+
+  result = gst_caps_intersect_uncached (caps1, caps2, mode);
+  caps_cache_insert ((CapsCacheOp) mode, hash, caps1, caps2, result, FALSE);
+
+  return result;
 }
 
 /**
@@ -391,6 +391,16 @@ _priv_gst_debug_init (void)
   const gchar *env;
   FILE *log_file;
 
+  env = g_getenv ("GST_DEBUG_BINARY_FILE");
+  if (add_default_log_func && env != NULL && *env != '\0') {
+    gchar *name = _priv_gst_debug_file_name (env);
+
+    /* fall back to the default log function if the file can't be opened */
+    if (gst_debug_add_binary_logger (name, 0))
+      add_default_log_func = FALSE;
+    g_free (name);
+  }
+
   if (add_default_log_func) {
     env = g_getenv ("GST_DEBUG_FILE");
     if (env != NULL && *env != '\0') {
@@ -2558,6 +2568,18 @@ _priv_gst_debug_cleanup (void)
 
   g_mutex_unlock (&__dbg_functions_mutex);
 
+  /* log functions might still write out pending messages that refer to the
+   * categories, so remove them first */
+  g_mutex_lock (&__log_func_mutex);
+  while (__log_functions) {
+    LogFuncEntry *log_func_entry = __log_functions->data;
+    if (log_func_entry->notify)
+      log_func_entry->notify (log_func_entry->user_data);
+    g_free (log_func_entry);
+    __log_functions = g_slist_delete_link (__log_functions, __log_functions);
+  }
+  g_mutex_unlock (&__log_func_mutex);
+
   g_mutex_lock (&__cat_mutex);
   while (__categories) {
     GstDebugCategory *cat = __categories->data;
@@ -2569,16 +2591,6 @@ _priv_gst_debug_cleanup (void)
   g_mutex_unlock (&__cat_mutex);
 
   clear_level_names ();
-
-  g_mutex_lock (&__log_func_mutex);
-  while (__log_functions) {
-    LogFuncEntry *log_func_entry = __log_functions->data;
-    if (log_func_entry->notify)
-      log_func_entry->notify (log_func_entry->user_data);
-    g_free (log_func_entry);
-    __log_functions = g_slist_delete_link (__log_functions, __log_functions);
-  }
-  g_mutex_unlock (&__log_func_mutex);
 }
 
 static void
@@ -3796,6 +3808,519 @@ gst_debug_remove_ring_buffer_logger (void)
   gst_debug_remove_log_function (gst_ring_buffer_logger_log);
 }
 
+/* Binary logger
+ *
+ * Every thread that logs gets its own ring buffer with a single producer (the
+ * thread) and a single consumer (the writer thread), so logging only costs
+ * formatting the message itself and a memcpy, without any lock or system
+ * call. The category, file and function are stored as pointers and only
+ * resolved to strings by the writer thread, which writes each of them once
+ * to the file. When a ring buffer is full, messages are dropped and the
+ * number of dropped messages is written to the file instead.
+ *
+ * The file starts with a header of the magic "GSTDBGB\0", the version, a
+ * byte order mark and the PID as native endian 32 bit integers and is
+ * followed by records that start with a type byte:
+ *
+ * - STRING: guint64 id, guint32 length and the string
+ * - MESSAGE: guint64 timestamp, thread, object and category id, gint32
+ *   line, guint8 level, guint32 lengths of the file, function, object id
+ *   and message, followed by these strings
+ * - DROPPED: guint64 thread, guint32 number of dropped messages
+ *
+ * The files can be converted to the text format of gst_debug_log_default()
+ * with the gst-debug-decode tool.
+ */
+
+#define BINARY_LOG_VERSION 1
+#define BINARY_LOG_BOM 0x01020304
+
+#define BINARY_LOG_RECORD_STRING 1
+#define BINARY_LOG_RECORD_MESSAGE 2
+#define BINARY_LOG_RECORD_DROPPED 3
+
+/* level of the records that only pad until the end of the ring buffer */
+#define BINARY_LOG_PADDING G_MAXUINT32
+
+#define BINARY_LOG_DEFAULT_SIZE (1024 * 1024)
+#define BINARY_LOG_MIN_SIZE 4096
+#define BINARY_LOG_DRAIN_INTERVAL (100 * G_TIME_SPAN_MILLISECOND)
+
+typedef struct
+{
+  FILE *file;
+  guint ring_size;
+
+  GThread *thread;
+  GCond cond;
+  gboolean running;
+
+  /* GstBinaryLogRing of all threads that logged */
+  GList *rings;
+  /* ids of the strings that were already written */
+  GHashTable *strings;
+} GstBinaryLogger;
+
+typedef struct
+{
+  /* NULL once the logger was removed */
+  GstBinaryLogger *logger;
+  GThread *thread;
+
+  guint8 *data;
+  guint size;
+  /* free running positions, the producer only writes head and the writer
+   * thread only writes tail */
+  gint head;
+  gint tail;
+  gint dropped;
+  /* set when the thread exited */
+  gint orphaned;
+} GstBinaryLogRing;
+
+typedef struct
+{
+  /* aligned to 8 bytes, including the object id and message */
+  guint32 size;
+  guint32 level;
+  gint32 line;
+  guint16 file_len;
+  guint16 function_len;
+  guint32 id_len;
+  guint32 message_len;
+  GstClockTime elapsed;
+  GstDebugCategory *category;
+  gpointer object;
+  /* followed by the file, function, object id and message */
+} GstBinaryLogRecord;
+
+/* protects binary_logger and the rings list of it */
+static GMutex binary_logger_lock;
+static GstBinaryLogger *binary_logger = NULL;
+
+static void gst_binary_log_ring_thread_exit (GstBinaryLogRing * ring);
+static GPrivate binary_log_ring =
+G_PRIVATE_INIT ((GDestroyNotify) gst_binary_log_ring_thread_exit);
+
+static void
+gst_binary_log_ring_free (GstBinaryLogRing * ring)
+{
+  g_free (ring->data);
+  g_free (ring);
+}
+
+/* called when a thread that logged exits */
+static void
+gst_binary_log_ring_thread_exit (GstBinaryLogRing * ring)
+{
+  g_mutex_lock (&binary_logger_lock);
+  if (ring->logger) {
+    /* freed by the writer thread once the remaining messages are written */
+    g_atomic_int_set (&ring->orphaned, TRUE);
+  } else {
+    gst_binary_log_ring_free (ring);
+  }
+  g_mutex_unlock (&binary_logger_lock);
+}
+
+static GstBinaryLogRing *
+gst_binary_log_ring_new (GstBinaryLogger * logger)
+{
+  GstBinaryLogRing *ring;
+
+  ring = g_new0 (GstBinaryLogRing, 1);
+  ring->thread = g_thread_self ();
+  ring->size = logger->ring_size;
+  ring->data = g_malloc (ring->size);
+
+  g_mutex_lock (&binary_logger_lock);
+  if (binary_logger == logger) {
+    ring->logger = logger;
+    logger->rings = g_list_prepend (logger->rings, ring);
+  }
+  g_mutex_unlock (&binary_logger_lock);
+
+  /* frees the ring of a previous logger, if any */
+  g_private_replace (&binary_log_ring, ring);
+
+  return ring;
+}
+
+static void
+gst_binary_logger_log (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line, GObject * object,
+    GstDebugMessage * message, gpointer user_data)
+{
+  GstBinaryLogger *logger = user_data;
+  GstBinaryLogRing *ring;
+  GstBinaryLogRecord *record;
+  const gchar *message_str, *object_id;
+  gsize file_len, function_len, message_len, id_len, size, max_size;
+  guint head, tail, offset, contiguous, used;
+  guint8 *data;
+  gchar c;
+
+  ring = g_private_get (&binary_log_ring);
+  if (G_UNLIKELY (!ring || g_atomic_pointer_get (&ring->logger) != logger)) {
+    ring = gst_binary_log_ring_new (logger);
+    if (!ring->logger)
+      return;
+  }
+
+  message_str = gst_debug_message_get (message);
+  if (!message_str)
+    message_str = "";
+  object_id = gst_debug_message_get_id (message);
+
+  /* shorten __FILE__ like the default log function does */
+  c = file[0];
+  if (c == '.' || c == '/' || c == '\\' || (c != '\0' && file[1] == ':'))
+    file = gst_path_basename (file);
+
+  /* a single record may not take more than a quarter of the ring buffer */
+  max_size = ring->size / 4 - sizeof (GstBinaryLogRecord);
+  file_len = MIN (strlen (file), 128);
+  function_len = MIN (strlen (function), 128);
+  id_len = object_id ? MIN (strlen (object_id), 256) : 0;
+  message_len = MIN (strlen (message_str),
+      max_size - file_len - function_len - id_len);
+  size = GST_ROUND_UP_8 (sizeof (GstBinaryLogRecord) + file_len +
+      function_len + id_len + message_len);
+
+  head = ring->head;
+  tail = g_atomic_int_get (&ring->tail);
+  offset = head & (ring->size - 1);
+  contiguous = ring->size - offset;
+  used = head - tail;
+
+  if (size > contiguous) {
+    /* pad until the end and start at the beginning again */
+    if (used + contiguous + size > ring->size) {
+      g_atomic_int_inc (&ring->dropped);
+      return;
+    }
+    record = (GstBinaryLogRecord *) (ring->data + offset);
+    record->size = contiguous;
+    record->level = BINARY_LOG_PADDING;
+    head += contiguous;
+    used += contiguous;
+    offset = 0;
+  } else if (used + size > ring->size) {
+    g_atomic_int_inc (&ring->dropped);
+    return;
+  }
+
+  record = (GstBinaryLogRecord *) (ring->data + offset);
+  record->size = size;
+  record->level = level;
+  record->line = line;
+  record->file_len = file_len;
+  record->function_len = function_len;
+  record->id_len = id_len;
+  record->message_len = message_len;
+  record->elapsed =
+      GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+  record->category = category;
+  record->object = object;
+
+  data = (guint8 *) (record + 1);
+  memcpy (data, file, file_len);
+  data += file_len;
+  memcpy (data, function, function_len);
+  data += function_len;
+  if (id_len)
+    memcpy (data, object_id, id_len);
+  data += id_len;
+  memcpy (data, message_str, message_len);
+
+  /* publish the record to the writer thread */
+  g_atomic_int_set (&ring->head, head + size);
+
+  /* wake up the writer early when the ring buffer fills up */
+  if (used + size > ring->size / 2)
+    g_cond_signal (&logger->cond);
+}
+
+static void
+gst_binary_logger_write (GstBinaryLogger * logger, gconstpointer data,
+    gsize size)
+{
+  if (size > 0)
+    fwrite (data, 1, size, logger->file);
+}
+
+static void
+gst_binary_logger_write_u8 (GstBinaryLogger * logger, guint8 value)
+{
+  gst_binary_logger_write (logger, &value, sizeof (value));
+}
+
+static void
+gst_binary_logger_write_u32 (GstBinaryLogger * logger, guint32 value)
+{
+  gst_binary_logger_write (logger, &value, sizeof (value));
+}
+
+static void
+gst_binary_logger_write_u64 (GstBinaryLogger * logger, guint64 value)
+{
+  gst_binary_logger_write (logger, &value, sizeof (value));
+}
+
+/* writes @str once and returns the id to refer to it */
+static guint64
+gst_binary_logger_intern (GstBinaryLogger * logger, gconstpointer id,
+    const gchar * str)
+{
+  gsize len;
+
+  if (g_hash_table_contains (logger->strings, id))
+    return GPOINTER_TO_SIZE (id);
+
+  g_hash_table_add (logger->strings, (gpointer) id);
+
+  len = str ? strlen (str) : 0;
+  gst_binary_logger_write_u8 (logger, BINARY_LOG_RECORD_STRING);
+  gst_binary_logger_write_u64 (logger, GPOINTER_TO_SIZE (id));
+  gst_binary_logger_write_u32 (logger, len);
+  gst_binary_logger_write (logger, str, len);
+
+  return GPOINTER_TO_SIZE (id);
+}
+
+static void
+gst_binary_logger_write_record (GstBinaryLogger * logger,
+    GstBinaryLogRing * ring, const GstBinaryLogRecord * record)
+{
+  guint64 category_id;
+
+  category_id = gst_binary_logger_intern (logger, record->category,
+      gst_debug_category_get_name (record->category));
+
+  gst_binary_logger_write_u8 (logger, BINARY_LOG_RECORD_MESSAGE);
+  gst_binary_logger_write_u64 (logger, record->elapsed);
+  gst_binary_logger_write_u64 (logger, GPOINTER_TO_SIZE (ring->thread));
+  gst_binary_logger_write_u64 (logger, GPOINTER_TO_SIZE (record->object));
+  gst_binary_logger_write_u64 (logger, category_id);
+  gst_binary_logger_write_u32 (logger, record->line);
+  gst_binary_logger_write_u8 (logger, record->level);
+  gst_binary_logger_write_u32 (logger, record->file_len);
+  gst_binary_logger_write_u32 (logger, record->function_len);
+  gst_binary_logger_write_u32 (logger, record->id_len);
+  gst_binary_logger_write_u32 (logger, record->message_len);
+  gst_binary_logger_write (logger, record + 1, record->file_len +
+      record->function_len + record->id_len + record->message_len);
+}
+
+static void
+gst_binary_logger_drain_ring (GstBinaryLogger * logger,
+    GstBinaryLogRing * ring)
+{
+  guint head, tail;
+  gint dropped;
+
+  head = g_atomic_int_get (&ring->head);
+  tail = ring->tail;
+
+  while (tail != head) {
+    const GstBinaryLogRecord *record;
+
+    record = (const GstBinaryLogRecord *)
+        (ring->data + (tail & (ring->size - 1)));
+    if (record->level != BINARY_LOG_PADDING)
+      gst_binary_logger_write_record (logger, ring, record);
+    tail += record->size;
+  }
+  g_atomic_int_set (&ring->tail, tail);
+
+  dropped = g_atomic_int_get (&ring->dropped);
+  if (dropped > 0) {
+    g_atomic_int_add (&ring->dropped, -dropped);
+    gst_binary_logger_write_u8 (logger, BINARY_LOG_RECORD_DROPPED);
+    gst_binary_logger_write_u64 (logger, GPOINTER_TO_SIZE (ring->thread));
+    gst_binary_logger_write_u32 (logger, dropped);
+  }
+}
+
+/* Must be called with binary_logger_lock, which is released while writing so
+ * that threads logging for the first time or exiting don't wait for the file.
+ * The rings taken out of the list stay valid meanwhile, an exiting thread
+ * only marks its ring as orphaned as long as ring->logger is set. */
+static void
+gst_binary_logger_drain (GstBinaryLogger * logger)
+{
+  GList *rings, *l, *next;
+
+  rings = logger->rings;
+  logger->rings = NULL;
+  g_mutex_unlock (&binary_logger_lock);
+
+  for (l = rings; l; l = next) {
+    GstBinaryLogRing *ring = l->data;
+    /* checked before draining, the thread might log until it exits */
+    gboolean orphaned = g_atomic_int_get (&ring->orphaned);
+
+    next = l->next;
+
+    gst_binary_logger_drain_ring (logger, ring);
+    if (orphaned) {
+      rings = g_list_delete_link (rings, l);
+      gst_binary_log_ring_free (ring);
+    }
+  }
+
+  fflush (logger->file);
+
+  g_mutex_lock (&binary_logger_lock);
+  logger->rings = g_list_concat (logger->rings, rings);
+}
+
+static gpointer
+gst_binary_logger_thread (GstBinaryLogger * logger)
+{
+  g_mutex_lock (&binary_logger_lock);
+  while (logger->running) {
+    gst_binary_logger_drain (logger);
+    if (!logger->running)
+      break;
+    g_cond_wait_until (&logger->cond, &binary_logger_lock,
+        g_get_monotonic_time () + BINARY_LOG_DRAIN_INTERVAL);
+  }
+  g_mutex_unlock (&binary_logger_lock);
+
+  return NULL;
+}
+
+static void
+gst_binary_logger_free (GstBinaryLogger * logger)
+{
+  GstBinaryLogRing *ring;
+  GList *l;
+
+  g_mutex_lock (&binary_logger_lock);
+  logger->running = FALSE;
+  g_cond_signal (&logger->cond);
+  g_mutex_unlock (&binary_logger_lock);
+
+  g_thread_join (logger->thread);
+
+  g_mutex_lock (&binary_logger_lock);
+  /* no new rings are added from now on */
+  if (binary_logger == logger)
+    binary_logger = NULL;
+  gst_binary_logger_drain (logger);
+
+  /* the rings of threads that are still alive are freed when they exit */
+  for (l = logger->rings; l; l = l->next) {
+    ring = l->data;
+    if (g_atomic_int_get (&ring->orphaned))
+      gst_binary_log_ring_free (ring);
+    else
+      g_atomic_pointer_set (&ring->logger, NULL);
+  }
+  g_list_free (logger->rings);
+  g_mutex_unlock (&binary_logger_lock);
+
+  if (logger->file != stderr && logger->file != stdout)
+    fclose (logger->file);
+  g_hash_table_unref (logger->strings);
+  g_cond_clear (&logger->cond);
+  g_free (logger);
+}
+
+/**
+ * gst_debug_add_binary_logger:
+ * @filename: (type filename): the file to write the log to
+ * @max_size_per_thread: size of the ring buffer of each thread in bytes, or 0
+ *     for the default of 1 MiB
+ *
+ * Adds a debug logger that stores the debug messages in a ring buffer per
+ * thread without taking any lock, and writes them from a separate thread in
+ * a binary format to @filename. The file can be converted to the usual text
+ * format with the gst-debug-decode tool.
+ *
+ * This has much less impact on the timing of the pipeline than
+ * gst_debug_log_default(), which makes it possible to keep a high debug level
+ * enabled in live pipelines. If a thread logs faster than its messages are
+ * written, messages are dropped and the number of dropped messages is
+ * recorded in the log.
+ *
+ * The logger can be removed again with gst_debug_remove_binary_logger(), which
+ * writes out all pending messages. Only one logger at a time is possible.
+ *
+ * Returns: %TRUE if the logger was added
+ *
+ * Since: 1.26
+ */
+gboolean
+gst_debug_add_binary_logger (const gchar * filename,
+    guint max_size_per_thread)
+{
+  GstBinaryLogger *logger;
+  FILE *file;
+  guint32 header[3];
+  guint bits;
+
+  g_return_val_if_fail (filename != NULL, FALSE);
+
+  g_mutex_lock (&binary_logger_lock);
+  if (binary_logger) {
+    g_mutex_unlock (&binary_logger_lock);
+    g_warn_if_reached ();
+    return FALSE;
+  }
+
+  if (strcmp (filename, "-") == 0) {
+    file = stdout;
+  } else if (!(file = g_fopen (filename, "wb"))) {
+    g_mutex_unlock (&binary_logger_lock);
+    g_printerr ("Could not open log file '%s' for writing: %s\n", filename,
+        g_strerror (errno));
+    return FALSE;
+  }
+
+  if (max_size_per_thread == 0)
+    max_size_per_thread = BINARY_LOG_DEFAULT_SIZE;
+
+  logger = binary_logger = g_new0 (GstBinaryLogger, 1);
+  logger->file = file;
+  /* positions are masked, so the size has to be a power of two */
+  bits = MIN (g_bit_storage (max_size_per_thread - 1), 30);
+  logger->ring_size = MAX (1U << bits, BINARY_LOG_MIN_SIZE);
+  logger->strings = g_hash_table_new (NULL, NULL);
+  g_cond_init (&logger->cond);
+
+  fwrite ("GSTDBGB", 1, 8, file);
+  header[0] = BINARY_LOG_VERSION;
+  header[1] = BINARY_LOG_BOM;
+  header[2] = _gst_getpid ();
+  fwrite (header, sizeof (guint32), 3, file);
+
+  logger->running = TRUE;
+  logger->thread = g_thread_new ("gst-binary-logger",
+      (GThreadFunc) gst_binary_logger_thread, logger);
+  g_mutex_unlock (&binary_logger_lock);
+
+  gst_debug_add_log_function (gst_binary_logger_log, logger,
+      (GDestroyNotify) gst_binary_logger_free);
+
+  return TRUE;
+}
+
+/**
+ * gst_debug_remove_binary_logger:
+ *
+ * Removes the logger previously added with gst_debug_add_binary_logger() after
+ * writing out all pending messages.
+ *
+ * Since: 1.26
+ */
+void
+gst_debug_remove_binary_logger (void)
+{
+  gst_debug_remove_log_function (gst_binary_logger_log);
+}
+
 #else /* GST_DISABLE_GST_DEBUG */
 #ifndef GST_REMOVE_DISABLED
 
@@ -3816,5 +4341,17 @@ gst_debug_remove_ring_buffer_logger (void)
 {
 }
 
+gboolean
+gst_debug_add_binary_logger (const gchar * filename,
+    guint max_size_per_thread)
+{
+  return FALSE;
+}
+
+void
+gst_debug_remove_binary_logger (void)
+{
+}
+
 #endif /* GST_REMOVE_DISABLED */
 #endif /* GST_DISABLE_GST_DEBUG */
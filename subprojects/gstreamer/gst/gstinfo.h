@@ -2161,6 +2161,11 @@ void                  gst_debug_remove_ring_buffer_logger   (void);
 GST_API
 gchar **              gst_debug_ring_buffer_logger_get_logs (void);
 
+GST_API
+gboolean              gst_debug_add_binary_logger           (const gchar * filename, guint max_size_per_thread);
+GST_API
+void                  gst_debug_remove_binary_logger        (void);
+
 G_END_DECLS
 
 #endif /* __GSTINFO_H__ */
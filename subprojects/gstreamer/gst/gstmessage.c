@@ -223,7 +223,7 @@ _gst_message_free (GstMessage * message)
   memset (message, 0xff, sizeof (GstMessageImpl));
 #endif
 
-  g_free (message);
+  _priv_gst_arena_free (message);
 }
 
 static void
@@ -240,7 +240,7 @@ _gst_message_copy (GstMessage * message)
       GST_MESSAGE_TYPE_NAME (message),
       GST_OBJECT_NAME (GST_MESSAGE_SRC (message)));
 
-  copy = g_new0 (GstMessageImpl, 1);
+  copy = _priv_gst_arena_alloc0 (sizeof (GstMessageImpl));
 
   gst_message_init (copy, GST_MESSAGE_TYPE (message),
       GST_MESSAGE_SRC (message));
@@ -299,7 +299,7 @@ gst_message_new_custom (GstMessageType type, GstObject * src,
 {
   GstMessageImpl *message;
 
-  message = g_new0 (GstMessageImpl, 1);
+  message = _priv_gst_arena_alloc0 (sizeof (GstMessageImpl));
 
   GST_CAT_LOG (GST_CAT_MESSAGE, "source %s: creating new message %p %s",
       (src ? GST_OBJECT_NAME (src) : "NULL"), message,
@@ -320,7 +320,7 @@ gst_message_new_custom (GstMessageType type, GstObject * src,
   /* ERRORS */
 had_parent:
   {
-    g_free (message);
+    _priv_gst_arena_free (message);
     g_warning ("structure is already owned by another object");
     return NULL;
   }
@@ -1903,6 +1903,14 @@ gst_message_parse_request_state (GstMessage * message, GstState * state)
  * Create a new stream status message. This message is posted when a streaming
  * thread is created/destroyed or when the state changed.
  *
+ * When streaming threads are pinned to CPUs, with #GstBin:cpu-affinity or the
+ * `GST_TASK_CPU_AFFINITY` environment variable, the
+ * %GST_STREAM_STATUS_TYPE_ENTER messages posted by the tasks of pads also
+ * contain a "cpu-affinity" string field with the CPUs the thread may run on,
+ * and a "numa-node" integer field with its NUMA node, or -1 if unknown. These
+ * are updated by a #GstBin that pins the thread with #GstBin:cpu-affinity.
+ * (Since: 1.26)
+ *
  * Returns: (transfer full): the new stream status message.
  *
  * MT safe.
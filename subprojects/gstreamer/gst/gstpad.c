@@ -141,6 +141,11 @@ struct _GstPadPrivate
   gint using;
   guint probe_list_cookie;
 
+  /* union of the masks of all blocking and of all other probes, used to skip
+   * the probe machinery for data that no probe is interested in */
+  GstPadProbeType blocking_probe_types;
+  GstPadProbeType probe_types;
+
   /* counter of how many idle probes are running directly from the add_probe
    * call. Used to block any data flowing in the pad while the idle callback
    * Doesn't finish its work */
@@ -1371,6 +1376,70 @@ gst_pad_is_active (GstPad * pad)
   return result;
 }
 
+/* Must be called with the object lock */
+static void
+update_probe_types (GstPad * pad)
+{
+  GstPadProbeType blocking_types = 0, types = 0;
+  GHook *hook;
+
+  for (hook = pad->probes.hooks; hook; hook = hook->next) {
+    GstPadProbeType flags;
+
+    if (!G_HOOK_IS_VALID (hook))
+      continue;
+
+    flags = hook->flags >> G_HOOK_FLAG_USER_SHIFT;
+    if (flags & GST_PAD_PROBE_TYPE_BLOCKING)
+      blocking_types |= flags;
+    else
+      types |= flags;
+  }
+
+  pad->priv->blocking_probe_types = blocking_types;
+  pad->priv->probe_types = types;
+}
+
+/* Returns %FALSE if no probe of @pad can match @type, following the same
+ * rules as probe_hook_marshal(). Must be called with the object lock */
+static inline gboolean
+probes_may_match (GstPad * pad, GstPadProbeType type)
+{
+  GstPadProbeType flags;
+
+  /* serialized data waits for idle probes that are running from
+   * gst_pad_add_probe(), even if none of the probes matches */
+  if (G_UNLIKELY (GST_PAD_IS_RUNNING_IDLE_PROBE (pad)))
+    return TRUE;
+
+  if (type & GST_PAD_PROBE_TYPE_BLOCKING) {
+    flags = pad->priv->blocking_probe_types;
+    if ((flags & GST_PAD_PROBE_TYPE_BLOCKING & type) == 0)
+      return FALSE;
+  } else {
+    flags = pad->priv->probe_types;
+  }
+
+  if ((flags & GST_PAD_PROBE_TYPE_SCHEDULING & type) == 0)
+    return FALSE;
+
+  if (type & GST_PAD_PROBE_TYPE_PUSH) {
+    if ((type & GST_PAD_PROBE_TYPE_IDLE) == 0
+        && (flags & _PAD_PROBE_TYPE_ALL_BOTH_AND_FLUSH & type) == 0)
+      return FALSE;
+  } else {
+    if ((type & GST_PAD_PROBE_TYPE_BLOCKING) == 0
+        && (flags & _PAD_PROBE_TYPE_ALL_BOTH_AND_FLUSH & type) == 0)
+      return FALSE;
+  }
+
+  if ((type & GST_PAD_PROBE_TYPE_EVENT_FLUSH) &&
+      (flags & GST_PAD_PROBE_TYPE_EVENT_FLUSH) == 0)
+    return FALSE;
+
+  return TRUE;
+}
+
 static void
 cleanup_hook (GstPad * pad, GHook * hook)
 {
@@ -1402,6 +1471,7 @@ cleanup_hook (GstPad * pad, GHook * hook)
   }
   g_hook_destroy_link (&pad->probes, hook);
   pad->num_probes--;
+  update_probe_types (pad);
 }
 
 /**
@@ -1465,6 +1535,10 @@ gst_pad_add_probe (GstPad * pad, GstPadProbeType mask,
   /* add the probe */
   g_hook_append (&pad->probes, hook);
   pad->num_probes++;
+  if (mask & GST_PAD_PROBE_TYPE_BLOCKING)
+    pad->priv->blocking_probe_types |= mask;
+  else
+    pad->priv->probe_types |= mask;
   /* incremenent cookie so that the new hook gets called */
   pad->priv->probe_list_cookie++;
 
@@ -3767,7 +3841,7 @@ already_called:
 /* a probe that does not take or return any data */
 #define PROBE_NO_DATA(pad,mask,label,defaultval)                \
   G_STMT_START {						\
-    if (G_UNLIKELY (pad->num_probes)) {				\
+    if (G_UNLIKELY (pad->num_probes && probes_may_match (pad, mask))) {	\
       GstFlowReturn pval = defaultval;				\
       /* pass NULL as the data item */                          \
       GstPadProbeInfo info = { mask, 0, NULL, 0, 0 };		\
@@ -3780,7 +3854,7 @@ already_called:
 
 #define PROBE_FULL(pad,mask,data,offs,size,label,handleable,handle_label) \
   G_STMT_START {							\
-    if (G_UNLIKELY (pad->num_probes)) {					\
+    if (G_UNLIKELY (pad->num_probes && probes_may_match (pad, mask))) {	\
       /* pass the data item */						\
       GstPadProbeInfo info = { mask, 0, data, offs, size };		\
       info.ABI.abi.flow_ret = GST_FLOW_OK;				\
@@ -6316,6 +6390,23 @@ do_stream_status (GstPad * pad, GstStreamStatusType type,
       gst_message_set_stream_status_object (message, &value);
       g_value_unset (&value);
 
+      if (type == GST_STREAM_STATUS_TYPE_ENTER
+          && _priv_gst_affinity_is_used ()) {
+        GstCpuSet cpus;
+
+        /* report where the streaming thread runs, a bin with a cpu-affinity
+         * updates this when it pins the thread */
+        if (_priv_gst_thread_get_affinity (&cpus)) {
+          gchar *cpulist = _priv_gst_cpu_set_to_string (&cpus);
+
+          gst_structure_set (gst_message_writable_structure (message),
+              "cpu-affinity", G_TYPE_STRING, cpulist,
+              "numa-node", G_TYPE_INT, _priv_gst_numa_get_thread_node (),
+              NULL);
+          g_free (cpulist);
+        }
+      }
+
       GST_DEBUG_OBJECT (pad, "posting stream-status %d", type);
       gst_element_post_message (parent, message);
     }
@@ -51,6 +51,12 @@
  * descriptor, and gst_poll_fd_can_write() to see if it is possible to
  * write to it.
  *
+ * On Linux, the `GST_POLL_MODE` environment variable can be set to `epoll` to
+ * make new sets use epoll instead of ppoll(). File descriptors are then
+ * registered with the kernel when they are added or changed instead of on
+ * every wait, so the cost of a wait no longer grows with the number of file
+ * descriptors in the set.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -83,6 +89,10 @@
 #endif
 #include <sys/time.h>
 #include <sys/socket.h>
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_CREATE1)
+#define HAVE_EPOLL 1
+#include <sys/epoll.h>
+#endif
 #endif
 
 #ifdef G_OS_WIN32
@@ -124,9 +134,16 @@ typedef enum
   GST_POLL_MODE_PSELECT,
   GST_POLL_MODE_POLL,
   GST_POLL_MODE_PPOLL,
-  GST_POLL_MODE_WINDOWS
+  GST_POLL_MODE_WINDOWS,
+  GST_POLL_MODE_EPOLL
 } GstPollMode;
 
+#ifdef HAVE_EPOLL
+/* initial number of events collected by one epoll_wait() call, the array
+ * grows when it was filled completely */
+#define EPOLL_MIN_EVENTS 64
+#endif
+
 struct _GstPoll
 {
   GstPollMode mode;
@@ -150,6 +167,19 @@ struct _GstPoll
   HANDLE wakeup_event;
 #endif
 
+#ifdef HAVE_EPOLL
+  gint epoll_fd;
+  /* events returned by the last epoll_wait() */
+  struct epoll_event *epoll_events;
+  gint n_epoll_events;
+  /* fd -> revents of the fds that had events in the last wait, written to
+   * from the waiting thread with the lock */
+  GHashTable *ready_fds;
+  /* fd -> events of the fds epoll refuses (regular files and some devices),
+   * these are always ready like with poll(), protected by the lock */
+  GHashTable *always_ready_fds;
+#endif
+
   gboolean controllable;
   gint waiting;
   gint control_pending;
@@ -434,6 +464,254 @@ pollable_timeout (GstClockTime timeout)
 }
 #endif
 
+#ifndef G_OS_WIN32
+static GstPollMode
+default_mode (void)
+{
+  static GstPollMode mode = GST_POLL_MODE_AUTO;
+  static gsize init = 0;
+
+  if (g_once_init_enter (&init)) {
+    const gchar *env = g_getenv ("GST_POLL_MODE");
+
+    if (env == NULL || g_str_equal (env, "auto")) {
+      mode = GST_POLL_MODE_AUTO;
+#ifdef HAVE_EPOLL
+    } else if (g_str_equal (env, "epoll")) {
+      mode = GST_POLL_MODE_EPOLL;
+#endif
+#ifdef HAVE_PPOLL
+    } else if (g_str_equal (env, "ppoll")) {
+      mode = GST_POLL_MODE_PPOLL;
+#endif
+#ifdef HAVE_POLL
+    } else if (g_str_equal (env, "poll")) {
+      mode = GST_POLL_MODE_POLL;
+#endif
+#ifdef HAVE_PSELECT
+    } else if (g_str_equal (env, "pselect")) {
+      mode = GST_POLL_MODE_PSELECT;
+#endif
+    } else if (g_str_equal (env, "select")) {
+      mode = GST_POLL_MODE_SELECT;
+    } else {
+      GST_WARNING ("unsupported GST_POLL_MODE '%s', using default", env);
+      mode = GST_POLL_MODE_AUTO;
+    }
+    g_once_init_leave (&init, 1);
+  }
+
+  return mode;
+}
+#endif
+
+#ifdef HAVE_EPOLL
+static guint32
+pollfd_events_to_epoll (gshort events)
+{
+  guint32 res = 0;
+
+  if (events & POLLIN)
+    res |= EPOLLIN;
+  if (events & POLLOUT)
+    res |= EPOLLOUT;
+  if (events & POLLPRI)
+    res |= EPOLLPRI;
+
+  /* EPOLLERR and EPOLLHUP are always reported */
+  return res;
+}
+
+static gshort
+epoll_events_to_pollfd (guint32 events)
+{
+  gshort res = 0;
+
+  if (events & EPOLLIN)
+    res |= POLLIN;
+  if (events & EPOLLOUT)
+    res |= POLLOUT;
+  if (events & EPOLLPRI)
+    res |= POLLPRI;
+  if (events & EPOLLERR)
+    res |= POLLERR;
+  if (events & EPOLLHUP)
+    res |= POLLHUP;
+
+  return res;
+}
+
+/* registers the events of @pfd with the kernel, must be called with the
+ * lock */
+static void
+epoll_update (GstPoll * set, struct pollfd *pfd, gint op)
+{
+  struct epoll_event ev = { 0, };
+  gpointer key = GINT_TO_POINTER (pfd->fd);
+
+  if (set->mode != GST_POLL_MODE_EPOLL)
+    return;
+
+  if (g_hash_table_contains (set->always_ready_fds, key)) {
+    if (op == EPOLL_CTL_DEL)
+      g_hash_table_remove (set->always_ready_fds, key);
+    else
+      g_hash_table_insert (set->always_ready_fds, key,
+          GINT_TO_POINTER ((gint) pfd->events));
+    return;
+  }
+
+  ev.events = pollfd_events_to_epoll (pfd->events);
+  ev.data.fd = pfd->fd;
+
+  if (epoll_ctl (set->epoll_fd, op, pfd->fd, &ev) < 0) {
+    /* epoll does not support fds that are always ready, like regular files.
+     * poll() reports these as readable and writable, do the same */
+    if (op == EPOLL_CTL_ADD && errno == EPERM) {
+      GST_DEBUG ("%p: fd %d can't be used with epoll, always ready", set,
+          pfd->fd);
+      g_hash_table_insert (set->always_ready_fds, key,
+          GINT_TO_POINTER ((gint) pfd->events));
+      return;
+    }
+
+    /* closed fds are removed from the epoll set automatically */
+    if (op != EPOLL_CTL_DEL || errno != EBADF)
+      GST_WARNING ("%p: epoll_ctl %d on fd %d failed: %s", set, op, pfd->fd,
+          g_strerror (errno));
+  }
+}
+
+#ifdef HAVE_EPOLL_PWAIT2
+/* set when the kernel does not implement epoll_pwait2() */
+static gint epoll_pwait2_unsupported = 0;
+#endif
+
+static gint
+epoll_wait_fds (GstPoll * set, GstClockTime timeout)
+{
+  struct epoll_event timer_events[EPOLL_MIN_EVENTS];
+  struct epoll_event *events;
+  GHashTableIter iter;
+  gpointer key, value;
+  gint n_events, res, i, n_always_ready = 0;
+  gint t;
+#ifdef HAVE_EPOLL_PWAIT2
+  struct timespec ts;
+  struct timespec *tsptr;
+#endif
+
+  /* fds that are always ready make the wait return immediately */
+  g_mutex_lock (&set->lock);
+  g_hash_table_iter_init (&iter, set->always_ready_fds);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    if (GPOINTER_TO_INT (value) & (POLLIN | POLLOUT | POLLPRI))
+      n_always_ready++;
+  }
+  g_mutex_unlock (&set->lock);
+  if (n_always_ready > 0)
+    timeout = 0;
+
+  /* timers can be waited on from multiple threads at once and only contain
+   * the control socket */
+  if (set->timer) {
+    events = timer_events;
+    n_events = EPOLL_MIN_EVENTS;
+  } else {
+    events = set->epoll_events;
+    n_events = set->n_epoll_events;
+  }
+
+#ifdef HAVE_EPOLL_PWAIT2
+  if (!g_atomic_int_get (&epoll_pwait2_unsupported)) {
+    if (timeout != GST_CLOCK_TIME_NONE) {
+      GST_TIME_TO_TIMESPEC (timeout, ts);
+      tsptr = &ts;
+    } else {
+      tsptr = NULL;
+    }
+
+    res = epoll_pwait2 (set->epoll_fd, events, n_events, tsptr, NULL);
+    if (res >= 0 || errno != ENOSYS)
+      goto done;
+
+    /* built against a newer C library than the running kernel supports */
+    GST_INFO ("epoll_pwait2() not supported, using epoll_wait()");
+    g_atomic_int_set (&epoll_pwait2_unsupported, 1);
+  }
+#endif
+
+  /* round up so that we never time out early */
+  if (timeout != GST_CLOCK_TIME_NONE)
+    t = (gint) MIN ((timeout + GST_MSECOND - 1) / GST_MSECOND, G_MAXINT);
+  else
+    t = -1;
+
+  res = epoll_wait (set->epoll_fd, events, n_events, t);
+
+#ifdef HAVE_EPOLL_PWAIT2
+done:
+#endif
+  if (res < 0)
+    return res;
+
+  g_mutex_lock (&set->lock);
+  g_hash_table_remove_all (set->ready_fds);
+  for (i = 0; i < res; i++) {
+    struct epoll_event *ev = &events[i];
+
+    g_hash_table_insert (set->ready_fds, GINT_TO_POINTER (ev->data.fd),
+        GINT_TO_POINTER ((gint) epoll_events_to_pollfd (ev->events)));
+  }
+
+  /* collect more events at once next time */
+  if (res == n_events && !set->timer) {
+    set->n_epoll_events *= 2;
+    set->epoll_events = g_renew (struct epoll_event, set->epoll_events,
+        set->n_epoll_events);
+  }
+
+  g_hash_table_iter_init (&iter, set->always_ready_fds);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    gshort revents = GPOINTER_TO_INT (value) & (POLLIN | POLLOUT | POLLPRI);
+
+    if (revents == 0)
+      continue;
+    g_hash_table_insert (set->ready_fds, key, GINT_TO_POINTER ((gint) revents));
+    res++;
+  }
+  g_mutex_unlock (&set->lock);
+
+  return res;
+}
+#endif
+
+#ifndef G_OS_WIN32
+/* looks up the returned events of @fd from the last wait, must be called
+ * with the lock. Returns FALSE if @fd is not part of the set */
+static gboolean
+get_revents (const GstPoll * set, GstPollFD * fd, gshort * revents)
+{
+  gint idx;
+
+#ifdef HAVE_EPOLL
+  if (set->mode == GST_POLL_MODE_EPOLL) {
+    /* fds without events since the last wait are not in the table */
+    *revents = GPOINTER_TO_INT (g_hash_table_lookup (set->ready_fds,
+            GINT_TO_POINTER (fd->fd)));
+    return TRUE;
+  }
+#endif
+
+  idx = find_index (set->active_fds, fd);
+  if (idx < 0)
+    return FALSE;
+
+  *revents = g_array_index (set->active_fds, struct pollfd, idx).revents;
+  return TRUE;
+}
+#endif
+
 static GstPollMode
 choose_mode (GstPoll * set, GstClockTime timeout)
 {
@@ -681,11 +959,27 @@ gst_poll_new (gboolean controllable)
   GST_DEBUG ("%p: new controllable : %d", nset, controllable);
   g_mutex_init (&nset->lock);
 #ifndef G_OS_WIN32
-  nset->mode = GST_POLL_MODE_AUTO;
+  nset->mode = default_mode ();
   nset->fds = g_array_new (FALSE, FALSE, sizeof (struct pollfd));
   nset->active_fds = g_array_new (FALSE, FALSE, sizeof (struct pollfd));
   nset->control_read_fd.fd = -1;
   nset->control_write_fd.fd = -1;
+#ifdef HAVE_EPOLL
+  nset->epoll_fd = -1;
+  if (nset->mode == GST_POLL_MODE_EPOLL) {
+    nset->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    if (nset->epoll_fd < 0) {
+      GST_WARNING ("%p: can't create epoll fd: %s, using default mode", nset,
+          g_strerror (errno));
+      nset->mode = GST_POLL_MODE_AUTO;
+    } else {
+      nset->n_epoll_events = EPOLL_MIN_EVENTS;
+      nset->epoll_events = g_new (struct epoll_event, nset->n_epoll_events);
+      nset->ready_fds = g_hash_table_new (NULL, NULL);
+      nset->always_ready_fds = g_hash_table_new (NULL, NULL);
+    }
+  }
+#endif
   {
     gint control_sock[2];
 
@@ -776,6 +1070,15 @@ gst_poll_free (GstPoll * set)
     close (set->control_write_fd.fd);
   if (set->control_read_fd.fd >= 0)
     close (set->control_read_fd.fd);
+#ifdef HAVE_EPOLL
+  if (set->epoll_fd >= 0)
+    close (set->epoll_fd);
+  g_free (set->epoll_events);
+  if (set->ready_fds)
+    g_hash_table_unref (set->ready_fds);
+  if (set->always_ready_fds)
+    g_hash_table_unref (set->always_ready_fds);
+#endif
 #else
   CloseHandle (set->wakeup_event);
 
@@ -857,6 +1160,9 @@ gst_poll_add_fd_unlocked (GstPoll * set, GstPollFD * fd)
     nfd.revents = 0;
 
     g_array_append_val (set->fds, nfd);
+#ifdef HAVE_EPOLL
+    epoll_update (set, &nfd, EPOLL_CTL_ADD);
+#endif
 
     fd->idx = set->fds->len - 1;
 #else
@@ -939,6 +1245,12 @@ gst_poll_remove_fd (GstPoll * set, GstPollFD * fd)
     gst_poll_free_winsock_event (set, idx);
     g_array_remove_index_fast (set->events, idx);
 #endif
+#ifdef HAVE_EPOLL
+    epoll_update (set, &g_array_index (set->fds, struct pollfd, idx),
+        EPOLL_CTL_DEL);
+    if (set->ready_fds)
+      g_hash_table_remove (set->ready_fds, GINT_TO_POINTER (fd->fd));
+#endif
 
     /* remove the fd at index, we use _remove_index_fast, which copies the last
      * element of the array to the freed index */
@@ -990,6 +1302,9 @@ gst_poll_fd_ctl_write (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= POLLOUT;
     else
       pfd->events &= ~POLLOUT;
+#ifdef HAVE_EPOLL
+    epoll_update (set, pfd, EPOLL_CTL_MOD);
+#endif
 
     GST_LOG ("%p: pfd->events now %d (POLLOUT:%d)", set, pfd->events, POLLOUT);
 #else
@@ -1024,6 +1339,9 @@ gst_poll_fd_ctl_read_unlocked (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= POLLIN;
     else
       pfd->events &= ~POLLIN;
+#ifdef HAVE_EPOLL
+    epoll_update (set, pfd, EPOLL_CTL_MOD);
+#endif
 #else
     gst_poll_update_winsock_event_mask (set, idx, FD_READ | FD_ACCEPT, active);
 #endif
@@ -1104,6 +1422,9 @@ gst_poll_fd_ctl_pri (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= POLLPRI;
     else
       pfd->events &= ~POLLPRI;
+#ifdef HAVE_EPOLL
+    epoll_update (set, pfd, EPOLL_CTL_MOD);
+#endif
 
     GST_LOG ("%p: pfd->events now %d (POLLPRI:%d)", set, pfd->events, POLLOUT);
     MARK_REBUILD (set);
@@ -1168,7 +1489,11 @@ gboolean
 gst_poll_fd_has_closed (const GstPoll * set, GstPollFD * fd)
 {
   gboolean res = FALSE;
+#ifndef G_OS_WIN32
+  gshort revents;
+#else
   gint idx;
+#endif
 
   g_return_val_if_fail (set != NULL, FALSE);
   g_return_val_if_fail (fd != NULL, FALSE);
@@ -1176,20 +1501,21 @@ gst_poll_fd_has_closed (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
-  if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & POLLHUP) != 0;
+  if (get_revents (set, fd, &revents))
+    res = (revents & POLLHUP) != 0;
+  else
+    GST_WARNING ("%p: couldn't find fd !", set);
 #else
+  idx = find_index (set->active_fds, fd);
+  if (idx >= 0) {
     WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & FD_CLOSE) != 0;
-#endif
   } else {
     GST_WARNING ("%p: couldn't find fd !", set);
   }
+#endif
   g_mutex_unlock (&((GstPoll *) set)->lock);
 
   GST_DEBUG ("%p: fd (fd:%d, idx:%d) %d", set, fd->fd, fd->idx, res);
@@ -1210,7 +1536,11 @@ gboolean
 gst_poll_fd_has_error (const GstPoll * set, GstPollFD * fd)
 {
   gboolean res = FALSE;
+#ifndef G_OS_WIN32
+  gshort revents;
+#else
   gint idx;
+#endif
 
   g_return_val_if_fail (set != NULL, FALSE);
   g_return_val_if_fail (fd != NULL, FALSE);
@@ -1218,13 +1548,14 @@ gst_poll_fd_has_error (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
-  if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & (POLLERR | POLLNVAL)) != 0;
+  if (get_revents (set, fd, &revents))
+    res = (revents & (POLLERR | POLLNVAL)) != 0;
+  else
+    GST_WARNING ("%p: couldn't find fd !", set);
 #else
+  idx = find_index (set->active_fds, fd);
+  if (idx >= 0) {
     WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
 
     res = (wfd->events.iErrorCode[FD_CLOSE_BIT] != 0) ||
@@ -1232,10 +1563,10 @@ gst_poll_fd_has_error (const GstPoll * set, GstPollFD * fd)
         (wfd->events.iErrorCode[FD_WRITE_BIT] != 0) ||
         (wfd->events.iErrorCode[FD_ACCEPT_BIT] != 0) ||
         (wfd->events.iErrorCode[FD_CONNECT_BIT] != 0);
-#endif
   } else {
     GST_WARNING ("%p: couldn't find fd !", set);
   }
+#endif
   g_mutex_unlock (&((GstPoll *) set)->lock);
 
   GST_DEBUG ("%p: fd (fd:%d, idx:%d) %d", set, fd->fd, fd->idx, res);
@@ -1247,22 +1578,25 @@ static gboolean
 gst_poll_fd_can_read_unlocked (const GstPoll * set, GstPollFD * fd)
 {
   gboolean res = FALSE;
+#ifndef G_OS_WIN32
+  gshort revents;
+
+  if (get_revents (set, fd, &revents))
+    res = (revents & POLLIN) != 0;
+  else
+    GST_WARNING ("%p: couldn't find fd !", set);
+#else
   gint idx;
 
   idx = find_index (set->active_fds, fd);
   if (idx >= 0) {
-#ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & POLLIN) != 0;
-#else
     WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & (FD_READ | FD_ACCEPT)) != 0;
-#endif
   } else {
     GST_WARNING ("%p: couldn't find fd !", set);
   }
+#endif
   GST_DEBUG ("%p: fd (fd:%d, idx:%d) %d", set, fd->fd, fd->idx, res);
 
   return res;
@@ -1308,7 +1642,11 @@ gboolean
 gst_poll_fd_can_write (const GstPoll * set, GstPollFD * fd)
 {
   gboolean res = FALSE;
+#ifndef G_OS_WIN32
+  gshort revents;
+#else
   gint idx;
+#endif
 
   g_return_val_if_fail (set != NULL, FALSE);
   g_return_val_if_fail (fd != NULL, FALSE);
@@ -1316,20 +1654,21 @@ gst_poll_fd_can_write (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
-  if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & POLLOUT) != 0;
+  if (get_revents (set, fd, &revents))
+    res = (revents & POLLOUT) != 0;
+  else
+    GST_WARNING ("%p: couldn't find fd !", set);
 #else
+  idx = find_index (set->active_fds, fd);
+  if (idx >= 0) {
     WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & FD_WRITE) != 0;
-#endif
   } else {
     GST_WARNING ("%p: couldn't find fd !", set);
   }
+#endif
   g_mutex_unlock (&((GstPoll *) set)->lock);
 
   GST_DEBUG ("%p: fd (fd:%d, idx:%d) %d", set, fd->fd, fd->idx, res);
@@ -1357,7 +1696,7 @@ gst_poll_fd_has_pri (const GstPoll * set, GstPollFD * fd)
   return FALSE;
 #else
   gboolean res = FALSE;
-  gint idx;
+  gshort revents;
 
   g_return_val_if_fail (set != NULL, FALSE);
   g_return_val_if_fail (fd != NULL, FALSE);
@@ -1365,14 +1704,10 @@ gst_poll_fd_has_pri (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
-  if (idx >= 0) {
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
-
-    res = (pfd->revents & POLLPRI) != 0;
-  } else {
+  if (get_revents (set, fd, &revents))
+    res = (revents & POLLPRI) != 0;
+  else
     GST_WARNING ("%p: couldn't find fd !", set);
-  }
   g_mutex_unlock (&((GstPoll *) set)->lock);
 
   GST_DEBUG ("%p: fd (fd:%d, idx:%d) %d", set, fd->fd, fd->idx, res);
@@ -1434,7 +1769,8 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 
     mode = choose_mode (set, timeout);
 
-    if (TEST_REBUILD (set)) {
+    /* the kernel keeps the fds of an epoll set, nothing to rebuild */
+    if (mode != GST_POLL_MODE_EPOLL && TEST_REBUILD (set)) {
       g_mutex_lock (&set->lock);
 #ifndef G_OS_WIN32
       g_array_set_size (set->active_fds, set->fds->len);
@@ -1593,6 +1929,16 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 #else
         g_assert_not_reached ();
         errno = ENOSYS;
+#endif
+        break;
+      }
+      case GST_POLL_MODE_EPOLL:
+      {
+#ifdef HAVE_EPOLL
+        res = epoll_wait_fds (set, timeout);
+#else
+        g_assert_not_reached ();
+        errno = ENOSYS;
 #endif
         break;
       }
@@ -78,6 +78,11 @@
  * checked to make sure the information is minimally valid. If not, the entry is
  * simply dropped.
  *
+ * If the `GST_REGISTRY_FAST_VALIDATE` environment variable is set, the cache
+ * also stores a hash of the plugin search paths and of the modification times
+ * of all directories that are scanned for plugins. On startup the cache is used without
+ * checking the individual plugin files as long as this hash did not change.
+ *
  * ## Implementation notes:
  *
  * The "cache" and "registry" are different concepts and can represent
@@ -140,6 +145,9 @@ extern HMODULE _priv_gst_dll_handle;
 
 #define GST_CAT_DEFAULT GST_CAT_REGISTRY
 
+/* how deep plugin paths are scanned for plugins */
+#define SCAN_PATH_MAX_LEVEL 10
+
 struct _GstRegistryPrivate
 {
   GList *plugins;
@@ -1408,7 +1416,7 @@ gst_registry_scan_path_internal (GstRegistryScanContext * context,
   gboolean changed;
 
   GST_DEBUG_OBJECT (context->registry, "scanning path %s", path);
-  changed = gst_registry_scan_path_level (context, path, 10);
+  changed = gst_registry_scan_path_level (context, path, SCAN_PATH_MAX_LEVEL);
 
   GST_DEBUG_OBJECT (context->registry, "registry changed in path %s: %d", path,
       changed);
@@ -1760,43 +1768,21 @@ typedef enum
   REGISTRY_SCAN_AND_UPDATE_SUCCESS_UPDATED
 } GstRegistryScanAndUpdateResult;
 
-/*
- * scan_and_update_registry:
- * @default_registry: the #GstRegistry
- * @registry_file: registry filename
- * @write_changes: write registry if it has changed?
- *
- * Scans for registry changes and eventually updates the registry cache.
- *
- * Return: %REGISTRY_SCAN_AND_UPDATE_FAILURE if the registry could not scanned
- *         or updated, %REGISTRY_SCAN_AND_UPDATE_SUCCESS_NOT_CHANGED if the
- *         registry is clean and %REGISTRY_SCAN_AND_UPDATE_SUCCESS_UPDATED if
- *         it has been updated and the cache needs to be re-read.
- */
-static GstRegistryScanAndUpdateResult
-scan_and_update_registry (GstRegistry * default_registry,
-    const gchar * registry_file, gboolean write_changes, GError ** error)
+/* Returns the directories to scan for plugins, in the order in which they
+ * take precedence */
+static GPtrArray *
+gst_registry_get_plugin_search_paths (void)
 {
+  GPtrArray *paths;
   const gchar *plugin_path;
-  gboolean changed = FALSE;
   GList *l;
-  GstRegistryScanContext context;
 
-  GST_INFO ("Validating plugins from registry cache: %s", registry_file);
-
-  init_scan_context (&context, default_registry);
-
-  /* It sounds tempting to just compare the mtime of directories with the mtime
-   * of the registry cache, but it does not work. It would not catch updated
-   * plugins, which might bring more or less features.
-   */
+  paths = g_ptr_array_new_with_free_func (g_free);
 
-  /* scan paths specified via --gst-plugin-path */
+  /* paths specified via --gst-plugin-path */
   GST_DEBUG ("scanning paths added via --gst-plugin-path");
-  for (l = _priv_gst_plugin_paths; l != NULL; l = l->next) {
-    GST_INFO ("Scanning plugin path: \"%s\"", (gchar *) l->data);
-    changed |= gst_registry_scan_path_internal (&context, (gchar *) l->data);
-  }
+  for (l = _priv_gst_plugin_paths; l != NULL; l = l->next)
+    g_ptr_array_add (paths, g_strdup (l->data));
   /* keep plugin_paths around in case a re-scan is forced later on */
 
   /* GST_PLUGIN_PATH specifies a list of directories to scan for
@@ -1810,9 +1796,8 @@ scan_and_update_registry (GstRegistry * default_registry,
 
     GST_DEBUG ("GST_PLUGIN_PATH set to %s", plugin_path);
     list = g_strsplit (plugin_path, G_SEARCHPATH_SEPARATOR_S, 0);
-    for (i = 0; list[i]; i++) {
-      changed |= gst_registry_scan_path_internal (&context, list[i]);
-    }
+    for (i = 0; list[i]; i++)
+      g_ptr_array_add (paths, g_strdup (list[i]));
     g_strfreev (list);
   } else {
     GST_DEBUG ("GST_PLUGIN_PATH not set");
@@ -1825,18 +1810,14 @@ scan_and_update_registry (GstRegistry * default_registry,
   if (plugin_path == NULL)
     plugin_path = g_getenv ("GST_PLUGIN_SYSTEM_PATH");
   if (plugin_path == NULL) {
-    char *home_plugins, *relocated_libgstreamer, *system_plugindir;
+    char *relocated_libgstreamer;
 
     GST_DEBUG ("GST_PLUGIN_SYSTEM_PATH not set");
 
     /* plugins in the user's home directory take precedence over
      * system-installed ones */
-    home_plugins = g_build_filename (g_get_user_data_dir (),
-        "gstreamer-" GST_API_VERSION, "plugins", NULL);
-
-    GST_DEBUG ("scanning home plugins %s", home_plugins);
-    changed |= gst_registry_scan_path_internal (&context, home_plugins);
-    g_free (home_plugins);
+    g_ptr_array_add (paths, g_build_filename (g_get_user_data_dir (),
+            "gstreamer-" GST_API_VERSION, "plugins", NULL));
 
     /* add the main (installed) library path */
 
@@ -1844,16 +1825,12 @@ scan_and_update_registry (GstRegistry * default_registry,
     if (relocated_libgstreamer) {
       GST_DEBUG ("found libgstreamer-" GST_API_VERSION " library "
           "at %s", relocated_libgstreamer);
-      system_plugindir = g_build_filename (relocated_libgstreamer,
-          "gstreamer-" GST_API_VERSION, NULL);
+      g_ptr_array_add (paths, g_build_filename (relocated_libgstreamer,
+              "gstreamer-" GST_API_VERSION, NULL));
     } else {
-      system_plugindir = g_strdup (PLUGINDIR);
+      g_ptr_array_add (paths, g_strdup (PLUGINDIR));
     }
 
-    GST_DEBUG ("using plugin dir %s", system_plugindir);
-    changed |= gst_registry_scan_path_internal (&context, system_plugindir);
-
-    g_clear_pointer (&system_plugindir, g_free);
     g_clear_pointer (&relocated_libgstreamer, g_free);
   } else {
     gchar **list;
@@ -1861,19 +1838,249 @@ scan_and_update_registry (GstRegistry * default_registry,
 
     GST_DEBUG ("GST_PLUGIN_SYSTEM_PATH set to %s", plugin_path);
     list = g_strsplit (plugin_path, G_SEARCHPATH_SEPARATOR_S, 0);
-    for (i = 0; list[i]; i++) {
-      changed |= gst_registry_scan_path_internal (&context, list[i]);
-    }
+    for (i = 0; list[i]; i++)
+      g_ptr_array_add (paths, g_strdup (list[i]));
     g_strfreev (list);
   }
 
+  return paths;
+}
+
+static gboolean
+gst_registry_manifest_add_dir (GChecksum * cs, const gchar * path,
+    time_t scan_start)
+{
+  GStatBuf dir_status;
+  gint64 mtime = -1;
+
+  g_checksum_update (cs, (const guchar *) path, strlen (path) + 1);
+
+  if (g_stat (path, &dir_status) == 0) {
+    /* the cache can't have seen changes made to a directory while, or in the
+     * same second as, it was scanned */
+    if (scan_start != 0 && dir_status.st_mtime >= scan_start) {
+      GST_INFO ("directory %s was modified during the scan", path);
+      return FALSE;
+    }
+    mtime = dir_status.st_mtime;
+  }
+  g_checksum_update (cs, (const guchar *) &mtime, sizeof (mtime));
+
+  return TRUE;
+}
+
+/* adds @path and the directories below it like gst_registry_scan_path_level()
+ * visits them */
+static gboolean
+gst_registry_manifest_add_tree (GChecksum * cs, const gchar * path,
+    int level, time_t scan_start)
+{
+  GDir *dir;
+  const gchar *dirent;
+  GList *l, *names = NULL;
+  gboolean valid;
+
+  valid = gst_registry_manifest_add_dir (cs, path, scan_start);
+  if (!valid || level <= 0)
+    return valid;
+
+  dir = g_dir_open (path, 0, NULL);
+  if (!dir)
+    return TRUE;
+
+  /* the order of the entries can differ between runs */
+  while ((dirent = g_dir_read_name (dir)))
+    names = g_list_prepend (names, g_strdup (dirent));
+  g_dir_close (dir);
+  names = g_list_sort (names, (GCompareFunc) strcmp);
+
+  for (l = names; valid && l != NULL; l = l->next) {
+    const gchar *name = l->data;
+    gchar *filename;
+
+    /* the plugins themselves, saves a stat() for most entries */
+    if (g_str_has_suffix (name, "." G_MODULE_SUFFIX)
+#ifdef GST_EXTRA_MODULE_SUFFIX
+        || g_str_has_suffix (name, GST_EXTRA_MODULE_SUFFIX)
+#endif
+        )
+      continue;
+
+    if (skip_directory (path, name))
+      continue;
+
+    filename = g_build_filename (path, name, NULL);
+    if (g_file_test (filename, G_FILE_TEST_IS_DIR))
+      valid = gst_registry_manifest_add_tree (cs, filename, level - 1,
+          scan_start);
+    g_free (filename);
+  }
+  g_list_free_full (names, g_free);
+
+  return valid;
+}
+
+/*
+ * gst_registry_get_manifest:
+ * @registry: the #GstRegistry
+ * @paths: the plugin search paths
+ * @scan_start: the time the scan of @paths started, or 0
+ *
+ * Hashes @paths together with the modification times of these directories
+ * and of all directories below them that are scanned for plugins. Adding,
+ * removing or renaming a plugin file or a directory changes the modification
+ * time of its parent directory, so the registry cache is still current if this
+ * hash did not change since it was written. Plugin files that are overwritten
+ * in place are not detected.
+ *
+ * Returns: the manifest hash, or 0 if a directory was modified after
+ * @scan_start.
+ */
+static guint64
+gst_registry_get_manifest (GstRegistry * registry, GPtrArray * paths,
+    time_t scan_start)
+{
+  GChecksum *cs;
+  guint8 digest[32];
+  gsize digest_len = sizeof (digest);
+  guint64 manifest = 0;
+  gboolean valid = TRUE;
+  guint i;
+
+  cs = g_checksum_new (G_CHECKSUM_SHA256);
+
+  /* plugins are found recursively, so a new plugin can be in a new directory
+   * below a search path */
+  for (i = 0; valid && i < paths->len; i++)
+    valid = gst_registry_manifest_add_tree (cs, paths->pdata[i],
+        SCAN_PATH_MAX_LEVEL, scan_start);
+
+  if (valid) {
+    g_checksum_get_digest (cs, digest, &digest_len);
+    memcpy (&manifest, digest, sizeof (manifest));
+    /* 0 means there is no manifest */
+    if (manifest == 0)
+      manifest = 1;
+  }
+  g_checksum_free (cs);
+
+  return manifest;
+}
+
+/*
+ * gst_registry_validate_manifest:
+ * @registry: the #GstRegistry
+ * @cache_manifest: the manifest hash stored in the registry cache
+ *
+ * Checks whether the cache that was just read into @registry is current
+ * without looking at each plugin file, and if so marks the cached plugins as
+ * registered like a full scan would.
+ *
+ * Returns: %TRUE if the registry cache can be used as is.
+ */
+static gboolean
+gst_registry_validate_manifest (GstRegistry * registry, guint64 cache_manifest)
+{
+  GPtrArray *paths;
+  GList *l;
+  guint64 manifest;
+
+  if (cache_manifest == 0) {
+    GST_INFO ("registry cache has no manifest");
+    return FALSE;
+  }
+
+  paths = gst_registry_get_plugin_search_paths ();
+  manifest = gst_registry_get_manifest (registry, paths, 0);
+  g_ptr_array_unref (paths);
+
+  if (manifest != cache_manifest) {
+    GST_INFO ("plugin directories changed since the registry cache was "
+        "written");
+    return FALSE;
+  }
+
+  GST_OBJECT_LOCK (registry);
+  /* the few plugins with external dependencies are checked individually */
+  for (l = registry->priv->plugins; l != NULL; l = l->next) {
+    GstPlugin *plugin = l->data;
+
+    if (plugin->priv->deps != NULL &&
+        (_priv_plugin_deps_env_vars_changed (plugin) ||
+            _priv_plugin_deps_files_changed (plugin))) {
+      GST_INFO ("external dependencies of plugin %s changed",
+          GST_STR_NULL (plugin->filename));
+      GST_OBJECT_UNLOCK (registry);
+      return FALSE;
+    }
+  }
+
+  for (l = registry->priv->plugins; l != NULL; l = l->next) {
+    GstPlugin *plugin = l->data;
+
+    GST_OBJECT_FLAG_UNSET (plugin, GST_PLUGIN_FLAG_CACHED);
+    plugin->registered = TRUE;
+  }
+  GST_OBJECT_UNLOCK (registry);
+
+  return TRUE;
+}
+
+/*
+ * scan_and_update_registry:
+ * @default_registry: the #GstRegistry
+ * @registry_file: registry filename
+ * @write_changes: write registry if it has changed?
+ * @write_manifest: store a manifest in the registry cache, and write it even
+ *     if no plugin changed
+ *
+ * Scans for registry changes and eventually updates the registry cache.
+ *
+ * Return: %REGISTRY_SCAN_AND_UPDATE_FAILURE if the registry could not scanned
+ *         or updated, %REGISTRY_SCAN_AND_UPDATE_SUCCESS_NOT_CHANGED if the
+ *         registry is clean and %REGISTRY_SCAN_AND_UPDATE_SUCCESS_UPDATED if
+ *         it has been updated and the cache needs to be re-read.
+ */
+static GstRegistryScanAndUpdateResult
+scan_and_update_registry (GstRegistry * default_registry,
+    const gchar * registry_file, gboolean write_changes,
+    gboolean write_manifest, GError ** error)
+{
+  gboolean changed = FALSE;
+  GPtrArray *paths;
+  GstRegistryScanContext context;
+  guint64 manifest = 0;
+  time_t scan_start;
+  guint i;
+
+  GST_INFO ("Validating plugins from registry cache: %s", registry_file);
+
+  init_scan_context (&context, default_registry);
+
+  /* It sounds tempting to just compare the mtime of directories with the mtime
+   * of the registry cache, but it does not work. It would not catch updated
+   * plugins, which might bring more or less features. Only the opt-in
+   * manifest does that, see gst_registry_get_manifest().
+   */
+
+  scan_start = time (NULL);
+  paths = gst_registry_get_plugin_search_paths ();
+  for (i = 0; i < paths->len; i++) {
+    GST_INFO ("Scanning plugin path: \"%s\"", (gchar *) paths->pdata[i]);
+    changed |= gst_registry_scan_path_internal (&context, paths->pdata[i]);
+  }
+
   clear_scan_context (&context);
   changed |= context.changed;
 
   /* Remove cached plugins so stale info is cleared. */
   changed |= gst_registry_remove_cache_plugins (default_registry);
 
-  if (!changed) {
+  if (write_manifest)
+    manifest = gst_registry_get_manifest (default_registry, paths, scan_start);
+  g_ptr_array_unref (paths);
+
+  if (!changed && !write_manifest) {
     GST_INFO ("Registry cache has not changed");
     return REGISTRY_SCAN_AND_UPDATE_SUCCESS_NOT_CHANGED;
   }
@@ -1883,9 +2090,12 @@ scan_and_update_registry (GstRegistry * default_registry,
     return REGISTRY_SCAN_AND_UPDATE_FAILURE;
   }
 
-  GST_INFO ("Registry cache changed. Writing new registry cache");
+  if (changed)
+    GST_INFO ("Registry cache changed. Writing new registry cache");
+  else
+    GST_INFO ("Writing registry cache with new manifest");
   if (!priv_gst_registry_binary_write_cache (default_registry,
-          default_registry->priv->plugins, registry_file)) {
+          default_registry->priv->plugins, registry_file, manifest)) {
     g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
         _("Error writing registry cache to %s: %s"),
         registry_file, g_strerror (errno));
@@ -1893,7 +2103,8 @@ scan_and_update_registry (GstRegistry * default_registry,
   }
 
   GST_INFO ("Registry cache written successfully");
-  return REGISTRY_SCAN_AND_UPDATE_SUCCESS_UPDATED;
+  return changed ? REGISTRY_SCAN_AND_UPDATE_SUCCESS_UPDATED :
+      REGISTRY_SCAN_AND_UPDATE_SUCCESS_NOT_CHANGED;
 }
 
 static void
@@ -1903,6 +2114,10 @@ ensure_current_registry (GError ** error)
   GstRegistry *default_registry;
   gboolean do_update = TRUE;
   gboolean have_cache = TRUE;
+  gboolean fast_validate = FALSE;
+  gboolean cache_read = FALSE;
+  guint64 cache_manifest = 0;
+  const gchar *fast_env;
 
   default_registry = gst_registry_get ();
 
@@ -1914,13 +2129,19 @@ ensure_current_registry (GError ** error)
         "gstreamer-" GST_API_VERSION, GST_REGISTRY_FILE_NAME, NULL);
   }
 
+  if ((fast_env = g_getenv ("GST_REGISTRY_FAST_VALIDATE"))) {
+    /* enabled for any value different from "no" */
+    fast_validate = (strcmp (fast_env, "no") != 0);
+  }
+
   if (!_gst_disable_registry_cache) {
     GST_INFO ("reading registry cache: %s", registry_file);
     have_cache = priv_gst_registry_binary_read_cache (default_registry,
-        registry_file);
+        registry_file, &cache_manifest);
     /* Only ever read the registry cache once, then disable it for
      * subsequent updates during the program lifetime */
     _gst_disable_registry_cache = TRUE;
+    cache_read = have_cache;
   }
 
   if (have_cache) {
@@ -1935,6 +2156,13 @@ ensure_current_registry (GError ** error)
     }
   }
 
+  /* an explicit gst_update_registry() later on always does a full scan */
+  if (do_update && fast_validate && cache_read &&
+      gst_registry_validate_manifest (default_registry, cache_manifest)) {
+    GST_INFO ("registry cache validated by its manifest");
+    do_update = FALSE;
+  }
+
   if (do_update) {
     const gchar *reuse_env;
 
@@ -1944,7 +2172,8 @@ ensure_current_registry (GError ** error)
     }
     /* now check registry */
     GST_DEBUG ("Updating registry cache");
-    scan_and_update_registry (default_registry, registry_file, TRUE, error);
+    scan_and_update_registry (default_registry, registry_file, TRUE,
+        fast_validate, error);
   } else {
     GST_DEBUG ("Not updating registry cache (disabled)");
   }
@@ -413,6 +413,7 @@ gst_registry_binary_initialize_magic (GstBinaryRegistryMagic * m)
  * gst_registry_binary_write_cache:
  * @registry: a #GstRegistry
  * @location: a filename
+ * @manifest_hash: the manifest of the plugin directories, or 0
  *
  * Write the @registry to a cache to file at given @location.
  *
@@ -420,7 +421,7 @@ gst_registry_binary_initialize_magic (GstBinaryRegistryMagic * m)
  */
 gboolean
 priv_gst_registry_binary_write_cache (GstRegistry * registry, GList * plugins,
-    const char *location)
+    const char *location, guint64 manifest_hash)
 {
   GList *walk;
   GstBinaryRegistryMagic magic;
@@ -458,7 +459,7 @@ priv_gst_registry_binary_write_cache (GstRegistry * registry, GList * plugins,
   }
 
   _priv_gst_registry_chunks_save_global_header (&to_write, registry,
-      priv_gst_plugin_loading_get_whitelist_hash ());
+      priv_gst_plugin_loading_get_whitelist_hash (), manifest_hash);
 
   GST_INFO ("Writing binary registry cache");
 
@@ -564,6 +565,7 @@ fail:
  * gst_registry_binary_read_cache:
  * @registry: a #GstRegistry
  * @location: a filename
+ * @manifest_hash: (out): the manifest the cache was written with
  *
  * Read the contents of the binary cache file at @location into @registry.
  *
@@ -571,7 +573,7 @@ fail:
  */
 gboolean
 priv_gst_registry_binary_read_cache (GstRegistry * registry,
-    const char *location)
+    const char *location, guint64 * manifest_hash)
 {
   GMappedFile *mapped = NULL;
   gchar *contents = NULL;
@@ -586,6 +588,8 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
   gdouble seconds;
 #endif
 
+  *manifest_hash = 0;
+
   /* make sure these types exist */
   GST_TYPE_ELEMENT_FACTORY;
   GST_TYPE_TYPE_FIND_FACTORY;
@@ -641,7 +645,7 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
   }
 
   if (!_priv_gst_registry_chunks_load_global_header (registry, &in,
-          contents + size, &filter_env_hash)) {
+          contents + size, &filter_env_hash, manifest_hash)) {
     GST_ERROR ("Couldn't read global header chunk");
     goto Error;
   }
@@ -649,6 +653,7 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
   if (filter_env_hash != priv_gst_plugin_loading_get_whitelist_hash ()) {
     GST_INFO_OBJECT (registry, "Plugin loading filter environment changed, "
         "ignoring plugin cache to force update with new filter environment");
+    *manifest_hash = 0;
     goto done;
   }
 
@@ -668,6 +673,7 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
           (guint) ((gsize) in - (gsize) contents), size);
       if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, NULL)) {
         GST_ERROR ("Problem while reading binary registry %s", location);
+        *manifest_hash = 0;
         goto Error;
       }
     }
@@ -932,25 +932,29 @@ fail:
 
 void
 _priv_gst_registry_chunks_save_global_header (GList ** list,
-    GstRegistry * registry, guint32 filter_env_hash)
+    GstRegistry * registry, guint32 filter_env_hash, guint64 manifest_hash)
 {
   GstRegistryChunkGlobalHeader *hdr;
   GstRegistryChunk *chk;
 
-  hdr = g_new (GstRegistryChunkGlobalHeader, 1);
+  /* zeroed so that the padding written to the file is deterministic */
+  hdr = g_new0 (GstRegistryChunkGlobalHeader, 1);
   chk = gst_registry_chunks_make_data (hdr,
       sizeof (GstRegistryChunkGlobalHeader));
 
   hdr->filter_env_hash = filter_env_hash;
+  hdr->manifest_hash = manifest_hash;
 
   *list = g_list_prepend (*list, chk);
 
-  GST_LOG ("Saved global header (filter_env_hash=0x%08x)", filter_env_hash);
+  GST_LOG ("Saved global header (filter_env_hash=0x%08x, manifest_hash=0x%016"
+      G_GINT64_MODIFIER "x)", filter_env_hash, manifest_hash);
 }
 
 gboolean
 _priv_gst_registry_chunks_load_global_header (GstRegistry * registry,
-    gchar ** in, gchar * end, guint32 * filter_env_hash)
+    gchar ** in, gchar * end, guint32 * filter_env_hash,
+    guint64 * manifest_hash)
 {
   GstRegistryChunkGlobalHeader *hdr;
 
@@ -958,6 +962,7 @@ _priv_gst_registry_chunks_load_global_header (GstRegistry * registry,
   GST_LOG ("Reading/casting for GstRegistryChunkGlobalHeader at %p", *in);
   unpack_element (*in, hdr, GstRegistryChunkGlobalHeader, end, fail);
   *filter_env_hash = hdr->filter_env_hash;
+  *manifest_hash = hdr->manifest_hash;
   return TRUE;
 
   /* Errors */
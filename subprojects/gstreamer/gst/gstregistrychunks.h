@@ -48,9 +48,19 @@ typedef struct _GstRegistryChunk
   gboolean align;
 } GstRegistryChunk;
 
+/*
+ * GstRegistryChunkGlobalHeader:
+ *
+ * @filter_env_hash: hash of the plugin loading whitelist
+ *
+ * @manifest_hash: hash of the plugin search paths and the modification times
+ * of the directories holding the plugins at the time the cache was written,
+ * or 0 if the cache can't be validated that way.
+ */
 typedef struct _GstRegistryChunkGlobalHeader
 {
   guint32  filter_env_hash;
+  guint64  manifest_hash;
 } GstRegistryChunkGlobalHeader;
 
 /*
@@ -175,11 +185,12 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
 
 void
 _priv_gst_registry_chunks_save_global_header (GList ** list,
-    GstRegistry * registry, guint32 filter_env_hash);
+    GstRegistry * registry, guint32 filter_env_hash, guint64 manifest_hash);
 
 gboolean
 _priv_gst_registry_chunks_load_global_header (GstRegistry * registry,
-    gchar ** in, gchar *end, guint32 * filter_env_hash);
+    gchar ** in, gchar *end, guint32 * filter_env_hash,
+    guint64 * manifest_hash);
 
 void
 _priv_gst_registry_chunk_free (GstRegistryChunk *chunk);
@@ -171,6 +171,14 @@ typedef struct
    *  else it's a pointer to the arr field. */
   GstStructureField *fields;
 
+  /* Hash index of the fields for structures with at least
+   * STRUCTURE_INDEX_MIN_FIELDS fields, NULL if not built yet. index[0] is
+   * the mask of the table, the slots that follow contain the position of a
+   * field in fields + 1, or 0 when empty. Built lazily on the first lookup,
+   * possibly from multiple threads when the structure is shared, and
+   * dropped whenever fields are removed. */
+  guint *index;
+
   GstStructureField arr[1];
 } GstStructureImpl;
 
@@ -190,6 +198,54 @@ typedef struct
 #define IS_TAGLIST(structure) \
     (structure->name == GST_QUARK (TAGLIST))
 
+/* Below this number of fields a linear search over the fields is as fast
+ * as a hash lookup and doesn't need the extra memory */
+#define STRUCTURE_INDEX_MIN_FIELDS 16
+
+/* quarks are mostly sequential numbers, multiplying with an odd constant
+ * spreads them over the table without collisions between neighbours */
+#define STRUCTURE_INDEX_SLOT(quark, mask) \
+    (((guint) (quark) * 2654435769u) & (mask))
+
+static inline void
+_structure_index_insert (guint * index, GQuark name, guint idx)
+{
+  guint mask = index[0];
+  guint slot = STRUCTURE_INDEX_SLOT (name, mask);
+
+  while (index[slot + 1] != 0)
+    slot = (slot + 1) & mask;
+  index[slot + 1] = idx + 1;
+}
+
+static guint *
+_structure_index_build (GstStructureImpl * impl)
+{
+  guint *index;
+  guint i, n_slots = 32;
+
+  /* keep the load factor at most 1/2 */
+  while (n_slots < impl->fields_len * 2)
+    n_slots <<= 1;
+
+  index = g_new0 (guint, n_slots + 1);
+  index[0] = n_slots - 1;
+  for (i = 0; i < impl->fields_len; i++)
+    _structure_index_insert (index, impl->fields[i].name, i);
+
+  GST_CAT_LOG (GST_CAT_PERFORMANCE, "built index with %u slots for %u fields",
+      n_slots, impl->fields_len);
+
+  return index;
+}
+
+static inline void
+_structure_index_clear (GstStructureImpl * impl)
+{
+  g_free (impl->index);
+  impl->index = NULL;
+}
+
 /* Replacement for g_array_append_val */
 static void
 _structure_append_val (GstStructure * s, GstStructureField * val)
@@ -218,6 +274,16 @@ _structure_append_val (GstStructure * s, GstStructureField * val)
 
   /* Finally set value */
   impl->fields[impl->fields_len++] = *val;
+
+  /* keep an existing index up to date, grow it when it gets too full */
+  if (impl->index) {
+    if (impl->fields_len * 2 > impl->index[0] + 1) {
+      _structure_index_clear (impl);
+      impl->index = _structure_index_build (impl);
+    } else {
+      _structure_index_insert (impl->index, val->name, impl->fields_len - 1);
+    }
+  }
 }
 
 /* Replacement for g_array_remove_index */
@@ -230,6 +296,9 @@ _structure_remove_index (GstStructure * s, guint idx)
   if (idx >= impl->fields_len)
     return;
 
+  /* positions of all following fields change, rebuild on the next lookup */
+  _structure_index_clear (impl);
+
   /* Shift everything if it's not the last item */
   if (idx != impl->fields_len)
     memmove (&impl->fields[idx],
@@ -278,7 +347,7 @@ gst_structure_new_id_empty_with_size (GQuark quark, guint prealloc)
 
   n_alloc = GST_ROUND_UP_8 (prealloc);
   structure =
-      g_malloc0 (sizeof (GstStructureImpl) + (n_alloc -
+      _priv_gst_arena_alloc0 (sizeof (GstStructureImpl) + (n_alloc -
           1) * sizeof (GstStructureField));
 
   ((GstStructure *) structure)->type = _gst_structure_type;
@@ -540,13 +609,14 @@ gst_structure_free (GstStructure * structure)
   }
   if (GST_STRUCTURE_IS_USING_DYNAMIC_ARRAY (structure))
     g_free (((GstStructureImpl *) structure)->fields);
+  g_free (((GstStructureImpl *) structure)->index);
 
 #ifdef USE_POISONING
   memset (structure, 0xff, sizeof (GstStructure));
 #endif
   GST_TRACE ("free structure %p", structure);
 
-  g_free (structure);
+  _priv_gst_arena_free (structure);
 }
 
 /**
@@ -1062,7 +1132,6 @@ static void
 gst_structure_set_field (GstStructure * structure, GstStructureField * field)
 {
   GstStructureField *f;
-  guint i, len;
 
   if (!gst_structure_validate_field_value (structure, field->name,
           &field->value)) {
@@ -1070,15 +1139,11 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
     return;
   }
 
-  len = GST_STRUCTURE_LEN (structure);
-  for (i = 0; i < len; i++) {
-    f = GST_STRUCTURE_FIELD (structure, i);
-
-    if (G_UNLIKELY (f->name == field->name)) {
-      g_value_unset (&f->value);
-      memcpy (f, field, sizeof (GstStructureField));
-      return;
-    }
+  f = gst_structure_id_get_field (structure, field->name);
+  if (G_UNLIKELY (f != NULL)) {
+    g_value_unset (&f->value);
+    memcpy (f, field, sizeof (GstStructureField));
+    return;
   }
 
   _structure_append_val (structure, field);
@@ -1089,11 +1154,37 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
 static GstStructureField *
 gst_structure_id_get_field (const GstStructure * structure, GQuark field_id)
 {
+  GstStructureImpl *impl = (GstStructureImpl *) structure;
   GstStructureField *field;
   guint i, len;
 
   len = GST_STRUCTURE_LEN (structure);
 
+  if (len >= STRUCTURE_INDEX_MIN_FIELDS) {
+    guint *index, mask, slot;
+
+    index = g_atomic_pointer_get (&impl->index);
+    if (G_UNLIKELY (index == NULL)) {
+      /* the structure might be shared and looked up from multiple threads,
+       * only one of them gets to install its index */
+      index = _structure_index_build (impl);
+      if (!g_atomic_pointer_compare_and_exchange (&impl->index, NULL, index)) {
+        g_free (index);
+        index = g_atomic_pointer_get (&impl->index);
+      }
+    }
+
+    mask = index[0];
+    slot = STRUCTURE_INDEX_SLOT (field_id, mask);
+    while ((i = index[slot + 1]) != 0) {
+      field = GST_STRUCTURE_FIELD (structure, i - 1);
+      if (field->name == field_id)
+        return field;
+      slot = (slot + 1) & mask;
+    }
+    return NULL;
+  }
+
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
 
@@ -2916,28 +3007,16 @@ G_STMT_START {                                                                \
   }                                                                           \
 } G_STMT_END
 
-/**
- * gst_structure_get_valist:
- * @structure: a #GstStructure
- * @first_fieldname: the name of the first field to read
- * @args: variable arguments
- *
- * Parses the variable arguments and reads fields from @structure accordingly.
- * valist-variant of gst_structure_get(). Look at the documentation of
- * gst_structure_get() for more details.
- *
- * Returns: %TRUE, or %FALSE if there was a problem reading any of the fields
- */
-gboolean
-gst_structure_get_valist (const GstStructure * structure,
-    const char *first_fieldname, va_list args)
+/* Reads the fields like gst_structure_get_valist(), @lcopy_flags are passed
+ * to the lcopy function of the value types to decide whether the caller
+ * gets a copy of the value or the value owned by the structure. */
+static gboolean
+gst_structure_get_valist_full (const GstStructure * structure,
+    const char *first_fieldname, va_list args, guint lcopy_flags)
 {
   const char *field_name;
   GType expected_type = G_TYPE_INVALID;
 
-  g_return_val_if_fail (GST_IS_STRUCTURE (structure), FALSE);
-  g_return_val_if_fail (first_fieldname != NULL, FALSE);
-
   field_name = first_fieldname;
   while (field_name) {
     const GValue *val = NULL;
@@ -2953,7 +3032,7 @@ gst_structure_get_valist (const GstStructure * structure,
     if (G_VALUE_TYPE (val) != expected_type)
       goto wrong_type;
 
-    GST_VALUE_LCOPY (val, args, 0, &err, field_name);
+    GST_VALUE_LCOPY (val, args, lcopy_flags, &err, field_name);
     if (err) {
       g_warning ("%s: %s", G_STRFUNC, err);
       g_free (err);
@@ -2983,6 +3062,53 @@ wrong_type:
   }
 }
 
+/**
+ * gst_structure_get_valist:
+ * @structure: a #GstStructure
+ * @first_fieldname: the name of the first field to read
+ * @args: variable arguments
+ *
+ * Parses the variable arguments and reads fields from @structure accordingly.
+ * valist-variant of gst_structure_get(). Look at the documentation of
+ * gst_structure_get() for more details.
+ *
+ * Returns: %TRUE, or %FALSE if there was a problem reading any of the fields
+ */
+gboolean
+gst_structure_get_valist (const GstStructure * structure,
+    const char *first_fieldname, va_list args)
+{
+  g_return_val_if_fail (GST_IS_STRUCTURE (structure), FALSE);
+  g_return_val_if_fail (first_fieldname != NULL, FALSE);
+
+  return gst_structure_get_valist_full (structure, first_fieldname, args, 0);
+}
+
+/**
+ * gst_structure_get_borrowed_valist:
+ * @structure: a #GstStructure
+ * @first_fieldname: the name of the first field to read
+ * @args: variable arguments
+ *
+ * Parses the variable arguments and reads fields from @structure accordingly.
+ * valist-variant of gst_structure_get_borrowed(). Look at the documentation
+ * of gst_structure_get_borrowed() for more details.
+ *
+ * Returns: %TRUE, or %FALSE if there was a problem reading any of the fields
+ *
+ * Since: 1.26
+ */
+gboolean
+gst_structure_get_borrowed_valist (const GstStructure * structure,
+    const char *first_fieldname, va_list args)
+{
+  g_return_val_if_fail (GST_IS_STRUCTURE (structure), FALSE);
+  g_return_val_if_fail (first_fieldname != NULL, FALSE);
+
+  return gst_structure_get_valist_full (structure, first_fieldname, args,
+      G_VALUE_NOCOPY_CONTENTS);
+}
+
 /**
  * gst_structure_id_get_valist:
  * @structure: a #GstStructure
@@ -3088,6 +3214,45 @@ gst_structure_get (const GstStructure * structure, const char *first_fieldname,
   return ret;
 }
 
+/**
+ * gst_structure_get_borrowed:
+ * @structure: a #GstStructure
+ * @first_fieldname: the name of the first field to read
+ * @...: variable arguments
+ *
+ * Parses the variable arguments and reads fields from @structure accordingly,
+ * like gst_structure_get() but without copying the values.
+ *
+ * For refcounted (mini)objects, strings and boxed types you will receive a
+ * pointer to the value owned by @structure, no reference is added and
+ * nothing needs to be freed. The values are only valid as long as @structure
+ * is not modified or freed. This avoids the copies of gst_structure_get()
+ * when only looking at nested structures, caps or strings of large
+ * structures such as statistics.
+ *
+ * Returns: %FALSE if there was a problem reading any of the fields (e.g.
+ *     because the field requested did not exist, or was of a type other
+ *     than the type specified), otherwise %TRUE.
+ *
+ * Since: 1.26
+ */
+gboolean
+gst_structure_get_borrowed (const GstStructure * structure,
+    const char *first_fieldname, ...)
+{
+  gboolean ret;
+  va_list args;
+
+  g_return_val_if_fail (GST_IS_STRUCTURE (structure), FALSE);
+  g_return_val_if_fail (first_fieldname != NULL, FALSE);
+
+  va_start (args, first_fieldname);
+  ret = gst_structure_get_borrowed_valist (structure, first_fieldname, args);
+  va_end (args);
+
+  return ret;
+}
+
 /**
  * gst_structure_id_get:
  * @structure: a #GstStructure
@@ -3209,25 +3374,23 @@ gst_structure_intersect (const GstStructure * struct1,
    * intersect if we have the field in both */
   for (it1 = 0; it1 < len1; it1++) {
     GstStructureField *field1 = GST_STRUCTURE_FIELD (struct1, it1);
-    gboolean seenother = FALSE;
-    for (it2 = 0; it2 < len2; it2++) {
-      GstStructureField *field2 = GST_STRUCTURE_FIELD (struct2, it2);
-      if (field1->name == field2->name) {
-        GValue dest_value = { 0 };
-        seenother = TRUE;
-        /* Get the intersection if any */
-        if (gst_value_intersect (&dest_value, &field1->value, &field2->value)) {
-          gst_structure_id_take_value (dest, field1->name, &dest_value);
-          break;
-        } else {
-          /* No intersection, return nothing */
-          goto error;
-        }
+    GstStructureField *field2 =
+        gst_structure_id_get_field (struct2, field1->name);
+
+    if (field2) {
+      GValue dest_value = { 0 };
+
+      /* Get the intersection if any */
+      if (gst_value_intersect (&dest_value, &field1->value, &field2->value)) {
+        gst_structure_id_take_value (dest, field1->name, &dest_value);
+      } else {
+        /* No intersection, return nothing */
+        goto error;
       }
-    }
-    /* Field1 was only present in struct1, copy it over */
-    if (!seenother)
+    } else {
+      /* Field1 was only present in struct1, copy it over */
       gst_structure_id_set_value (dest, field1->name, &field1->value);
+    }
   }
 
   /* Now iterate over the 2nd struct and copy over everything which
@@ -3235,17 +3398,9 @@ gst_structure_intersect (const GstStructure * struct1,
    * values being present in both just above) */
   for (it2 = 0; it2 < len2; it2++) {
     GstStructureField *field2 = GST_STRUCTURE_FIELD (struct2, it2);
-    gboolean seenother = FALSE;
-    for (it1 = 0; it1 < len1; it1++) {
-      GstStructureField *field1 = GST_STRUCTURE_FIELD (struct1, it1);
-      if (field1->name == field2->name) {
-        seenother = TRUE;
-        break;
-      }
-    }
-    if (!seenother)
-      gst_structure_id_set_value (dest, field2->name, &field2->value);
 
+    if (!gst_structure_id_get_field (struct1, field2->name))
+      gst_structure_id_set_value (dest, field2->name, &field2->value);
   }
 
   return dest;
@@ -3322,7 +3477,7 @@ gboolean
 gst_structure_is_subset (const GstStructure * subset,
     const GstStructure * superset)
 {
-  guint it1, len1, it2, len2;
+  guint len1, it2, len2;
 
   g_assert (superset);
 
@@ -3336,32 +3491,26 @@ gst_structure_is_subset (const GstStructure * subset,
 
   for (it2 = 0; it2 < len2; it2++) {
     GstStructureField *superfield = GST_STRUCTURE_FIELD (superset, it2);
-    gboolean seenother = FALSE;
-    for (it1 = 0; it1 < len1; it1++) {
-      GstStructureField *subfield = GST_STRUCTURE_FIELD (subset, it1);
-      if (subfield->name == superfield->name) {
-        int comparison =
-            gst_value_compare (&subfield->value, &superfield->value);
-        seenother = TRUE;
-
-        /* If present and equal, stop iterating */
-        if (comparison == GST_VALUE_EQUAL)
-          break;
-
-        /* Stop everything if ordered but unequal */
-        if (comparison != GST_VALUE_UNORDERED)
-          return FALSE;
+    GstStructureField *subfield =
+        gst_structure_id_get_field (subset, superfield->name);
+    int comparison;
 
-        /* Stop everything if not a subset */
-        if (!gst_value_is_subset (&subfield->value, &superfield->value))
-          return FALSE;
+    /* We did not see superfield in subfield */
+    if (!subfield)
+      return FALSE;
 
-        break;
-      }
-    }
+    comparison = gst_value_compare (&subfield->value, &superfield->value);
 
-    /* We did not see superfield in subfield */
-    if (!seenother)
+    /* If present and equal, continue with the next field */
+    if (comparison == GST_VALUE_EQUAL)
+      continue;
+
+    /* Stop everything if ordered but unequal */
+    if (comparison != GST_VALUE_UNORDERED)
+      return FALSE;
+
+    /* Stop everything if not a subset */
+    if (!gst_value_is_subset (&subfield->value, &superfield->value))
       return FALSE;
   }
 
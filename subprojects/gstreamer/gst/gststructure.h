@@ -228,6 +228,14 @@ gboolean              gst_structure_get                  (const GstStructure  *
                                                           const char          * first_fieldname,
                                                           ...) G_GNUC_NULL_TERMINATED;
 GST_API
+gboolean              gst_structure_get_borrowed_valist  (const GstStructure  * structure,
+                                                          const char          * first_fieldname,
+                                                          va_list              args);
+GST_API
+gboolean              gst_structure_get_borrowed         (const GstStructure  * structure,
+                                                          const char          * first_fieldname,
+                                                          ...) G_GNUC_NULL_TERMINATED;
+GST_API
 gboolean              gst_structure_id_get_valist        (const GstStructure  * structure,
                                                           GQuark                first_field_id,
                                                           va_list               args);
@@ -227,6 +227,11 @@ struct _GstClockEntryFutex
 
   gboolean initialized;
 
+  /* position in the async queue and insertion order for entries with the
+   * same time, protected by the clock lock */
+  guint queue_index;
+  guint64 queue_seq;
+
   GMutex lock;
   guint cond_val;
 };
@@ -401,6 +406,11 @@ struct _GstClockEntryPThread
 
   gboolean initialized;
 
+  /* position in the async queue and insertion order for entries with the
+   * same time, protected by the clock lock */
+  guint queue_index;
+  guint64 queue_seq;
+
   pthread_cond_t cond;
   pthread_mutex_t lock;
 };
@@ -533,6 +543,11 @@ struct _GstClockEntryGLib
 
   gboolean initialized;
 
+  /* position in the async queue and insertion order for entries with the
+   * same time, protected by the clock lock */
+  guint queue_index;
+  guint64 queue_seq;
+
   GMutex lock;
   GCond cond;
 };
@@ -558,12 +573,15 @@ init_entry (GstClockEntryImpl * entry)
 G_STATIC_ASSERT (sizeof (GstClockEntryImpl) <=
     sizeof (struct _GstClockEntryImpl));
 
+#define ENTRY_NOT_QUEUED G_MAXUINT
+
 /* Must be called with clock lock */
 static inline void
 ensure_entry_initialized (GstClockEntryImpl * entry_impl)
 {
   if (!entry_impl->initialized) {
     init_entry (entry_impl);
+    entry_impl->queue_index = ENTRY_NOT_QUEUED;
     entry_impl->initialized = TRUE;
   }
 }
@@ -573,12 +591,115 @@ struct _GstSystemClockPrivate
   GThread *thread;              /* thread for async notify */
   gboolean stopping;
 
-  GList *entries;
+  /* binary min-heap of the pending async entries, each holding a ref */
+  GPtrArray *entries;
+  guint64 entries_seq;
+  /* entry taken from the heap by the async thread, the thread holds its ref */
+  GstClockEntryImpl *current;
   GCond entries_changed;
 
   GstClockType clock_type;
 };
 
+/* The async entries are kept in a binary min-heap ordered by time, and by
+ * insertion order for entries with the same time. Each entry knows its
+ * position in the heap, so that it can be removed or moved in O(log n) when it
+ * is unscheduled or rescheduled. All of this must be called with the clock
+ * lock. */
+static inline gboolean
+entry_is_earlier (GstClockEntryImpl * a, GstClockEntryImpl * b)
+{
+  GstClockTime ta = GST_CLOCK_ENTRY_TIME ((GstClockEntry *) a);
+  GstClockTime tb = GST_CLOCK_ENTRY_TIME ((GstClockEntry *) b);
+
+  return ta < tb || (ta == tb && a->queue_seq < b->queue_seq);
+}
+
+static inline void
+entries_set (GPtrArray * entries, guint index, GstClockEntryImpl * entry)
+{
+  g_ptr_array_index (entries, index) = entry;
+  entry->queue_index = index;
+}
+
+static void
+entries_sift_up (GPtrArray * entries, guint index)
+{
+  GstClockEntryImpl *entry = g_ptr_array_index (entries, index);
+
+  while (index > 0) {
+    guint parent = (index - 1) / 2;
+    GstClockEntryImpl *p = g_ptr_array_index (entries, parent);
+
+    if (!entry_is_earlier (entry, p))
+      break;
+    entries_set (entries, index, p);
+    index = parent;
+  }
+  entries_set (entries, index, entry);
+}
+
+static void
+entries_sift_down (GPtrArray * entries, guint index)
+{
+  GstClockEntryImpl *entry = g_ptr_array_index (entries, index);
+  guint len = entries->len;
+
+  while (2 * index + 1 < len) {
+    guint child = 2 * index + 1;
+    GstClockEntryImpl *c = g_ptr_array_index (entries, child);
+
+    if (child + 1 < len &&
+        entry_is_earlier (g_ptr_array_index (entries, child + 1), c)) {
+      child++;
+      c = g_ptr_array_index (entries, child);
+    }
+    if (!entry_is_earlier (c, entry))
+      break;
+    entries_set (entries, index, c);
+    index = child;
+  }
+  entries_set (entries, index, entry);
+}
+
+/* Adds @entry to the heap, taking over a ref. If it is queued already it is
+ * only moved to the position for its current time and the ref is dropped. */
+static void
+entries_push (GstSystemClockPrivate * priv, GstClockEntryImpl * entry)
+{
+  entry->queue_seq = priv->entries_seq++;
+
+  if (entry->queue_index != ENTRY_NOT_QUEUED) {
+    entries_sift_up (priv->entries, entry->queue_index);
+    entries_sift_down (priv->entries, entry->queue_index);
+    gst_clock_id_unref ((GstClockID) entry);
+    return;
+  }
+
+  g_ptr_array_add (priv->entries, entry);
+  entries_sift_up (priv->entries, priv->entries->len - 1);
+}
+
+/* Removes @entry from the heap, the caller takes over the ref it held */
+static void
+entries_remove (GstSystemClockPrivate * priv, GstClockEntryImpl * entry)
+{
+  GPtrArray *entries = priv->entries;
+  guint index = entry->queue_index;
+  GstClockEntryImpl *last;
+
+  g_assert (index < entries->len && g_ptr_array_index (entries,
+          index) == entry);
+
+  entry->queue_index = ENTRY_NOT_QUEUED;
+  last = g_ptr_array_steal_index_fast (entries, entries->len - 1);
+  if (last != entry) {
+    entries_set (entries, index, last);
+    entries_sift_up (entries, index);
+    entries_sift_down (entries, last->queue_index);
+  }
+}
+
 #ifdef HAVE_POSIX_TIMERS
 # ifdef HAVE_MONOTONIC_CLOCK
 #  define DEFAULT_CLOCK_TYPE GST_CLOCK_TYPE_MONOTONIC
@@ -668,7 +789,7 @@ gst_system_clock_init (GstSystemClock * clock)
 
   priv->clock_type = DEFAULT_CLOCK_TYPE;
 
-  priv->entries = NULL;
+  priv->entries = g_ptr_array_new ();
   g_cond_init (&priv->entries_changed);
 
 #if 0
@@ -685,37 +806,39 @@ gst_system_clock_dispose (GObject * object)
   GstClock *clock = (GstClock *) object;
   GstSystemClock *sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   GstSystemClockPrivate *priv = sysclock->priv;
-  GList *entries;
+  guint i;
 
   /* else we have to stop the thread */
   GST_SYSTEM_CLOCK_LOCK (clock);
   priv->stopping = TRUE;
   /* unschedule all entries */
-  for (entries = priv->entries; entries; entries = g_list_next (entries)) {
-    GstClockEntryImpl *entry = (GstClockEntryImpl *) entries->data;
+  for (i = 0; priv->entries && i < priv->entries->len; i++) {
+    GstClockEntryImpl *entry = g_ptr_array_index (priv->entries, i);
 
     /* We don't need to take the entry lock here because the async thread
-     * would only ever look at the head entry, which is locked below and only
-     * accesses new entries with the clock lock, which we hold here.
+     * would only ever look at the entry it took from the queue, which is
+     * locked below, and only accesses new entries with the clock lock, which
+     * we hold here.
      */
     GST_CLOCK_ENTRY_STATUS ((GstClockEntry *) entry) = GST_CLOCK_UNSCHEDULED;
+  }
 
-    /* Wake up only the head entry: the async thread would only be waiting for
-     * this one, not all of them. Once the head entry is unscheduled it tries
-     * to get the system clock lock (which we hold here) and then look for the
-     * next entry. Once it gets the lock it will notice that all further
-     * entries are unscheduled, would remove them one by one from the list and
-     * then shut down. */
-    if (!entries->prev) {
-      /* it was initialized before adding to the list */
-      g_assert (entry->initialized);
-
-      GST_SYSTEM_CLOCK_ENTRY_LOCK (entry);
-      GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "unscheduling entry %p",
-          entry);
-      GST_SYSTEM_CLOCK_ENTRY_BROADCAST (entry);
-      GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
-    }
+  /* Wake up only the entry the async thread is working on: it would only be
+   * waiting for this one, not any of the queued ones. Once it is unscheduled
+   * the thread tries to get the system clock lock (which we hold here), notices
+   * that the clock is stopping and shuts down. */
+  if (priv->current) {
+    GstClockEntryImpl *entry = priv->current;
+
+    /* it was initialized before adding to the queue */
+    g_assert (entry->initialized);
+
+    GST_SYSTEM_CLOCK_ENTRY_LOCK (entry);
+    GST_CLOCK_ENTRY_STATUS ((GstClockEntry *) entry) = GST_CLOCK_UNSCHEDULED;
+    GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "unscheduling entry %p",
+        entry);
+    GST_SYSTEM_CLOCK_ENTRY_BROADCAST (entry);
+    GST_SYSTEM_CLOCK_ENTRY_UNLOCK (entry);
   }
   GST_SYSTEM_CLOCK_BROADCAST (clock);
   GST_SYSTEM_CLOCK_UNLOCK (clock);
@@ -725,9 +848,16 @@ gst_system_clock_dispose (GObject * object)
   priv->thread = NULL;
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "joined thread");
 
-  g_list_foreach (priv->entries, (GFunc) gst_clock_id_unref, NULL);
-  g_list_free (priv->entries);
-  priv->entries = NULL;
+  if (priv->entries) {
+    for (i = 0; i < priv->entries->len; i++) {
+      GstClockEntryImpl *entry = g_ptr_array_index (priv->entries, i);
+
+      entry->queue_index = ENTRY_NOT_QUEUED;
+      gst_clock_id_unref ((GstClockID) entry);
+    }
+    g_ptr_array_free (priv->entries, TRUE);
+    priv->entries = NULL;
+  }
 
   g_cond_clear (&priv->entries_changed);
 
@@ -852,7 +982,7 @@ gst_system_clock_obtain (void)
   return clock;
 }
 
-/* this thread reads the sorted clock entries from the queue.
+/* this thread takes the earliest clock entry from the queue.
  *
  * It waits on each of them and fires the callback when the timeout occurs.
  *
@@ -883,7 +1013,7 @@ gst_system_clock_async_thread (GstClock * clock)
     GstClockReturn res;
 
     /* check if something to be done */
-    while (priv->entries == NULL) {
+    while (priv->entries->len == 0) {
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
           "no clock entries, waiting..");
       /* wait for work to do */
@@ -894,10 +1024,12 @@ gst_system_clock_async_thread (GstClock * clock)
         goto exit;
     }
 
-    /* pick the next entry */
-    entry = priv->entries->data;
+    /* take the next entry, its ref is ours now */
+    entry = g_ptr_array_index (priv->entries, 0);
+    entries_remove (priv, (GstClockEntryImpl *) entry);
+    priv->current = (GstClockEntryImpl *) entry;
 
-    /* it was initialized before adding to the list */
+    /* it was initialized before adding to the queue */
     g_assert (((GstClockEntryImpl *) entry)->initialized);
 
     /* unlocked before the next loop iteration at latest */
@@ -966,9 +1098,9 @@ gst_system_clock_async_thread (GstClock * clock)
           GST_SYSTEM_CLOCK_LOCK (clock);
           /* adjust time now */
           entry->time = requested + entry->interval;
-          /* and resort the list now */
-          priv->entries =
-              g_list_sort (priv->entries, gst_clock_id_compare_func);
+          /* and put it back into the queue now */
+          priv->current = NULL;
+          entries_push (priv, (GstClockEntryImpl *) entry);
           /* and restart */
           continue;
         } else {
@@ -978,8 +1110,8 @@ gst_system_clock_async_thread (GstClock * clock)
       }
       case GST_CLOCK_BUSY:
         /* somebody unlocked the entry but is was not canceled, This means that
-         * a new entry was added in front of the queue. Pick the new head
-         * entry of the list and continue waiting. */
+         * an earlier entry was added to the queue. Put this one back and
+         * continue waiting on the new earliest entry. */
         GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
             "async entry %p needs restart", entry);
 
@@ -990,6 +1122,8 @@ gst_system_clock_async_thread (GstClock * clock)
         if (entry_needs_unlock)
           GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
         GST_SYSTEM_CLOCK_LOCK (clock);
+        priv->current = NULL;
+        entries_push (priv, (GstClockEntryImpl *) entry);
         continue;
       default:
         GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
@@ -1003,8 +1137,8 @@ gst_system_clock_async_thread (GstClock * clock)
       GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
     GST_SYSTEM_CLOCK_LOCK (clock);
 
-    /* we remove the current entry and unref it */
-    priv->entries = g_list_remove (priv->entries, entry);
+    /* we are done with the current entry and unref it */
+    priv->current = NULL;
     gst_clock_id_unref ((GstClockID) entry);
   }
 exit:
@@ -1336,10 +1470,9 @@ no_thread:
   return FALSE;
 }
 
-/* Add an entry to the list of pending async waits. The entry is inserted
- * in sorted order. If we inserted the entry at the head of the list, we
- * need to signal the thread as it might either be waiting on it or waiting
- * for a new entry.
+/* Add an entry to the queue of pending async waits. If it became the earliest
+ * entry, we need to signal the thread as it might either be waiting on a later
+ * entry or waiting for a new entry.
  *
  * MT safe.
  */
@@ -1348,7 +1481,6 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
 {
   GstSystemClock *sysclock;
   GstSystemClockPrivate *priv;
-  GstClockEntry *head;
 
   sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   priv = sysclock->priv;
@@ -1366,49 +1498,45 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
     goto was_unscheduled;
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
 
-  if (priv->entries)
-    head = priv->entries->data;
-  else
-    head = NULL;
-
   /* need to take a ref */
   gst_clock_id_ref ((GstClockID) entry);
 
-  /* insert the entry in sorted order */
-  priv->entries = g_list_insert_sorted (priv->entries, entry,
-      gst_clock_id_compare_func);
+  /* add the entry to the queue */
+  entries_push (priv, (GstClockEntryImpl *) entry);
+
+  /* only need to send the signal if the entry is now the earliest one, else
+   * the thread is just waiting for another entry and will get to this entry
+   * automatically. */
+  if (g_ptr_array_index (priv->entries, 0) == entry) {
+    GstClockEntryImpl *current = priv->current;
 
-  /* only need to send the signal if the entry was added to the
-   * front, else the thread is just waiting for another entry and
-   * will get to this entry automatically. */
-  if (priv->entries->data == entry) {
     GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
-        "async entry added to head %p", head);
-    if (head == NULL) {
-      /* the list was empty before, signal the cond so that the async thread can
-       * start taking a look at the queue */
+        "async entry added to head, current %p", current);
+    if (current == NULL) {
+      /* the thread is not working on an entry, signal the cond so that the
+       * async thread can start taking a look at the queue */
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
-          "first entry, sending signal");
+          "no current entry, sending signal");
       GST_SYSTEM_CLOCK_BROADCAST (clock);
-    } else {
+    } else if (entry_is_earlier ((GstClockEntryImpl *) entry, current)) {
       GstClockReturn status;
 
-      /* it was initialized before adding to the list */
-      g_assert (((GstClockEntryImpl *) head)->initialized);
+      /* it was initialized before adding to the queue */
+      g_assert (current->initialized);
 
-      GST_SYSTEM_CLOCK_ENTRY_LOCK ((GstClockEntryImpl *) head);
-      status = GST_CLOCK_ENTRY_STATUS (head);
-      GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "head entry %p status %d",
-          head, status);
+      GST_SYSTEM_CLOCK_ENTRY_LOCK (current);
+      status = GST_CLOCK_ENTRY_STATUS ((GstClockEntry *) current);
+      GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
+          "current entry %p status %d", current, status);
 
       if (status == GST_CLOCK_BUSY) {
         /* the async thread was waiting for an entry, unlock the wait so that it
          * looks at the new head entry instead, we only need to do this once */
         GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
-            "head entry was busy. Wakeup async thread");
-        GST_SYSTEM_CLOCK_ENTRY_BROADCAST ((GstClockEntryImpl *) head);
+            "current entry was busy. Wakeup async thread");
+        GST_SYSTEM_CLOCK_ENTRY_BROADCAST (current);
       }
-      GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) head);
+      GST_SYSTEM_CLOCK_ENTRY_UNLOCK (current);
     }
   }
   GST_SYSTEM_CLOCK_UNLOCK (clock);
@@ -1460,5 +1588,14 @@ gst_system_clock_id_unschedule (GstClock * clock, GstClockEntry * entry)
     GST_SYSTEM_CLOCK_ENTRY_BROADCAST ((GstClockEntryImpl *) entry);
   }
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
+
+  /* drop it from the async queue right away instead of letting it wait for
+   * its time. The caller holds a ref, so this can't free the entry. */
+  if (((GstClockEntryImpl *) entry)->queue_index != ENTRY_NOT_QUEUED) {
+    GstSystemClockPrivate *priv = GST_SYSTEM_CLOCK_CAST (clock)->priv;
+
+    entries_remove (priv, (GstClockEntryImpl *) entry);
+    gst_clock_id_unref ((GstClockID) entry);
+  }
   GST_SYSTEM_CLOCK_UNLOCK (clock);
 }
@@ -121,6 +121,13 @@ struct _GstTaskPrivate
   /* remember the pool and id that is currently running. */
   gpointer id;
   GstTaskPool *pool_id;
+
+  /* cooperative tasks run one iteration per job on a
+   * #GstWorkStealingTaskPool instead of owning a thread.
+   * The enter_func was called for the current run */
+  gboolean entered;
+  /* a cooperative task that is paused and has no job queued */
+  gboolean parked;
 };
 
 #ifdef _MSC_VER
@@ -213,6 +220,7 @@ gst_task_win32_set_thread_name (const gchar * name)
 static void gst_task_finalize (GObject * object);
 
 static void gst_task_func (GstTask * task);
+static void gst_task_step (GstTask * task);
 
 static GMutex pool_lock;
 
@@ -365,6 +373,10 @@ gst_task_func (GstTask * task)
   task->thread = tself;
   GST_OBJECT_UNLOCK (task);
 
+  /* apply the default affinity before the enter_func, which can pin the
+   * thread to the CPUs of a bin through the stream-status message */
+  _priv_gst_thread_reset_affinity ();
+
   /* fire the enter_func callback when we need to */
   if (priv->enter_func)
     priv->enter_func (task, tself, priv->enter_user_data);
@@ -435,6 +447,112 @@ no_lock:
   }
 }
 
+/* queue the next iteration of a cooperative task on its pool.
+ * This function must be called with the task LOCK. */
+static gboolean
+gst_task_schedule_step (GstTask * task)
+{
+  GError *error = NULL;
+  GstTaskPrivate *priv = task->priv;
+
+  gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction) gst_task_step,
+      task, &error);
+
+  if (G_UNLIKELY (error != NULL)) {
+    GST_WARNING_OBJECT (task, "failed to schedule task: %s", error->message);
+    g_error_free (error);
+    return FALSE;
+  }
+  priv->parked = FALSE;
+  return TRUE;
+}
+
+/* the equivalent of gst_task_func for cooperative tasks, runs a single
+ * iteration of the task function and schedules the next one. Pausing parks
+ * the task without a job until the state changes again. */
+static void
+gst_task_step (GstTask * task)
+{
+  GRecMutex *lock;
+  GThread *tself;
+  GstTaskPrivate *priv;
+
+  priv = task->priv;
+
+  tself = g_thread_self ();
+
+  GST_OBJECT_LOCK (task);
+  if (GET_TASK_STATE (task) == GST_TASK_STOPPED)
+    goto exit;
+  lock = GST_TASK_GET_LOCK (task);
+  if (G_UNLIKELY (lock == NULL))
+    goto no_lock;
+
+  if (G_UNLIKELY (!priv->entered)) {
+    GST_DEBUG ("Entering task %p, thread %p", task, tself);
+    priv->entered = TRUE;
+    if (priv->enter_func) {
+      GST_OBJECT_UNLOCK (task);
+      priv->enter_func (task, tself, priv->enter_user_data);
+      GST_OBJECT_LOCK (task);
+    }
+  }
+
+  if (GET_TASK_STATE (task) == GST_TASK_STARTED) {
+    task->thread = tself;
+    GST_OBJECT_UNLOCK (task);
+
+    /* locking order is TASK_LOCK, LOCK */
+    g_rec_mutex_lock (lock);
+    if (G_LIKELY (GET_TASK_STATE (task) == GST_TASK_STARTED))
+      task->func (task->user_data);
+    g_rec_mutex_unlock (lock);
+
+    GST_OBJECT_LOCK (task);
+    task->thread = NULL;
+  }
+
+  switch (GET_TASK_STATE (task)) {
+    case GST_TASK_STARTED:
+      if (G_UNLIKELY (!gst_task_schedule_step (task)))
+        goto exit;
+      break;
+    case GST_TASK_PAUSED:
+      GST_INFO_OBJECT (task, "Task going to paused");
+      priv->parked = TRUE;
+      GST_TASK_SIGNAL (task);
+      break;
+    case GST_TASK_STOPPED:
+      goto exit;
+  }
+  GST_OBJECT_UNLOCK (task);
+
+  return;
+
+exit:
+  if (priv->entered && priv->leave_func) {
+    GST_OBJECT_UNLOCK (task);
+    priv->leave_func (task, tself, priv->leave_user_data);
+    GST_OBJECT_LOCK (task);
+  }
+  priv->entered = FALSE;
+  priv->parked = FALSE;
+  task->running = FALSE;
+  GST_TASK_SIGNAL (task);
+  GST_OBJECT_UNLOCK (task);
+
+  GST_DEBUG ("Exit task %p, thread %p", task, tself);
+
+  gst_object_unref (task);
+  return;
+
+no_lock:
+  {
+    g_warning ("starting task without a lock");
+    goto exit;
+  }
+}
+
 /**
  * gst_task_cleanup_all:
  *
@@ -579,6 +697,13 @@ gst_task_get_pool (GstTask * task)
  * Set @pool as the new GstTaskPool for @task. Any new streaming threads that
  * will be created by @task will now use @pool.
  *
+ * When @pool is a #GstWorkStealingTaskPool, @task does not get a thread of
+ * its own but runs each iteration of its function as a separate job on the
+ * pool. The lock of the task is released between iterations and consecutive
+ * iterations can run on different worker threads, so the enter and leave
+ * callbacks can be called from different threads too. The task function
+ * must never block, see gst_work_stealing_task_pool_new().
+ *
  * MT safe.
  */
 void
@@ -614,6 +739,10 @@ gst_task_set_pool (GstTask * task, GstTaskPool * pool)
  * Call @enter_func when the task function of @task is entered. @user_data will
  * be passed to @enter_func and @notify will be called when @user_data is no
  * longer referenced.
+ *
+ * With a #GstWorkStealingTaskPool the thread passed to @enter_func is only
+ * the one running the first iteration, the task can move to other threads
+ * afterwards.
  */
 void
 gst_task_set_enter_callback (GstTask * task, GstTaskThreadFunc enter_func,
@@ -652,6 +781,10 @@ gst_task_set_enter_callback (GstTask * task, GstTaskThreadFunc enter_func,
  * Call @leave_func when the task function of @task is left. @user_data will
  * be passed to @leave_func and @notify will be called when @user_data is no
  * longer referenced.
+ *
+ * With a #GstWorkStealingTaskPool @leave_func is called from the thread that
+ * ran the last iteration, which is not necessarily the one @enter_func was
+ * called from.
  */
 void
 gst_task_set_leave_callback (GstTask * task, GstTaskThreadFunc leave_func,
@@ -723,9 +856,17 @@ start_task (GstTask * task)
   /* push on the thread pool, we remember the original pool because the user
    * could change it later on and then we join to the wrong pool. */
   priv->pool_id = gst_object_ref (priv->pool);
-  priv->id =
-      gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction) gst_task_func,
-      task, &error);
+  if (GST_IS_WORK_STEALING_TASK_POOL (priv->pool_id)) {
+    priv->entered = FALSE;
+    priv->parked = FALSE;
+    priv->id =
+        gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction) gst_task_step,
+        task, &error);
+  } else {
+    priv->id =
+        gst_task_pool_push (priv->pool_id,
+        (GstTaskPoolFunction) gst_task_func, task, &error);
+  }
 
   if (error != NULL) {
     g_warning ("failed to create thread: %s", error->message);
@@ -762,6 +903,9 @@ gst_task_set_state_unlocked (GstTask * task, GstTaskState state)
       case GST_TASK_PAUSED:
         /* when we are paused, signal to go to the new state */
         GST_TASK_SIGNAL (task);
+        /* a parked cooperative task needs a new job for that */
+        if (task->priv->parked && !gst_task_schedule_step (task))
+          res = FALSE;
         break;
       case GST_TASK_STARTED:
         /* if we were started, we'll go to the new state after the next
@@ -934,6 +1078,12 @@ gst_task_join (GstTask * task)
   SET_TASK_STATE (task, GST_TASK_STOPPED);
   /* signal the state change for when it was blocked in PAUSED. */
   GST_TASK_SIGNAL (task);
+  if (priv->parked && !gst_task_schedule_step (task)) {
+    /* the pool is gone, finish the task from here */
+    GST_OBJECT_UNLOCK (task);
+    gst_task_step (task);
+    GST_OBJECT_LOCK (task);
+  }
   /* we set the running flag when pushing the task on the thread pool.
    * This means that the task function might not be called when we try
    * to join it here. */
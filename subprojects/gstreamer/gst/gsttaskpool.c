@@ -29,6 +29,10 @@
  * implementation uses a regular GThreadPool to start tasks.
  *
  * Subclasses can be made to create custom threads.
+ *
+ * #GstWorkStealingTaskPool multiplexes the tasks that use it on a fixed
+ * number of threads. It is only suitable for tasks whose function never
+ * blocks, which is not the case for most streaming threads of a pipeline.
  */
 
 #include "gst_private.h"
@@ -546,3 +550,474 @@ gst_shared_task_pool_new (void)
 
   return pool;
 }
+
+/* a job queued on one of the workers of a #GstWorkStealingTaskPool, the link
+ * is embedded so that queueing a job needs no extra allocation */
+typedef struct
+{
+  GList link;
+  GstTaskPoolFunction func;
+  gpointer user_data;
+} WorkStealingJob;
+
+typedef struct
+{
+  GstWorkStealingTaskPool *pool;
+  guint index;
+  GThread *thread;
+
+  /* protects the jobs and the stats */
+  GMutex lock;
+  /* the worker pops jobs from the head, other workers steal from the tail */
+  GQueue jobs;
+
+  GstClockTime start_time;
+  GstClockTime busy_time;
+  guint64 n_jobs;
+  guint64 n_stolen;
+} WorkStealingWorker;
+
+struct _GstWorkStealingTaskPoolPrivate
+{
+  guint n_threads;
+  WorkStealingWorker *workers;
+  gboolean running;
+
+  /* idle workers wait here until a job is queued */
+  GMutex sleep_lock;
+  GCond sleep_cond;
+  gint n_idle;
+  gint n_pending;
+
+  guint next_worker;
+};
+
+#define GST_WORK_STEALING_TASK_POOL_CAST(pool) ((GstWorkStealingTaskPool*)(pool))
+
+/* the worker running in the current thread, if any */
+static GPrivate current_worker;
+
+static void gst_work_stealing_task_pool_finalize (GObject * object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (GstWorkStealingTaskPool,
+    gst_work_stealing_task_pool, GST_TYPE_TASK_POOL);
+
+static WorkStealingJob *
+work_stealing_pop (WorkStealingWorker * worker, gboolean steal)
+{
+  GList *link;
+
+  g_mutex_lock (&worker->lock);
+  if (steal)
+    link = g_queue_pop_tail_link (&worker->jobs);
+  else
+    link = g_queue_pop_head_link (&worker->jobs);
+  g_mutex_unlock (&worker->lock);
+
+  return (WorkStealingJob *) link;
+}
+
+static WorkStealingJob *
+work_stealing_next_job (WorkStealingWorker * worker, gboolean * stolen)
+{
+  GstWorkStealingTaskPoolPrivate *priv = worker->pool->priv;
+  WorkStealingJob *job;
+  guint i;
+
+  *stolen = FALSE;
+
+  if ((job = work_stealing_pop (worker, FALSE)))
+    return job;
+
+  /* nothing to do for us, try to take work from the others */
+  for (i = 1; i < priv->n_threads; i++) {
+    WorkStealingWorker *victim =
+        &priv->workers[(worker->index + i) % priv->n_threads];
+
+    if ((job = work_stealing_pop (victim, TRUE))) {
+      *stolen = TRUE;
+      return job;
+    }
+  }
+
+  return NULL;
+}
+
+static gpointer
+work_stealing_worker_func (WorkStealingWorker * worker)
+{
+  GstWorkStealingTaskPoolPrivate *priv = worker->pool->priv;
+
+  g_private_set (&current_worker, worker);
+
+  GST_DEBUG_OBJECT (worker->pool, "worker %u started", worker->index);
+
+  while (TRUE) {
+    WorkStealingJob *job;
+    gboolean stolen;
+
+    job = work_stealing_next_job (worker, &stolen);
+    if (job) {
+      GstTaskPoolFunction func = job->func;
+      gpointer user_data = job->user_data;
+      GstClockTime start, end;
+
+      g_atomic_int_add (&priv->n_pending, -1);
+      g_free (job);
+
+      start = gst_util_get_timestamp ();
+      func (user_data);
+      end = gst_util_get_timestamp ();
+
+      g_mutex_lock (&worker->lock);
+      worker->busy_time += end - start;
+      worker->n_jobs++;
+      if (stolen)
+        worker->n_stolen++;
+      g_mutex_unlock (&worker->lock);
+      continue;
+    }
+
+    g_mutex_lock (&priv->sleep_lock);
+    if (!priv->running && g_atomic_int_get (&priv->n_pending) <= 0) {
+      g_mutex_unlock (&priv->sleep_lock);
+      break;
+    }
+    /* pushers check n_idle after queueing, so after incrementing it we are
+     * sure to either see the new job or get signalled */
+    g_atomic_int_inc (&priv->n_idle);
+    while (g_atomic_int_get (&priv->n_pending) <= 0 && priv->running)
+      g_cond_wait (&priv->sleep_cond, &priv->sleep_lock);
+    g_atomic_int_add (&priv->n_idle, -1);
+    g_mutex_unlock (&priv->sleep_lock);
+  }
+
+  GST_DEBUG_OBJECT (worker->pool, "worker %u stopped", worker->index);
+
+  g_private_set (&current_worker, NULL);
+
+  return NULL;
+}
+
+static void
+work_stealing_prepare (GstTaskPool * pool, GError ** error)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL_CAST (pool)->priv;
+  guint i;
+
+  GST_OBJECT_LOCK (pool);
+  if (priv->workers)
+    goto done;
+
+  priv->workers = g_new0 (WorkStealingWorker, priv->n_threads);
+
+  for (i = 0; i < priv->n_threads; i++) {
+    WorkStealingWorker *worker = &priv->workers[i];
+
+    worker->pool = GST_WORK_STEALING_TASK_POOL_CAST (pool);
+    worker->index = i;
+    g_mutex_init (&worker->lock);
+    g_queue_init (&worker->jobs);
+    worker->start_time = gst_util_get_timestamp ();
+  }
+  g_atomic_int_set (&priv->running, TRUE);
+
+  for (i = 0; i < priv->n_threads; i++) {
+    WorkStealingWorker *worker = &priv->workers[i];
+    gchar *name = g_strdup_printf ("gstworker-%u", i);
+
+    worker->thread = g_thread_try_new (name,
+        (GThreadFunc) work_stealing_worker_func, worker, error);
+    g_free (name);
+
+    if (worker->thread == NULL) {
+      GST_WARNING_OBJECT (pool, "could not start worker %u", i);
+      break;
+    }
+  }
+  GST_DEBUG_OBJECT (pool, "started %u workers", i);
+
+done:
+  GST_OBJECT_UNLOCK (pool);
+}
+
+static void
+work_stealing_cleanup (GstTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL_CAST (pool)->priv;
+  WorkStealingWorker *workers;
+  guint i;
+
+  GST_OBJECT_LOCK (pool);
+  workers = priv->workers;
+  GST_OBJECT_UNLOCK (pool);
+
+  if (workers == NULL)
+    return;
+
+  /* new jobs are refused from now on, the workers exit once the queued jobs
+   * are done. Pushers from other threads check running with the object lock
+   * so none of them can still be queueing after this. */
+  GST_OBJECT_LOCK (pool);
+  g_mutex_lock (&priv->sleep_lock);
+  g_atomic_int_set (&priv->running, FALSE);
+  g_cond_broadcast (&priv->sleep_cond);
+  g_mutex_unlock (&priv->sleep_lock);
+  GST_OBJECT_UNLOCK (pool);
+
+  for (i = 0; i < priv->n_threads; i++) {
+    if (workers[i].thread)
+      g_thread_join (workers[i].thread);
+  }
+
+  GST_OBJECT_LOCK (pool);
+  priv->workers = NULL;
+  priv->n_pending = 0;
+  GST_OBJECT_UNLOCK (pool);
+
+  for (i = 0; i < priv->n_threads; i++) {
+    WorkStealingJob *job;
+
+    /* run what was queued while shutting down, or when no worker could be
+     * started at all */
+    while ((job = work_stealing_pop (&workers[i], FALSE))) {
+      job->func (job->user_data);
+      g_free (job);
+    }
+    g_mutex_clear (&workers[i].lock);
+  }
+
+  g_free (workers);
+}
+
+static gpointer
+work_stealing_push (GstTaskPool * pool, GstTaskPoolFunction func,
+    gpointer user_data, GError ** error)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL_CAST (pool)->priv;
+  WorkStealingWorker *worker;
+  WorkStealingJob *job;
+  gboolean wakeup;
+
+  if (G_UNLIKELY (!g_atomic_int_get (&priv->running)))
+    goto not_running;
+
+  job = g_new (WorkStealingJob, 1);
+  job->link.data = job;
+  job->link.prev = job->link.next = NULL;
+  job->func = func;
+  job->user_data = user_data;
+
+  worker = g_private_get (&current_worker);
+  if (worker && worker->pool == GST_WORK_STEALING_TASK_POOL_CAST (pool)) {
+    /* jobs pushed from one of our workers stay on that worker, we only need
+     * help when there is more than one job queued. The workers are only
+     * freed after all of them were joined, so no lock is needed here. */
+    g_mutex_lock (&worker->lock);
+    g_queue_push_tail_link (&worker->jobs, &job->link);
+    wakeup = worker->jobs.length > 1;
+    g_mutex_unlock (&worker->lock);
+    g_atomic_int_inc (&priv->n_pending);
+  } else {
+    guint idx;
+
+    /* cleanup frees the workers, keep them alive while queueing */
+    GST_OBJECT_LOCK (pool);
+    if (G_UNLIKELY (priv->workers == NULL
+            || !g_atomic_int_get (&priv->running))) {
+      GST_OBJECT_UNLOCK (pool);
+      g_free (job);
+      goto not_running;
+    }
+
+    idx = (guint) g_atomic_int_add (&priv->next_worker, 1);
+    worker = &priv->workers[idx % priv->n_threads];
+    g_mutex_lock (&worker->lock);
+    g_queue_push_tail_link (&worker->jobs, &job->link);
+    g_mutex_unlock (&worker->lock);
+    g_atomic_int_inc (&priv->n_pending);
+    GST_OBJECT_UNLOCK (pool);
+    wakeup = TRUE;
+  }
+
+  if (wakeup && g_atomic_int_get (&priv->n_idle) > 0) {
+    g_mutex_lock (&priv->sleep_lock);
+    g_cond_signal (&priv->sleep_cond);
+    g_mutex_unlock (&priv->sleep_lock);
+  }
+
+  return NULL;
+
+  /* ERRORS */
+not_running:
+  {
+    g_set_error_literal (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "No thread pool");
+    return NULL;
+  }
+}
+
+static void
+gst_work_stealing_task_pool_class_init (GstWorkStealingTaskPoolClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstTaskPoolClass *taskpoolclass = GST_TASK_POOL_CLASS (klass);
+
+  gobject_class->finalize = gst_work_stealing_task_pool_finalize;
+
+  taskpoolclass->prepare = work_stealing_prepare;
+  taskpoolclass->cleanup = work_stealing_cleanup;
+  taskpoolclass->push = work_stealing_push;
+}
+
+static void
+gst_work_stealing_task_pool_init (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv;
+
+  priv = pool->priv = gst_work_stealing_task_pool_get_instance_private (pool);
+  priv->n_threads = 1;
+  g_mutex_init (&priv->sleep_lock);
+  g_cond_init (&priv->sleep_cond);
+}
+
+static void
+gst_work_stealing_task_pool_finalize (GObject * object)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL_CAST (object)->priv;
+
+  work_stealing_cleanup (GST_TASK_POOL_CAST (object));
+
+  g_mutex_clear (&priv->sleep_lock);
+  g_cond_clear (&priv->sleep_cond);
+
+  G_OBJECT_CLASS (gst_work_stealing_task_pool_parent_class)->finalize (object);
+}
+
+/**
+ * gst_work_stealing_task_pool_new:
+ * @n_threads: the number of worker threads, or 0 for one per CPU
+ *
+ * Create a new work stealing task pool. The pool runs the pushed functions
+ * on a fixed number of worker threads, each with its own queue of jobs. Idle
+ * workers take jobs from the queues of busy workers.
+ *
+ * A #GstTask using this pool runs its function one iteration at a time as a
+ * job on the pool instead of occupying a thread for its whole lifetime, see
+ * gst_task_set_pool().
+ *
+ * Only tasks whose function never blocks may use this pool. The function
+ * must return after a bounded amount of work and must not wait for anything,
+ * such as a clock, a full downstream queue, a pad push that blocks on a
+ * paused sink or another task of the same pool. A blocking task keeps its
+ * worker busy until it returns, and once all workers are blocked the jobs
+ * that would unblock them can never run. This rules out the streaming threads
+ * of most elements, the pool is not meant to be installed on arbitrary
+ * pipelines from the stream-status message.
+ *
+ * Returns: (transfer full): a new #GstWorkStealingTaskPool.
+ * gst_object_unref() after usage.
+ *
+ * Since: 1.26
+ */
+GstTaskPool *
+gst_work_stealing_task_pool_new (guint n_threads)
+{
+  GstWorkStealingTaskPool *pool;
+
+  pool = g_object_new (GST_TYPE_WORK_STEALING_TASK_POOL, NULL);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  pool->priv->n_threads = n_threads;
+
+  /* clear floating flag */
+  gst_object_ref_sink (pool);
+
+  return GST_TASK_POOL_CAST (pool);
+}
+
+/**
+ * gst_work_stealing_task_pool_get_n_threads:
+ * @pool: a #GstWorkStealingTaskPool
+ *
+ * Returns: the number of worker threads of @pool
+ *
+ * Since: 1.26
+ */
+guint
+gst_work_stealing_task_pool_get_n_threads (GstWorkStealingTaskPool * pool)
+{
+  g_return_val_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool), 0);
+
+  return pool->priv->n_threads;
+}
+
+/**
+ * gst_work_stealing_task_pool_get_stats:
+ * @pool: a #GstWorkStealingTaskPool
+ *
+ * Get the statistics of the workers of @pool. The returned structure has a
+ * "workers" field containing a #GstValueArray with one #GstStructure per
+ * worker thread with the following fields:
+ *
+ * - "jobs" G_TYPE_UINT64: the number of jobs that were run
+ * - "stolen" G_TYPE_UINT64: how many of those were taken from other workers
+ * - "busy-time" G_TYPE_UINT64: the total time spent running jobs
+ * - "utilization" G_TYPE_DOUBLE: busy-time divided by the time since the
+ *   worker was started, between 0.0 and 1.0
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics, the
+ * "workers" array is empty when @pool is not prepared.
+ *
+ * Since: 1.26
+ */
+GstStructure *
+gst_work_stealing_task_pool_get_stats (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv;
+  GstStructure *s;
+  GValue workers = G_VALUE_INIT;
+  GstClockTime now;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool), NULL);
+
+  priv = pool->priv;
+
+  g_value_init (&workers, GST_TYPE_ARRAY);
+  now = gst_util_get_timestamp ();
+
+  GST_OBJECT_LOCK (pool);
+  for (i = 0; priv->workers && i < priv->n_threads; i++) {
+    WorkStealingWorker *worker = &priv->workers[i];
+    GValue v = G_VALUE_INIT;
+    GstStructure *ws;
+    gdouble utilization = 0.0;
+
+    g_mutex_lock (&worker->lock);
+    if (now > worker->start_time)
+      utilization = (gdouble) worker->busy_time / (now - worker->start_time);
+    ws = gst_structure_new ("worker",
+        "jobs", G_TYPE_UINT64, worker->n_jobs,
+        "stolen", G_TYPE_UINT64, worker->n_stolen,
+        "busy-time", G_TYPE_UINT64, worker->busy_time,
+        "utilization", G_TYPE_DOUBLE, MIN (utilization, 1.0), NULL);
+    g_mutex_unlock (&worker->lock);
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, ws);
+    gst_value_array_append_and_take_value (&workers, &v);
+  }
+  GST_OBJECT_UNLOCK (pool);
+
+  s = gst_structure_new ("application/x-gst-task-pool-stats",
+      "n-threads", G_TYPE_UINT, priv->n_threads, NULL);
+  gst_structure_take_value (s, "workers", &workers);
+
+  return s;
+}
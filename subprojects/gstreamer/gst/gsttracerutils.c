@@ -56,7 +56,7 @@ static const gchar *_quark_strings[] = {
   "object-destroyed", "mini-object-reffed", "mini-object-unreffed",
   "object-reffed", "object-unreffed", "plugin-feature-loaded",
   "pad-chain-pre", "pad-chain-post", "pad-chain-list-pre",
-  "pad-chain-list-post",
+  "pad-chain-list-post", "caps-cache-lookup", "arena-alloc", "arena-free",
 };
 
 GQuark _priv_gst_tracer_quark_table[GST_TRACER_QUARK_MAX];
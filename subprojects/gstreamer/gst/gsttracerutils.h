@@ -84,6 +84,9 @@ typedef enum /*< skip >*/
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_POST,
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_LIST_PRE,
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_LIST_POST,
+  GST_TRACER_QUARK_HOOK_CAPS_CACHE_LOOKUP,
+  GST_TRACER_QUARK_HOOK_ARENA_ALLOC,
+  GST_TRACER_QUARK_HOOK_ARENA_FREE,
   GST_TRACER_QUARK_MAX
 } GstTracerQuarkId;
 
@@ -839,6 +842,95 @@ typedef void (*GstTracerHookPadChainListPost) (GObject *self, GstClockTime ts,
     GstTracerHookPadChainListPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
+/**
+ * GstTracerHookCapsCacheLookup:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @caps1: the first caps of the operation
+ * @caps2: the second caps of the operation
+ * @hit: whether the result was found in the cache
+ *
+ * Hook called when the caps cache, enabled with the GST_CAPS_CACHE
+ * environment variable, was looked up for a caps intersection or subset
+ * check, named "caps-cache-lookup".
+ *
+ * Since: 1.26
+ */
+typedef void (*GstTracerHookCapsCacheLookup) (GObject *self, GstClockTime ts,
+    const GstCaps *caps1, const GstCaps *caps2, gboolean hit);
+
+/**
+ * GST_TRACER_CAPS_CACHE_LOOKUP:
+ * @caps1: a %GstCaps
+ * @caps2: a %GstCaps
+ * @hit: a %gboolean
+ *
+ * Dispatches the "caps-cache-lookup" hook.
+ *
+ * Since: 1.26
+ */
+#define GST_TRACER_CAPS_CACHE_LOOKUP(caps1, caps2, hit) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_CAPS_CACHE_LOOKUP), \
+    GstTracerHookCapsCacheLookup, (GST_TRACER_ARGS, caps1, caps2, hit)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookArenaAlloc:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @mem: the allocated memory
+ * @size: the requested size
+ *
+ * Hook called when the memory of an event, query, message or structure was
+ * allocated from the arena enabled with the GST_MINIOBJECT_ARENA environment
+ * variable, named "arena-alloc".
+ *
+ * Since: 1.26
+ */
+typedef void (*GstTracerHookArenaAlloc) (GObject *self, GstClockTime ts,
+    gpointer mem, gsize size);
+
+/**
+ * GST_TRACER_ARENA_ALLOC:
+ * @mem: a memory pointer
+ * @size: a %gsize
+ *
+ * Dispatches the "arena-alloc" hook.
+ *
+ * Since: 1.26
+ */
+#define GST_TRACER_ARENA_ALLOC(mem, size) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ARENA_ALLOC), \
+    GstTracerHookArenaAlloc, (GST_TRACER_ARGS, mem, size)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookArenaFree:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @mem: the memory that is freed
+ *
+ * Hook called when memory allocated from the arena is given back to it,
+ * named "arena-free".
+ *
+ * Since: 1.26
+ */
+typedef void (*GstTracerHookArenaFree) (GObject *self, GstClockTime ts,
+    gpointer mem);
+
+/**
+ * GST_TRACER_ARENA_FREE:
+ * @mem: a memory pointer
+ *
+ * Dispatches the "arena-free" hook.
+ *
+ * Since: 1.26
+ */
+#define GST_TRACER_ARENA_FREE(mem) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_ARENA_FREE), \
+    GstTracerHookArenaFree, (GST_TRACER_ARGS, mem)); \
+}G_STMT_END
+
 #else /* !GST_DISABLE_GST_TRACER_HOOKS */
 
 static inline void
@@ -892,6 +984,9 @@ _priv_gst_tracing_deinit (void)
 #define GST_TRACER_PAD_CHAIN_POST(pad, res)
 #define GST_TRACER_PAD_CHAIN_LIST_PRE(pad, list)
 #define GST_TRACER_PAD_CHAIN_LIST_POST(pad, res)
+#define GST_TRACER_CAPS_CACHE_LOOKUP(caps1, caps2, hit)
+#define GST_TRACER_ARENA_ALLOC(mem, size)
+#define GST_TRACER_ARENA_FREE(mem)
 
 #endif /* GST_DISABLE_GST_TRACER_HOOKS */
 
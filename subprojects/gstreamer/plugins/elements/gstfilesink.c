@@ -27,6 +27,13 @@
  *
  * Write incoming data to a file in the local file system.
  *
+ * If #GstFileSink:write-behind is enabled, the data is handed to a separate
+ * writer thread instead of being written from the streaming thread. Up to
+ * #GstFileSink:write-behind-size bytes are queued, so that short latency
+ * spikes of the storage don't stall the upstream elements. This is also
+ * available to elements using filesink internally, for example by setting
+ * the property on the sink of splitmuxsink.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 v4l2src num-buffers=1 ! jpegenc ! filesink location=capture1.jpeg
@@ -135,6 +142,9 @@ GST_DEBUG_CATEGORY_STATIC (gst_file_sink_debug);
 #define DEFAULT_O_SYNC		FALSE
 #define DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT	0
 #define DEFAULT_FILE_MODE      GST_FILE_SINK_FILE_MODE_TRUNC
+#define DEFAULT_WRITE_BEHIND   FALSE
+#define DEFAULT_WRITE_BEHIND_SIZE (4 * 1024 * 1024)
+#define DEFAULT_SYNC_INTERVAL  0
 
 enum
 {
@@ -146,9 +156,21 @@ enum
   PROP_O_SYNC,
   PROP_MAX_TRANSIENT_ERROR_TIMEOUT,
   PROP_FILE_MODE,
+  PROP_WRITE_BEHIND,
+  PROP_WRITE_BEHIND_SIZE,
+  PROP_SYNC_INTERVAL,
+  PROP_STATS,
   PROP_LAST
 };
 
+/* A buffer or buffer list waiting to be written by the writer thread */
+typedef struct
+{
+  GstMiniObject *obj;
+  gsize size;
+  gint64 queued_time;
+} GstFileSinkWriteItem;
+
 /* Copy of glib's g_fopen due to win32 libc/cross-DLL brokenness: we can't
  * use the 'file pointer' opened in glib (and returned from this function)
  * in this library, as they may have unrelated C runtimes. */
@@ -189,6 +211,7 @@ gst_fopen (const gchar * filename, const gchar * mode, gboolean o_sync)
 }
 
 static void gst_file_sink_dispose (GObject * object);
+static void gst_file_sink_finalize (GObject * object);
 
 static void gst_file_sink_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -219,6 +242,7 @@ static void gst_file_sink_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
 
 static GstFlowReturn gst_file_sink_flush_buffer (GstFileSink * filesink);
+static GstFlowReturn gst_file_sink_write_behind_drain (GstFileSink * sink);
 
 #define _do_init \
   G_IMPLEMENT_INTERFACE (GST_TYPE_URI_HANDLER, gst_file_sink_uri_handler_init); \
@@ -237,6 +261,7 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
   GstBaseSinkClass *gstbasesink_class = GST_BASE_SINK_CLASS (klass);
 
   gobject_class->dispose = gst_file_sink_dispose;
+  gobject_class->finalize = gst_file_sink_finalize;
 
   gobject_class->set_property = gst_file_sink_set_property;
   gobject_class->get_property = gst_file_sink_get_property;
@@ -292,6 +317,79 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
           G_MAXINT, DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstFileSink:write-behind
+   *
+   * Write the data from a separate thread. Buffers are queued until they
+   * are written and the streaming thread only blocks once more than
+   * #GstFileSink:write-behind-size bytes are pending.
+   *
+   * Write errors are reported from the writer thread and make the next
+   * rendered buffer fail.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_WRITE_BEHIND,
+      g_param_spec_boolean ("write-behind", "Write Behind",
+          "Write data asynchronously from a separate thread",
+          DEFAULT_WRITE_BEHIND, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstFileSink:write-behind-size
+   *
+   * Maximum number of bytes queued for the writer thread before the
+   * streaming thread is blocked. A single buffer larger than this is still
+   * accepted when the queue is empty.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_WRITE_BEHIND_SIZE,
+      g_param_spec_uint ("write-behind-size", "Write Behind Size",
+          "Maximum number of bytes queued for writing in write-behind mode",
+          1, G_MAXUINT, DEFAULT_WRITE_BEHIND_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstFileSink:sync-interval
+   *
+   * Flush written data to the storage device at most this often in
+   * write-behind mode, with fdatasync() where available. 0 only syncs for
+   * buffers flagged with %GST_BUFFER_FLAG_SYNC_AFTER.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_SYNC_INTERVAL,
+      g_param_spec_uint64 ("sync-interval", "Sync Interval",
+          "Interval between syncs of the written data to the storage in "
+          "write-behind mode (0 = disabled)", 0, G_MAXUINT64,
+          DEFAULT_SYNC_INTERVAL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstFileSink:stats
+   *
+   * Statistics of the write-behind queue. This property returns a
+   * #GstStructure with name application/x-gst-file-sink-stats and the
+   * following fields:
+   *
+   * * #guint64 `queued-bytes`: the number of bytes currently queued.
+   * * #guint64 `max-queued-bytes`: the highest number of bytes queued.
+   * * #guint64 `writes`: the number of buffers and buffer lists written.
+   * * #guint64 `syncs`: the number of periodic syncs.
+   * * #guint64 `average-latency`: the average time between queueing and
+   *   writing in nanoseconds.
+   * * #guint64 `max-latency`: the maximum time between queueing and
+   *   writing in nanoseconds.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Write-behind queue statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "File Sink",
       "Sink/File", "Write stream to a file",
@@ -328,6 +426,14 @@ gst_file_sink_init (GstFileSink * filesink)
   filesink->buffer_size = DEFAULT_BUFFER_SIZE;
   filesink->append = FALSE;
   filesink->file_mode = DEFAULT_FILE_MODE;
+  filesink->write_behind = DEFAULT_WRITE_BEHIND;
+  filesink->write_behind_size = DEFAULT_WRITE_BEHIND_SIZE;
+  filesink->sync_interval = DEFAULT_SYNC_INTERVAL;
+
+  g_mutex_init (&filesink->wb_lock);
+  g_cond_init (&filesink->wb_cond);
+  g_cond_init (&filesink->wb_space_cond);
+  g_queue_init (&filesink->wb_queue);
 
   gst_base_sink_set_sync (GST_BASE_SINK (filesink), FALSE);
 }
@@ -345,6 +451,40 @@ gst_file_sink_dispose (GObject * object)
   sink->filename = NULL;
 }
 
+static void
+gst_file_sink_finalize (GObject * object)
+{
+  GstFileSink *sink = GST_FILE_SINK (object);
+
+  g_mutex_clear (&sink->wb_lock);
+  g_cond_clear (&sink->wb_cond);
+  g_cond_clear (&sink->wb_space_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static GstStructure *
+gst_file_sink_create_stats (GstFileSink * sink)
+{
+  GstStructure *s;
+  GstClockTime avg_latency = 0;
+
+  g_mutex_lock (&sink->wb_lock);
+  if (sink->wb_writes > 0)
+    avg_latency = sink->wb_total_latency / sink->wb_writes;
+
+  s = gst_structure_new ("application/x-gst-file-sink-stats",
+      "queued-bytes", G_TYPE_UINT64, sink->wb_queued_bytes,
+      "max-queued-bytes", G_TYPE_UINT64, sink->wb_max_queued_bytes,
+      "writes", G_TYPE_UINT64, sink->wb_writes,
+      "syncs", G_TYPE_UINT64, sink->wb_syncs,
+      "average-latency", G_TYPE_UINT64, avg_latency,
+      "max-latency", G_TYPE_UINT64, sink->wb_max_latency, NULL);
+  g_mutex_unlock (&sink->wb_lock);
+
+  return s;
+}
+
 static gboolean
 gst_file_sink_set_location (GstFileSink * sink, const gchar * location,
     GError ** error)
@@ -408,6 +548,15 @@ gst_file_sink_set_property (GObject * object, guint prop_id,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       sink->max_transient_error_timeout = g_value_get_int (value);
       break;
+    case PROP_WRITE_BEHIND:
+      sink->write_behind = g_value_get_boolean (value);
+      break;
+    case PROP_WRITE_BEHIND_SIZE:
+      sink->write_behind_size = g_value_get_uint (value);
+      break;
+    case PROP_SYNC_INTERVAL:
+      sink->sync_interval = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -442,12 +591,307 @@ gst_file_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       g_value_set_int (value, sink->max_transient_error_timeout);
       break;
+    case PROP_WRITE_BEHIND:
+      g_value_set_boolean (value, sink->write_behind);
+      break;
+    case PROP_WRITE_BEHIND_SIZE:
+      g_value_set_uint (value, sink->write_behind_size);
+      break;
+    case PROP_SYNC_INTERVAL:
+      g_value_set_uint64 (value, sink->sync_interval);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_file_sink_create_stats (sink));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+static void
+gst_file_sink_write_item_free (GstFileSinkWriteItem * item)
+{
+  gst_mini_object_unref (item->obj);
+  g_free (item);
+}
+
+static gint
+gst_file_sink_sync_fd (gint fd)
+{
+  gint ret;
+
+  do {
+#ifdef HAVE_FDATASYNC
+    ret = fdatasync (fd);
+#else
+    ret = fsync (fd);
+#endif
+  } while (ret < 0 && errno == EINTR);
+
+  return ret;
+}
+
+static gpointer
+gst_file_sink_write_behind_loop (GstFileSink * sink)
+{
+  GST_DEBUG_OBJECT (sink, "writer thread started");
+
+  g_mutex_lock (&sink->wb_lock);
+  for (;;) {
+    GstFileSinkWriteItem *item;
+    GstFlowReturn flow;
+    guint64 bytes_written = 0;
+    gint64 sync_deadline = -1;
+    GstClockTime latency;
+
+    if (sink->wb_dirty && sink->sync_interval > 0)
+      sync_deadline = sink->wb_last_sync + sink->sync_interval / GST_USECOND;
+
+    if (sync_deadline != -1 && g_get_monotonic_time () >= sync_deadline) {
+      gint ret;
+
+      sink->wb_dirty = FALSE;
+      g_mutex_unlock (&sink->wb_lock);
+      GST_LOG_OBJECT (sink, "syncing file");
+      ret = gst_file_sink_sync_fd (sink->wb_fd);
+      g_mutex_lock (&sink->wb_lock);
+
+      sink->wb_last_sync = g_get_monotonic_time ();
+      sink->wb_syncs++;
+
+      if (ret < 0 && sink->wb_flow == GST_FLOW_OK) {
+        GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+            (_("Error while writing to file \"%s\"."), sink->filename),
+            ("%s", g_strerror (errno)));
+        sink->wb_flow = GST_FLOW_ERROR;
+        g_cond_broadcast (&sink->wb_space_cond);
+      }
+      continue;
+    }
+
+    item = g_queue_pop_head (&sink->wb_queue);
+    if (item == NULL) {
+      if (sink->wb_stopping)
+        break;
+
+      if (sync_deadline != -1)
+        g_cond_wait_until (&sink->wb_cond, &sink->wb_lock, sync_deadline);
+      else
+        g_cond_wait (&sink->wb_cond, &sink->wb_lock);
+      continue;
+    }
+
+    sink->wb_busy = TRUE;
+    g_mutex_unlock (&sink->wb_lock);
+
+    GST_LOG_OBJECT (sink, "writing %" G_GSIZE_FORMAT " bytes at position %"
+        G_GUINT64_FORMAT, item->size, sink->wb_position);
+
+    /* writes are never interrupted, everything that was queued is written
+     * out before the file is closed or seeked */
+    if (GST_IS_BUFFER_LIST (item->obj)) {
+      flow = gst_writev_buffer_list (GST_OBJECT_CAST (sink), sink->wb_fd, NULL,
+          GST_BUFFER_LIST_CAST (item->obj), &bytes_written, 0,
+          sink->max_transient_error_timeout, sink->wb_position, NULL);
+    } else {
+      flow = gst_writev_buffer (GST_OBJECT_CAST (sink), sink->wb_fd, NULL,
+          GST_BUFFER_CAST (item->obj), &bytes_written, 0,
+          sink->max_transient_error_timeout, sink->wb_position, NULL);
+    }
+    sink->wb_position += bytes_written;
+
+    latency = (g_get_monotonic_time () - item->queued_time) * GST_USECOND;
+
+    g_mutex_lock (&sink->wb_lock);
+    sink->wb_busy = FALSE;
+    sink->wb_queued_bytes -= item->size;
+    sink->wb_writes++;
+    sink->wb_total_latency += latency;
+    sink->wb_max_latency = MAX (sink->wb_max_latency, latency);
+    if (!sink->wb_dirty) {
+      sink->wb_dirty = TRUE;
+      sink->wb_last_sync = g_get_monotonic_time ();
+    }
+
+    if (flow != GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (sink, "write failed: %s", gst_flow_get_name (flow));
+      /* the error was posted already, drop everything else */
+      sink->wb_flow = flow;
+      g_queue_clear_full (&sink->wb_queue,
+          (GDestroyNotify) gst_file_sink_write_item_free);
+      sink->wb_queued_bytes = 0;
+    }
+    g_cond_broadcast (&sink->wb_space_cond);
+
+    gst_file_sink_write_item_free (item);
+  }
+  g_mutex_unlock (&sink->wb_lock);
+
+  GST_DEBUG_OBJECT (sink, "writer thread stopped");
+
+  return NULL;
+}
+
+static gboolean
+gst_file_sink_write_behind_start (GstFileSink * sink)
+{
+  GError *err = NULL;
+
+  sink->wb_fd = fileno (sink->file);
+  sink->wb_position = sink->current_pos;
+  sink->wb_queued_bytes = 0;
+  sink->wb_busy = FALSE;
+  sink->wb_dirty = FALSE;
+  sink->wb_stopping = FALSE;
+  sink->wb_flow = GST_FLOW_OK;
+  sink->wb_max_queued_bytes = 0;
+  sink->wb_writes = 0;
+  sink->wb_syncs = 0;
+  sink->wb_total_latency = 0;
+  sink->wb_max_latency = 0;
+
+  sink->wb_thread = g_thread_try_new ("filesink-writer",
+      (GThreadFunc) gst_file_sink_write_behind_loop, sink, &err);
+  if (sink->wb_thread == NULL)
+    goto thread_failed;
+
+  return TRUE;
+
+  /* ERRORS */
+thread_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, FAILED, (NULL),
+        ("Could not start writer thread: %s", err->message));
+    g_clear_error (&err);
+    return FALSE;
+  }
+}
+
+/* Writes out everything that is still queued and stops the writer thread */
+static GstFlowReturn
+gst_file_sink_write_behind_stop (GstFileSink * sink)
+{
+  GstFlowReturn flow;
+
+  if (sink->wb_thread == NULL)
+    return GST_FLOW_OK;
+
+  g_mutex_lock (&sink->wb_lock);
+  sink->wb_stopping = TRUE;
+  g_cond_signal (&sink->wb_cond);
+  g_mutex_unlock (&sink->wb_lock);
+
+  g_thread_join (sink->wb_thread);
+  sink->wb_thread = NULL;
+
+  flow = sink->wb_flow;
+  sink->wb_queued_bytes = 0;
+
+  return flow;
+}
+
+/* Waits until everything queued so far is written */
+static GstFlowReturn
+gst_file_sink_write_behind_drain (GstFileSink * sink)
+{
+  GstFlowReturn flow;
+
+  if (sink->wb_thread == NULL)
+    return GST_FLOW_OK;
+
+  g_mutex_lock (&sink->wb_lock);
+  while ((!g_queue_is_empty (&sink->wb_queue) || sink->wb_busy)
+      && sink->wb_flow == GST_FLOW_OK)
+    g_cond_wait (&sink->wb_space_cond, &sink->wb_lock);
+  flow = sink->wb_flow;
+  g_mutex_unlock (&sink->wb_lock);
+
+  return flow;
+}
+
+/* Queues @obj for the writer thread, blocks while the queue is full. Takes
+ * ownership of @obj */
+static GstFlowReturn
+gst_file_sink_write_behind_queue (GstFileSink * sink, GstMiniObject * obj,
+    gsize size)
+{
+  GstFileSinkWriteItem *item;
+  GstFlowReturn flow;
+
+  g_mutex_lock (&sink->wb_lock);
+  while (sink->wb_queued_bytes > 0
+      && sink->wb_queued_bytes + size > sink->write_behind_size
+      && sink->wb_flow == GST_FLOW_OK) {
+    if (g_atomic_int_get (&sink->flushing))
+      goto flushing;
+
+    GST_LOG_OBJECT (sink, "queue full (%" G_GUINT64_FORMAT " bytes), waiting",
+        sink->wb_queued_bytes);
+    g_cond_wait (&sink->wb_space_cond, &sink->wb_lock);
+  }
+
+  flow = sink->wb_flow;
+  if (flow != GST_FLOW_OK)
+    goto write_failed;
+
+  item = g_new (GstFileSinkWriteItem, 1);
+  item->obj = obj;
+  item->size = size;
+  item->queued_time = g_get_monotonic_time ();
+
+  g_queue_push_tail (&sink->wb_queue, item);
+  sink->wb_queued_bytes += size;
+  sink->wb_max_queued_bytes =
+      MAX (sink->wb_max_queued_bytes, sink->wb_queued_bytes);
+  g_cond_signal (&sink->wb_cond);
+  g_mutex_unlock (&sink->wb_lock);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+flushing:
+  {
+    g_mutex_unlock (&sink->wb_lock);
+    GST_DEBUG_OBJECT (sink, "Flushing, not queueing");
+    return GST_FLOW_FLUSHING;
+  }
+write_failed:
+  {
+    g_mutex_unlock (&sink->wb_lock);
+    gst_mini_object_unref (obj);
+    return flow;
+  }
+}
+
+static GstFlowReturn
+gst_file_sink_write_behind_push (GstFileSink * sink, GstMiniObject * obj,
+    gsize size)
+{
+  GstFlowReturn flow;
+
+  for (;;) {
+    flow = gst_file_sink_write_behind_queue (sink, obj, size);
+
+    if (flow != GST_FLOW_FLUSHING)
+      break;
+
+    flow = gst_base_sink_wait_preroll (GST_BASE_SINK (sink));
+
+    if (flow != GST_FLOW_OK) {
+      gst_mini_object_unref (obj);
+      return flow;
+    }
+  }
+
+  /* the position is advanced once the data is queued, the writer thread
+   * keeps track of its own position */
+  if (flow == GST_FLOW_OK)
+    sink->current_pos += size;
+
+  return flow;
+}
+
 static gboolean
 gst_file_sink_open_file (GstFileSink * sink)
 {
@@ -493,6 +937,9 @@ gst_file_sink_open_file (GstFileSink * sink)
   GST_DEBUG_OBJECT (sink, "opened file %s, seekable %d",
       sink->filename, sink->seekable);
 
+  if (sink->write_behind && !gst_file_sink_write_behind_start (sink))
+    goto thread_failed;
+
   return TRUE;
 
   /* ERRORS */
@@ -509,6 +956,12 @@ open_failed:
         GST_ERROR_SYSTEM);
     return FALSE;
   }
+thread_failed:
+  {
+    fclose (sink->file);
+    sink->file = NULL;
+    return FALSE;
+  }
 }
 
 static void
@@ -519,6 +972,9 @@ gst_file_sink_close_file (GstFileSink * sink)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), NULL);
 
+    /* write errors were already posted by the writer thread */
+    gst_file_sink_write_behind_stop (sink);
+
     if (fclose (sink->file) != 0)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), GST_ERROR_SYSTEM);
@@ -610,6 +1066,9 @@ gst_file_sink_do_seek (GstFileSink * filesink, guint64 new_offset)
   if (gst_file_sink_flush_buffer (filesink) != GST_FLOW_OK)
     goto flush_buffer_failed;
 
+  if (gst_file_sink_write_behind_drain (filesink) != GST_FLOW_OK)
+    goto flush_buffer_failed;
+
 #ifdef HAVE_FSEEKO
   if (fseeko (filesink->file, (off_t) new_offset, SEEK_SET) != 0)
     goto seek_failed;
@@ -625,6 +1084,7 @@ gst_file_sink_do_seek (GstFileSink * filesink, guint64 new_offset)
   /* adjust position reporting after seek;
    * presumably this should basically yield new_offset */
   gst_file_sink_get_current_offset (filesink, &filesink->current_pos);
+  filesink->wb_position = filesink->current_pos;
 
   return TRUE;
 
@@ -681,6 +1141,8 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
       break;
     }
     case GST_EVENT_FLUSH_STOP:
+      if (gst_file_sink_write_behind_drain (filesink) != GST_FLOW_OK)
+        goto flush_buffer_failed;
       if (filesink->current_pos != 0 && filesink->seekable) {
         gst_file_sink_do_seek (filesink, 0);
         if (ftruncate (fileno (filesink->file), 0))
@@ -695,6 +1157,8 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
     case GST_EVENT_EOS:
       if (gst_file_sink_flush_buffer (filesink) != GST_FLOW_OK)
         goto flush_buffer_failed;
+      if (gst_file_sink_write_behind_drain (filesink) != GST_FLOW_OK)
+        goto flush_buffer_failed;
       break;
     default:
       break;
@@ -752,6 +1216,16 @@ gst_file_sink_get_current_offset (GstFileSink * filesink, guint64 * p_pos)
   return (ret != (off_t) - 1);
 }
 
+static gboolean
+accumulate_size (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  guint *size = user_data;
+
+  *size += gst_buffer_get_size (*buffer);
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_file_sink_render_list_internal (GstFileSink * sink,
     GstBufferList * buffer_list)
@@ -768,6 +1242,16 @@ gst_file_sink_render_list_internal (GstFileSink * sink,
       "writing %u buffers at position %" G_GUINT64_FORMAT, num_buffers,
       sink->current_pos);
 
+  if (sink->wb_thread) {
+    guint size = 0;
+
+    gst_buffer_list_foreach (buffer_list, accumulate_size, &size);
+
+    /* copy the list as the internal one is reused after flushing */
+    return gst_file_sink_write_behind_push (sink,
+        GST_MINI_OBJECT_CAST (gst_buffer_list_copy (buffer_list)), size);
+  }
+
   for (;;) {
     guint64 bytes_written = 0;
 
@@ -805,7 +1289,18 @@ gst_file_sink_flush_buffer (GstFileSink * filesink)
   GST_DEBUG_OBJECT (filesink, "Flushing out buffer of size %" G_GSIZE_FORMAT,
       filesink->current_buffer_size);
 
-  if (filesink->buffer && filesink->current_buffer_size) {
+  if (filesink->buffer && filesink->current_buffer_size
+      && filesink->wb_thread) {
+    GstBuffer *buffer;
+
+    /* hand the memory over to the writer thread and continue with a new one */
+    buffer = gst_buffer_new_wrapped (filesink->buffer,
+        filesink->current_buffer_size);
+    filesink->buffer = g_malloc (filesink->allocated_buffer_size);
+
+    flow_ret = gst_file_sink_write_behind_push (filesink,
+        GST_MINI_OBJECT_CAST (buffer), filesink->current_buffer_size);
+  } else if (filesink->buffer && filesink->current_buffer_size) {
     guint64 skip = 0;
 
     for (;;) {
@@ -859,16 +1354,6 @@ has_sync_after_buffer (GstBuffer ** buffer, guint idx, gpointer user_data)
   return TRUE;
 }
 
-static gboolean
-accumulate_size (GstBuffer ** buffer, guint idx, gpointer user_data)
-{
-  guint *size = user_data;
-
-  *size += gst_buffer_get_size (*buffer);
-
-  return TRUE;
-}
-
 static GstFlowReturn
 render_buffer (GstFileSink * filesink, GstBuffer * buffer)
 {
@@ -876,6 +1361,11 @@ render_buffer (GstFileSink * filesink, GstBuffer * buffer)
   guint64 bytes_written = 0;
   guint64 skip = 0;
 
+  if (filesink->wb_thread)
+    return gst_file_sink_write_behind_push (filesink,
+        GST_MINI_OBJECT_CAST (gst_buffer_ref (buffer)),
+        gst_buffer_get_size (buffer));
+
   for (;;) {
     flow =
         gst_writev_buffer (GST_OBJECT_CAST (filesink),
@@ -968,6 +1458,9 @@ gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
     }
   }
 
+  if (flow == GST_FLOW_OK && sync_after)
+    flow = gst_file_sink_write_behind_drain (sink);
+
   if (flow == GST_FLOW_OK && sync_after) {
     do {
       fsync_ret = fsync (fileno (sink->file));
@@ -1052,6 +1545,9 @@ gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
     flow = GST_FLOW_OK;
   }
 
+  if (flow == GST_FLOW_OK && sync_after)
+    flow = gst_file_sink_write_behind_drain (filesink);
+
   if (flow == GST_FLOW_OK && sync_after) {
     do {
       fsync_ret = fsync (fileno (filesink->file));
@@ -1075,6 +1571,12 @@ gst_file_sink_start (GstBaseSink * basesink)
   filesink = GST_FILE_SINK_CAST (basesink);
 
   g_atomic_int_set (&filesink->flushing, FALSE);
+
+  /* don't carry a write error of a previous run over */
+  g_mutex_lock (&filesink->wb_lock);
+  filesink->wb_flow = GST_FLOW_OK;
+  g_mutex_unlock (&filesink->wb_lock);
+
   return gst_file_sink_open_file (filesink);
 }
 
@@ -1086,6 +1588,11 @@ gst_file_sink_stop (GstBaseSink * basesink)
   filesink = GST_FILE_SINK_CAST (basesink);
 
   gst_file_sink_close_file (filesink);
+
+  g_mutex_lock (&filesink->wb_lock);
+  filesink->wb_flow = GST_FLOW_OK;
+  g_mutex_unlock (&filesink->wb_lock);
+
   return TRUE;
 }
 
@@ -1097,6 +1604,11 @@ gst_file_sink_unlock (GstBaseSink * basesink)
   filesink = GST_FILE_SINK_CAST (basesink);
   g_atomic_int_set (&filesink->flushing, TRUE);
 
+  /* wake up the streaming thread if it's waiting for space in the queue */
+  g_mutex_lock (&filesink->wb_lock);
+  g_cond_broadcast (&filesink->wb_space_cond);
+  g_mutex_unlock (&filesink->wb_lock);
+
   return TRUE;
 }
 
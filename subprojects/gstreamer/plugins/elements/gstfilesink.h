@@ -113,6 +113,32 @@ struct _GstFileSink {
   gint max_transient_error_timeout;
 
   gboolean flushing;
+
+  /* write-behind */
+  gboolean write_behind;
+  guint write_behind_size;
+  GstClockTime sync_interval;
+
+  GThread *wb_thread;
+  GMutex wb_lock;
+  GCond wb_cond;                /* signalled when items are queued */
+  GCond wb_space_cond;          /* signalled when items were written */
+  GQueue wb_queue;
+  gint wb_fd;
+  guint64 wb_position;          /* position of the writer thread */
+  guint64 wb_queued_bytes;
+  gboolean wb_busy;             /* writer thread is writing an item */
+  gboolean wb_dirty;            /* data written since the last sync */
+  gboolean wb_stopping;
+  gint64 wb_last_sync;
+  GstFlowReturn wb_flow;
+
+  /* write-behind statistics, protected by wb_lock */
+  guint64 wb_max_queued_bytes;
+  guint64 wb_writes;
+  guint64 wb_syncs;
+  GstClockTime wb_total_latency;
+  GstClockTime wb_max_latency;
 };
 
 struct _GstFileSinkClass {
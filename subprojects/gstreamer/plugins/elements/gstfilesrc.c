@@ -26,6 +26,11 @@
  *
  * Read data from a file in the local file system.
  *
+ * If #GstFileSrc:use-mmap is enabled, regular files are memory-mapped and
+ * the buffers point directly into the page cache instead of being copied
+ * with read(). This saves a memcpy per block for demuxers reading large
+ * files, but the file must not be truncated while it is being read.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! audioconvert ! audioresample ! autoaudiosink
@@ -68,6 +73,10 @@
 #  include <unistd.h>
 #endif
 
+#ifdef HAVE_SYS_MMAN_H
+#  include <sys/mman.h>
+#endif
+
 #define struct_stat struct stat
 
 #ifdef __BIONIC__               /* Android */
@@ -113,13 +122,70 @@ enum
 };
 
 #define DEFAULT_BLOCKSIZE       4*1024
+#define DEFAULT_USE_MMAP        FALSE
+
+/* how far ahead of the current position the kernel is asked to read in
+ * when reading from a memory-mapped file */
+#define MMAP_READAHEAD          (2 * 1024 * 1024)
 
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_USE_MMAP
 };
 
+#ifdef HAVE_SYS_MMAN_H
+/* A read-only mapping of the whole file. Every memory handed out from it
+ * holds a reference, so the file stays mapped until the last buffer pointing
+ * into it is gone, even after the element was stopped. */
+struct _GstFileSrcMapping
+{
+  gint refcount;
+  guint8 *data;
+  gsize size;
+};
+
+static GstFileSrcMapping *
+gst_file_src_mapping_new (gint fd, gsize size)
+{
+  GstFileSrcMapping *mapping;
+  gpointer data;
+
+  data = mmap (NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED)
+    return NULL;
+
+#ifdef HAVE_MADVISE
+  madvise (data, size, MADV_SEQUENTIAL);
+#endif
+
+  mapping = g_new (GstFileSrcMapping, 1);
+  mapping->refcount = 1;
+  mapping->data = data;
+  mapping->size = size;
+
+  return mapping;
+}
+
+static GstFileSrcMapping *
+gst_file_src_mapping_ref (GstFileSrcMapping * mapping)
+{
+  g_atomic_int_inc (&mapping->refcount);
+
+  return mapping;
+}
+
+static void
+gst_file_src_mapping_unref (GstFileSrcMapping * mapping)
+{
+  if (g_atomic_int_dec_and_test (&mapping->refcount)) {
+    munmap (mapping->data, mapping->size);
+    g_free (mapping);
+  }
+}
+#endif
+
 static void gst_file_src_finalize (GObject * object);
 
 static void gst_file_src_set_property (GObject * object, guint prop_id,
@@ -132,6 +198,8 @@ static gboolean gst_file_src_stop (GstBaseSrc * basesrc);
 
 static gboolean gst_file_src_is_seekable (GstBaseSrc * src);
 static gboolean gst_file_src_get_size (GstBaseSrc * src, guint64 * size);
+static GstFlowReturn gst_file_src_create (GstBaseSrc * src, guint64 offset,
+    guint length, GstBuffer ** buf);
 static GstFlowReturn gst_file_src_fill (GstBaseSrc * src, guint64 offset,
     guint length, GstBuffer * buf);
 
@@ -166,6 +234,27 @@ gst_file_src_class_init (GstFileSrcClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstFileSrc:use-mmap:
+   *
+   * Memory-map regular files and output buffers that point directly into the
+   * mapping instead of reading the data into newly allocated buffers. The
+   * buffers are read-only and keep the mapping alive for as long as they
+   * are in use.
+   *
+   * The file must not be truncated while it is mapped, accessing the
+   * truncated part would crash the process. Data appended to the file after
+   * it was opened is read normally. If mapping fails, or on platforms
+   * without mmap(), the file is read normally as well.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Memory-map regular files and output zero-copy buffers",
+          DEFAULT_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gobject_class->finalize = gst_file_src_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -179,6 +268,7 @@ gst_file_src_class_init (GstFileSrcClass * klass)
   gstbasesrc_class->stop = GST_DEBUG_FUNCPTR (gst_file_src_stop);
   gstbasesrc_class->is_seekable = GST_DEBUG_FUNCPTR (gst_file_src_is_seekable);
   gstbasesrc_class->get_size = GST_DEBUG_FUNCPTR (gst_file_src_get_size);
+  gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_file_src_create);
   gstbasesrc_class->fill = GST_DEBUG_FUNCPTR (gst_file_src_fill);
 
   if (sizeof (off_t) < 8) {
@@ -195,6 +285,8 @@ gst_file_src_init (GstFileSrc * src)
   src->uri = NULL;
 
   src->is_regular = FALSE;
+  src->use_mmap = DEFAULT_USE_MMAP;
+  src->mapping = NULL;
 
   gst_base_src_set_blocksize (GST_BASE_SRC (src), DEFAULT_BLOCKSIZE);
 }
@@ -273,6 +365,11 @@ gst_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOCATION:
       gst_file_src_set_location (src, g_value_get_string (value), NULL);
       break;
+    case PROP_USE_MMAP:
+      GST_OBJECT_LOCK (src);
+      src->use_mmap = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -293,12 +390,101 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_LOCATION:
       g_value_set_string (value, src->filename);
       break;
+    case PROP_USE_MMAP:
+      GST_OBJECT_LOCK (src);
+      g_value_set_boolean (value, src->use_mmap);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+#ifdef HAVE_SYS_MMAN_H
+/* Hints the kernel to read ahead the part of the mapping after the one that
+ * is currently read, so the next buffers don't block on page faults */
+static void
+gst_file_src_mmap_advise (GstFileSrc * src, guint64 offset)
+{
+#ifdef HAVE_MADVISE
+  GstFileSrcMapping *mapping = src->mapping;
+  guint64 start, end;
+  gsize page_size;
+
+  /* still within the range that was advised before */
+  if (offset >= src->mmap_advised_start
+      && (offset + MMAP_READAHEAD / 2 <= src->mmap_advised_end
+          || src->mmap_advised_end == mapping->size))
+    return;
+
+  page_size = sysconf (_SC_PAGESIZE);
+  start = offset - offset % page_size;
+  end = MIN (offset + MMAP_READAHEAD, mapping->size);
+  if (start >= end)
+    return;
+
+  GST_LOG_OBJECT (src, "advising kernel to read 0x%" G_GINT64_MODIFIER "x - 0x%"
+      G_GINT64_MODIFIER "x", start, end);
+
+  madvise (mapping->data + start, end - start, MADV_WILLNEED);
+
+  src->mmap_advised_start = start;
+  src->mmap_advised_end = end;
+#endif
+}
+
+static GstFlowReturn
+gst_file_src_create_mmap (GstFileSrc * src, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstFileSrcMapping *mapping = src->mapping;
+  GstMemory *mem;
+  GstBuffer *buf;
+  gsize size;
+
+  size = MIN (length, mapping->size - offset);
+
+  GST_LOG_OBJECT (src, "Mapping %" G_GSIZE_FORMAT " bytes at offset 0x%"
+      G_GINT64_MODIFIER "x", size, offset);
+
+  gst_file_src_mmap_advise (src, offset + size);
+
+  mem = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY,
+      mapping->data + offset, size, 0, size,
+      gst_file_src_mapping_ref (mapping),
+      (GDestroyNotify) gst_file_src_mapping_unref);
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf, mem);
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + size;
+
+  *buffer = buf;
+
+  return GST_FLOW_OK;
+}
+#endif
+
+static GstFlowReturn
+gst_file_src_create (GstBaseSrc * basesrc, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+#ifdef HAVE_SYS_MMAN_H
+  GstFileSrc *src = GST_FILE_SRC_CAST (basesrc);
+
+  /* downstream provided buffers are filled normally, as are the parts of
+   * the file that were appended after it was mapped */
+  if (src->mapping != NULL && *buffer == NULL && offset != -1
+      && offset < src->mapping->size)
+    return gst_file_src_create_mmap (src, offset, length, buffer);
+#endif
+
+  return GST_BASE_SRC_CLASS (parent_class)->create (basesrc, offset, length,
+      buffer);
+}
+
 /***
  * read code below
  * that is to say, you shouldn't read the code below, but the code that reads
@@ -487,6 +673,9 @@ gst_file_src_start (GstBaseSrc * basesrc)
 {
   GstFileSrc *src = GST_FILE_SRC (basesrc);
   int flags = O_RDONLY | O_BINARY;
+#ifdef HAVE_SYS_MMAN_H
+  gboolean use_mmap;
+#endif
 #if defined (__BIONIC__)
   flags |= O_LARGEFILE;
 #endif
@@ -569,6 +758,30 @@ gst_file_src_start (GstBaseSrc * basesrc)
 
   gst_base_src_set_dynamic_size (basesrc, src->seekable);
 
+#ifdef HAVE_SYS_MMAN_H
+  GST_OBJECT_LOCK (src);
+  use_mmap = src->use_mmap;
+  GST_OBJECT_UNLOCK (src);
+
+  if (use_mmap && src->is_regular) {
+    struct_stat stat_results;
+
+    /* empty files can't be mapped and are simply read */
+    if (fstat (src->fd, &stat_results) == 0 && stat_results.st_size > 0
+        && (guint64) stat_results.st_size <= G_MAXSIZE) {
+      src->mapping = gst_file_src_mapping_new (src->fd, stat_results.st_size);
+      src->mmap_advised_start = src->mmap_advised_end = 0;
+
+      if (src->mapping)
+        GST_INFO_OBJECT (src, "mapped %" G_GSIZE_FORMAT " bytes",
+            src->mapping->size);
+      else
+        GST_WARNING_OBJECT (src, "could not map file, reading it instead: %s",
+            g_strerror (errno));
+    }
+  }
+#endif
+
   return TRUE;
 
   /* ERROR */
@@ -632,6 +845,14 @@ gst_file_src_stop (GstBaseSrc * basesrc)
 {
   GstFileSrc *src = GST_FILE_SRC (basesrc);
 
+#ifdef HAVE_SYS_MMAN_H
+  /* buffers still in use downstream keep the file mapped */
+  if (src->mapping) {
+    gst_file_src_mapping_unref (src->mapping);
+    src->mapping = NULL;
+  }
+#endif
+
   /* close the file */
   g_close (src->fd, NULL);
 
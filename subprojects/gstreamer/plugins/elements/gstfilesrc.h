@@ -45,6 +45,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstFileSrc GstFileSrc;
 typedef struct _GstFileSrcClass GstFileSrcClass;
+typedef struct _GstFileSrcMapping GstFileSrcMapping;
 
 /**
  * GstFileSrc:
@@ -63,6 +64,11 @@ struct _GstFileSrc {
   gboolean seekable;                    /* whether the file is seekable */
   gboolean is_regular;                  /* whether it's a (symlink to a)
                                            regular file */
+
+  gboolean use_mmap;                    /* whether to mmap regular files */
+  GstFileSrcMapping *mapping;           /* mapping of the file or NULL */
+  guint64 mmap_advised_start;           /* range the kernel was asked to */
+  guint64 mmap_advised_end;             /* read ahead */
 };
 
 struct _GstFileSrcClass {
@@ -269,6 +269,11 @@ enum
 
 #define DEFAULT_MINIMUM_INTERLEAVE (250 * GST_MSECOND)
 
+#define DEFAULT_PUSH_LISTS FALSE
+#define DEFAULT_MAX_LIST_SIZE_BUFFERS 64
+#define DEFAULT_MAX_LIST_SIZE_BYTES 0
+#define DEFAULT_MAX_LIST_SIZE_TIME 0
+
 enum
 {
   PROP_0,
@@ -288,6 +293,10 @@ enum
   PROP_UNLINKED_CACHE_TIME,
   PROP_MINIMUM_INTERLEAVE,
   PROP_STATS,
+  PROP_PUSH_LISTS,
+  PROP_MAX_LIST_SIZE_BUFFERS,
+  PROP_MAX_LIST_SIZE_BYTES,
+  PROP_MAX_LIST_SIZE_TIME,
   PROP_LAST
 };
 
@@ -840,6 +849,72 @@ gst_multi_queue_class_init (GstMultiQueueClass * klass)
           "Multiqueue Statistics",
           GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiQueue:push-lists:
+   *
+   * Take all consecutive buffers that are currently queued on a linked
+   * stream, up to the max-list-size limits, and push them downstream as a
+   * single #GstBufferList instead of one by one.
+   *
+   * Not-linked streams and the EOS handling still work per item, and
+   * downstream elements without a chain list function receive the buffers
+   * one by one as before.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_PUSH_LISTS,
+      g_param_spec_boolean ("push-lists", "Push lists",
+          "Push all queued consecutive buffers as buffer lists",
+          DEFAULT_PUSH_LISTS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiQueue:max-list-size-buffers:
+   *
+   * Max. number of buffers in a buffer list pushed when
+   * #GstMultiQueue:push-lists is enabled.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_LIST_SIZE_BUFFERS,
+      g_param_spec_uint ("max-list-size-buffers", "Max. list size (buffers)",
+          "Max. number of buffers in pushed buffer lists (0=disable)", 0,
+          G_MAXUINT, DEFAULT_MAX_LIST_SIZE_BUFFERS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiQueue:max-list-size-bytes:
+   *
+   * Max. amount of data in a buffer list pushed when
+   * #GstMultiQueue:push-lists is enabled.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_LIST_SIZE_BYTES,
+      g_param_spec_uint ("max-list-size-bytes", "Max. list size (bytes)",
+          "Max. amount of data in pushed buffer lists (bytes, 0=disable)", 0,
+          G_MAXUINT, DEFAULT_MAX_LIST_SIZE_BYTES,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiQueue:max-list-size-time:
+   *
+   * Max. duration of the buffers in a buffer list pushed when
+   * #GstMultiQueue:push-lists is enabled. Buffers without duration are not
+   * accounted.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_LIST_SIZE_TIME,
+      g_param_spec_uint64 ("max-list-size-time", "Max. list size (ns)",
+          "Max. duration of pushed buffer lists (in ns, 0=disable)", 0,
+          G_MAXUINT64, DEFAULT_MAX_LIST_SIZE_TIME,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_multi_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -883,6 +958,11 @@ gst_multi_queue_init (GstMultiQueue * mqueue)
   mqueue->min_interleave_time = DEFAULT_MINIMUM_INTERLEAVE;
   mqueue->unlinked_cache_time = DEFAULT_UNLINKED_CACHE_TIME;
 
+  mqueue->push_lists = DEFAULT_PUSH_LISTS;
+  mqueue->max_list_size.visible = DEFAULT_MAX_LIST_SIZE_BUFFERS;
+  mqueue->max_list_size.bytes = DEFAULT_MAX_LIST_SIZE_BYTES;
+  mqueue->max_list_size.time = DEFAULT_MAX_LIST_SIZE_TIME;
+
   mqueue->counter = 1;
   mqueue->highid = -1;
   mqueue->high_time = GST_CLOCK_STIME_NONE;
@@ -1031,6 +1111,26 @@ gst_multi_queue_set_property (GObject * object, guint prop_id,
         calculate_interleave (mq, NULL);
       GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
       break;
+    case PROP_PUSH_LISTS:
+      GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+      mq->push_lists = g_value_get_boolean (value);
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      break;
+    case PROP_MAX_LIST_SIZE_BUFFERS:
+      GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+      mq->max_list_size.visible = g_value_get_uint (value);
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      break;
+    case PROP_MAX_LIST_SIZE_BYTES:
+      GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+      mq->max_list_size.bytes = g_value_get_uint (value);
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      break;
+    case PROP_MAX_LIST_SIZE_TIME:
+      GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+      mq->max_list_size.time = g_value_get_uint64 (value);
+      GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1134,6 +1234,18 @@ gst_multi_queue_get_property (GObject * object, guint prop_id,
     case PROP_STATS:
       g_value_take_boxed (value, gst_multi_queue_get_stats (mq));
       break;
+    case PROP_PUSH_LISTS:
+      g_value_set_boolean (value, mq->push_lists);
+      break;
+    case PROP_MAX_LIST_SIZE_BUFFERS:
+      g_value_set_uint (value, mq->max_list_size.visible);
+      break;
+    case PROP_MAX_LIST_SIZE_BYTES:
+      g_value_set_uint (value, mq->max_list_size.bytes);
+      break;
+    case PROP_MAX_LIST_SIZE_TIME:
+      g_value_set_uint64 (value, mq->max_list_size.time);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2013,6 +2125,32 @@ gst_single_queue_push_one (GstMultiQueue * mq, GstSingleQueue * sq,
           buffer, GST_TIME_ARGS (timestamp));
       result = gst_pad_push (srcpad, buffer);
     }
+  } else if (GST_IS_BUFFER_LIST (object)) {
+    GstBufferList *buffer_list;
+    guint i, n;
+
+    buffer_list = GST_BUFFER_LIST_CAST (object);
+    n = gst_buffer_list_length (buffer_list);
+
+    for (i = 0; i < n; i++) {
+      GstBuffer *buffer = gst_buffer_list_get (buffer_list, i);
+
+      apply_buffer (mq, sq, GST_BUFFER_DTS_OR_PTS (buffer),
+          GST_BUFFER_DURATION (buffer), &sq->src_segment);
+    }
+
+    /* Applying the buffers may have made the queue non-full again, unblock it if needed */
+    gst_data_queue_limits_changed (sq->queue);
+
+    if (G_UNLIKELY (*allow_drop)) {
+      GST_DEBUG_ID (sq->debug_id,
+          "Dropping EOS buffer list %p with %u buffers", buffer_list, n);
+      gst_buffer_list_unref (buffer_list);
+    } else {
+      GST_DEBUG_ID (sq->debug_id,
+          "Pushing buffer list %p with %u buffers", buffer_list, n);
+      result = gst_pad_push_list (srcpad, buffer_list);
+    }
   } else if (GST_IS_EVENT (object)) {
     GstEvent *event;
 
@@ -2156,6 +2294,73 @@ gst_multi_queue_mo_item_new (GstMiniObject * object, guint32 curid)
   return item;
 }
 
+/* Pops the buffers following @buffer from @sq as long as they fit into the
+ * max_list_size limits. Returns them together with @buffer as a buffer list
+ * and updates @newid to the id of the last one, or returns @buffer if
+ * nothing could be merged. */
+static GstMiniObject *
+gst_single_queue_pop_list (GstMultiQueue * mq, GstSingleQueue * sq,
+    GstBuffer * buffer, guint32 * newid)
+{
+  GstBufferList *buffer_list = NULL;
+  GstDataQueueSize max_list_size;
+  GstDataQueueItem *sitem;
+  guint n_buffers = 1;
+  guint64 bytes, duration = 0;
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  max_list_size = mq->max_list_size;
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  bytes = gst_buffer_get_size (buffer);
+  if (GST_BUFFER_DURATION_IS_VALID (buffer))
+    duration = GST_BUFFER_DURATION (buffer);
+
+  /* we're the only thread popping from the queue, peeking a non-empty queue
+   * doesn't block */
+  while (!gst_data_queue_is_empty (sq->queue)
+      && gst_data_queue_peek (sq->queue, &sitem)) {
+    GstMultiQueueItem *item = (GstMultiQueueItem *) sitem;
+
+    /* only merge plain buffers, everything else keeps its position */
+    if (item->is_query || !GST_IS_BUFFER (item->object))
+      break;
+
+    if (max_list_size.visible > 0 && n_buffers >= max_list_size.visible)
+      break;
+    if (max_list_size.bytes > 0 && bytes + item->size > max_list_size.bytes)
+      break;
+    if (max_list_size.time > 0 && duration + item->duration >
+        max_list_size.time)
+      break;
+
+    if (!gst_data_queue_pop (sq->queue, &sitem))
+      break;
+
+    item = (GstMultiQueueItem *) sitem;
+    *newid = item->posid;
+    bytes += item->size;
+    duration += item->duration;
+    n_buffers++;
+
+    if (buffer_list == NULL) {
+      buffer_list = gst_buffer_list_new ();
+      gst_buffer_list_add (buffer_list, buffer);
+    }
+    gst_buffer_list_add (buffer_list,
+        GST_BUFFER_CAST (gst_multi_queue_item_steal_object (item)));
+    gst_multi_queue_item_destroy (item);
+  }
+
+  if (buffer_list == NULL)
+    return GST_MINI_OBJECT_CAST (buffer);
+
+  GST_LOG_ID (sq->debug_id, "merged %u buffers into buffer list %p",
+      n_buffers, buffer_list);
+
+  return GST_MINI_OBJECT_CAST (buffer_list);
+}
+
 /* Each main loop attempts to push buffers until the return value
  * is not-linked. not-linked pads are not allowed to push data beyond
  * any linked pads, so they don't 'rush ahead of the pack'.
@@ -2175,6 +2380,7 @@ gst_multi_queue_loop (GstPad * pad)
   gboolean is_query = FALSE;
   gboolean do_update_buffering = FALSE;
   gboolean dropping = FALSE;
+  gboolean push_lists;
   GstPad *srcpad = NULL;
 
   sq = GST_MULTIQUEUE_PAD (pad)->sq;
@@ -2324,6 +2530,7 @@ next:
     sq->nextid = 0;
     sq->next_time = GST_CLOCK_STIME_NONE;
   }
+  push_lists = mq->push_lists;
   GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
 
   if (sq->flushing)
@@ -2332,6 +2539,13 @@ next:
   GST_LOG_ID (sq->debug_id, "BEFORE PUSHING sq->srcresult: %s",
       gst_flow_get_name (sq->srcresult));
 
+  /* When linked, merge the buffers that are already queued behind this one.
+   * Not-linked streams keep going item by item as they have to wait for the
+   * linked ones before each push */
+  if (is_buffer && !dropping && sq->srcresult == GST_FLOW_OK && push_lists)
+    object = gst_single_queue_pop_list (mq, sq, GST_BUFFER_CAST (object),
+        &newid);
+
   /* Update time stats */
   GST_MULTI_QUEUE_MUTEX_LOCK (mq);
   next_time = get_running_time (&sq->src_segment, object, TRUE);
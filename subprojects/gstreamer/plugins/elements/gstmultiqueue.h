@@ -90,6 +90,10 @@ struct _GstMultiQueue {
   gboolean interleave_incomplete; /* TRUE if not all streams were active */
 
   GstClockTime unlinked_cache_time;
+
+  /* merge queued buffers into lists of at most max_list_size */
+  gboolean push_lists;
+  GstDataQueueSize max_list_size;
 };
 
 struct _GstMultiQueueClass {
@@ -122,7 +122,11 @@ enum
   PROP_MIN_THRESHOLD_TIME,
   PROP_LEAKY,
   PROP_SILENT,
-  PROP_FLUSH_ON_EOS
+  PROP_FLUSH_ON_EOS,
+  PROP_PUSH_LISTS,
+  PROP_MAX_LIST_SIZE_BUFFERS,
+  PROP_MAX_LIST_SIZE_BYTES,
+  PROP_MAX_LIST_SIZE_TIME
 };
 
 /* default property values */
@@ -130,6 +134,11 @@ enum
 #define DEFAULT_MAX_SIZE_BYTES    (10 * 1024 * 1024)    /* 10 MB       */
 #define DEFAULT_MAX_SIZE_TIME     GST_SECOND    /* 1 second    */
 
+#define DEFAULT_PUSH_LISTS            FALSE
+#define DEFAULT_MAX_LIST_SIZE_BUFFERS 64
+#define DEFAULT_MAX_LIST_SIZE_BYTES   0
+#define DEFAULT_MAX_LIST_SIZE_TIME    0
+
 #define GST_QUEUE_MUTEX_LOCK(q) G_STMT_START {                          \
   g_mutex_lock (&q->qlock);                                              \
 } G_STMT_END
@@ -405,6 +414,74 @@ gst_queue_class_init (GstQueueClass * klass)
           G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * queue:push-lists:
+   *
+   * Take all consecutive buffers that are currently queued, up to the
+   * max-list-size limits, and push them downstream as a single
+   * #GstBufferList instead of one by one.
+   *
+   * This amortizes the cost of the pad locking, probes and wakeups of
+   * downstream over many buffers when the queue fills up faster than
+   * downstream consumes, e.g. for packetized network data. Events and
+   * queries are never merged, and downstream elements without a chain list
+   * function receive the buffers one by one as before.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_PUSH_LISTS,
+      g_param_spec_boolean ("push-lists", "Push lists",
+          "Push all queued consecutive buffers as buffer lists",
+          DEFAULT_PUSH_LISTS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * queue:max-list-size-buffers:
+   *
+   * Max. number of buffers in a buffer list pushed when #queue:push-lists
+   * is enabled.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_LIST_SIZE_BUFFERS,
+      g_param_spec_uint ("max-list-size-buffers", "Max. list size (buffers)",
+          "Max. number of buffers in pushed buffer lists (0=disable)", 0,
+          G_MAXUINT, DEFAULT_MAX_LIST_SIZE_BUFFERS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * queue:max-list-size-bytes:
+   *
+   * Max. amount of data in a buffer list pushed when #queue:push-lists
+   * is enabled.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_LIST_SIZE_BYTES,
+      g_param_spec_uint ("max-list-size-bytes", "Max. list size (bytes)",
+          "Max. amount of data in pushed buffer lists (bytes, 0=disable)", 0,
+          G_MAXUINT, DEFAULT_MAX_LIST_SIZE_BYTES,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * queue:max-list-size-time:
+   *
+   * Max. duration of the buffers in a buffer list pushed when
+   * #queue:push-lists is enabled. Buffers without duration are not
+   * accounted.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_LIST_SIZE_TIME,
+      g_param_spec_uint64 ("max-list-size-time", "Max. list size (ns)",
+          "Max. duration of pushed buffer lists (in ns, 0=disable)", 0,
+          G_MAXUINT64, DEFAULT_MAX_LIST_SIZE_TIME,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -454,6 +531,10 @@ gst_queue_init (GstQueue * queue)
   queue->max_size.time = DEFAULT_MAX_SIZE_TIME;
   GST_QUEUE_CLEAR_LEVEL (queue->min_threshold);
   GST_QUEUE_CLEAR_LEVEL (queue->orig_min_threshold);
+  queue->push_lists = DEFAULT_PUSH_LISTS;
+  queue->max_list_size.buffers = DEFAULT_MAX_LIST_SIZE_BUFFERS;
+  queue->max_list_size.bytes = DEFAULT_MAX_LIST_SIZE_BYTES;
+  queue->max_list_size.time = DEFAULT_MAX_LIST_SIZE_TIME;
   gst_segment_init (&queue->sink_segment, GST_FORMAT_TIME);
   gst_segment_init (&queue->src_segment, GST_FORMAT_TIME);
   queue->head_needs_discont = queue->tail_needs_discont = FALSE;
@@ -955,6 +1036,64 @@ no_item:
   }
 }
 
+/* dequeue the buffers following @buffer as long as they fit into the
+ * max_list_size limits, with QUEUE_LOCK. Returns a buffer list with @buffer
+ * and the dequeued buffers, or @buffer if the next item can't be merged */
+static GstMiniObject *
+gst_queue_locked_dequeue_list (GstQueue * queue, GstBuffer * buffer)
+{
+  GstBufferList *buffer_list = NULL;
+  GstQueueItem *qitem;
+  guint n_buffers = 1;
+  guint64 bytes = gst_buffer_get_size (buffer);
+  GstClockTime duration = 0;
+
+  if (GST_BUFFER_DURATION_IS_VALID (buffer))
+    duration = GST_BUFFER_DURATION (buffer);
+
+  while ((qitem = gst_vec_deque_peek_head_struct (queue->queue))) {
+    GstBuffer *next;
+
+    /* only merge plain buffers, everything else keeps its position */
+    if (qitem->is_query || !GST_IS_BUFFER (qitem->item))
+      break;
+
+    next = GST_BUFFER_CAST (qitem->item);
+
+    if (queue->max_list_size.buffers > 0
+        && n_buffers >= queue->max_list_size.buffers)
+      break;
+    if (queue->max_list_size.bytes > 0
+        && bytes + qitem->size > queue->max_list_size.bytes)
+      break;
+    if (queue->max_list_size.time > 0 && GST_BUFFER_DURATION_IS_VALID (next)
+        && duration + GST_BUFFER_DURATION (next) > queue->max_list_size.time)
+      break;
+
+    if (buffer_list == NULL) {
+      buffer_list = gst_buffer_list_new_sized (MIN (queue->cur_level.buffers,
+              64) + 1);
+      gst_buffer_list_add (buffer_list, buffer);
+    }
+
+    bytes += qitem->size;
+    if (GST_BUFFER_DURATION_IS_VALID (next))
+      duration += GST_BUFFER_DURATION (next);
+    n_buffers++;
+
+    next = GST_BUFFER_CAST (gst_queue_locked_dequeue (queue));
+    gst_buffer_list_add (buffer_list, next);
+  }
+
+  if (buffer_list == NULL)
+    return GST_MINI_OBJECT_CAST (buffer);
+
+  GST_CAT_LOG_OBJECT (queue_dataflow, queue,
+      "merged %u buffers into buffer list %p", n_buffers, buffer_list);
+
+  return GST_MINI_OBJECT_CAST (buffer_list);
+}
+
 static GstFlowReturn
 gst_queue_handle_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -1411,6 +1550,9 @@ gst_queue_push_one (GstQueue * queue)
   if (data == NULL)
     goto no_item;
 
+  if (queue->push_lists && GST_IS_BUFFER (data))
+    data = gst_queue_locked_dequeue_list (queue, GST_BUFFER_CAST (data));
+
 next:
   is_list = GST_IS_BUFFER_LIST (data);
 
@@ -1896,6 +2038,18 @@ gst_queue_set_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       queue->flush_on_eos = g_value_get_boolean (value);
       break;
+    case PROP_PUSH_LISTS:
+      queue->push_lists = g_value_get_boolean (value);
+      break;
+    case PROP_MAX_LIST_SIZE_BUFFERS:
+      queue->max_list_size.buffers = g_value_get_uint (value);
+      break;
+    case PROP_MAX_LIST_SIZE_BYTES:
+      queue->max_list_size.bytes = g_value_get_uint (value);
+      break;
+    case PROP_MAX_LIST_SIZE_TIME:
+      queue->max_list_size.time = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1949,6 +2103,18 @@ gst_queue_get_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       g_value_set_boolean (value, queue->flush_on_eos);
       break;
+    case PROP_PUSH_LISTS:
+      g_value_set_boolean (value, queue->push_lists);
+      break;
+    case PROP_MAX_LIST_SIZE_BUFFERS:
+      g_value_set_uint (value, queue->max_list_size.buffers);
+      break;
+    case PROP_MAX_LIST_SIZE_BYTES:
+      g_value_set_uint (value, queue->max_list_size.bytes);
+      break;
+    case PROP_MAX_LIST_SIZE_TIME:
+      g_value_set_uint64 (value, queue->max_list_size.time);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
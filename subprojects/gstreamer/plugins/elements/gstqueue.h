@@ -139,6 +139,10 @@ struct _GstQueue {
   GstQuery *last_handled_query;
 
   gboolean flush_on_eos; /* flush on EOS */
+
+  /* merge queued buffers into lists of at most max_list_size */
+  gboolean push_lists;
+  GstQueueSize max_list_size;
 };
 
 struct _GstQueueClass {
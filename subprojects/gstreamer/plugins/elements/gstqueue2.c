@@ -81,7 +81,7 @@
 #include <unistd.h>
 #endif
 
-#ifdef __BIONIC__               /* Android */
+#if defined (__BIONIC__) || defined (HAVE_POSIX_FALLOCATE)
 #include <fcntl.h>
 #endif
 
@@ -126,6 +126,8 @@ enum
 #define DEFAULT_TEMP_REMOVE        TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
 #define DEFAULT_USE_BITRATE_QUERY  TRUE
+#define DEFAULT_TEMP_WRITE_ASYNC   FALSE
+#define DEFAULT_TEMP_WRITE_MAX_PENDING (16 * 1024 * 1024)       /* 16 MB */
 
 enum
 {
@@ -150,6 +152,9 @@ enum
   PROP_AVG_IN_RATE,
   PROP_USE_BITRATE_QUERY,
   PROP_BITRATE,
+  PROP_TEMP_WRITE_ASYNC,
+  PROP_TEMP_WRITE_MAX_PENDING,
+  PROP_TEMP_STATS,
   PROP_LAST
 };
 static GParamSpec *obj_props[PROP_LAST] = { NULL, };
@@ -470,6 +475,61 @@ gst_queue2_class_init (GstQueue2Class * klass)
       "Conversion value between data size and time",
       0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstQueue2:temp-write-async
+   *
+   * When temp-template is set, write the temporary file from a separate
+   * thread so that the streaming thread does not block on disk I/O. Data
+   * that is not written yet is still served to downstream from memory.
+   * Only supported on platforms with pread() and pwrite(), elsewhere the
+   * file is written synchronously.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_TEMP_WRITE_ASYNC] =
+      g_param_spec_boolean ("temp-write-async",
+      "Write temp file asynchronously",
+      "Write the temp-location from a separate thread",
+      DEFAULT_TEMP_WRITE_ASYNC, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GstQueue2:temp-write-max-pending
+   *
+   * When temp-write-async is enabled, the maximum amount of data in bytes
+   * that is kept in memory while waiting to be written to the temporary
+   * file. Upstream is blocked when this limit is reached.
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_TEMP_WRITE_MAX_PENDING] =
+      g_param_spec_uint ("temp-write-max-pending",
+      "Max. pending temp file data (bytes)",
+      "Max. amount of data waiting to be written to the temp-location "
+      "(bytes, 0 = unlimited)",
+      0, G_MAXUINT, DEFAULT_TEMP_WRITE_MAX_PENDING,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GstQueue2:temp-stats
+   *
+   * Statistics about the temporary file I/O, as a structure named
+   * "application/x-queue2-temp-stats" with the fields:
+   *
+   * * "bytes-written" (guint64): bytes written to the file
+   * * "bytes-read" (guint64): bytes read from the file
+   * * "write-rate" (gdouble): bytes per second spent writing
+   * * "read-rate" (gdouble): bytes per second spent reading
+   * * "pending-bytes" (guint64): bytes waiting to be written
+   * * "avg-write-latency" (guint64): average time in nanoseconds between
+   *   queueing data and it being written
+   * * "max-write-latency" (guint64): maximum of the above
+   *
+   * Since: 1.26
+   */
+  obj_props[PROP_TEMP_STATS] = g_param_spec_boxed ("temp-stats",
+      "Temp file statistics", "Temp file I/O statistics",
+      GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 
   /* set several parent class virtual functions */
@@ -569,6 +629,13 @@ gst_queue2_init (GstQueue2 * queue)
 
   queue->use_bitrate_query = DEFAULT_USE_BITRATE_QUERY;
 
+  queue->temp_write_async = DEFAULT_TEMP_WRITE_ASYNC;
+  queue->temp_write_max_pending = DEFAULT_TEMP_WRITE_MAX_PENDING;
+  queue->spill_fd = -1;
+  g_mutex_init (&queue->spill_lock);
+  g_cond_init (&queue->spill_cond);
+  g_queue_init (&queue->spill_pending);
+
   GST_DEBUG_OBJECT (queue,
       "initialized queue's not_empty & not_full conditions");
 }
@@ -596,6 +663,8 @@ gst_queue2_finalize (GObject * object)
   g_cond_clear (&queue->query_handled);
   g_timer_destroy (queue->in_timer);
   g_timer_destroy (queue->out_timer);
+  g_mutex_clear (&queue->spill_lock);
+  g_cond_clear (&queue->spill_cond);
 
   /* temp_file path cleanup  */
   g_free (queue->temp_template);
@@ -1509,38 +1578,420 @@ gst_queue2_have_data (GstQueue2 * queue, guint64 offset, guint length)
 #define FSEEK_FILE(file,offset)  (fseek (file, offset, SEEK_SET) != 0)
 #endif
 
+/* Writes to the temp file are collected in chunks of up to this size before
+ * the spill thread writes them out */
+#define SPILL_CHUNK_SIZE (1024 * 1024)
+
+#if defined (HAVE_PREAD) && defined (HAVE_PWRITE)
+#define SPILL_ASYNC_SUPPORTED 1
+#endif
+
+typedef struct
+{
+  guint64 offset;               /* offset in the temp file */
+  guint8 *data;
+  gsize size;
+  gsize alloc;
+  gboolean writing;             /* being written by the spill thread */
+  GstClockTime queued;          /* time the first data was queued */
+} GstQueue2Spill;
+
+static void
+gst_queue2_spill_free (GstQueue2Spill * spill)
+{
+  g_free (spill->data);
+  g_free (spill);
+}
+
+/* called with the spill lock */
+static void
+gst_queue2_spill_account_write (GstQueue2 * queue, gsize size,
+    GstClockTime io_time, GstClockTime latency)
+{
+  queue->spill_bytes_written += size;
+  queue->spill_write_time += io_time;
+  queue->spill_n_writes++;
+  queue->spill_latency_total += latency;
+  queue->spill_latency_max = MAX (queue->spill_latency_max, latency);
+}
+
+#ifdef SPILL_ASYNC_SUPPORTED
+static gint
+spill_pwrite_all (gint fd, const guint8 * data, gsize size, guint64 offset)
+{
+  while (size > 0) {
+    gssize res = pwrite (fd, data, size, (off_t) offset);
+
+    if (res < 0) {
+      if (errno == EINTR)
+        continue;
+      return errno;
+    }
+    data += res;
+    size -= res;
+    offset += res;
+  }
+  return 0;
+}
+
+static gpointer
+gst_queue2_spill_thread (gpointer data)
+{
+  GstQueue2 *queue = data;
+
+  g_mutex_lock (&queue->spill_lock);
+  while (TRUE) {
+    GstQueue2Spill *spill;
+    GstClockTime start, end;
+    gint fd, err;
+
+    while (!queue->spill_stopping && g_queue_is_empty (&queue->spill_pending))
+      g_cond_wait (&queue->spill_cond, &queue->spill_lock);
+
+    /* when stopping, all pending chunks are written out first */
+    spill = g_queue_peek_head (&queue->spill_pending);
+    if (spill == NULL)
+      break;
+
+    /* the chunk stays in the pending queue so that readers can still find
+     * its data until it is completely written */
+    spill->writing = TRUE;
+    fd = queue->spill_fd;
+    g_mutex_unlock (&queue->spill_lock);
+
+    start = gst_util_get_timestamp ();
+    err = spill_pwrite_all (fd, spill->data, spill->size, spill->offset);
+    end = gst_util_get_timestamp ();
+
+    g_mutex_lock (&queue->spill_lock);
+    g_queue_pop_head (&queue->spill_pending);
+    queue->spill_pending_bytes -= spill->size;
+    if (err != 0) {
+      GST_WARNING_OBJECT (queue, "failed to write %" G_GSIZE_FORMAT
+          " bytes at offset %" G_GUINT64_FORMAT ": %s", spill->size,
+          spill->offset, g_strerror (err));
+      if (queue->spill_errno == 0)
+        queue->spill_errno = err;
+    } else {
+      gst_queue2_spill_account_write (queue, spill->size, end - start,
+          end - spill->queued);
+    }
+    gst_queue2_spill_free (spill);
+    g_cond_broadcast (&queue->spill_cond);
+  }
+  g_mutex_unlock (&queue->spill_lock);
+
+  return NULL;
+}
+#endif
+
+/* must be called with MUTEX_LOCK after the temp file was (re)opened */
+static void
+gst_queue2_spill_start (GstQueue2 * queue)
+{
+#ifdef SPILL_ASYNC_SUPPORTED
+  GError *err = NULL;
+
+  if (!queue->temp_write_async || queue->spill_thread != NULL
+      || queue->temp_file == NULL)
+    return;
+
+  queue->spill_fd = fileno (queue->temp_file);
+  queue->spill_errno = 0;
+  queue->spill_stopping = FALSE;
+
+#ifdef HAVE_POSIX_FALLOCATE
+  /* reserve the space of the ring buffer so that the writes don't have to
+   * allocate file blocks */
+  if (QUEUE_IS_USING_RING_BUFFER (queue)) {
+    gint res = posix_fallocate (queue->spill_fd, 0,
+        (off_t) queue->ring_buffer_max_size);
+
+    if (res != 0)
+      GST_WARNING_OBJECT (queue, "could not preallocate %" G_GUINT64_FORMAT
+          " bytes: %s", queue->ring_buffer_max_size, g_strerror (res));
+  }
+#endif
+
+  queue->spill_thread = g_thread_try_new ("queue2-spill",
+      gst_queue2_spill_thread, queue, &err);
+  if (queue->spill_thread == NULL) {
+    GST_WARNING_OBJECT (queue, "could not start spill thread, writing "
+        "synchronously: %s", err->message);
+    g_clear_error (&err);
+  }
+#else
+  if (queue->temp_write_async)
+    GST_WARNING_OBJECT (queue, "asynchronous writes are not supported on "
+        "this platform, writing synchronously");
+#endif
+}
+
+/* must be called with MUTEX_LOCK before the temp file is closed or reopened.
+ * Writes out all pending data if @drain, else drops everything not being
+ * written yet. */
+static void
+gst_queue2_spill_stop (GstQueue2 * queue, gboolean drain)
+{
+  if (queue->spill_thread == NULL)
+    return;
+
+  g_mutex_lock (&queue->spill_lock);
+  if (!drain) {
+    GstQueue2Spill *spill;
+
+    while ((spill = g_queue_peek_tail (&queue->spill_pending))
+        && !spill->writing) {
+      g_queue_pop_tail (&queue->spill_pending);
+      queue->spill_pending_bytes -= spill->size;
+      gst_queue2_spill_free (spill);
+    }
+  }
+  queue->spill_stopping = TRUE;
+  g_cond_broadcast (&queue->spill_cond);
+  g_mutex_unlock (&queue->spill_lock);
+
+  g_thread_join (queue->spill_thread);
+  queue->spill_thread = NULL;
+  queue->spill_stopping = FALSE;
+}
+
+/* wakes up gst_queue2_wait_spill_space() after sinkresult was changed */
+static void
+gst_queue2_spill_wakeup (GstQueue2 * queue)
+{
+  g_mutex_lock (&queue->spill_lock);
+  g_cond_broadcast (&queue->spill_cond);
+  g_mutex_unlock (&queue->spill_lock);
+}
+
+/* must be called with MUTEX_LOCK. Limits the memory used when the disk can't
+ * keep up by waiting for pending data to be written. The MUTEX_LOCK is
+ * released while waiting so that the source pad and flushing don't block.
+ * Returns FALSE when flushing. */
+static gboolean
+gst_queue2_wait_spill_space (GstQueue2 * queue)
+{
+  gboolean res = TRUE;
+
+  if (queue->spill_thread == NULL || queue->temp_write_max_pending == 0)
+    return TRUE;
+
+  g_mutex_lock (&queue->spill_lock);
+  while (queue->spill_errno == 0
+      && queue->spill_pending_bytes >= queue->temp_write_max_pending) {
+    if (queue->sinkresult != GST_FLOW_OK) {
+      res = FALSE;
+      break;
+    }
+
+    GST_CAT_LOG_OBJECT (queue_dataflow, queue, "waiting for %"
+        G_GUINT64_FORMAT " pending bytes to be written",
+        queue->spill_pending_bytes);
+
+    /* the spill lock is taken after the MUTEX_LOCK */
+    GST_QUEUE2_MUTEX_UNLOCK (queue);
+    g_cond_wait (&queue->spill_cond, &queue->spill_lock);
+    g_mutex_unlock (&queue->spill_lock);
+    GST_QUEUE2_MUTEX_LOCK (queue);
+    g_mutex_lock (&queue->spill_lock);
+  }
+  g_mutex_unlock (&queue->spill_lock);
+
+  return res;
+}
+
+/* must be called with MUTEX_LOCK. Writes @size bytes of @data at @offset of
+ * the temp file. When writing synchronously the file must already be
+ * positioned at @offset, else the data is copied and the spill thread writes
+ * it, see gst_queue2_wait_spill_space() for limiting the pending data.
+ * Returns FALSE with errno set on errors. */
+static gboolean
+gst_queue2_write_temp_file (GstQueue2 * queue, guint64 offset,
+    const guint8 * data, gsize size)
+{
+  GstQueue2Spill *spill;
+
+  if (queue->spill_thread == NULL) {
+    GstClockTime start, end;
+
+    start = gst_util_get_timestamp ();
+    if (fwrite (data, size, 1, queue->temp_file) != 1)
+      return FALSE;
+    end = gst_util_get_timestamp ();
+
+    g_mutex_lock (&queue->spill_lock);
+    gst_queue2_spill_account_write (queue, size, end - start, end - start);
+    g_mutex_unlock (&queue->spill_lock);
+
+    return TRUE;
+  }
+
+  g_mutex_lock (&queue->spill_lock);
+  if (queue->spill_errno != 0) {
+    gint err = queue->spill_errno;
+
+    g_mutex_unlock (&queue->spill_lock);
+    errno = err;
+    return FALSE;
+  }
+
+  /* append to the last chunk if it continues it */
+  spill = g_queue_peek_tail (&queue->spill_pending);
+  if (spill == NULL || spill->writing || spill->offset + spill->size != offset
+      || spill->size + size > SPILL_CHUNK_SIZE) {
+    spill = g_new0 (GstQueue2Spill, 1);
+    spill->offset = offset;
+    spill->queued = gst_util_get_timestamp ();
+    g_queue_push_tail (&queue->spill_pending, spill);
+  }
+  if (spill->size + size > spill->alloc) {
+    spill->alloc = MAX (spill->size + size, MIN (SPILL_CHUNK_SIZE,
+            spill->alloc * 2));
+    spill->data = g_realloc (spill->data, spill->alloc);
+  }
+  memcpy (spill->data + spill->size, data, size);
+  spill->size += size;
+  queue->spill_pending_bytes += size;
+
+  g_cond_broadcast (&queue->spill_cond);
+  g_mutex_unlock (&queue->spill_lock);
+
+  return TRUE;
+}
+
+/* must be called with MUTEX_LOCK. Reads @length bytes at @offset of the temp
+ * file into @dst, including data that is still waiting to be written. When
+ * reading synchronously the file must already be positioned at @offset.
+ * Returns the number of bytes read, or -1 with errno set on errors. */
+static gssize
+gst_queue2_read_temp_file (GstQueue2 * queue, guint64 offset, guint length,
+    guint8 * dst)
+{
+  GstClockTime start;
+  gssize res = 0;
+
+  start = gst_util_get_timestamp ();
+
+  if (queue->spill_thread == NULL) {
+    res = fread (dst, 1, length, queue->temp_file);
+  }
+#ifdef SPILL_ASYNC_SUPPORTED
+  else {
+    GList *l;
+
+    /* Holding the spill lock keeps chunks that are being written in the
+     * pending queue, so everything not found in there is on disk already.
+     * New chunks can't be added as we hold the MUTEX_LOCK. */
+    g_mutex_lock (&queue->spill_lock);
+    while (res < length) {
+      gssize r = pread (queue->spill_fd, dst + res, length - res,
+          (off_t) (offset + res));
+
+      if (r < 0 && errno == EINTR)
+        continue;
+      if (r < 0) {
+        gint err = errno;
+
+        g_mutex_unlock (&queue->spill_lock);
+        errno = err;
+        return -1;
+      }
+      if (r == 0)
+        break;
+      res += r;
+    }
+
+    /* newer data from the pending chunks, in the order it was written */
+    for (l = queue->spill_pending.head; l; l = l->next) {
+      GstQueue2Spill *spill = l->data;
+      guint64 start_pos, end_pos;
+
+      start_pos = MAX (spill->offset, offset);
+      end_pos = MIN (spill->offset + spill->size, offset + length);
+      if (start_pos >= end_pos)
+        continue;
+
+      memcpy (dst + (start_pos - offset),
+          spill->data + (start_pos - spill->offset), end_pos - start_pos);
+      /* the file might not have been extended up to here yet */
+      if (start_pos <= offset + res)
+        res = MAX (res, (gssize) (end_pos - offset));
+    }
+    g_mutex_unlock (&queue->spill_lock);
+  }
+#endif
+
+  g_mutex_lock (&queue->spill_lock);
+  queue->spill_bytes_read += res;
+  queue->spill_read_time += gst_util_get_timestamp () - start;
+  g_mutex_unlock (&queue->spill_lock);
+
+  return res;
+}
+
+static GstStructure *
+gst_queue2_get_temp_stats (GstQueue2 * queue)
+{
+  GstStructure *s;
+
+  g_mutex_lock (&queue->spill_lock);
+  s = gst_structure_new ("application/x-queue2-temp-stats",
+      "bytes-written", G_TYPE_UINT64, queue->spill_bytes_written,
+      "bytes-read", G_TYPE_UINT64, queue->spill_bytes_read,
+      "write-rate", G_TYPE_DOUBLE, queue->spill_write_time > 0 ?
+      (gdouble) queue->spill_bytes_written * GST_SECOND /
+      queue->spill_write_time : 0.0,
+      "read-rate", G_TYPE_DOUBLE, queue->spill_read_time > 0 ?
+      (gdouble) queue->spill_bytes_read * GST_SECOND /
+      queue->spill_read_time : 0.0,
+      "pending-bytes", G_TYPE_UINT64, queue->spill_pending_bytes,
+      "avg-write-latency", G_TYPE_UINT64, queue->spill_n_writes > 0 ?
+      queue->spill_latency_total / queue->spill_n_writes : 0,
+      "max-write-latency", G_TYPE_UINT64, queue->spill_latency_max, NULL);
+  g_mutex_unlock (&queue->spill_lock);
+
+  return s;
+}
+
 static GstFlowReturn
 gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
     guint8 * dst, gint64 * read_return)
 {
   guint8 *ring_buffer;
-  size_t res;
+  gssize res;
 
   ring_buffer = queue->ring_buffer;
 
-  if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, offset))
+  if (QUEUE_IS_USING_TEMP_FILE (queue) && !queue->spill_thread
+      && FSEEK_FILE (queue->temp_file, offset))
     goto seek_failed;
 
   /* this should not block */
   GST_LOG_OBJECT (queue, "Reading %d bytes from offset %" G_GUINT64_FORMAT,
       length, offset);
   if (QUEUE_IS_USING_TEMP_FILE (queue)) {
-    res = fread (dst, 1, length, queue->temp_file);
+    res = gst_queue2_read_temp_file (queue, offset, length, dst);
   } else {
     memcpy (dst, ring_buffer + offset, length);
     res = length;
   }
 
-  GST_LOG_OBJECT (queue, "read %" G_GSIZE_FORMAT " bytes", res);
+  GST_LOG_OBJECT (queue, "read %" G_GSSIZE_FORMAT " bytes", res);
 
-  if (G_UNLIKELY (res < length)) {
-    if (!QUEUE_IS_USING_TEMP_FILE (queue))
-      goto could_not_read;
-    /* check for errors or EOF */
-    if (ferror (queue->temp_file))
+  if (G_UNLIKELY (res < (gssize) length)) {
+    if (!QUEUE_IS_USING_TEMP_FILE (queue) || res < 0)
       goto could_not_read;
-    if (feof (queue->temp_file) && length > 0)
-      goto eos;
+    if (queue->spill_thread) {
+      if (length > 0)
+        goto eos;
+    } else {
+      /* check for errors or EOF */
+      if (ferror (queue->temp_file))
+        goto could_not_read;
+      if (feof (queue->temp_file) && length > 0)
+        goto eos;
+    }
   }
 
   *read_return = res;
@@ -1833,6 +2284,8 @@ gst_queue2_open_temp_location_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "opened temp file %s", queue->temp_template);
 
+  gst_queue2_spill_start (queue);
+
   return TRUE;
 
   /* ERRORS */
@@ -1875,6 +2328,9 @@ gst_queue2_close_temp_location_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "closing temp file");
 
+  /* a file that is kept around must contain everything */
+  gst_queue2_spill_stop (queue, !queue->temp_remove);
+
   fflush (queue->temp_file);
   fclose (queue->temp_file);
 
@@ -1897,7 +2353,12 @@ gst_queue2_flush_temp_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "flushing temp file");
 
+  gst_queue2_spill_stop (queue, FALSE);
+
   queue->temp_file = g_freopen (queue->temp_location, "wb+", queue->temp_file);
+
+  if (queue->temp_file)
+    gst_queue2_spill_start (queue);
 }
 
 static void
@@ -2015,6 +2476,10 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
   while (size > 0) {
     guint to_write;
 
+    if (QUEUE_IS_USING_TEMP_FILE (queue)
+        && !gst_queue2_wait_spill_space (queue))
+      goto out_flushing;
+
     if (QUEUE_IS_USING_RING_BUFFER (queue)) {
       gint64 space;
 
@@ -2135,7 +2600,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       new_writing_pos = writing_pos + to_write;
     }
 
-    if (QUEUE_IS_USING_TEMP_FILE (queue)
+    if (QUEUE_IS_USING_TEMP_FILE (queue) && !queue->spill_thread
         && FSEEK_FILE (queue->temp_file, writing_pos))
       goto seek_failed;
 
@@ -2146,7 +2611,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
           queue->current->writing_pos, queue->current->rb_writing_pos);
       /* either not using ring buffer or no wrapping, just write */
       if (QUEUE_IS_USING_TEMP_FILE (queue)) {
-        if (fwrite (data, to_write, 1, queue->temp_file) != 1)
+        if (!gst_queue2_write_temp_file (queue, writing_pos, data, to_write))
           goto handle_error;
       } else {
         memcpy (ring_buffer + writing_pos, data, to_write);
@@ -2191,20 +2656,23 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
         GST_INFO_OBJECT (queue, "writing %u bytes", block_one);
         /* write data to end of ring buffer */
         if (QUEUE_IS_USING_TEMP_FILE (queue)) {
-          if (fwrite (data, block_one, 1, queue->temp_file) != 1)
+          if (!gst_queue2_write_temp_file (queue, writing_pos, data,
+                  block_one))
             goto handle_error;
         } else {
           memcpy (ring_buffer + writing_pos, data, block_one);
         }
       }
 
-      if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, 0))
+      if (QUEUE_IS_USING_TEMP_FILE (queue) && !queue->spill_thread
+          && FSEEK_FILE (queue->temp_file, 0))
         goto seek_failed;
 
       if (block_two > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_two);
         if (QUEUE_IS_USING_TEMP_FILE (queue)) {
-          if (fwrite (data + block_one, block_two, 1, queue->temp_file) != 1)
+          if (!gst_queue2_write_temp_file (queue, 0, data + block_one,
+                  block_two))
             goto handle_error;
         } else {
           memcpy (ring_buffer, data + block_one, block_two);
@@ -2598,6 +3066,7 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         /* unblock the loop and chain functions */
         GST_QUEUE2_SIGNAL_ADD (queue);
         GST_QUEUE2_SIGNAL_DEL (queue);
+        gst_queue2_spill_wakeup (queue);
         GST_QUEUE2_MUTEX_UNLOCK (queue);
 
         /* make sure it pauses, this should happen since we sent
@@ -2614,6 +3083,7 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         /* flush the sink pad */
         queue->sinkresult = GST_FLOW_FLUSHING;
         GST_QUEUE2_SIGNAL_DEL (queue);
+        gst_queue2_spill_wakeup (queue);
         queue->last_query = FALSE;
         g_cond_signal (&queue->query_handled);
         GST_QUEUE2_MUTEX_UNLOCK (queue);
@@ -3667,6 +4137,7 @@ gst_queue2_sink_activate_mode (GstPad * pad, GstObject * parent,
         queue->srcresult = GST_FLOW_FLUSHING;
         queue->sinkresult = GST_FLOW_FLUSHING;
         GST_QUEUE2_SIGNAL_DEL (queue);
+        gst_queue2_spill_wakeup (queue);
         GST_QUEUE2_MUTEX_UNLOCK (queue);
 
         /* wait until it is unblocked and clean up */
@@ -3713,6 +4184,7 @@ gst_queue2_src_activate_push (GstPad * pad, GstObject * parent, gboolean active)
     queue->sinkresult = GST_FLOW_FLUSHING;
     /* the item add signal will unblock */
     GST_QUEUE2_SIGNAL_ADD (queue);
+    gst_queue2_spill_wakeup (queue);
     GST_QUEUE2_MUTEX_UNLOCK (queue);
 
     /* step 2, make sure streaming finishes */
@@ -3771,6 +4243,7 @@ gst_queue2_src_activate_pull (GstPad * pad, GstObject * parent, gboolean active)
     queue->sinkresult = GST_FLOW_FLUSHING;
     /* this will unlock getrange */
     GST_QUEUE2_SIGNAL_ADD (queue);
+    gst_queue2_spill_wakeup (queue);
     result = TRUE;
     GST_QUEUE2_MUTEX_UNLOCK (queue);
   }
@@ -3999,6 +4472,15 @@ gst_queue2_set_property (GObject * object,
     case PROP_USE_BITRATE_QUERY:
       queue->use_bitrate_query = g_value_get_boolean (value);
       break;
+    case PROP_TEMP_WRITE_ASYNC:
+      queue->temp_write_async = g_value_get_boolean (value);
+      break;
+    case PROP_TEMP_WRITE_MAX_PENDING:
+      g_mutex_lock (&queue->spill_lock);
+      queue->temp_write_max_pending = g_value_get_uint (value);
+      g_cond_broadcast (&queue->spill_cond);
+      g_mutex_unlock (&queue->spill_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -4100,6 +4582,15 @@ gst_queue2_get_property (GObject * object,
       g_value_set_uint64 (value, (guint64) bitrate);
       break;
     }
+    case PROP_TEMP_WRITE_ASYNC:
+      g_value_set_boolean (value, queue->temp_write_async);
+      break;
+    case PROP_TEMP_WRITE_MAX_PENDING:
+      g_value_set_uint (value, queue->temp_write_max_pending);
+      break;
+    case PROP_TEMP_STATS:
+      g_value_take_boxed (value, gst_queue2_get_temp_stats (queue));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
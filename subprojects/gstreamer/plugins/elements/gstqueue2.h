@@ -165,6 +165,27 @@ struct _GstQueue2
   guint64 ring_buffer_max_size;
   guint8 * ring_buffer;
 
+  /* writing the temp file from a separate thread */
+  gboolean temp_write_async;
+  guint temp_write_max_pending;
+  GThread *spill_thread;
+  GMutex spill_lock;            /* protects all spill fields below */
+  GCond spill_cond;
+  gint spill_fd;
+  GQueue spill_pending;         /* chunks waiting to be written, in order */
+  guint64 spill_pending_bytes;
+  gboolean spill_stopping;
+  gint spill_errno;             /* errno of the first failed write */
+
+  /* temp file statistics */
+  guint64 spill_bytes_written;
+  guint64 spill_bytes_read;
+  GstClockTime spill_write_time;
+  GstClockTime spill_read_time;
+  guint64 spill_n_writes;
+  GstClockTime spill_latency_total;
+  GstClockTime spill_latency_max;
+
   gint downstream_may_block;
 
   GstBufferingMode mode;
@@ -35,6 +35,13 @@
  * provide separate threads for each branch. Otherwise a blocked dataflow in one
  * branch would stall the other branches.
  *
+ * Alternatively #GstTee:async-branches can be enabled, in which case every src
+ * pad queues references to the incoming buffers and pushes them from its own
+ * thread. How many buffers a pad queues and what happens when it is full is
+ * configured per pad with the #GstTeePad:max-size-buffers and
+ * #GstTeePad:leaky properties, and #GstTeePad:stats reports how many buffers
+ * were pushed and dropped on the branch and how long they were queued.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! tee name=t ! queue ! audioconvert ! audioresample ! autoaudiosink t. ! queue ! audioconvert ! goom ! videoconvert ! autovideosink
@@ -82,12 +89,36 @@ gst_tee_pull_mode_get_type (void)
   return type;
 }
 
+#define GST_TYPE_TEE_BRANCH_LEAKY (gst_tee_branch_leaky_get_type())
+static GType
+gst_tee_branch_leaky_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue data[] = {
+    {GST_TEE_BRANCH_NO_LEAK, "Not Leaky", "no"},
+    {GST_TEE_BRANCH_LEAK_UPSTREAM, "Leaky on upstream (new buffers)",
+        "upstream"},
+    {GST_TEE_BRANCH_LEAK_DOWNSTREAM, "Leaky on downstream (old buffers)",
+        "downstream"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstTeeBranchLeaky", data);
+  }
+  return type;
+}
+
 #define DEFAULT_PROP_NUM_SRC_PADS	0
 #define DEFAULT_PROP_HAS_CHAIN		TRUE
 #define DEFAULT_PROP_SILENT		TRUE
 #define DEFAULT_PROP_LAST_MESSAGE	NULL
 #define DEFAULT_PULL_MODE		GST_TEE_PULL_MODE_NEVER
 #define DEFAULT_PROP_ALLOW_NOT_LINKED	FALSE
+#define DEFAULT_PROP_ASYNC_BRANCHES	FALSE
+
+#define DEFAULT_PAD_MAX_SIZE_BUFFERS	200
+#define DEFAULT_PAD_LEAKY		GST_TEE_BRANCH_NO_LEAK
 
 enum
 {
@@ -99,6 +130,15 @@ enum
   PROP_PULL_MODE,
   PROP_ALLOC_PAD,
   PROP_ALLOW_NOT_LINKED,
+  PROP_ASYNC_BRANCHES,
+};
+
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_MAX_SIZE_BUFFERS,
+  PROP_PAD_LEAKY,
+  PROP_PAD_STATS,
 };
 
 static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
@@ -141,6 +181,24 @@ struct _GstTeePad
   gboolean pushed;
   GstFlowReturn result;
   gboolean removed;
+
+  /* async-branches mode, TRUE while the pad task is pushing the items */
+  gint async;
+
+  GMutex lock;                  /* protects all fields below */
+  GCond cond;
+  GstVecDeque *items;           /* GstTeeItem, buffers, lists and events */
+  guint n_buffers;              /* buffers and lists in items */
+  guint max_size_buffers;
+  GstTeeBranchLeaky leaky;
+  gboolean flushing;
+  gboolean busy;                /* pushing an item */
+  GstFlowReturn srcresult;
+
+  guint64 n_pushed;
+  guint64 n_dropped;
+  GstClockTime latency_total;
+  GstClockTime latency_max;
 };
 
 struct _GstTeePadClass
@@ -148,11 +206,74 @@ struct _GstTeePadClass
   GstPadClass parent;
 };
 
+typedef struct
+{
+  GstMiniObject *item;
+  GstClockTime queued;          /* time the item was queued */
+} GstTeeItem;
+
 G_DEFINE_TYPE (GstTeePad, gst_tee_pad, GST_TYPE_PAD);
 
+static void gst_tee_pad_finalize (GObject * object);
+static void gst_tee_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_tee_pad_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
 static void
 gst_tee_pad_class_init (GstTeePadClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_tee_pad_finalize;
+  gobject_class->set_property = gst_tee_pad_set_property;
+  gobject_class->get_property = gst_tee_pad_get_property;
+
+  /**
+   * GstTeePad:max-size-buffers:
+   *
+   * The maximum number of buffers and buffer lists queued on this pad when
+   * #GstTee:async-branches is enabled.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_PAD_MAX_SIZE_BUFFERS,
+      g_param_spec_uint ("max-size-buffers", "Max. size (buffers)",
+          "Max. number of buffers queued on the branch", 1, G_MAXUINT,
+          DEFAULT_PAD_MAX_SIZE_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTeePad:leaky:
+   *
+   * What to do with new buffers when #GstTee:async-branches is enabled and
+   * this pad is full.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_PAD_LEAKY,
+      g_param_spec_enum ("leaky", "Leaky",
+          "Where the branch leaks, if at all", GST_TYPE_TEE_BRANCH_LEAKY,
+          DEFAULT_PAD_LEAKY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTeePad:stats:
+   *
+   * Statistics of the branch when #GstTee:async-branches is enabled, as a
+   * structure named "application/x-tee-pad-stats" with the fields:
+   *
+   * * "queued" (guint): buffers currently queued
+   * * "pushed" (guint64): buffers pushed downstream
+   * * "dropped" (guint64): buffers dropped because the branch was full
+   * * "avg-latency" (guint64): average time in nanoseconds the buffers were
+   *   queued
+   * * "max-latency" (guint64): maximum of the above
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_PAD_STATS,
+      g_param_spec_boxed ("stats", "Statistics", "Branch statistics",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -167,6 +288,310 @@ static void
 gst_tee_pad_init (GstTeePad * pad)
 {
   gst_tee_pad_reset (pad);
+
+  g_mutex_init (&pad->lock);
+  g_cond_init (&pad->cond);
+  pad->items = gst_vec_deque_new_for_struct (sizeof (GstTeeItem), 16);
+  pad->max_size_buffers = DEFAULT_PAD_MAX_SIZE_BUFFERS;
+  pad->leaky = DEFAULT_PAD_LEAKY;
+  pad->flushing = TRUE;
+  pad->srcresult = GST_FLOW_FLUSHING;
+}
+
+/* with the pad lock */
+static void
+gst_tee_pad_clear_items (GstTeePad * pad)
+{
+  GstTeeItem *titem;
+
+  while ((titem = gst_vec_deque_pop_head_struct (pad->items))) {
+    GstMiniObject *item = titem->item;
+
+    /* keep the sticky events so that they get pushed again after the flush,
+     * like queue does */
+    if (GST_IS_EVENT (item) && GST_EVENT_IS_STICKY (item)
+        && GST_EVENT_TYPE (item) != GST_EVENT_SEGMENT
+        && GST_EVENT_TYPE (item) != GST_EVENT_EOS)
+      gst_pad_store_sticky_event (GST_PAD_CAST (pad), GST_EVENT_CAST (item));
+    gst_mini_object_unref (item);
+  }
+  pad->n_buffers = 0;
+  g_cond_broadcast (&pad->cond);
+}
+
+static void
+gst_tee_pad_finalize (GObject * object)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+  GstTeeItem *titem;
+
+  while ((titem = gst_vec_deque_pop_head_struct (pad->items)))
+    gst_mini_object_unref (titem->item);
+  gst_vec_deque_free (pad->items);
+  g_mutex_clear (&pad->lock);
+  g_cond_clear (&pad->cond);
+
+  G_OBJECT_CLASS (gst_tee_pad_parent_class)->finalize (object);
+}
+
+static void
+gst_tee_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  g_mutex_lock (&pad->lock);
+  switch (prop_id) {
+    case PROP_PAD_MAX_SIZE_BUFFERS:
+      pad->max_size_buffers = g_value_get_uint (value);
+      g_cond_broadcast (&pad->cond);
+      break;
+    case PROP_PAD_LEAKY:
+      pad->leaky = (GstTeeBranchLeaky) g_value_get_enum (value);
+      g_cond_broadcast (&pad->cond);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  g_mutex_unlock (&pad->lock);
+}
+
+static void
+gst_tee_pad_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  g_mutex_lock (&pad->lock);
+  switch (prop_id) {
+    case PROP_PAD_MAX_SIZE_BUFFERS:
+      g_value_set_uint (value, pad->max_size_buffers);
+      break;
+    case PROP_PAD_LEAKY:
+      g_value_set_enum (value, pad->leaky);
+      break;
+    case PROP_PAD_STATS:
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-tee-pad-stats",
+              "queued", G_TYPE_UINT, pad->n_buffers,
+              "pushed", G_TYPE_UINT64, pad->n_pushed,
+              "dropped", G_TYPE_UINT64, pad->n_dropped,
+              "avg-latency", G_TYPE_UINT64, pad->n_pushed > 0 ?
+              pad->latency_total / pad->n_pushed : 0,
+              "max-latency", G_TYPE_UINT64, pad->latency_max, NULL));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  g_mutex_unlock (&pad->lock);
+}
+
+/* with the pad lock, drops the oldest queued buffer or list */
+static void
+gst_tee_pad_drop_oldest (GstTeePad * pad)
+{
+  gsize i, len;
+
+  len = gst_vec_deque_get_length (pad->items);
+  for (i = 0; i < len; i++) {
+    GstTeeItem *titem = gst_vec_deque_peek_nth_struct (pad->items, i);
+
+    /* events are never dropped */
+    if (!GST_IS_EVENT (titem->item)) {
+      GstTeeItem dropped;
+
+      gst_vec_deque_drop_struct (pad->items, i, &dropped);
+      GST_LOG_OBJECT (pad, "dropping old %" GST_PTR_FORMAT, dropped.item);
+      gst_mini_object_unref (dropped.item);
+      pad->n_buffers--;
+      pad->n_dropped++;
+      return;
+    }
+  }
+}
+
+/* Queues @item on @pad for its task to push, takes ownership of @item.
+ * Returns the result of the last push on the pad. */
+static GstFlowReturn
+gst_tee_pad_enqueue (GstTeePad * pad, GstMiniObject * item)
+{
+  GstTeeItem titem;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&pad->lock);
+  if (pad->flushing)
+    goto flushing;
+
+  if (GST_IS_EVENT (item)) {
+    /* a new stream can be pushed after EOS */
+    if (pad->srcresult == GST_FLOW_EOS
+        && (GST_EVENT_TYPE (item) == GST_EVENT_STREAM_START
+            || GST_EVENT_TYPE (item) == GST_EVENT_SEGMENT))
+      pad->srcresult = GST_FLOW_OK;
+  } else {
+    if (pad->srcresult != GST_FLOW_OK && pad->srcresult != GST_FLOW_NOT_LINKED)
+      goto out_result;
+
+    while (pad->n_buffers >= pad->max_size_buffers) {
+      if (pad->leaky == GST_TEE_BRANCH_LEAK_UPSTREAM) {
+        GST_LOG_OBJECT (pad, "branch full, dropping %" GST_PTR_FORMAT, item);
+        pad->n_dropped++;
+        gst_mini_object_unref (item);
+        ret = pad->srcresult;
+        g_mutex_unlock (&pad->lock);
+        return ret;
+      }
+
+      if (pad->leaky == GST_TEE_BRANCH_LEAK_DOWNSTREAM) {
+        gst_tee_pad_drop_oldest (pad);
+        continue;
+      }
+
+      GST_LOG_OBJECT (pad, "branch full, waiting");
+      g_cond_wait (&pad->cond, &pad->lock);
+      if (pad->flushing)
+        goto flushing;
+    }
+    pad->n_buffers++;
+  }
+
+  titem.item = item;
+  titem.queued = gst_util_get_timestamp ();
+  gst_vec_deque_push_tail_struct (pad->items, &titem);
+  g_cond_broadcast (&pad->cond);
+
+  ret = pad->srcresult;
+  g_mutex_unlock (&pad->lock);
+
+  return ret;
+
+flushing:
+  {
+    GST_LOG_OBJECT (pad, "pad is flushing");
+    g_mutex_unlock (&pad->lock);
+    gst_mini_object_unref (item);
+    return GST_FLOW_FLUSHING;
+  }
+out_result:
+  {
+    ret = pad->srcresult;
+    GST_LOG_OBJECT (pad, "branch returned %s, dropping %"
+        GST_PTR_FORMAT, gst_flow_get_name (ret), item);
+    g_mutex_unlock (&pad->lock);
+    gst_mini_object_unref (item);
+    return ret;
+  }
+}
+
+static void
+gst_tee_pad_loop (GstTeePad * pad)
+{
+  GstTeeItem titem;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&pad->lock);
+  while (!pad->flushing && gst_vec_deque_is_empty (pad->items))
+    g_cond_wait (&pad->cond, &pad->lock);
+
+  if (pad->flushing)
+    goto out_flushing;
+
+  titem = *(GstTeeItem *) gst_vec_deque_pop_head_struct (pad->items);
+  if (!GST_IS_EVENT (titem.item)) {
+    GstClockTime latency = gst_util_get_timestamp () - titem.queued;
+
+    pad->n_buffers--;
+    pad->n_pushed++;
+    pad->latency_total += latency;
+    pad->latency_max = MAX (pad->latency_max, latency);
+  }
+  pad->busy = TRUE;
+  g_cond_broadcast (&pad->cond);
+  g_mutex_unlock (&pad->lock);
+
+  if (GST_IS_EVENT (titem.item)) {
+    gst_pad_push_event (GST_PAD_CAST (pad), GST_EVENT_CAST (titem.item));
+    ret = GST_FLOW_OK;
+  } else if (GST_IS_BUFFER_LIST (titem.item)) {
+    ret = gst_pad_push_list (GST_PAD_CAST (pad),
+        GST_BUFFER_LIST_CAST (titem.item));
+  } else {
+    ret = gst_pad_push (GST_PAD_CAST (pad), GST_BUFFER_CAST (titem.item));
+  }
+
+  g_mutex_lock (&pad->lock);
+  pad->busy = FALSE;
+  g_cond_broadcast (&pad->cond);
+  if (pad->flushing)
+    goto out_flushing;
+
+  if (ret == GST_FLOW_OK || ret == GST_FLOW_NOT_LINKED) {
+    if (!GST_IS_EVENT (titem.item))
+      pad->srcresult = ret;
+    g_mutex_unlock (&pad->lock);
+    return;
+  }
+
+  /* the branch does not accept data anymore, upstream gets the result with
+   * the next buffer */
+  GST_DEBUG_OBJECT (pad, "push failed: %s",
+      gst_flow_get_name (ret));
+  pad->srcresult = ret;
+  gst_tee_pad_clear_items (pad);
+  g_mutex_unlock (&pad->lock);
+
+  if (ret == GST_FLOW_NOT_NEGOTIATED || ret < GST_FLOW_EOS) {
+    GstObject *parent = gst_pad_get_parent (GST_PAD_CAST (pad));
+
+    if (parent) {
+      GST_ELEMENT_FLOW_ERROR (parent, ret);
+      gst_object_unref (parent);
+    }
+  }
+  return;
+
+out_flushing:
+  {
+    GST_LOG_OBJECT (pad, "pausing task, flushing");
+    g_mutex_unlock (&pad->lock);
+    gst_pad_pause_task (GST_PAD_CAST (pad));
+  }
+}
+
+static gboolean
+gst_tee_pad_start (GstTeePad * pad)
+{
+  g_mutex_lock (&pad->lock);
+  pad->flushing = FALSE;
+  pad->srcresult = GST_FLOW_OK;
+  g_mutex_unlock (&pad->lock);
+
+  return gst_pad_start_task (GST_PAD_CAST (pad),
+      (GstTaskFunction) gst_tee_pad_loop, pad, NULL);
+}
+
+/* wakes up the task and the streaming thread and drops the queued items */
+static void
+gst_tee_pad_set_flushing (GstTeePad * pad)
+{
+  g_mutex_lock (&pad->lock);
+  pad->flushing = TRUE;
+  pad->srcresult = GST_FLOW_FLUSHING;
+  gst_tee_pad_clear_items (pad);
+  g_mutex_unlock (&pad->lock);
+}
+
+/* waits until the task pushed all queued items */
+static void
+gst_tee_pad_wait_empty (GstTeePad * pad)
+{
+  g_mutex_lock (&pad->lock);
+  while (!pad->flushing && (pad->busy
+          || !gst_vec_deque_is_empty (pad->items)))
+    g_cond_wait (&pad->cond, &pad->lock);
+  g_mutex_unlock (&pad->lock);
 }
 
 static GstPad *gst_tee_request_new_pad (GstElement * element,
@@ -288,6 +713,25 @@ gst_tee_class_init (GstTeeClass * klass)
           "all unlinked", DEFAULT_PROP_ALLOW_NOT_LINKED,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTee:async-branches
+   *
+   * Push on every src pad from a separate thread. Each pad queues references
+   * to the incoming buffers, so that a slow branch does not delay the other
+   * branches, without the need for a queue element in every branch.
+   *
+   * The queueing behaviour is configured per pad with the
+   * #GstTeePad:max-size-buffers and #GstTeePad:leaky properties. Changes only
+   * take effect when the src pads are activated.
+   *
+   * Since: 1.26
+   */
+  g_object_class_install_property (gobject_class, PROP_ASYNC_BRANCHES,
+      g_param_spec_boolean ("async-branches", "Async branches",
+          "Push on every src pad from a separate thread",
+          DEFAULT_PROP_ASYNC_BRANCHES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Tee pipe fitting",
       "Generic",
@@ -301,6 +745,8 @@ gst_tee_class_init (GstTeeClass * klass)
   gstelement_class->release_pad = GST_DEBUG_FUNCPTR (gst_tee_release_pad);
 
   gst_type_mark_as_plugin_api (GST_TYPE_TEE_PULL_MODE, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_TEE_BRANCH_LEAKY, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_TEE_PAD, 0);
 }
 
 static void
@@ -396,6 +842,9 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
 
   GST_OBJECT_UNLOCK (tee);
 
+  gst_pad_set_activatemode_function (srcpad,
+      GST_DEBUG_FUNCPTR (gst_tee_src_activate_mode));
+
   switch (mode) {
     case GST_PAD_MODE_PULL:
       /* we already have a src pad in pull mode, and our pull mode can only be
@@ -411,8 +860,6 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
   if (!res)
     goto activate_failed;
 
-  gst_pad_set_activatemode_function (srcpad,
-      GST_DEBUG_FUNCPTR (gst_tee_src_activate_mode));
   gst_pad_set_query_function (srcpad, GST_DEBUG_FUNCPTR (gst_tee_src_query));
   gst_pad_set_getrange_function (srcpad,
       GST_DEBUG_FUNCPTR (gst_tee_src_get_range));
@@ -508,6 +955,9 @@ gst_tee_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       tee->allow_not_linked = g_value_get_boolean (value);
       break;
+    case PROP_ASYNC_BRANCHES:
+      tee->async_branches = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -544,6 +994,9 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       g_value_set_boolean (value, tee->allow_not_linked);
       break;
+    case PROP_ASYNC_BRANCHES:
+      g_value_set_boolean (value, tee->async_branches);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -551,15 +1004,116 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
   GST_OBJECT_UNLOCK (tee);
 }
 
+typedef struct
+{
+  GstEvent *event;
+  gboolean result;
+  gboolean dispatched;
+} EventData;
+
+static gboolean
+gst_tee_forward_event (GstPad * srcpad, EventData * data)
+{
+  GstTeePad *tpad = GST_TEE_PAD_CAST (srcpad);
+  GstEvent *event = gst_event_ref (data->event);
+
+  /* serialized events are queued to keep them in order with the buffers */
+  if (g_atomic_int_get (&tpad->async) && GST_EVENT_IS_SERIALIZED (event)) {
+    data->result |= gst_tee_pad_enqueue (tpad,
+        GST_MINI_OBJECT_CAST (event)) != GST_FLOW_FLUSHING;
+  } else {
+    data->result |= gst_pad_push_event (srcpad, event);
+  }
+  data->dispatched = TRUE;
+
+  return FALSE;
+}
+
+static void
+gst_tee_foreach_async_pad (GstTee * tee, void (*func) (GstTeePad * pad))
+{
+  GstIterator *iter;
+  GValue item = G_VALUE_INIT;
+  gboolean done = FALSE;
+
+  iter = gst_element_iterate_src_pads (GST_ELEMENT_CAST (tee));
+  while (!done) {
+    switch (gst_iterator_next (iter, &item)) {
+      case GST_ITERATOR_OK:{
+        GstTeePad *pad = g_value_get_object (&item);
+
+        if (g_atomic_int_get (&pad->async))
+          func (pad);
+        g_value_reset (&item);
+        break;
+      }
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync (iter);
+        break;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+  g_value_unset (&item);
+  gst_iterator_free (iter);
+}
+
+static void
+gst_tee_pad_flush_start (GstTeePad * pad)
+{
+  gst_tee_pad_set_flushing (pad);
+  gst_pad_pause_task (GST_PAD_CAST (pad));
+}
+
+static void
+gst_tee_pad_flush_stop (GstTeePad * pad)
+{
+  g_mutex_lock (&pad->lock);
+  gst_tee_pad_clear_items (pad);
+  g_mutex_unlock (&pad->lock);
+  gst_tee_pad_start (pad);
+}
+
 static gboolean
 gst_tee_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
-  gboolean res;
+  GstTee *tee = GST_TEE_CAST (parent);
+  gboolean res, async_branches;
+
+  GST_OBJECT_LOCK (tee);
+  async_branches = tee->async_branches;
+  GST_OBJECT_UNLOCK (tee);
+
+  if (!async_branches)
+    return gst_pad_event_default (pad, parent, event);
 
   switch (GST_EVENT_TYPE (event)) {
-    default:
+    case GST_EVENT_FLUSH_START:
+      /* unblocks the branches, after which the tasks can be paused */
       res = gst_pad_event_default (pad, parent, event);
+      gst_tee_foreach_async_pad (tee, gst_tee_pad_flush_start);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      /* the tasks are paused, so this can be pushed directly */
+      res = gst_pad_event_default (pad, parent, event);
+      gst_tee_foreach_async_pad (tee, gst_tee_pad_flush_stop);
+      break;
+    default:
+    {
+      EventData data;
+
+      data.event = event;
+      data.dispatched = FALSE;
+      data.result = FALSE;
+
+      gst_pad_forward (pad, (GstPadForwardFunction) gst_tee_forward_event,
+          &data);
+
+      res = data.dispatched ? data.result : TRUE;
+      gst_event_unref (event);
       break;
+    }
   }
 
   return res;
@@ -652,19 +1206,35 @@ gst_tee_query_allocation (const GValue * item, GValue * ret, gpointer user_data)
    * about the maximum, as this is a parameter of the downstream provided
    * pool. We only read the first allocation pool as the minimum number of
    * buffers is normally constant regardless of the pool being used. */
+  size = min = 0;
   if (gst_query_get_n_allocation_pools (query) > 0) {
     gst_query_parse_nth_allocation_pool (query, 0, NULL, &size, &min, NULL);
 
     GST_DEBUG_OBJECT (ctx->tee,
         "Aggregating allocation pool size=%u min_buffers=%u", size, min);
+  }
+
+  /* In async-branches mode the branch keeps up to max-size-buffers buffers
+   * queued on top of what downstream holds on to */
+  if (g_atomic_int_get (&GST_TEE_PAD_CAST (src_pad)->async)) {
+    GstTeePad *tpad = GST_TEE_PAD_CAST (src_pad);
+    guint depth;
 
-    if (ctx->size < size)
-      ctx->size = size;
+    g_mutex_lock (&tpad->lock);
+    depth = tpad->max_size_buffers;
+    g_mutex_unlock (&tpad->lock);
 
-    if (ctx->min_buffers < min)
-      ctx->min_buffers = min;
+    GST_DEBUG_OBJECT (ctx->tee, "Branch %s:%s queues up to %u buffers",
+        GST_DEBUG_PAD_NAME (src_pad), depth);
+    min += depth;
   }
 
+  if (ctx->size < size)
+    ctx->size = size;
+
+  if (ctx->min_buffers < min)
+    ctx->min_buffers = min;
+
   /* Allocation Meta:
    * For allocation meta, we'll need to aggregate the argument using the new
    * GstMetaInfo::agggregate_func */
@@ -746,6 +1316,10 @@ gst_tee_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
       GValue ret = G_VALUE_INIT;
       struct AllocQueryCtx ctx = { tee, query, };
 
+      /* the queued buffers were allocated for the old caps, let the branches
+       * push them before asking downstream about the new ones */
+      gst_tee_foreach_async_pad (tee, gst_tee_pad_wait_empty);
+
       g_value_init (&ret, G_TYPE_BOOLEAN);
       g_value_set_boolean (&ret, TRUE);
 
@@ -813,6 +1387,9 @@ gst_tee_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
       break;
     }
     default:
+      /* let the branches handle the queued data first */
+      if (GST_QUERY_IS_SERIALIZED (query))
+        gst_tee_foreach_async_pad (tee, gst_tee_pad_wait_empty);
       res = gst_pad_query_default (pad, parent, query);
       break;
   }
@@ -848,6 +1425,9 @@ gst_tee_do_push (GstTee * tee, GstPad * pad, gpointer data, gboolean is_list)
   if (pad == tee->pull_pad) {
     /* don't push on the pad we're pulling from */
     res = GST_FLOW_OK;
+  } else if (g_atomic_int_get (&GST_TEE_PAD_CAST (pad)->async)) {
+    res = gst_tee_pad_enqueue (GST_TEE_PAD_CAST (pad),
+        gst_mini_object_ref (GST_MINI_OBJECT_CAST (data)));
   } else if (is_list) {
     res =
         gst_pad_push_list (pad,
@@ -893,6 +1473,9 @@ gst_tee_handle_data (GstTee * tee, gpointer data, gboolean is_list)
 
     if (pad == tee->pull_pad) {
       ret = GST_FLOW_OK;
+    } else if (g_atomic_int_get (&GST_TEE_PAD_CAST (pad)->async)) {
+      ret = gst_tee_pad_enqueue (GST_TEE_PAD_CAST (pad),
+          GST_MINI_OBJECT_CAST (data));
     } else if (is_list) {
       ret = gst_pad_push_list (pad, GST_BUFFER_LIST_CAST (data));
     } else {
@@ -1127,6 +1710,26 @@ gst_tee_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
       GST_OBJECT_UNLOCK (tee);
       break;
     }
+    case GST_PAD_MODE_PUSH:
+    {
+      GstTeePad *tpad = GST_TEE_PAD_CAST (pad);
+      gboolean async_branches;
+
+      GST_OBJECT_LOCK (tee);
+      async_branches = tee->async_branches;
+      GST_OBJECT_UNLOCK (tee);
+
+      res = TRUE;
+      if (active && async_branches) {
+        g_atomic_int_set (&tpad->async, TRUE);
+        res = gst_tee_pad_start (tpad);
+      } else if (!active && g_atomic_int_get (&tpad->async)) {
+        gst_tee_pad_set_flushing (tpad);
+        res = gst_pad_stop_task (pad);
+        g_atomic_int_set (&tpad->async, FALSE);
+      }
+      break;
+    }
     default:
       res = TRUE;
       break;
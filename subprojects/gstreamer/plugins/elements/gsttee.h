@@ -57,6 +57,24 @@ typedef enum {
   GST_TEE_PULL_MODE_SINGLE,
 } GstTeePullMode;
 
+/**
+ * GstTeeBranchLeaky:
+ * @GST_TEE_BRANCH_NO_LEAK: Block upstream when the branch is full.
+ * @GST_TEE_BRANCH_LEAK_UPSTREAM: Drop the new buffer when the branch is full.
+ * @GST_TEE_BRANCH_LEAK_DOWNSTREAM: Drop the oldest queued buffer when the
+ *   branch is full.
+ *
+ * What a src pad does with new buffers when #GstTee:async-branches is
+ * enabled and the pad already queues #GstTeePad:max-size-buffers buffers.
+ *
+ * Since: 1.26
+ */
+typedef enum {
+  GST_TEE_BRANCH_NO_LEAK,
+  GST_TEE_BRANCH_LEAK_UPSTREAM,
+  GST_TEE_BRANCH_LEAK_DOWNSTREAM,
+} GstTeeBranchLeaky;
+
 /**
  * GstTee:
  *
@@ -81,6 +99,7 @@ struct _GstTee {
   GstPad         *pull_pad;
 
   gboolean        allow_not_linked;
+  gboolean        async_branches;
 };
 
 struct _GstTeeClass {
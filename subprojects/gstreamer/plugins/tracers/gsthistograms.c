@@ -0,0 +1,854 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gsthistograms.c: tracing module keeping per pad histograms
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-histograms
+ * @short_description: keep per pad histograms of the dataflow
+ *
+ * A tracing module that keeps histograms for every source pad that pushes
+ * buffers, instead of logging every event like the stats tracer does:
+ *
+ * - push-duration: time spent in gst_pad_push(), i.e. in the chain function
+ *   of the peer and everything it does synchronously (ns)
+ * - gap: time between two pushes on the pad (ns)
+ * - buffer-size: size of the pushed buffers (bytes)
+ * - queue-residency: for source pads of queue, queue2 and multiqueue, the
+ *   time a buffer spent in the element (ns)
+ *
+ * The histograms use log-linear buckets with 8 sub-buckets per power of two,
+ * so the reported percentiles are within 12.5% of the real value and the
+ * memory used per pad is fixed. The number of tracked pads is limited by the
+ * 'max-pads' parameter.
+ *
+ * When the caps cache is enabled with the GST_CAPS_CACHE environment variable,
+ * the number of cache hits and misses is included as well.
+ *
+ * The histograms are written as one JSON object per line to the file given
+ * in the 'file' parameter, or to the debug log of the `histograms` category,
+ * every 'interval' seconds, when the tracer is destroyed, and when the
+ * "dump" action signal is emitted. The "get-json" action signal returns the
+ * current histograms without writing them out.
+ *
+ * ```
+ * GST_TRACERS="histograms(file=/tmp/histograms.json,interval=10)" ./...
+ * ```
+ *
+ * Since: 1.26
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gsthistograms.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <glib/gstdio.h>
+
+GST_DEBUG_CATEGORY_STATIC (gst_histograms_debug);
+#define GST_CAT_DEFAULT gst_histograms_debug
+
+enum
+{
+  /* actions */
+  SIGNAL_GET_JSON,
+  SIGNAL_DUMP,
+
+  LAST_SIGNAL
+};
+
+#define DEFAULT_MAX_PADS 1024
+#define DEFAULT_INTERVAL 0
+
+/* maximum number of buffers remembered per queue element for the residency,
+ * the table is cleared when buffers got dropped without leaving the queue */
+#define MAX_QUEUED_BUFFERS 4096
+
+/* buffer lists up to this length are passed on without a heap allocation */
+#define N_STACK_BUFFERS 64
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_histograms_debug, "histograms", 0, \
+        "histograms tracer");
+#define gst_histograms_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstHistogramsTracer, gst_histograms_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static guint gst_histograms_tracer_signals[LAST_SIGNAL] = { 0 };
+
+static GQuark queue_stats_quark;
+
+/* protects PadStats.tracer, so that a pad finalized while the tracer is
+ * finalized does not use the freed tracer, taken before the tracer lock */
+G_LOCK_DEFINE_STATIC (pad_stats);
+
+/* log-linear histogram: values below HISTOGRAM_SUB_BUCKETS have their own
+ * bucket, above that each power of two is split in HISTOGRAM_SUB_BUCKETS */
+#define HISTOGRAM_SUB_BITS 3
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct
+{
+  guint64 count;
+  guint64 sum;
+  guint64 min;
+  guint64 max;
+  guint64 buckets[HISTOGRAM_BUCKETS];
+} Histogram;
+
+typedef enum
+{
+  HISTOGRAM_PUSH_DURATION,
+  HISTOGRAM_GAP,
+  HISTOGRAM_BUFFER_SIZE,
+  HISTOGRAM_QUEUE_RESIDENCY,
+  N_HISTOGRAMS
+} HistogramType;
+
+static const gchar *histogram_names[N_HISTOGRAMS] = {
+  "push-duration",
+  "gap",
+  "buffer-size",
+  "queue-residency",
+};
+
+typedef struct
+{
+  /* NULL once the tracer is gone, protected by the pad_stats lock */
+  GstHistogramsTracer *tracer;
+  GstPad *pad;
+  gchar *name;
+
+  /* TRUE when the parent of the pad is a queue */
+  gboolean queue_src;
+  /* whether the peer of the pad belongs to a queue, reset on (un)link */
+  gint peer_checked;
+  gboolean peer_queue;
+
+  /* protects the fields below */
+  GMutex lock;
+  GstClockTime last_push;
+  GstClockTime push_start;
+  Histogram histograms[N_HISTOGRAMS];
+} PadStats;
+
+/* buffers that entered a queue element, stored on the element */
+typedef struct
+{
+  GMutex lock;
+  /* GstBuffer * -> entry time */
+  GHashTable *buffers;
+} QueueStats;
+
+/* histograms */
+
+static inline guint
+histogram_bucket (guint64 value)
+{
+  guint msb = 0;
+  guint64 v;
+
+  if (value < HISTOGRAM_SUB_BUCKETS)
+    return value;
+
+  for (v = value; v > 1; v >>= 1)
+    msb++;
+
+  return (msb - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS +
+      ((value >> (msb - HISTOGRAM_SUB_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+/* the smallest value that ends up in @bucket */
+static guint64
+histogram_bucket_lower (guint bucket)
+{
+  guint shift;
+
+  if (bucket < HISTOGRAM_SUB_BUCKETS)
+    return bucket;
+
+  shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+  return ((guint64) HISTOGRAM_SUB_BUCKETS + bucket % HISTOGRAM_SUB_BUCKETS)
+      << shift;
+}
+
+/* the largest value that ends up in @bucket */
+static guint64
+histogram_bucket_upper (guint bucket)
+{
+  if (bucket < HISTOGRAM_SUB_BUCKETS)
+    return bucket;
+
+  return histogram_bucket_lower (bucket) +
+      ((G_GUINT64_CONSTANT (1) << (bucket / HISTOGRAM_SUB_BUCKETS - 1)) - 1);
+}
+
+static inline void
+histogram_add (Histogram * h, guint64 value)
+{
+  if (h->count == 0 || value < h->min)
+    h->min = value;
+  if (value > h->max)
+    h->max = value;
+  h->count++;
+  h->sum += value;
+  h->buckets[histogram_bucket (value)]++;
+}
+
+static guint64
+histogram_percentile (const Histogram * h, gdouble percentile)
+{
+  guint64 rank, seen = 0;
+  guint i;
+
+  rank = (guint64) (percentile * h->count / 100.0 + 0.5);
+  rank = CLAMP (rank, 1, h->count);
+
+  for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    seen += h->buckets[i];
+    if (seen >= rank)
+      return MIN (histogram_bucket_upper (i), h->max);
+  }
+
+  return h->max;
+}
+
+static void
+histogram_to_json (const Histogram * h, GString * json)
+{
+  gboolean first = TRUE;
+  guint i;
+
+  g_string_append_printf (json, "{\"count\":%" G_GUINT64_FORMAT
+      ",\"min\":%" G_GUINT64_FORMAT ",\"max\":%" G_GUINT64_FORMAT
+      ",\"mean\":%" G_GUINT64_FORMAT ",\"p50\":%" G_GUINT64_FORMAT
+      ",\"p90\":%" G_GUINT64_FORMAT ",\"p99\":%" G_GUINT64_FORMAT
+      ",\"p999\":%" G_GUINT64_FORMAT ",\"buckets\":[", h->count, h->min,
+      h->max, h->sum / h->count, histogram_percentile (h, 50.0),
+      histogram_percentile (h, 90.0), histogram_percentile (h, 99.0),
+      histogram_percentile (h, 99.9));
+
+  /* only the non-empty buckets as [lower, upper, count] */
+  for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    if (h->buckets[i] == 0)
+      continue;
+    g_string_append_printf (json, "%s[%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT
+        ",%" G_GUINT64_FORMAT "]", first ? "" : ",",
+        histogram_bucket_lower (i), histogram_bucket_upper (i), h->buckets[i]);
+    first = FALSE;
+  }
+  g_string_append (json, "]}");
+}
+
+static void
+append_json_string (GString * json, const gchar * str)
+{
+  const gchar *p;
+
+  g_string_append_c (json, '"');
+  for (p = str; *p; p++) {
+    if (*p == '"' || *p == '\\')
+      g_string_append_c (json, '\\');
+    if ((guchar) * p < 0x20)
+      g_string_append_printf (json, "\\u%04x", (guchar) * p);
+    else
+      g_string_append_c (json, *p);
+  }
+  g_string_append_c (json, '"');
+}
+
+/* data helpers */
+
+static gboolean
+is_queue (GstElement * element)
+{
+  GstElementFactory *factory;
+  const gchar *name;
+
+  if (!element || !(factory = gst_element_get_factory (element)))
+    return FALSE;
+
+  name = GST_OBJECT_NAME (factory);
+  return g_str_equal (name, "queue") || g_str_equal (name, "queue2") ||
+      g_str_equal (name, "multiqueue");
+}
+
+static void
+queue_stats_free (QueueStats * qstats)
+{
+  g_hash_table_unref (qstats->buffers);
+  g_mutex_clear (&qstats->lock);
+  g_free (qstats);
+}
+
+static QueueStats *
+get_queue_stats (GstElement * element)
+{
+  QueueStats *qstats;
+
+  GST_OBJECT_LOCK (element);
+  qstats = g_object_get_qdata ((GObject *) element, queue_stats_quark);
+  if (!qstats) {
+    qstats = g_new0 (QueueStats, 1);
+    g_mutex_init (&qstats->lock);
+    qstats->buffers = g_hash_table_new (NULL, NULL);
+    g_object_set_qdata_full ((GObject *) element, queue_stats_quark, qstats,
+        (GDestroyNotify) queue_stats_free);
+  }
+  GST_OBJECT_UNLOCK (element);
+
+  return qstats;
+}
+
+static void
+pad_stats_free (PadStats * stats)
+{
+  g_free (stats->name);
+  g_mutex_clear (&stats->lock);
+  g_free (stats);
+}
+
+/* called when the pad is finalized */
+static void
+pad_stats_destroy (PadStats * stats)
+{
+  GstHistogramsTracer *self;
+
+  G_LOCK (pad_stats);
+  self = stats->tracer;
+  if (self) {
+    g_mutex_lock (&self->lock);
+    g_hash_table_remove (self->pads, stats);
+    g_mutex_unlock (&self->lock);
+  }
+  G_UNLOCK (pad_stats);
+
+  pad_stats_free (stats);
+}
+
+static PadStats *
+get_pad_stats (GstHistogramsTracer * self, GstPad * pad)
+{
+  PadStats *stats;
+  guint i;
+
+  stats = g_object_get_qdata ((GObject *) pad, self->stats_quark);
+  if (G_LIKELY (stats))
+    return stats;
+
+  g_mutex_lock (&self->lock);
+  if (g_hash_table_size (self->pads) >= self->max_pads) {
+    g_mutex_unlock (&self->lock);
+    return NULL;
+  }
+
+  stats = g_new0 (PadStats, 1);
+  stats->tracer = self;
+  stats->pad = pad;
+  stats->name = g_strdup_printf ("%s:%s", GST_DEBUG_PAD_NAME (pad));
+  stats->queue_src = is_queue (GST_PAD_PARENT (pad));
+  g_mutex_init (&stats->lock);
+  stats->last_push = GST_CLOCK_TIME_NONE;
+  stats->push_start = GST_CLOCK_TIME_NONE;
+  for (i = 0; i < N_HISTOGRAMS; i++)
+    stats->histograms[i].min = G_MAXUINT64;
+
+  g_hash_table_add (self->pads, stats);
+  g_object_set_qdata_full ((GObject *) pad, self->stats_quark, stats,
+      (GDestroyNotify) pad_stats_destroy);
+  g_mutex_unlock (&self->lock);
+
+  GST_DEBUG_OBJECT (self, "tracking pad %s", stats->name);
+
+  return stats;
+}
+
+/* returns the queue element downstream of @pad, if any */
+static GstElement *
+get_peer_queue (PadStats * stats, GstPad * pad)
+{
+  GstPad *peer;
+  GstElement *parent = NULL;
+
+  if (!g_atomic_int_get (&stats->peer_checked)) {
+    GstElement *peer_parent = NULL;
+
+    if ((peer = gst_pad_get_peer (pad))) {
+      peer_parent = gst_pad_get_parent_element (peer);
+      gst_object_unref (peer);
+    }
+    stats->peer_queue = is_queue (peer_parent);
+    g_atomic_int_set (&stats->peer_checked, TRUE);
+
+    if (stats->peer_queue)
+      return peer_parent;
+    if (peer_parent)
+      gst_object_unref (peer_parent);
+    return NULL;
+  }
+
+  if (!stats->peer_queue)
+    return NULL;
+
+  if ((peer = gst_pad_get_peer (pad))) {
+    parent = gst_pad_get_parent_element (peer);
+    gst_object_unref (peer);
+  }
+  return parent;
+}
+
+static void
+queue_enter (GstElement * queue, GstBuffer * buffer, GstClockTime ts)
+{
+  QueueStats *qstats = get_queue_stats (queue);
+
+  g_mutex_lock (&qstats->lock);
+  if (g_hash_table_size (qstats->buffers) >= MAX_QUEUED_BUFFERS)
+    g_hash_table_remove_all (qstats->buffers);
+  g_hash_table_insert (qstats->buffers, buffer, GSIZE_TO_POINTER (ts));
+  g_mutex_unlock (&qstats->lock);
+}
+
+static void
+queue_leave (PadStats * stats, GstPad * pad, GstBuffer * buffer,
+    GstClockTime ts)
+{
+  QueueStats *qstats = get_queue_stats (GST_PAD_PARENT (pad));
+  gpointer entered;
+  gboolean found;
+
+  g_mutex_lock (&qstats->lock);
+  found = g_hash_table_steal_extended (qstats->buffers, buffer, NULL,
+      &entered);
+  g_mutex_unlock (&qstats->lock);
+
+  if (found && ts >= GPOINTER_TO_SIZE (entered)) {
+    g_mutex_lock (&stats->lock);
+    histogram_add (&stats->histograms[HISTOGRAM_QUEUE_RESIDENCY],
+        ts - GPOINTER_TO_SIZE (entered));
+    g_mutex_unlock (&stats->lock);
+  }
+}
+
+static void
+do_push_buffer_pre (GstHistogramsTracer * self, GstClockTime ts, GstPad * pad,
+    GstBuffer ** buffers, guint n_buffers)
+{
+  PadStats *stats;
+  GstElement *queue;
+  guint i;
+
+  if (!(stats = get_pad_stats (self, pad)))
+    return;
+
+  g_mutex_lock (&stats->lock);
+  if (GST_CLOCK_TIME_IS_VALID (stats->last_push) && ts >= stats->last_push)
+    histogram_add (&stats->histograms[HISTOGRAM_GAP], ts - stats->last_push);
+  stats->last_push = ts;
+  stats->push_start = ts;
+  for (i = 0; i < n_buffers; i++)
+    histogram_add (&stats->histograms[HISTOGRAM_BUFFER_SIZE],
+        gst_buffer_get_size (buffers[i]));
+  g_mutex_unlock (&stats->lock);
+
+  if (stats->queue_src) {
+    for (i = 0; i < n_buffers; i++)
+      queue_leave (stats, pad, buffers[i], ts);
+  }
+
+  if ((queue = get_peer_queue (stats, pad))) {
+    for (i = 0; i < n_buffers; i++)
+      queue_enter (queue, buffers[i], ts);
+    gst_object_unref (queue);
+  }
+}
+
+static void
+do_push_buffer_post (GstHistogramsTracer * self, GstClockTime ts,
+    GstPad * pad)
+{
+  PadStats *stats;
+
+  stats = g_object_get_qdata ((GObject *) pad, self->stats_quark);
+  if (!stats)
+    return;
+
+  g_mutex_lock (&stats->lock);
+  if (GST_CLOCK_TIME_IS_VALID (stats->push_start) && ts >= stats->push_start)
+    histogram_add (&stats->histograms[HISTOGRAM_PUSH_DURATION],
+        ts - stats->push_start);
+  stats->push_start = GST_CLOCK_TIME_NONE;
+  g_mutex_unlock (&stats->lock);
+}
+
+/* hooks */
+
+static void
+do_push_buffer_pre_cb (GstTracer * tracer, GstClockTime ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  do_push_buffer_pre (GST_HISTOGRAMS_TRACER_CAST (tracer), ts, pad, &buffer,
+      1);
+}
+
+static void
+do_push_buffer_list_pre_cb (GstTracer * tracer, GstClockTime ts,
+    GstPad * pad, GstBufferList * list)
+{
+  guint n = gst_buffer_list_length (list);
+  GstBuffer *stack_buffers[N_STACK_BUFFERS];
+  GstBuffer **buffers = stack_buffers;
+  guint i;
+
+  if (G_UNLIKELY (n > N_STACK_BUFFERS))
+    buffers = g_new (GstBuffer *, n);
+
+  for (i = 0; i < n; i++)
+    buffers[i] = gst_buffer_list_get (list, i);
+
+  do_push_buffer_pre (GST_HISTOGRAMS_TRACER_CAST (tracer), ts, pad, buffers,
+      n);
+
+  if (buffers != stack_buffers)
+    g_free (buffers);
+}
+
+static void
+do_push_buffer_post_cb (GstTracer * tracer, GstClockTime ts, GstPad * pad,
+    GstFlowReturn res)
+{
+  do_push_buffer_post (GST_HISTOGRAMS_TRACER_CAST (tracer), ts, pad);
+}
+
+static void
+do_pad_link_changed (GstHistogramsTracer * self, GstPad * srcpad)
+{
+  PadStats *stats;
+
+  stats = g_object_get_qdata ((GObject *) srcpad, self->stats_quark);
+  if (stats)
+    g_atomic_int_set (&stats->peer_checked, FALSE);
+}
+
+static void
+do_pad_link_post_cb (GstTracer * tracer, GstClockTime ts, GstPad * srcpad,
+    GstPad * sinkpad, GstPadLinkReturn res)
+{
+  do_pad_link_changed (GST_HISTOGRAMS_TRACER_CAST (tracer), srcpad);
+}
+
+static void
+do_pad_unlink_post_cb (GstTracer * tracer, GstClockTime ts, GstPad * srcpad,
+    GstPad * sinkpad, gboolean res)
+{
+  do_pad_link_changed (GST_HISTOGRAMS_TRACER_CAST (tracer), srcpad);
+}
+
+static void
+do_caps_cache_lookup_cb (GstTracer * tracer, GstClockTime ts,
+    const GstCaps * caps1, const GstCaps * caps2, gboolean hit)
+{
+  GstHistogramsTracer *self = GST_HISTOGRAMS_TRACER_CAST (tracer);
+
+  if (hit)
+    g_atomic_int_inc (&self->caps_cache_hits);
+  else
+    g_atomic_int_inc (&self->caps_cache_misses);
+}
+
+/* dumping */
+
+static gint
+compare_pad_stats (gconstpointer a, gconstpointer b)
+{
+  const PadStats *sa = *(const PadStats **) a;
+  const PadStats *sb = *(const PadStats **) b;
+
+  return g_strcmp0 (sa->name, sb->name);
+}
+
+static gchar *
+gst_histograms_tracer_get_json (GstHistogramsTracer * self)
+{
+  GString *json;
+  GPtrArray *pads;
+  GHashTableIter iter;
+  gpointer key;
+  gboolean first = TRUE;
+  guint i, j, hits, misses;
+
+  json = g_string_sized_new (4096);
+  g_string_append_printf (json, "{\"timestamp\":%" G_GUINT64_FORMAT
+      ",\"pads\":[", g_get_real_time () * 1000);
+
+  g_mutex_lock (&self->lock);
+  pads = g_ptr_array_sized_new (g_hash_table_size (self->pads));
+  g_hash_table_iter_init (&iter, self->pads);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    g_ptr_array_add (pads, key);
+  g_ptr_array_sort (pads, compare_pad_stats);
+
+  for (i = 0; i < pads->len; i++) {
+    PadStats *stats = g_ptr_array_index (pads, i);
+
+    g_string_append (json, first ? "{\"pad\":" : ",{\"pad\":");
+    append_json_string (json, stats->name);
+
+    g_mutex_lock (&stats->lock);
+    for (j = 0; j < N_HISTOGRAMS; j++) {
+      if (stats->histograms[j].count == 0)
+        continue;
+      g_string_append_printf (json, ",\"%s\":", histogram_names[j]);
+      histogram_to_json (&stats->histograms[j], json);
+    }
+    g_mutex_unlock (&stats->lock);
+
+    g_string_append_c (json, '}');
+    first = FALSE;
+  }
+  g_mutex_unlock (&self->lock);
+  g_ptr_array_free (pads, TRUE);
+
+  g_string_append_c (json, ']');
+
+  hits = g_atomic_int_get (&self->caps_cache_hits);
+  misses = g_atomic_int_get (&self->caps_cache_misses);
+  if (hits > 0 || misses > 0) {
+    g_string_append_printf (json, ",\"caps-cache\":{\"hits\":%u,"
+        "\"misses\":%u}", hits, misses);
+  }
+
+  g_string_append_c (json, '}');
+
+  return g_string_free (json, FALSE);
+}
+
+static void
+gst_histograms_tracer_dump (GstHistogramsTracer * self)
+{
+  gchar *json = gst_histograms_tracer_get_json (self);
+
+  if (self->file) {
+    FILE *f = g_fopen (self->file, "a");
+
+    if (f) {
+      fprintf (f, "%s\n", json);
+      fclose (f);
+    } else {
+      GST_WARNING_OBJECT (self, "could not open %s: %s", self->file,
+          g_strerror (errno));
+    }
+  } else {
+    GST_INFO_OBJECT (self, "%s", json);
+  }
+
+  g_free (json);
+}
+
+static gpointer
+gst_histograms_tracer_dump_thread (GstHistogramsTracer * self)
+{
+  gint64 end_time;
+
+  g_mutex_lock (&self->dump_lock);
+  end_time = g_get_monotonic_time () + self->interval * G_TIME_SPAN_SECOND;
+  while (!self->stopping) {
+    if (!g_cond_wait_until (&self->dump_cond, &self->dump_lock, end_time)) {
+      g_mutex_unlock (&self->dump_lock);
+      gst_histograms_tracer_dump (self);
+      g_mutex_lock (&self->dump_lock);
+      end_time += self->interval * G_TIME_SPAN_SECOND;
+    }
+  }
+  g_mutex_unlock (&self->dump_lock);
+
+  return NULL;
+}
+
+/* tracer class */
+
+static void
+set_params (GstHistogramsTracer * self)
+{
+  gchar *params, *tmp;
+  GstStructure *params_struct = NULL;
+
+  g_object_get (self, "params", &params, NULL);
+  if (!params)
+    return;
+
+  tmp = g_strdup_printf ("histograms,%s", params);
+  params_struct = gst_structure_from_string (tmp, NULL);
+  g_free (tmp);
+
+  if (params_struct) {
+    const gchar *name;
+
+    gst_structure_get_uint (params_struct, "max-pads", &self->max_pads);
+    gst_structure_get_uint (params_struct, "interval", &self->interval);
+    self->file = g_strdup (gst_structure_get_string (params_struct, "file"));
+    if ((name = gst_structure_get_string (params_struct, "name")))
+      gst_object_set_name (GST_OBJECT (self), name);
+    gst_structure_free (params_struct);
+  } else {
+    GST_WARNING_OBJECT (self, "could not parse params '%s'", params);
+  }
+
+  g_free (params);
+}
+
+static void
+gst_histograms_tracer_init (GstHistogramsTracer * self)
+{
+  gchar *name;
+
+  name = g_strdup_printf ("histograms-%p", self);
+  self->stats_quark = g_quark_from_string (name);
+  g_free (name);
+
+  g_mutex_init (&self->lock);
+  self->pads = g_hash_table_new (NULL, NULL);
+  self->max_pads = DEFAULT_MAX_PADS;
+  self->interval = DEFAULT_INTERVAL;
+
+  g_mutex_init (&self->dump_lock);
+  g_cond_init (&self->dump_cond);
+}
+
+static void
+gst_histograms_tracer_constructed (GObject * object)
+{
+  GstHistogramsTracer *self = GST_HISTOGRAMS_TRACER (object);
+  GstTracer *tracer = GST_TRACER (object);
+
+  set_params (self);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre_cb));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_buffer_post_cb));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre_cb));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_buffer_post_cb));
+  gst_tracing_register_hook (tracer, "pad-link-post",
+      G_CALLBACK (do_pad_link_post_cb));
+  gst_tracing_register_hook (tracer, "pad-unlink-post",
+      G_CALLBACK (do_pad_unlink_post_cb));
+  gst_tracing_register_hook (tracer, "caps-cache-lookup",
+      G_CALLBACK (do_caps_cache_lookup_cb));
+
+  if (self->interval > 0)
+    self->dump_thread = g_thread_new ("gsthistograms",
+        (GThreadFunc) gst_histograms_tracer_dump_thread, self);
+
+  ((GObjectClass *) gst_histograms_tracer_parent_class)->constructed (object);
+}
+
+static void
+gst_histograms_tracer_finalize (GObject * object)
+{
+  GstHistogramsTracer *self = GST_HISTOGRAMS_TRACER (object);
+  GHashTableIter iter;
+  gpointer key;
+
+  if (self->dump_thread) {
+    g_mutex_lock (&self->dump_lock);
+    self->stopping = TRUE;
+    g_cond_signal (&self->dump_cond);
+    g_mutex_unlock (&self->dump_lock);
+    g_thread_join (self->dump_thread);
+  }
+
+  gst_histograms_tracer_dump (self);
+
+  /* detach the stats from the pads that are still alive. A pad that is
+   * being finalized already dropped its qdata and waits for the pad_stats
+   * lock in pad_stats_destroy(), which then frees the stats */
+  G_LOCK (pad_stats);
+  g_mutex_lock (&self->lock);
+  g_hash_table_iter_init (&iter, self->pads);
+  while (g_hash_table_iter_next (&iter, &key, NULL)) {
+    PadStats *stats = key;
+
+    if (g_object_steal_qdata ((GObject *) stats->pad, self->stats_quark))
+      pad_stats_free (stats);
+    else
+      stats->tracer = NULL;
+  }
+  g_hash_table_unref (self->pads);
+  g_mutex_unlock (&self->lock);
+  G_UNLOCK (pad_stats);
+
+  g_mutex_clear (&self->lock);
+  g_mutex_clear (&self->dump_lock);
+  g_cond_clear (&self->dump_cond);
+  g_free (self->file);
+
+  ((GObjectClass *) gst_histograms_tracer_parent_class)->finalize (object);
+}
+
+static void
+gst_histograms_tracer_class_init (GstHistogramsTracerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->constructed = gst_histograms_tracer_constructed;
+  gobject_class->finalize = gst_histograms_tracer_finalize;
+
+  queue_stats_quark = g_quark_from_static_string ("histograms.queue-stats");
+
+  klass->get_json = gst_histograms_tracer_get_json;
+  klass->dump = gst_histograms_tracer_dump;
+
+  /**
+   * GstHistogramsTracer::get-json:
+   * @histogramstracer: the histograms tracer object to emit this signal on
+   *
+   * Returns the histograms of all tracked pads as a JSON object with a
+   * "pads" array.
+   *
+   * Returns: (transfer full): a JSON string
+   *
+   * Since: 1.26
+   */
+  gst_histograms_tracer_signals[SIGNAL_GET_JSON] =
+      g_signal_new ("get-json", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET
+      (GstHistogramsTracerClass, get_json), NULL, NULL, NULL, G_TYPE_STRING, 0,
+      G_TYPE_NONE);
+
+  /**
+   * GstHistogramsTracer::dump:
+   * @histogramstracer: the histograms tracer object to emit this signal on
+   *
+   * Writes the histograms of all tracked pads to the configured file or the
+   * debug log.
+   *
+   * Since: 1.26
+   */
+  gst_histograms_tracer_signals[SIGNAL_DUMP] =
+      g_signal_new ("dump", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET
+      (GstHistogramsTracerClass, dump), NULL, NULL, NULL, G_TYPE_NONE, 0,
+      G_TYPE_NONE);
+}
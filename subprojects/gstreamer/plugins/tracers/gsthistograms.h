@@ -0,0 +1,88 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gsthistograms.h: tracing module keeping per pad histograms
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_HISTOGRAMS_TRACER_H__
+#define __GST_HISTOGRAMS_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_HISTOGRAMS_TRACER \
+  (gst_histograms_tracer_get_type())
+#define GST_HISTOGRAMS_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_HISTOGRAMS_TRACER,GstHistogramsTracer))
+#define GST_HISTOGRAMS_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_HISTOGRAMS_TRACER,GstHistogramsTracerClass))
+#define GST_IS_HISTOGRAMS_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_HISTOGRAMS_TRACER))
+#define GST_IS_HISTOGRAMS_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_HISTOGRAMS_TRACER))
+#define GST_HISTOGRAMS_TRACER_CAST(obj) ((GstHistogramsTracer *)(obj))
+
+typedef struct _GstHistogramsTracer GstHistogramsTracer;
+typedef struct _GstHistogramsTracerClass GstHistogramsTracerClass;
+
+/**
+ * GstHistogramsTracer:
+ *
+ * Opaque #GstHistogramsTracer data structure
+ */
+struct _GstHistogramsTracer {
+  GstTracer parent;
+
+  /*< private >*/
+  /* quark of the per pad stats in the pad qdata */
+  GQuark stats_quark;
+  /* protects pads */
+  GMutex lock;
+  /* set of all PadStats */
+  GHashTable *pads;
+  guint max_pads;
+
+  gchar *file;
+  guint interval;
+
+  /* caps cache lookups, see GST_CAPS_CACHE */
+  gint caps_cache_hits;
+  gint caps_cache_misses;
+
+  /* periodic dumping */
+  GThread *dump_thread;
+  GMutex dump_lock;
+  GCond dump_cond;
+  gboolean stopping;
+};
+
+struct _GstHistogramsTracerClass {
+  GstTracerClass parent_class;
+
+  /* actions */
+  gchar *        (*get_json)                    (GstHistogramsTracer *tracer);
+  void           (*dump)                        (GstHistogramsTracer *tracer);
+};
+
+G_GNUC_INTERNAL GType gst_histograms_tracer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_HISTOGRAMS_TRACER_H__ */
@@ -448,6 +448,31 @@ object_created_cb (GstTracer * tracer, GstClockTime ts, GstObject * object)
   handle_object_created (self, object, object_type, GOBJECT);
 }
 
+static void
+arena_alloc_cb (GstTracer * tracer, GstClockTime ts, gpointer mem, gsize size)
+{
+  GstLeaksTracer *self = GST_LEAKS_TRACER_CAST (tracer);
+
+  g_mutex_lock (&self->arena_lock);
+  g_hash_table_insert (self->arena_blocks, mem, GSIZE_TO_POINTER (size));
+  self->arena_bytes += size;
+  self->arena_used = TRUE;
+  g_mutex_unlock (&self->arena_lock);
+}
+
+static void
+arena_free_cb (GstTracer * tracer, GstClockTime ts, gpointer mem)
+{
+  GstLeaksTracer *self = GST_LEAKS_TRACER_CAST (tracer);
+  gpointer size;
+
+  g_mutex_lock (&self->arena_lock);
+  /* blocks allocated before the tracer was created are not known */
+  if (g_hash_table_steal_extended (self->arena_blocks, mem, NULL, &size))
+    self->arena_bytes -= GPOINTER_TO_SIZE (size);
+  g_mutex_unlock (&self->arena_lock);
+}
+
 static void
 handle_object_reffed (GstLeaksTracer * self, gpointer object, GType type,
     gint new_refcount, gboolean reffed, GstClockTime ts)
@@ -525,6 +550,8 @@ gst_leaks_tracer_init (GstLeaksTracer * self)
   self->log_leaks = DEFAULT_LOG_LEAKS;
   self->objects = g_hash_table_new_full (NULL, NULL, NULL,
       (GDestroyNotify) object_refing_infos_free);
+  g_mutex_init (&self->arena_lock);
+  self->arena_blocks = g_hash_table_new (NULL, NULL);
 
   if (g_getenv ("GST_LEAKS_TRACER_SIG")) {
 #ifdef G_OS_UNIX
@@ -551,6 +578,10 @@ gst_leaks_tracer_constructed (GObject * object)
       G_CALLBACK (mini_object_created_cb));
   gst_tracing_register_hook (tracer, "object-created",
       G_CALLBACK (object_created_cb));
+  gst_tracing_register_hook (tracer, "arena-alloc",
+      G_CALLBACK (arena_alloc_cb));
+  gst_tracing_register_hook (tracer, "arena-free",
+      G_CALLBACK (arena_free_cb));
 
   if (self->check_refs) {
     gst_tracing_register_hook (tracer, "object-reffed",
@@ -777,6 +808,12 @@ gst_leaks_tracer_finalize (GObject * object)
   if (self->log_leaks)
     leaks = process_leaks (self, NULL);
 
+  /* Some structures, like the ones of static caps, stay alive until the
+   * process exits, so blocks that are still in use are only logged */
+  GST_INFO_OBJECT (self, "%u arena blocks with %" G_GUINT64_FORMAT
+      " bytes still in use", g_hash_table_size (self->arena_blocks),
+      self->arena_bytes);
+
   /* Remove weak references */
   g_hash_table_iter_init (&iter, self->objects);
   while (g_hash_table_iter_next (&iter, &obj, &infos)) {
@@ -800,6 +837,8 @@ gst_leaks_tracer_finalize (GObject * object)
   g_clear_pointer (&self->added, g_hash_table_unref);
   g_clear_pointer (&self->removed, g_hash_table_unref);
   g_clear_pointer (&self->unhandled_filter, g_hash_table_unref);
+  g_clear_pointer (&self->arena_blocks, g_hash_table_unref);
+  g_mutex_clear (&self->arena_lock);
 
   G_LOCK (instances);
   g_queue_remove (&instances, self);
@@ -1018,6 +1057,9 @@ gst_leaks_tracer_get_live_objects (GstLeaksTracer * self)
 {
   GstStructure *info;
   GValue live_objects = G_VALUE_INIT;
+  guint arena_blocks;
+  guint64 arena_bytes;
+  gboolean arena_used;
 
   g_value_init (&live_objects, GST_TYPE_LIST);
 
@@ -1025,7 +1067,17 @@ gst_leaks_tracer_get_live_objects (GstLeaksTracer * self)
   process_leaks (self, &live_objects);
   GST_OBJECT_UNLOCK (self);
 
+  g_mutex_lock (&self->arena_lock);
+  arena_blocks = g_hash_table_size (self->arena_blocks);
+  arena_bytes = self->arena_bytes;
+  arena_used = self->arena_used;
+  g_mutex_unlock (&self->arena_lock);
+
   info = gst_structure_new_empty ("live-objects-info");
+  if (arena_used) {
+    gst_structure_set (info, "arena-blocks", G_TYPE_UINT, arena_blocks,
+        "arena-bytes", G_TYPE_UINT64, arena_bytes, NULL);
+  }
   gst_structure_take_value (info, "live-objects-list", &live_objects);
 
   return info;
@@ -1207,6 +1259,10 @@ gst_leaks_tracer_class_init (GstLeaksTracerClass * klass)
    * activity checkpoint action signals might be a better fit for your use
    * case.
    *
+   * When the `GST_MINIOBJECT_ARENA` environment variable is set, the returned
+   * #GstStructure also has an `arena-blocks` and an `arena-bytes` field with
+   * the number and size of the arena blocks still in use (Since: 1.26).
+   *
    * Returns: (transfer full): a newly-allocated #GstStructure
    *
    * Since: 1.18
@@ -72,6 +72,14 @@ struct _GstLeaksTracer {
   gboolean log_leaks;
 
   GstStackTraceFlags trace_flags;
+
+  /* gpointer (arena block in use) -> its size, see GST_MINIOBJECT_ARENA.
+   * Protected by arena_lock, as blocks can be allocated while the object
+   * lock is held */
+  GMutex arena_lock;
+  GHashTable *arena_blocks;
+  guint64 arena_bytes;
+  gboolean arena_used;
 };
 
 struct _GstLeaksTracerClass {
@@ -30,6 +30,7 @@
 #include "gststats.h"
 #include "gstleaks.h"
 #include "gstfactories.h"
+#include "gsthistograms.h"
 
 static gboolean
 plugin_init (GstPlugin * plugin)
@@ -51,6 +52,9 @@ plugin_init (GstPlugin * plugin)
   if (!gst_tracer_register (plugin, "factories",
           gst_factories_tracer_get_type ()))
     return FALSE;
+  if (!gst_tracer_register (plugin, "histograms",
+          gst_histograms_tracer_get_type ()))
+    return FALSE;
   return TRUE;
 }
 
@@ -28,6 +28,11 @@
  *  -c children: is the number of branches on each level
  *  -f <flavour>: can be "audio" or "video" and is controlling the kind of
  *                elements that are used.
+ *  -i instances: is the number of identical trees in the pipeline
+ *
+ * Run it with and without GST_CAPS_CACHE=<entries> in the environment to
+ * compare negotiation with and without the caps cache. Many instances of
+ * the same elements make for a lot of identical caps operations.
  */
 
 #include <gst/gst.h>
@@ -190,6 +195,8 @@ main (gint argc, gchar * argv[])
   gint children = 3;
   gint depth = 4;
   gint loops = 50;
+  gint instances = 1;
+  const gchar *caps_cache;
 
   GOptionContext *ctx;
   GOptionEntry options[] = {
@@ -206,6 +213,9 @@ main (gint argc, gchar * argv[])
     {"loops", 'l', 0, G_OPTION_ARG_INT, &loops,
         "How many loops to run (default: 50)", NULL}
     ,
+    {"instances", 'i', 0, G_OPTION_ARG_INT, &instances,
+        "Number of identical trees in the pipeline (default: 1)", NULL}
+    ,
     {NULL}
   };
   GError *err = NULL;
@@ -231,20 +241,25 @@ main (gint argc, gchar * argv[])
   if (strcmp (flavour_str, "video") == 0)
     flavour = FLAVOUR_VIDEO;
 
+  caps_cache = g_getenv ("GST_CAPS_CACHE");
+  g_print ("caps cache: %s\n", caps_cache ? caps_cache : "disabled");
+
   /* build pipeline */
-  g_print ("building %s pipeline with depth = %d and children = %d\n",
-      flavour_str, depth, children);
+  g_print ("building %s pipeline with %d instance(s) of depth = %d and "
+      "children = %d\n", flavour_str, instances, depth, children);
   g_free (flavour_str);
 
   start = gst_util_get_timestamp ();
   bin = GST_BIN (gst_pipeline_new ("pipeline"));
-  sink = gst_element_factory_make ("fakesink", NULL);
-  gst_bin_add (bin, sink);
-  if (!create_node (bin, sink, "sink", &new_sink, children, flavour)) {
-    goto Error;
-  }
-  if (!create_nodes (bin, new_sink, depth, children, flavour)) {
-    goto Error;
+  for (i = 0; i < instances; i++) {
+    sink = gst_element_factory_make ("fakesink", NULL);
+    gst_bin_add (bin, sink);
+    if (!create_node (bin, sink, "sink", &new_sink, children, flavour)) {
+      goto Error;
+    }
+    if (!create_nodes (bin, new_sink, depth, children, flavour)) {
+      goto Error;
+    }
   }
   end = gst_util_get_timestamp ();
   /* num-threads = num-sources = pow (children, depth) */
@@ -265,6 +280,10 @@ main (gint argc, gchar * argv[])
   end = gst_util_get_timestamp ();
   g_print ("%" GST_TIME_FORMAT " reached PAUSED state (%d loop iterations)\n",
       GST_TIME_ARGS (end - start), loops);
+  if (loops > 0) {
+    g_print ("%" GST_TIME_FORMAT " per iteration\n",
+        GST_TIME_ARGS ((end - start) / loops));
+  }
   /* clean up */
 Error:
   gst_element_set_state (GST_ELEMENT (bin), GST_STATE_NULL);
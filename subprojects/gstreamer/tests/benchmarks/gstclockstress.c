@@ -23,9 +23,11 @@
 #include <gst/glib-compat-private.h>
 
 #define MAX_THREADS  100
+#define DEFAULT_ASYNC_ENTRIES 100000
 
 static gboolean running = TRUE;
 static gint count = 0;
+static gint fired = 0;
 
 static void *
 run_test (void *user_data)
@@ -43,22 +45,76 @@ run_test (void *user_data)
   return NULL;
 }
 
+static gboolean
+async_cb (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  g_atomic_int_inc (&fired);
+  return TRUE;
+}
+
+/* schedule many async entries spread over one second in random order, cancel
+ * half of them and wait for the others to fire */
+static void
+run_async_test (GstClock * sysclock, gint n_entries)
+{
+  GstClockID *ids;
+  GstClockTime base, start, end;
+  gint i, expected;
+
+  ids = g_new (GstClockID, n_entries);
+  base = gst_clock_get_time (sysclock) + GST_SECOND;
+  for (i = 0; i < n_entries; i++)
+    ids[i] = gst_clock_new_single_shot_id (sysclock,
+        base + g_random_int_range (0, GST_SECOND / GST_USECOND) * GST_USECOND);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_entries; i++)
+    gst_clock_id_wait_async (ids[i], async_cb, NULL, NULL);
+  end = gst_util_get_timestamp ();
+  g_print ("scheduled %d async entries in %" GST_TIME_FORMAT "\n", n_entries,
+      GST_TIME_ARGS (end - start));
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_entries; i += 2)
+    gst_clock_id_unschedule (ids[i]);
+  end = gst_util_get_timestamp ();
+  g_print ("unscheduled %d async entries in %" GST_TIME_FORMAT "\n",
+      (n_entries + 1) / 2, GST_TIME_ARGS (end - start));
+
+  expected = n_entries / 2;
+  start = gst_util_get_timestamp ();
+  while (g_atomic_int_get (&fired) < expected &&
+      gst_clock_get_time (sysclock) < base + 3 * GST_SECOND)
+    g_usleep (G_USEC_PER_SEC / 100);
+  end = gst_util_get_timestamp ();
+  g_print ("%d of %d async entries fired after waiting %" GST_TIME_FORMAT
+      "\n", g_atomic_int_get (&fired), expected, GST_TIME_ARGS (end - start));
+
+  for (i = 0; i < n_entries; i++)
+    gst_clock_id_unref (ids[i]);
+  g_free (ids);
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
   GThread *threads[MAX_THREADS];
   gint num_threads;
+  gint num_entries = DEFAULT_ASYNC_ENTRIES;
   gint t;
   GstClock *sysclock;
 
   gst_init (&argc, &argv);
 
-  if (argc != 2) {
-    g_print ("usage: %s <num_threads>\n", argv[0]);
+  if (argc != 2 && argc != 3) {
+    g_print ("usage: %s <num_threads> [<num_async_entries>]\n", argv[0]);
     exit (-1);
   }
 
   num_threads = atoi (argv[1]);
+  if (argc == 3)
+    num_entries = atoi (argv[2]);
 
   if (num_threads <= 0 || num_threads > MAX_THREADS) {
     g_print ("number of threads must be between 0 and %d\n", MAX_THREADS);
@@ -94,6 +150,9 @@ main (gint argc, gchar * argv[])
 
   g_print ("performed %d get_time operations\n", count);
 
+  if (num_entries > 0)
+    run_async_test (sysclock, num_entries);
+
   gst_object_unref (sysclock);
 
   return 0;
@@ -0,0 +1,144 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gsteventchurn.c: create and free events and queries on different threads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Producer threads create the events and queries that a streaming thread
+ * typically sends, and hand them over to consumer threads that free them,
+ * like a demuxer sending events to a queue. Run it once without and once
+ * with GST_MINIOBJECT_ARENA set to compare the allocators. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+
+static GAsyncQueue *handover;
+static guint64 n_per_producer;
+
+static gpointer
+producer_func (gpointer data)
+{
+  GstSegment segment;
+  guint64 i;
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+
+  for (i = 0; i < n_per_producer; i++) {
+    GstMiniObject *obj;
+
+    switch (i % 4) {
+      case 0:
+        obj = (GstMiniObject *) gst_event_new_segment (&segment);
+        break;
+      case 1:
+        obj = (GstMiniObject *) gst_event_new_gap (i * GST_MSECOND,
+            GST_MSECOND);
+        break;
+      case 2:
+        obj = (GstMiniObject *) gst_query_new_latency ();
+        break;
+      default:
+        obj = (GstMiniObject *) gst_event_new_qos (GST_QOS_TYPE_UNDERFLOW,
+            1.0, 0, i * GST_MSECOND);
+        break;
+    }
+    g_async_queue_push (handover, obj);
+  }
+
+  return NULL;
+}
+
+static gpointer
+consumer_func (gpointer data)
+{
+  GstMiniObject *obj;
+
+  /* the end of the stream is signalled with the queue itself */
+  while ((obj = g_async_queue_pop (handover)) != (gpointer) handover)
+    gst_mini_object_unref (obj);
+
+  return NULL;
+}
+
+static void
+run_test (guint n_threads)
+{
+  GThread **producers, **consumers;
+  GstClockTime start, end;
+  guint64 total;
+  guint i;
+
+  producers = g_new (GThread *, n_threads);
+  consumers = g_new (GThread *, n_threads);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_threads; i++) {
+    consumers[i] = g_thread_new ("consumer", consumer_func, NULL);
+    producers[i] = g_thread_new ("producer", producer_func, NULL);
+  }
+  for (i = 0; i < n_threads; i++)
+    g_thread_join (producers[i]);
+  for (i = 0; i < n_threads; i++)
+    g_async_queue_push (handover, handover);
+  for (i = 0; i < n_threads; i++)
+    g_thread_join (consumers[i]);
+  end = gst_util_get_timestamp ();
+
+  total = n_per_producer * n_threads;
+  g_print ("%2u producers/consumers: %" G_GUINT64_FORMAT " objects in %"
+      GST_TIME_FORMAT ", %.0f objects/s\n", n_threads, total,
+      GST_TIME_ARGS (end - start),
+      (gdouble) total * GST_SECOND / (end - start));
+
+  g_free (producers);
+  g_free (consumers);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  const gchar *arena;
+  guint n_threads;
+
+  gst_init (&argc, &argv);
+
+  if (argc != 2) {
+    g_print ("usage: %s <nobjects per thread>\n", argv[0]);
+    exit (-1);
+  }
+
+  n_per_producer = atoi (argv[1]);
+
+  if (n_per_producer <= 0) {
+    g_print ("number of objects must be greater than 0\n");
+    exit (-3);
+  }
+
+  arena = g_getenv ("GST_MINIOBJECT_ARENA");
+  g_print ("arena: %s\n", arena && *arena ? arena : "disabled");
+
+  handover = g_async_queue_new ();
+
+  for (n_threads = 1; n_threads <= 8; n_threads *= 2)
+    run_test (n_threads);
+
+  g_async_queue_unref (handover);
+
+  return 0;
+}
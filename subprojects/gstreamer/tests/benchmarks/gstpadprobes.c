@@ -0,0 +1,117 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Pushes buffers between two linked pads while the source pad has probes
+ * installed that are not interested in buffers, like the event and query
+ * probes that rtpbin and webrtcbin add to their pads. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define DEFAULT_BUFFERS 1000000
+
+static GstPadProbeReturn
+unrelated_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  g_assert_not_reached ();
+  return GST_PAD_PROBE_OK;
+}
+
+static GstFlowReturn
+chain_func (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static void
+run_test (guint n_probes, guint64 n_buffers)
+{
+  static const GstPadProbeType types[] = {
+    GST_PAD_PROBE_TYPE_EVENT_UPSTREAM,
+    GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM,
+    GST_PAD_PROBE_TYPE_EVENT_FLUSH,
+    GST_PAD_PROBE_TYPE_QUERY_UPSTREAM,
+  };
+  GstPad *src, *sink;
+  GstSegment segment;
+  GstBuffer *buf;
+  GstClockTime start, end;
+  guint64 i;
+  guint p;
+
+  src = gst_pad_new ("src", GST_PAD_SRC);
+  sink = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sink, chain_func);
+  gst_pad_set_active (src, TRUE);
+  gst_pad_set_active (sink, TRUE);
+  gst_pad_link (src, sink);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (src, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (src, gst_event_new_segment (&segment));
+
+  for (p = 0; p < n_probes; p++)
+    gst_pad_add_probe (src, types[p % G_N_ELEMENTS (types)], unrelated_probe,
+        NULL, NULL);
+
+  buf = gst_buffer_new ();
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_buffers; i++)
+    gst_pad_push (src, gst_buffer_ref (buf));
+  end = gst_util_get_timestamp ();
+  gst_buffer_unref (buf);
+
+  g_print ("%2u unrelated probes: %" G_GUINT64_FORMAT " buffers in %"
+      GST_TIME_FORMAT ", %.0f buffers/s\n", n_probes, n_buffers,
+      GST_TIME_ARGS (end - start),
+      (gdouble) n_buffers * GST_SECOND / (end - start));
+
+  gst_pad_set_active (src, FALSE);
+  gst_pad_set_active (sink, FALSE);
+  gst_object_unref (src);
+  gst_object_unref (sink);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint64 n_buffers = DEFAULT_BUFFERS;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 2) {
+    g_print ("usage: %s [<number of buffers>]\n", argv[0]);
+    exit (-1);
+  }
+  if (argc == 2)
+    n_buffers = g_ascii_strtoull (argv[1], NULL, 10);
+
+  if (n_buffers == 0) {
+    g_print ("number of buffers must be greater than 0\n");
+    exit (-2);
+  }
+
+  run_test (0, n_buffers);
+  run_test (1, n_buffers);
+  run_test (10, n_buffers);
+
+  return 0;
+}
@@ -0,0 +1,150 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gstpollwait.c: measure the latency of gst_poll_wait() with many fds
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Every iteration makes a single fd of the set readable and waits for it,
+ * which is the common case of a multisocketsink or udpsrc with many idle
+ * sockets. Run it once with GST_POLL_MODE=ppoll and once with
+ * GST_POLL_MODE=epoll to compare the backends. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <gst/gst.h>
+
+#define DEFAULT_ITERATIONS 10000
+
+static void
+raise_fd_limit (guint n_fds)
+{
+  struct rlimit rl;
+
+  if (getrlimit (RLIMIT_NOFILE, &rl) < 0)
+    return;
+
+  /* two sockets per fd plus some slack */
+  if (rl.rlim_cur < 2 * n_fds + 64 && rl.rlim_cur < rl.rlim_max) {
+    rl.rlim_cur = MIN (rl.rlim_max, 2 * n_fds + 64);
+    setrlimit (RLIMIT_NOFILE, &rl);
+  }
+}
+
+static gboolean
+run_test (guint n_fds, guint iterations)
+{
+  GstPoll *set;
+  GstPollFD *fds;
+  gint *writers;
+  GstClockTime start, end;
+  guint i, created = 0;
+  gboolean ret = FALSE;
+
+  raise_fd_limit (n_fds);
+
+  set = gst_poll_new (TRUE);
+  fds = g_new0 (GstPollFD, n_fds);
+  writers = g_new0 (gint, n_fds);
+
+  for (i = 0; i < n_fds; i++) {
+    gint sv[2];
+
+    if (socketpair (PF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+      g_printerr ("could not create %u socket pairs, raise the fd limit\n",
+          n_fds);
+      goto done;
+    }
+
+    gst_poll_fd_init (&fds[i]);
+    fds[i].fd = sv[0];
+    writers[i] = sv[1];
+    created++;
+
+    gst_poll_add_fd (set, &fds[i]);
+    gst_poll_fd_ctl_read (set, &fds[i], TRUE);
+  }
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++) {
+    guint n = (i * 7919) % n_fds;
+    gchar c = 'x';
+
+    if (write (writers[n], &c, 1) != 1)
+      goto done;
+
+    if (gst_poll_wait (set, GST_CLOCK_TIME_NONE) != 1)
+      goto done;
+
+    if (!gst_poll_fd_can_read (set, &fds[n]))
+      goto done;
+
+    if (read (fds[n].fd, &c, 1) != 1)
+      goto done;
+  }
+  end = gst_util_get_timestamp ();
+
+  g_print ("%6u fds: %u waits in %" GST_TIME_FORMAT ", %.2f us per wait\n",
+      n_fds, iterations, GST_TIME_ARGS (end - start),
+      (gdouble) (end - start) / (iterations * 1000.0));
+  ret = TRUE;
+
+done:
+  if (!ret)
+    g_printerr ("%6u fds: test failed\n", n_fds);
+
+  for (i = 0; i < created; i++) {
+    close (fds[i].fd);
+    close (writers[i]);
+  }
+  g_free (fds);
+  g_free (writers);
+  gst_poll_free (set);
+
+  return ret;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  static const guint sizes[] = { 10, 1000, 10000 };
+  const gchar *mode;
+  guint iterations = DEFAULT_ITERATIONS;
+  guint i;
+  gboolean ret = TRUE;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    iterations = atoi (argv[1]);
+
+  if (iterations == 0) {
+    g_printerr ("usage: %s [iterations]\n", argv[0]);
+    return -1;
+  }
+
+  mode = g_getenv ("GST_POLL_MODE");
+  g_print ("GstPoll mode: %s\n", mode ? mode : "auto");
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++)
+    ret &= run_test (sizes[i], iterations);
+
+  return ret ? 0 : -1;
+}
@@ -0,0 +1,141 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gstpoolcontention.c: acquire/release throughput of a contended pool
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Producer threads acquire buffers from a shared pool and hand them over to
+ * consumer threads that release them, like a payloader feeding a network
+ * sink on another thread. The pool is bounded so that producers also hit the
+ * path where they have to wait for a buffer to be released. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define BUFFER_SIZE (1400)
+#define MAX_BUFFERS (64)
+
+static GstBufferPool *pool;
+static GAsyncQueue *handover;
+static guint64 n_per_producer;
+
+static gpointer
+producer_func (gpointer data)
+{
+  guint64 i;
+
+  for (i = 0; i < n_per_producer; i++) {
+    GstBuffer *buf;
+
+    if (gst_buffer_pool_acquire_buffer (pool, &buf, NULL) != GST_FLOW_OK) {
+      g_printerr ("failed to acquire buffer\n");
+      break;
+    }
+    g_async_queue_push (handover, buf);
+  }
+
+  return NULL;
+}
+
+static gpointer
+consumer_func (gpointer data)
+{
+  GstBuffer *buf;
+
+  /* the end of the stream is signalled with the pool itself */
+  while ((buf = g_async_queue_pop (handover)) != (gpointer) pool)
+    gst_buffer_unref (buf);
+
+  return NULL;
+}
+
+static void
+run_test (guint n_threads)
+{
+  GThread **producers, **consumers;
+  GstClockTime start, end;
+  guint64 total;
+  guint i;
+
+  producers = g_new (GThread *, n_threads);
+  consumers = g_new (GThread *, n_threads);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_threads; i++) {
+    consumers[i] = g_thread_new ("consumer", consumer_func, NULL);
+    producers[i] = g_thread_new ("producer", producer_func, NULL);
+  }
+  for (i = 0; i < n_threads; i++)
+    g_thread_join (producers[i]);
+  for (i = 0; i < n_threads; i++)
+    g_async_queue_push (handover, pool);
+  for (i = 0; i < n_threads; i++)
+    g_thread_join (consumers[i]);
+  end = gst_util_get_timestamp ();
+
+  total = n_per_producer * n_threads;
+  g_print ("%2u producers/consumers: %" G_GUINT64_FORMAT " buffers in %"
+      GST_TIME_FORMAT ", %.0f buffers/s\n", n_threads, total,
+      GST_TIME_ARGS (end - start),
+      (gdouble) total * GST_SECOND / (end - start));
+
+  g_free (producers);
+  g_free (consumers);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstStructure *conf;
+  guint n_threads;
+
+  gst_init (&argc, &argv);
+
+  if (argc != 2) {
+    g_print ("usage: %s <nbuffers per thread>\n", argv[0]);
+    exit (-1);
+  }
+
+  n_per_producer = atoi (argv[1]);
+
+  if (n_per_producer <= 0) {
+    g_print ("number of buffers must be greater than 0\n");
+    exit (-3);
+  }
+
+  pool = gst_buffer_pool_new ();
+
+  conf = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (conf, NULL, BUFFER_SIZE, 0, MAX_BUFFERS);
+  gst_buffer_pool_set_config (pool, conf);
+
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  handover = g_async_queue_new ();
+
+  for (n_threads = 1; n_threads <= 8; n_threads *= 2)
+    run_test (n_threads);
+
+  g_async_queue_unref (handover);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gststructurefields.c: field access on structures with many fields
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Builds structures shaped like the statistics of webrtcbin or rtpbin, with
+ * a mix of integer, string and nested structure fields, and measures how
+ * expensive it is to update and read all of them, to serialize and parse
+ * them, and to read the nested structures with and without copying them. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define DEFAULT_ITERATIONS 10000
+
+static GstStructure *
+make_stats (guint n_fields, gchar ** names)
+{
+  GstStructure *s, *nested;
+  guint i;
+
+  s = gst_structure_new_empty ("application/x-rtp-source-stats");
+  nested = gst_structure_new ("nested-stats", "packets", G_TYPE_UINT64,
+      G_GUINT64_CONSTANT (1000), "jitter", G_TYPE_UINT, 10, NULL);
+
+  for (i = 0; i < n_fields; i++) {
+    switch (i % 4) {
+      case 0:
+      case 1:
+        gst_structure_set (s, names[i], G_TYPE_UINT64, (guint64) i, NULL);
+        break;
+      case 2:
+        gst_structure_set (s, names[i], G_TYPE_STRING, "some-identifier",
+            NULL);
+        break;
+      case 3:
+        gst_structure_set (s, names[i], GST_TYPE_STRUCTURE, nested, NULL);
+        break;
+    }
+  }
+  gst_structure_free (nested);
+
+  return s;
+}
+
+static void
+run_test (guint n_fields, guint iterations)
+{
+  GstStructure *s, *parsed;
+  gchar **names, *str;
+  GstClockTime start, end;
+  guint i, j;
+  guint64 sum = 0;
+
+  names = g_new0 (gchar *, n_fields + 1);
+  for (i = 0; i < n_fields; i++)
+    names[i] = g_strdup_printf ("stat-%u", i);
+
+  s = make_stats (n_fields, names);
+
+  /* update every integer field, like an element refreshing its stats */
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++) {
+    for (j = 0; j < n_fields; j += 4)
+      gst_structure_set (s, names[j], G_TYPE_UINT64, (guint64) i, NULL);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%4u fields: set     %8.1f ns per field\n", n_fields,
+      (gdouble) (end - start) / (iterations * ((n_fields + 3) / 4)));
+
+  /* read every integer field */
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++) {
+    for (j = 0; j < n_fields; j += 4) {
+      guint64 v;
+
+      if (gst_structure_get_uint64 (s, names[j], &v))
+        sum += v;
+    }
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%4u fields: get     %8.1f ns per field\n", n_fields,
+      (gdouble) (end - start) / (iterations * ((n_fields + 3) / 4)));
+
+  /* read every nested structure, with a copy and borrowed */
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++) {
+    for (j = 3; j < n_fields; j += 4) {
+      GstStructure *nested;
+
+      if (gst_structure_get (s, names[j], GST_TYPE_STRUCTURE, &nested, NULL)) {
+        sum += gst_structure_n_fields (nested);
+        gst_structure_free (nested);
+      }
+    }
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%4u fields: copy    %8.1f ns per field\n", n_fields,
+      (gdouble) (end - start) / (iterations * MAX (n_fields / 4, 1)));
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++) {
+    for (j = 3; j < n_fields; j += 4) {
+      GstStructure *nested;
+
+      if (gst_structure_get_borrowed (s, names[j], GST_TYPE_STRUCTURE,
+              &nested, NULL))
+        sum += gst_structure_n_fields (nested);
+    }
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%4u fields: borrow  %8.1f ns per field\n", n_fields,
+      (gdouble) (end - start) / (iterations * MAX (n_fields / 4, 1)));
+
+  /* serialization round trip, fewer iterations as this is a lot slower */
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations / 10; i++) {
+    str = gst_structure_to_string (s);
+    parsed = gst_structure_from_string (str, NULL);
+    sum += gst_structure_n_fields (parsed);
+    gst_structure_free (parsed);
+    g_free (str);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%4u fields: string  %8.1f us per round trip\n", n_fields,
+      (gdouble) (end - start) / (MAX (iterations / 10, 1) * 1000.0));
+
+  /* keep the compiler from dropping the reads */
+  if (sum == 0)
+    g_print ("no fields read\n");
+
+  gst_structure_free (s);
+  g_strfreev (names);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  static const guint sizes[] = { 4, 16, 64, 256 };
+  guint iterations = DEFAULT_ITERATIONS;
+  guint i;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    iterations = atoi (argv[1]);
+
+  if (iterations == 0) {
+    g_printerr ("usage: %s [iterations]\n", argv[0]);
+    return -1;
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++)
+    run_test (sizes[i], iterations);
+
+  return 0;
+}
@@ -19,13 +19,99 @@
  * Boston, MA 02110-1301, USA.
  */
 
+/* Without arguments this only initialises GStreamer, e.g. to be run under
+ * perf or time. With a number of runs it runs itself that many times with
+ * a full validation of the registry cache and with GST_REGISTRY_FAST_VALIDATE
+ * set, and reports how long gst_init() took in the child processes. The
+ * registry cache is updated before each series so that the runs themselves
+ * measure a current cache. */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <gst/gst.h>
 
+#define CHILD_ENV "GST_INIT_BENCHMARK_CHILD"
+
+static gboolean
+run_child (const gchar * self, const gchar * fast_validate, gint64 * elapsed)
+{
+  gchar *argv[] = { (gchar *) self, NULL };
+  gchar **envp;
+  gchar *out = NULL;
+  gint status;
+  gboolean ret;
+
+  envp = g_get_environ ();
+  envp = g_environ_setenv (envp, CHILD_ENV, "1", TRUE);
+  envp = g_environ_setenv (envp, "GST_REGISTRY_FAST_VALIDATE", fast_validate,
+      TRUE);
+
+  ret = g_spawn_sync (NULL, argv, envp, G_SPAWN_DEFAULT, NULL, NULL, &out,
+      NULL, &status, NULL) && g_spawn_check_exit_status (status, NULL);
+  if (ret)
+    *elapsed = g_ascii_strtoll (out, NULL, 10);
+
+  g_free (out);
+  g_strfreev (envp);
+
+  return ret;
+}
+
+static void
+run_test (const gchar * self, const gchar * fast_validate, gint n_runs)
+{
+  gint64 elapsed, min = G_MAXINT64, max = 0, total = 0;
+  gint i;
+
+  /* bring the cache, and its manifest, up to date */
+  if (!run_child (self, fast_validate, &elapsed)) {
+    g_print ("failed to run %s\n", self);
+    exit (-2);
+  }
+
+  for (i = 0; i < n_runs; i++) {
+    if (!run_child (self, fast_validate, &elapsed)) {
+      g_print ("failed to run %s\n", self);
+      exit (-2);
+    }
+    min = MIN (min, elapsed);
+    max = MAX (max, elapsed);
+    total += elapsed;
+  }
+
+  g_print ("GST_REGISTRY_FAST_VALIDATE=%-3s: gst_init() min %" GST_TIME_FORMAT
+      ", avg %" GST_TIME_FORMAT ", max %" GST_TIME_FORMAT "\n", fast_validate,
+      GST_TIME_ARGS (min * GST_USECOND),
+      GST_TIME_ARGS (total / n_runs * GST_USECOND),
+      GST_TIME_ARGS (max * GST_USECOND));
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
+  gint64 start;
+  gint n_runs;
+
+  if (g_getenv (CHILD_ENV)) {
+    start = g_get_monotonic_time ();
+    gst_init (&argc, &argv);
+    printf ("%" G_GINT64_FORMAT "\n", g_get_monotonic_time () - start);
+    return 0;
+  }
+
   gst_init (&argc, &argv);
 
+  if (argc < 2)
+    return 0;
+
+  n_runs = atoi (argv[1]);
+  if (n_runs <= 0) {
+    g_print ("usage: %s [<number of runs>]\n", argv[0]);
+    exit (-1);
+  }
+
+  run_test (argv[0], "no", n_runs);
+  run_test (argv[0], "yes", n_runs);
+
   return 0;
 }
@@ -330,6 +330,149 @@ GST_START_TEST (test_seeking)
 
 GST_END_TEST;
 
+GST_START_TEST (test_write_behind)
+{
+  GstElement *filesink;
+  GstStructure *stats;
+  gchar *tmp_fn;
+  GstSegment segment;
+  guint64 writes, queued_bytes, max_queued_bytes;
+
+  tmp_fn = create_temporary_file ();
+  if (tmp_fn == NULL)
+    return;
+  filesink = setup_filesink ();
+
+  GST_LOG ("using temp file '%s'", tmp_fn);
+  g_object_set (filesink, "location", tmp_fn, "write-behind", TRUE,
+      "write-behind-size", 1000, "sync-interval", GST_MSECOND, NULL);
+  gst_util_set_object_arg (G_OBJECT (filesink), "buffer-mode", "unbuffered");
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_stream_start ("test")));
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* the position is updated as soon as the data is queued */
+  PUSH_BYTES (100);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 100);
+
+  PUSH_BYTES (8800);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 8900);
+
+  PUSH_BUFFER_LIST (2, 50);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 9000);
+
+  PUSH_BUFFER_WITH_MULTIPLE_MEM_BLOCKS (2, 20);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 9040);
+
+  /* seeking waits for the queued data to be written first */
+  segment.start = 8900;
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 8900);
+  CHECK_WRITTEN_BYTES (0, 100, 9040);
+  CHECK_WRITTEN_BYTES (100, 8800, 9040);
+
+  PUSH_BYTES (1234);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 10134);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* everything is written once EOS was handled */
+  CHECK_WRITTEN_BYTES (8900, 1234, 10134);
+
+  g_object_get (filesink, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "writes", &writes));
+  fail_unless (gst_structure_get_uint64 (stats, "queued-bytes",
+          &queued_bytes));
+  fail_unless (gst_structure_get_uint64 (stats, "max-queued-bytes",
+          &max_queued_bytes));
+  fail_unless_equals_uint64 (writes, 5);
+  fail_unless_equals_uint64 (queued_bytes, 0);
+  fail_unless (max_queued_bytes > 0);
+  gst_structure_free (stats);
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  cleanup_filesink (filesink);
+
+  CHECK_WRITTEN_BYTES (0, 100, 10134);
+  CHECK_WRITTEN_BYTES (8900, 1234, 10134);
+
+  g_remove (tmp_fn);
+  g_free (tmp_fn);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_write_behind_error)
+{
+  GstElement *filesink;
+  GstSegment segment;
+  GstFlowReturn flow = GST_FLOW_OK;
+  gchar *tmp_fn;
+  guint n;
+
+  /* every write to it fails with ENOSPC */
+  if (!g_file_test ("/dev/full", G_FILE_TEST_EXISTS))
+    return;
+
+  tmp_fn = create_temporary_file ();
+  if (tmp_fn == NULL)
+    return;
+  filesink = setup_filesink ();
+
+  g_object_set (filesink, "location", "/dev/full", "write-behind", TRUE,
+      "write-behind-size", 1000, NULL);
+  gst_util_set_object_arg (G_OBJECT (filesink), "buffer-mode", "unbuffered");
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_stream_start ("test")));
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* the queue only has room for one buffer, so the write error shows up
+   * when pushing one of the next ones */
+  for (n = 0; n < 10 && flow == GST_FLOW_OK; n++)
+    flow = gst_pad_push (mysrcpad, gst_buffer_new_and_alloc (1000));
+  fail_unless_equals_int (flow, GST_FLOW_ERROR);
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  /* the error is not carried over to the next run */
+  g_object_set (filesink, "location", tmp_fn, NULL);
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_stream_start ("test")));
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  PUSH_BYTES (100);
+  PUSH_BYTES (1234);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  cleanup_filesink (filesink);
+
+  CHECK_WRITTEN_BYTES (0, 100, 1334);
+  CHECK_WRITTEN_BYTES (100, 1234, 1334);
+
+  g_remove (tmp_fn);
+  g_free (tmp_fn);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_flush)
 {
   GstElement *filesink;
@@ -577,6 +720,8 @@ filesink_suite (void)
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_flush);
+  tcase_add_test (tc_chain, test_write_behind);
+  tcase_add_test (tc_chain, test_write_behind_error);
   tcase_add_test (tc_chain, test_buffered_write_17_1);
   tcase_add_test (tc_chain, test_buffered_write_9_2);
   tcase_add_test (tc_chain, test_buffered_write_6_3);
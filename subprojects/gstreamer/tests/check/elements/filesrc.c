@@ -303,6 +303,81 @@ GST_START_TEST (test_pull)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_mmap)
+{
+  GstElement *src;
+  GstPad *pad;
+  GstFlowReturn ret;
+  GstBuffer *buffer1, *buffer2, *buffer3;
+  GstMapInfo info;
+  gchar *contents;
+  gsize length;
+  gboolean use_mmap;
+
+  fail_unless (g_file_get_contents (TESTFILE, &contents, &length, NULL));
+  fail_unless (length > 100);
+
+  src = setup_filesrc ();
+
+  g_object_set (G_OBJECT (src), "location", TESTFILE, "use-mmap", TRUE, NULL);
+  g_object_get (G_OBJECT (src), "use-mmap", &use_mmap, NULL);
+  fail_unless (use_mmap == TRUE);
+
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to ready");
+
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (pad != NULL);
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  /* read the start of the file */
+  buffer1 = NULL;
+  ret = gst_pad_get_range (pad, 0, 100, &buffer1);
+  fail_unless (ret == GST_FLOW_OK);
+  fail_unless (buffer1 != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffer1), 100);
+  fail_unless_equals_int (GST_BUFFER_OFFSET (buffer1), 0);
+  fail_unless_equals_int (GST_BUFFER_OFFSET_END (buffer1), 100);
+
+  /* read past the end of the file, should be truncated */
+  buffer2 = NULL;
+  ret = gst_pad_get_range (pad, length - 10, 20, &buffer2);
+  fail_unless (ret == GST_FLOW_OK);
+  fail_unless (buffer2 != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffer2), 10);
+
+  /* and at the end of the file */
+  buffer3 = NULL;
+  ret = gst_pad_get_range (pad, length, 10, &buffer3);
+  fail_unless (ret == GST_FLOW_EOS);
+  fail_unless (buffer3 == NULL);
+
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+  gst_object_unref (pad);
+  cleanup_filesrc (src);
+
+  /* the buffers must stay valid after the element was shut down */
+  fail_unless (gst_buffer_map (buffer1, &info, GST_MAP_READ));
+  fail_unless (memcmp (info.data, contents, 100) == 0);
+  gst_buffer_unmap (buffer1, &info);
+
+  fail_unless (gst_buffer_map (buffer2, &info, GST_MAP_READ));
+  fail_unless (memcmp (info.data, contents + length - 10, 10) == 0);
+  gst_buffer_unmap (buffer2, &info);
+
+  gst_buffer_unref (buffer1);
+  gst_buffer_unref (buffer2);
+  g_free (contents);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_coverage)
 {
   GstElement *src;
@@ -554,6 +629,7 @@ filesrc_suite (void)
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_pull);
+  tcase_add_test (tc_chain, test_pull_mmap);
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_uri_query);
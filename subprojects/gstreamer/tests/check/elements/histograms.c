@@ -0,0 +1,497 @@
+/* GStreamer
+ *
+ * Unit test for the histograms tracer
+ *
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next) {
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+  }
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+static GstElement *
+run_pipeline (const gchar * description)
+{
+  GstElement *pipe;
+  GstMessage *m;
+
+  pipe = gst_parse_launch (description, NULL);
+  fail_unless (pipe);
+
+  fail_unless (gst_element_set_state (pipe, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (m), GST_MESSAGE_EOS);
+  gst_message_unref (m);
+
+  return pipe;
+}
+
+static void
+stop_pipeline (GstElement * pipe)
+{
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+/* A minimal JSON parser for the output of the tracer, there is no JSON
+ * library in the dependencies of the core. Objects become structures,
+ * arrays become GST_TYPE_ARRAY values and numbers, which are all unsigned
+ * integers, become guint64 values. */
+static gboolean parse_json_value (const gchar ** p, GValue * value);
+
+static void
+skip_json_whitespace (const gchar ** p)
+{
+  while (g_ascii_isspace (**p))
+    (*p)++;
+}
+
+static gchar *
+parse_json_string (const gchar ** p)
+{
+  GString *str;
+
+  if (**p != '"')
+    return NULL;
+  (*p)++;
+
+  str = g_string_new (NULL);
+  while (**p != '"') {
+    if (**p == '\0')
+      goto error;
+
+    if (**p == '\\') {
+      (*p)++;
+      if (**p == 'u') {
+        gchar hex[5] = { 0, };
+        guint i;
+
+        for (i = 0; i < 4; i++) {
+          if (!g_ascii_isxdigit ((*p)[i + 1]))
+            goto error;
+          hex[i] = (*p)[i + 1];
+        }
+        g_string_append_unichar (str, g_ascii_strtoull (hex, NULL, 16));
+        *p += 5;
+        continue;
+      }
+      if (**p != '"' && **p != '\\' && **p != '/')
+        goto error;
+    }
+    g_string_append_c (str, **p);
+    (*p)++;
+  }
+  (*p)++;
+
+  return g_string_free (str, FALSE);
+
+error:
+  g_string_free (str, TRUE);
+  return NULL;
+}
+
+static gboolean
+parse_json_object (const gchar ** p, GValue * value)
+{
+  GstStructure *s;
+
+  (*p)++;
+  s = gst_structure_new_empty ("object");
+  skip_json_whitespace (p);
+  if (**p == '}') {
+    (*p)++;
+    goto done;
+  }
+
+  while (TRUE) {
+    GValue field = G_VALUE_INIT;
+    gchar *name;
+
+    skip_json_whitespace (p);
+    if ((name = parse_json_string (p)) == NULL)
+      goto error;
+    skip_json_whitespace (p);
+    if (**p != ':') {
+      g_free (name);
+      goto error;
+    }
+    (*p)++;
+    if (!parse_json_value (p, &field)) {
+      g_free (name);
+      goto error;
+    }
+    /* no duplicate keys */
+    if (gst_structure_has_field (s, name)) {
+      g_free (name);
+      g_value_unset (&field);
+      goto error;
+    }
+    gst_structure_take_value (s, name, &field);
+    g_free (name);
+
+    skip_json_whitespace (p);
+    if (**p == '}') {
+      (*p)++;
+      break;
+    }
+    if (**p != ',')
+      goto error;
+    (*p)++;
+  }
+
+done:
+  g_value_init (value, GST_TYPE_STRUCTURE);
+  g_value_take_boxed (value, s);
+  return TRUE;
+
+error:
+  gst_structure_free (s);
+  return FALSE;
+}
+
+static gboolean
+parse_json_array (const gchar ** p, GValue * value)
+{
+  (*p)++;
+  g_value_init (value, GST_TYPE_ARRAY);
+  skip_json_whitespace (p);
+  if (**p == ']') {
+    (*p)++;
+    return TRUE;
+  }
+
+  while (TRUE) {
+    GValue item = G_VALUE_INIT;
+
+    if (!parse_json_value (p, &item))
+      goto error;
+    gst_value_array_append_and_take_value (value, &item);
+
+    skip_json_whitespace (p);
+    if (**p == ']') {
+      (*p)++;
+      return TRUE;
+    }
+    if (**p != ',')
+      goto error;
+    (*p)++;
+  }
+
+error:
+  g_value_unset (value);
+  return FALSE;
+}
+
+static gboolean
+parse_json_value (const gchar ** p, GValue * value)
+{
+  skip_json_whitespace (p);
+
+  switch (**p) {
+    case '{':
+      return parse_json_object (p, value);
+    case '[':
+      return parse_json_array (p, value);
+    case '"':{
+      gchar *str = parse_json_string (p);
+
+      if (str == NULL)
+        return FALSE;
+      g_value_init (value, G_TYPE_STRING);
+      g_value_take_string (value, str);
+      return TRUE;
+    }
+    default:{
+      gchar *end;
+      guint64 number;
+
+      if (!g_ascii_isdigit (**p))
+        return FALSE;
+      number = g_ascii_strtoull (*p, &end, 10);
+      *p = end;
+      g_value_init (value, G_TYPE_UINT64);
+      g_value_set_uint64 (value, number);
+      return TRUE;
+    }
+  }
+}
+
+/* parses the whole document, which has to be an object */
+static GstStructure *
+parse_json (const gchar * json)
+{
+  GValue value = G_VALUE_INIT;
+  GstStructure *s;
+  const gchar *p = json;
+
+  if (!parse_json_value (&p, &value))
+    fail ("invalid JSON at offset %d: %s", (gint) (p - json), json);
+  skip_json_whitespace (&p);
+  if (*p != '\0')
+    fail ("trailing data at offset %d: %s", (gint) (p - json), json);
+  fail_unless (G_VALUE_HOLDS (&value, GST_TYPE_STRUCTURE));
+
+  s = g_value_dup_boxed (&value);
+  g_value_unset (&value);
+
+  return s;
+}
+
+static guint64
+get_json_number (const GstStructure * s, const gchar * name)
+{
+  guint64 number;
+
+  if (!gst_structure_get_uint64 (s, name, &number))
+    fail ("no number \"%s\" in %" GST_PTR_FORMAT, name, s);
+
+  return number;
+}
+
+static const GstStructure *
+get_json_object (const GValue * value)
+{
+  fail_unless (G_VALUE_HOLDS (value, GST_TYPE_STRUCTURE));
+  return gst_value_get_structure (value);
+}
+
+static const GstStructure *
+find_pad (const GstStructure * json, const gchar * name)
+{
+  const GValue *pads = gst_structure_get_value (json, "pads");
+  guint i;
+
+  fail_unless (pads != NULL && GST_VALUE_HOLDS_ARRAY (pads));
+  for (i = 0; i < gst_value_array_get_size (pads); i++) {
+    const GstStructure *pad =
+        get_json_object (gst_value_array_get_value (pads, i));
+
+    if (g_strcmp0 (gst_structure_get_string (pad, "pad"), name) == 0)
+      return pad;
+  }
+
+  return NULL;
+}
+
+/* checks that the summary of a histogram agrees with its buckets */
+static guint64
+check_histogram (const GValue * value)
+{
+  const GstStructure *h = get_json_object (value);
+  const GValue *buckets;
+  guint64 count, min, max, sum = 0, prev_upper = 0;
+  guint i;
+
+  count = get_json_number (h, "count");
+  min = get_json_number (h, "min");
+  max = get_json_number (h, "max");
+  fail_unless (count > 0);
+  fail_unless (min <= max);
+  fail_unless (get_json_number (h, "mean") >= min);
+  fail_unless (get_json_number (h, "mean") <= max);
+  fail_unless (get_json_number (h, "p50") <= get_json_number (h, "p90"));
+  fail_unless (get_json_number (h, "p90") <= get_json_number (h, "p99"));
+  fail_unless (get_json_number (h, "p99") <= get_json_number (h, "p999"));
+  fail_unless (get_json_number (h, "p999") <= max);
+
+  buckets = gst_structure_get_value (h, "buckets");
+  fail_unless (buckets != NULL && GST_VALUE_HOLDS_ARRAY (buckets));
+  fail_unless (gst_value_array_get_size (buckets) > 0);
+  for (i = 0; i < gst_value_array_get_size (buckets); i++) {
+    const GValue *bucket = gst_value_array_get_value (buckets, i);
+    guint64 lower, upper, n;
+
+    /* [lower, upper, count] of the non-empty buckets, in order */
+    fail_unless (GST_VALUE_HOLDS_ARRAY (bucket));
+    fail_unless_equals_int (gst_value_array_get_size (bucket), 3);
+    lower = g_value_get_uint64 (gst_value_array_get_value (bucket, 0));
+    upper = g_value_get_uint64 (gst_value_array_get_value (bucket, 1));
+    n = g_value_get_uint64 (gst_value_array_get_value (bucket, 2));
+
+    fail_unless (lower <= upper);
+    fail_unless (i == 0 || lower > prev_upper);
+    fail_unless (n > 0);
+    if (i == 0)
+      fail_unless (lower <= min && min <= upper);
+    prev_upper = upper;
+    sum += n;
+  }
+  fail_unless (max <= prev_upper);
+  fail_unless_equals_uint64 (sum, count);
+
+  return count;
+}
+
+static gboolean
+check_pad_histogram (GQuark field_id, const GValue * value, gpointer user_data)
+{
+  if (field_id != g_quark_from_static_string ("pad"))
+    check_histogram (value);
+
+  return TRUE;
+}
+
+GST_START_TEST (test_get_json)
+{
+  GstElement *pipe;
+  GstTracer *tracer;
+  GstStructure *s;
+  const GstStructure *pad, *h;
+  const GValue *pads;
+  gchar *json = NULL;
+  guint i;
+
+  pipe = run_pipeline ("fakesrc name=src num-buffers=20 sizetype=fixed "
+      "sizemax=100 ! queue name=q ! fakesink sync=false");
+
+  tracer = get_tracer_by_name ("hist");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-json", &json);
+  fail_unless (json);
+  GST_INFO ("histograms: %s", json);
+
+  s = parse_json (json);
+  fail_unless (get_json_number (s, "timestamp") > 0);
+
+  /* every histogram of every pad is consistent */
+  pads = gst_structure_get_value (s, "pads");
+  fail_unless (pads != NULL && GST_VALUE_HOLDS_ARRAY (pads));
+  for (i = 0; i < gst_value_array_get_size (pads); i++) {
+    pad = get_json_object (gst_value_array_get_value (pads, i));
+    fail_unless (gst_structure_get_string (pad, "pad") != NULL);
+    gst_structure_foreach (pad, check_pad_histogram, NULL);
+  }
+
+  /* all buffers went through both source pads */
+  pad = find_pad (s, "src:src");
+  fail_unless (pad != NULL);
+  h = get_json_object (gst_structure_get_value (pad, "buffer-size"));
+  fail_unless_equals_uint64 (get_json_number (h, "count"), 20);
+  fail_unless_equals_uint64 (get_json_number (h, "min"), 100);
+  fail_unless_equals_uint64 (get_json_number (h, "max"), 100);
+  fail_unless_equals_uint64 (check_histogram (gst_structure_get_value (pad,
+              "push-duration")), 20);
+  /* the first buffer has no gap to a previous one */
+  fail_unless_equals_uint64 (check_histogram (gst_structure_get_value (pad,
+              "gap")), 19);
+
+  pad = find_pad (s, "q:src");
+  fail_unless (pad != NULL);
+  fail_unless_equals_uint64 (check_histogram (gst_structure_get_value (pad,
+              "buffer-size")), 20);
+  fail_unless_equals_uint64 (check_histogram (gst_structure_get_value (pad,
+              "queue-residency")), 20);
+
+  gst_structure_free (s);
+  g_free (json);
+
+  /* the stats of the pads go away with the pads */
+  stop_pipeline (pipe);
+  g_signal_emit_by_name (tracer, "get-json", &json);
+  s = parse_json (json);
+  fail_unless (find_pad (s, "src:src") == NULL);
+  fail_unless (find_pad (s, "q:src") == NULL);
+
+  gst_structure_free (s);
+  g_free (json);
+  gst_object_unref (tracer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_live_pads)
+{
+  GstElement *pipe;
+  GstTracer *tracer;
+  gchar *json = NULL;
+
+  pipe = run_pipeline ("fakesrc name=src num-buffers=20 sizetype=fixed "
+      "sizemax=100 ! queue name=q ! fakesink sync=false");
+
+  /* query while the pads are still alive */
+  tracer = get_tracer_by_name ("hist");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-json", &json);
+  fail_unless (json);
+  GST_INFO ("histograms: %s", json);
+
+  fail_unless (strstr (json, "\"pad\":\"src:src\"") != NULL);
+  fail_unless (strstr (json, "\"pad\":\"q:src\"") != NULL);
+  fail_unless (strstr (json, "\"buffer-size\":{\"count\":20,"
+          "\"min\":100,\"max\":100") != NULL);
+  fail_unless (strstr (json, "\"queue-residency\":{\"count\":20,") != NULL);
+  fail_unless (strstr (json, "\"push-duration\":") != NULL);
+  fail_unless (strstr (json, "\"gap\":") != NULL);
+
+  /* dumping to the log must not crash */
+  g_signal_emit_by_name (tracer, "dump");
+
+  g_free (json);
+  gst_object_unref (tracer);
+
+  stop_pipeline (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+histogramstracer_suite (void)
+{
+  Suite *s = suite_create ("histogramstracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_get_json);
+  tcase_add_test (tc_chain, test_live_pads);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (histogramstracer); because we need to set
+ * the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+  g_setenv ("GST_TRACERS", "histograms(name=hist)", TRUE);
+  gst_check_init (&argc, &argv);
+  s = histogramstracer_suite ();
+  return gst_check_run_suite (s, "histogramstracer", __FILE__);
+}
@@ -1735,6 +1735,139 @@ GST_START_TEST (test_time_level_before_output)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  GList *buffers;
+  guint n_lists;
+  guint list_sizes[8];
+} ListData;
+
+static GstFlowReturn
+list_data_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  ListData *data = gst_pad_get_element_private (pad);
+
+  g_mutex_lock (&data->lock);
+  data->buffers = g_list_append (data->buffers, buffer);
+  g_cond_broadcast (&data->cond);
+  g_mutex_unlock (&data->lock);
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+list_data_chain_list (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  ListData *data = gst_pad_get_element_private (pad);
+  guint i, len = gst_buffer_list_length (list);
+
+  g_mutex_lock (&data->lock);
+  if (data->n_lists < G_N_ELEMENTS (data->list_sizes))
+    data->list_sizes[data->n_lists] = len;
+  data->n_lists++;
+  for (i = 0; i < len; i++) {
+    data->buffers = g_list_append (data->buffers,
+        gst_buffer_ref (gst_buffer_list_get (list, i)));
+  }
+  g_cond_broadcast (&data->cond);
+  g_mutex_unlock (&data->lock);
+
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+list_data_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  gst_event_unref (event);
+  return TRUE;
+}
+
+GST_START_TEST (test_push_lists)
+{
+  ListData data = { 0, };
+  GstElement *mq;
+  GstPad *mq_sinkpad, *mq_srcpad, *sinkpad;
+  GstBuffer *pushed[10];
+  GstSegment segment;
+  GstCaps *caps;
+  gulong probe_id;
+  guint i;
+
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+
+  mq = gst_element_factory_make ("multiqueue", NULL);
+  g_object_set (mq, "push-lists", TRUE, "max-list-size-buffers", 4,
+      "max-size-buffers", 0, NULL);
+
+  mq_sinkpad = gst_element_request_pad_simple (mq, "sink_%u");
+  mq_srcpad = gst_element_get_static_pad (mq, "src_0");
+
+  sinkpad = gst_pad_new ("dummysink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sinkpad, list_data_chain);
+  gst_pad_set_chain_list_function (sinkpad, list_data_chain_list);
+  gst_pad_set_event_function (sinkpad, list_data_event);
+  gst_pad_set_element_private (sinkpad, &data);
+  fail_unless (gst_pad_link (mq_srcpad, sinkpad) == GST_PAD_LINK_OK);
+  gst_pad_set_active (sinkpad, TRUE);
+
+  /* keep everything queued until all buffers are in */
+  probe_id = gst_pad_add_probe (mq_srcpad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      NULL, NULL, NULL);
+
+  fail_unless (gst_element_set_state (mq,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_send_event (mq_sinkpad, gst_event_new_stream_start ("test"));
+  caps = gst_caps_new_empty_simple ("foo/x-bar");
+  gst_pad_send_event (mq_sinkpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_send_event (mq_sinkpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < G_N_ELEMENTS (pushed); i++) {
+    pushed[i] = gst_buffer_new_and_alloc (4);
+    fail_unless_equals_int (gst_pad_chain (mq_sinkpad, pushed[i]),
+        GST_FLOW_OK);
+  }
+
+  gst_pad_remove_probe (mq_srcpad, probe_id);
+
+  g_mutex_lock (&data.lock);
+  while (g_list_length (data.buffers) < G_N_ELEMENTS (pushed))
+    g_cond_wait (&data.cond, &data.lock);
+  g_mutex_unlock (&data.lock);
+
+  /* the queued buffers come out in lists of at most 4 buffers */
+  fail_unless_equals_int (data.n_lists, 3);
+  fail_unless_equals_int (data.list_sizes[0], 4);
+  fail_unless_equals_int (data.list_sizes[1], 4);
+  fail_unless_equals_int (data.list_sizes[2], 2);
+
+  for (i = 0; i < G_N_ELEMENTS (pushed); i++)
+    fail_unless (g_list_nth_data (data.buffers, i) == pushed[i]);
+
+  fail_unless (gst_element_set_state (mq,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_element_release_request_pad (mq, mq_sinkpad);
+  gst_object_unref (mq_sinkpad);
+  gst_object_unref (mq_srcpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (mq);
+
+  g_list_free_full (data.buffers, (GDestroyNotify) gst_buffer_unref);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+}
+
+GST_END_TEST;
+
 static Suite *
 multiqueue_suite (void)
 {
@@ -1767,6 +1900,7 @@ multiqueue_suite (void)
 
   tcase_add_test (tc_chain, test_stream_status_messages);
   tcase_add_test (tc_chain, test_time_level_before_output);
+  tcase_add_test (tc_chain, test_push_lists);
 
   return s;
 }
@@ -1381,6 +1381,77 @@ GST_START_TEST (test_time_level_before_output)
 
 GST_END_TEST;
 
+static guint n_lists;
+static guint list_sizes[8];
+
+static GstFlowReturn
+chain_list_func (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  guint i, len = gst_buffer_list_length (list);
+
+  if (n_lists < G_N_ELEMENTS (list_sizes))
+    list_sizes[n_lists] = len;
+  n_lists++;
+
+  for (i = 0; i < len; i++)
+    gst_check_chain_func (pad, parent,
+        gst_buffer_ref (gst_buffer_list_get (list, i)));
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+GST_START_TEST (test_push_lists)
+{
+  GstBuffer *pushed[10];
+  GstSegment segment;
+  guint i;
+
+  g_object_set (queue, "push-lists", TRUE, "max-list-size-buffers", 4, NULL);
+  n_lists = 0;
+
+  block_src ();
+
+  UNDERRUN_LOCK ();
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+  UNDERRUN_WAIT ();
+  UNDERRUN_UNLOCK ();
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  /* everything is queued while the srcpad is blocked */
+  for (i = 0; i < G_N_ELEMENTS (pushed); i++) {
+    pushed[i] = gst_buffer_new_and_alloc (4);
+    fail_unless (gst_pad_push (mysrcpad, pushed[i]) == GST_FLOW_OK);
+  }
+
+  UNDERRUN_LOCK ();
+  mysinkpad = setup_sink_pad (queue, &sinktemplate);
+  gst_pad_set_chain_list_function (mysinkpad, chain_list_func);
+  unblock_src ();
+  UNDERRUN_WAIT ();
+  UNDERRUN_UNLOCK ();
+
+  /* the queued buffers come out in lists of at most 4 buffers */
+  fail_unless_equals_int (n_lists, 3);
+  fail_unless_equals_int (list_sizes[0], 4);
+  fail_unless_equals_int (list_sizes[1], 4);
+  fail_unless_equals_int (list_sizes[2], 2);
+
+  fail_unless_equals_int (g_list_length (buffers), G_N_ELEMENTS (pushed));
+  for (i = 0; i < G_N_ELEMENTS (pushed); i++)
+    fail_unless (g_list_nth_data (buffers, i) == pushed[i]);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+}
+
+GST_END_TEST;
+
 static Suite *
 queue_suite (void)
 {
@@ -1406,6 +1477,7 @@ queue_suite (void)
   tcase_add_test (tc_chain, test_initial_events_nodelay);
   tcase_add_test (tc_chain, test_flush_on_error);
   tcase_add_test (tc_chain, test_time_level_before_output);
+  tcase_add_test (tc_chain, test_push_lists);
 
   return s;
 }
@@ -922,6 +922,93 @@ GST_START_TEST (test_time_level_before_output)
 
 GST_END_TEST;
 
+static void
+temp_file_handoff (GstElement * sink, GstBuffer * buf, GstPad * pad,
+    gpointer user_data)
+{
+  guint8 *expected = user_data;
+  GstMapInfo map;
+  gsize i;
+
+  fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+  for (i = 0; i < map.size; i++) {
+    fail_unless_equals_int (map.data[i], *expected);
+    (*expected)++;
+  }
+  gst_buffer_unmap (buf, &map);
+}
+
+static void
+do_test_temp_file (gboolean async, guint64 ring_buffer_max_size)
+{
+  GstElement *pipe, *queue2, *input, *output;
+  GstStructure *stats;
+  GstMessage *msg;
+  guint64 written, pending;
+  gchar *template;
+  guint8 expected = 0;
+
+  pipe = gst_pipeline_new ("pipeline");
+
+  input = gst_element_factory_make ("fakesrc", NULL);
+  fail_unless (input != NULL, "failed to create 'fakesrc' element");
+  /* continuous pattern so that the output can be checked */
+  g_object_set (input, "num-buffers", 256, "sizetype", 2, "sizemax", 4096,
+      "filltype", 5, NULL);
+
+  output = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (output != NULL, "failed to create 'fakesink' element");
+  g_object_set (output, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (output, "handoff", G_CALLBACK (temp_file_handoff),
+      &expected);
+
+  queue2 = setup_queue2 (pipe, input, output);
+  template = g_build_filename (g_get_tmp_dir (), "queue2-test-XXXXXX", NULL);
+  g_object_set (queue2, "temp-template", template, "temp-write-async", async,
+      "temp-write-max-pending", 64 * 1024, "ring-buffer-max-size",
+      ring_buffer_max_size, NULL);
+  g_free (template);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+
+  msg = gst_bus_poll (GST_ELEMENT_BUS (pipe),
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR, -1);
+
+  fail_if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR,
+      "Expected EOS message, got ERROR message");
+  gst_message_unref (msg);
+
+  /* everything was either written already or is still waiting for it */
+  g_object_get (queue2, "temp-stats", &stats, NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-queue2-temp-stats"));
+  fail_unless (gst_structure_get_uint64 (stats, "bytes-written", &written));
+  fail_unless (gst_structure_get_uint64 (stats, "pending-bytes", &pending));
+  fail_unless_equals_uint64 (written + pending, 256 * 4096);
+  fail_unless (gst_structure_has_field (stats, "bytes-read"));
+  fail_unless (gst_structure_has_field (stats, "avg-write-latency"));
+  gst_structure_free (stats);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+}
+
+GST_START_TEST (test_temp_file)
+{
+  do_test_temp_file (FALSE, 0);
+  do_test_temp_file (TRUE, 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_temp_file_ringbuffer)
+{
+  do_test_temp_file (FALSE, 64 * 1024);
+  do_test_temp_file (TRUE, 64 * 1024);
+}
+
+GST_END_TEST;
+
 static Suite *
 queue2_suite (void)
 {
@@ -942,6 +1029,8 @@ queue2_suite (void)
   tcase_add_test (tc_chain, test_ready_paused_buffering_message);
   tcase_add_test (tc_chain, test_flush_on_error);
   tcase_add_test (tc_chain, test_time_level_before_output);
+  tcase_add_test (tc_chain, test_temp_file);
+  tcase_add_test (tc_chain, test_temp_file_ringbuffer);
 
   return s;
 }
@@ -596,6 +596,197 @@ GST_START_TEST (test_flow_aggregation)
 
 GST_END_TEST;
 
+static GMutex slow_lock;
+static GCond slow_cond;
+static gboolean slow_blocked;
+static guint slow_count;
+static gint fast_count;
+
+static GstFlowReturn
+_slow_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  g_mutex_lock (&slow_lock);
+  while (slow_blocked)
+    g_cond_wait (&slow_cond, &slow_lock);
+  slow_count++;
+  g_mutex_unlock (&slow_lock);
+
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+_fast_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  g_atomic_int_inc (&fast_count);
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static gboolean
+_accept_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  gst_event_unref (event);
+  return TRUE;
+}
+
+/* only answers for the caps that reached the pad already */
+static gboolean
+_caps_allocation_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  GstCaps *caps, *current;
+  gboolean res;
+
+  if (GST_QUERY_TYPE (query) != GST_QUERY_ALLOCATION)
+    return FALSE;
+
+  gst_query_parse_allocation (query, &caps, NULL);
+  current = gst_pad_get_current_caps (pad);
+  res = current != NULL && gst_caps_is_equal (current, caps);
+  gst_clear_caps (&current);
+
+  if (res)
+    gst_query_add_allocation_pool (query, NULL, 128, 2, 0);
+
+  return res;
+}
+
+/* a blocked branch must not delay the other one when async-branches is
+ * enabled, and only keeps max-size-buffers around */
+GST_START_TEST (test_async_branches_leaky)
+{
+  GstPad *mysrc, *mysink1, *mysink2;
+  GstPad *teesink, *teesrc1, *teesrc2;
+  GstElement *tee;
+  GstStructure *stats;
+  GstSegment segment;
+  GstQuery *query;
+  GstCaps *caps;
+  guint64 pushed, dropped;
+  guint size, min;
+  gint i;
+
+  slow_blocked = TRUE;
+  slow_count = 0;
+  fast_count = 0;
+
+  tee = gst_element_factory_make ("tee", NULL);
+  fail_unless (tee != NULL);
+  g_object_set (tee, "async-branches", TRUE, NULL);
+  teesink = gst_element_get_static_pad (tee, "sink");
+  fail_unless (teesink != NULL);
+  teesrc1 = gst_element_request_pad_simple (tee, "src_%u");
+  fail_unless (teesrc1 != NULL);
+  teesrc2 = gst_element_request_pad_simple (tee, "src_%u");
+  fail_unless (teesrc2 != NULL);
+  g_object_set (teesrc2, "max-size-buffers", 2, "leaky", 2, NULL);
+
+  mysink1 = gst_pad_new ("mysink1", GST_PAD_SINK);
+  gst_pad_set_chain_function (mysink1, _fast_chain);
+  gst_pad_set_event_function (mysink1, _accept_event);
+  gst_pad_set_query_function (mysink1, _caps_allocation_query);
+  gst_pad_set_active (mysink1, TRUE);
+
+  mysink2 = gst_pad_new ("mysink2", GST_PAD_SINK);
+  gst_pad_set_chain_function (mysink2, _slow_chain);
+  gst_pad_set_event_function (mysink2, _accept_event);
+  gst_pad_set_query_function (mysink2, _caps_allocation_query);
+  gst_pad_set_active (mysink2, TRUE);
+
+  mysrc = gst_pad_new ("mysrc", GST_PAD_SRC);
+  gst_pad_set_active (mysrc, TRUE);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrc, gst_event_new_stream_start ("test"));
+  caps = gst_caps_new_empty_simple ("test/test");
+  gst_pad_push_event (mysrc, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+  gst_pad_push_event (mysrc, gst_event_new_segment (&segment));
+
+  fail_unless (gst_pad_link (mysrc, teesink) == GST_PAD_LINK_OK);
+  fail_unless (gst_pad_link (teesrc1, mysink1) == GST_PAD_LINK_OK);
+  fail_unless (gst_pad_link (teesrc2, mysink2) == GST_PAD_LINK_OK);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  /* does not block although the second branch does */
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_int (gst_pad_push (mysrc, gst_buffer_new ()),
+        GST_FLOW_OK);
+
+  g_mutex_lock (&slow_lock);
+  slow_blocked = FALSE;
+  g_cond_signal (&slow_cond);
+  g_mutex_unlock (&slow_lock);
+
+  /* waits for the branches to handle all queued buffers */
+  query = gst_query_new_drain ();
+  gst_pad_peer_query (mysrc, query);
+  gst_query_unref (query);
+
+  fail_unless_equals_int (g_atomic_int_get (&fast_count), 10);
+
+  g_object_get (teesrc2, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "pushed", &pushed));
+  fail_unless (gst_structure_get_uint64 (stats, "dropped", &dropped));
+  gst_structure_free (stats);
+
+  /* one buffer was being pushed and two were queued while blocked */
+  fail_unless (dropped >= 7);
+  fail_unless_equals_uint64 (pushed + dropped, 10);
+  fail_unless_equals_int (slow_count, pushed);
+
+  /* a caps change is queued behind the buffers of the blocked branch, the
+   * allocation query must only be answered once it reached downstream */
+  g_mutex_lock (&slow_lock);
+  slow_blocked = TRUE;
+  g_mutex_unlock (&slow_lock);
+
+  for (i = 0; i < 2; i++)
+    fail_unless_equals_int (gst_pad_push (mysrc, gst_buffer_new ()),
+        GST_FLOW_OK);
+
+  caps = gst_caps_new_empty_simple ("test/other");
+  fail_unless (gst_pad_push_event (mysrc, gst_event_new_caps (caps)));
+
+  g_mutex_lock (&slow_lock);
+  slow_blocked = FALSE;
+  g_cond_signal (&slow_cond);
+  g_mutex_unlock (&slow_lock);
+
+  query = gst_query_new_allocation (caps, TRUE);
+  fail_unless (gst_pad_peer_query (mysrc, query));
+  fail_unless_equals_int (gst_query_get_n_allocation_pools (query), 1);
+  gst_query_parse_nth_allocation_pool (query, 0, NULL, &size, &min, NULL);
+  fail_unless_equals_int (size, 128);
+  /* downstream minimum, the queue of the deepest branch and the one buffer
+   * for multiplexing */
+  fail_unless_equals_int (min, 2 + 200 + 1);
+  gst_query_unref (query);
+  gst_caps_unref (caps);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  fail_unless (gst_pad_unlink (mysrc, teesink) == TRUE);
+  fail_unless (gst_pad_unlink (teesrc1, mysink1) == TRUE);
+  fail_unless (gst_pad_unlink (teesrc2, mysink2) == TRUE);
+
+  gst_object_unref (teesink);
+  gst_object_unref (teesrc1);
+  gst_object_unref (teesrc2);
+  gst_element_release_request_pad (tee, teesrc1);
+  gst_element_release_request_pad (tee, teesrc2);
+  gst_object_unref (tee);
+
+  gst_object_unref (mysink1);
+  gst_object_unref (mysink2);
+  gst_object_unref (mysrc);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_request_pads)
 {
   GstElement *tee;
@@ -957,6 +1148,7 @@ tee_suite (void)
   tcase_add_test (tc_chain, test_release_while_second_buffer_alloc);
   tcase_add_test (tc_chain, test_internal_links);
   tcase_add_test (tc_chain, test_flow_aggregation);
+  tcase_add_test (tc_chain, test_async_branches_leaky);
   tcase_add_test (tc_chain, test_request_pads);
   tcase_add_test (tc_chain, test_allow_not_linked);
   tcase_add_test (tc_chain, test_allocation_query_aggregation);
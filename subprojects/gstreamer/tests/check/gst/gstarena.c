@@ -0,0 +1,311 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gstarena.c: Unit tests for the GST_MINIOBJECT_ARENA allocator
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+/* small magazines, so that blocks move through the depot all the time */
+#define ARENA_BLOCKS "4"
+
+#define N_OBJECTS 1000
+#define N_ROUNDS 3
+
+static GstEvent *
+create_event (guint i)
+{
+  return gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+      gst_structure_new ("arena-test", "index", G_TYPE_UINT, i,
+          "name", G_TYPE_STRING, "arena", NULL));
+}
+
+static void
+check_event (GstEvent * event, guint i)
+{
+  const GstStructure *s;
+  guint index;
+
+  fail_unless (GST_IS_EVENT (event));
+  s = gst_event_get_structure (event);
+  fail_unless (gst_structure_has_name (s, "arena-test"));
+  fail_unless (gst_structure_get_uint (s, "index", &index));
+  fail_unless_equals_int (index, i);
+  fail_unless_equals_string (gst_structure_get_string (s, "name"), "arena");
+}
+
+static GstQuery *
+create_query (guint i)
+{
+  GstQuery *query;
+
+  query = gst_query_new_position (GST_FORMAT_TIME);
+  gst_query_set_position (query, GST_FORMAT_TIME, i * GST_SECOND);
+
+  return query;
+}
+
+static void
+check_query (GstQuery * query, guint i)
+{
+  GstFormat format;
+  gint64 position;
+
+  fail_unless (GST_IS_QUERY (query));
+  fail_unless_equals_int (GST_QUERY_TYPE (query), GST_QUERY_POSITION);
+  gst_query_parse_position (query, &format, &position);
+  fail_unless_equals_int (format, GST_FORMAT_TIME);
+  fail_unless_equals_uint64 (position, i * GST_SECOND);
+}
+
+static void
+push_objects (GAsyncQueue * queue)
+{
+  guint i;
+
+  for (i = 0; i < N_OBJECTS; i++) {
+    g_async_queue_push (queue, create_event (i));
+    g_async_queue_push (queue, create_query (i));
+  }
+}
+
+static void
+pop_objects (GAsyncQueue * queue)
+{
+  guint i;
+
+  for (i = 0; i < N_OBJECTS; i++) {
+    GstEvent *event;
+    GstQuery *query;
+
+    event = g_async_queue_pop (queue);
+    check_event (event, i);
+    gst_event_unref (event);
+
+    query = g_async_queue_pop (queue);
+    check_query (query, i);
+    gst_query_unref (query);
+  }
+}
+
+static gpointer
+push_objects_thread (GAsyncQueue * queue)
+{
+  push_objects (queue);
+  return NULL;
+}
+
+static gpointer
+pop_objects_thread (GAsyncQueue * queue)
+{
+  pop_objects (queue);
+  return NULL;
+}
+
+GST_START_TEST (test_free_other_thread)
+{
+  GAsyncQueue *queue;
+  GThread *thread;
+  guint round;
+
+  queue = g_async_queue_new ();
+
+  for (round = 0; round < N_ROUNDS; round++) {
+    /* allocated on the other thread, freed here */
+    thread = g_thread_new ("arena-push", (GThreadFunc) push_objects_thread,
+        queue);
+    pop_objects (queue);
+    g_thread_join (thread);
+
+    /* allocated here, freed on the other thread */
+    thread = g_thread_new ("arena-pop", (GThreadFunc) pop_objects_thread,
+        queue);
+    push_objects (queue);
+    g_thread_join (thread);
+  }
+
+  g_async_queue_unref (queue);
+}
+
+GST_END_TEST;
+
+static GPrivate exit_event = G_PRIVATE_INIT ((GDestroyNotify) gst_event_unref);
+
+static gpointer
+create_and_exit_thread (gpointer data)
+{
+  GPtrArray *events;
+  guint i;
+
+  events = g_ptr_array_new ();
+  for (i = 0; i < N_OBJECTS; i++)
+    g_ptr_array_add (events, create_event (i));
+
+  /* leave some free blocks in the cache of this thread */
+  for (i = 0; i < N_OBJECTS / 2; i++)
+    gst_event_unref (create_event (i));
+
+  /* freed by a thread-local destructor, which can run after the arena cache
+   * of this thread was already freed */
+  g_private_set (&exit_event, create_event (N_OBJECTS));
+
+  return events;
+}
+
+GST_START_TEST (test_thread_exit)
+{
+  GPtrArray *events;
+  GThread *thread;
+  guint round, i;
+
+  for (round = 0; round < N_ROUNDS; round++) {
+    thread = g_thread_new ("arena-exit", create_and_exit_thread, NULL);
+    events = g_thread_join (thread);
+
+    /* the objects outlive the thread that allocated them */
+    fail_unless_equals_int (events->len, N_OBJECTS);
+    for (i = 0; i < events->len; i++) {
+      check_event (g_ptr_array_index (events, i), i);
+      gst_event_unref (g_ptr_array_index (events, i));
+    }
+    g_ptr_array_free (events, TRUE);
+  }
+
+  /* the blocks of the exited threads can be used again */
+  for (i = 0; i < N_OBJECTS; i++) {
+    GstEvent *event = create_event (i);
+
+    check_event (event, i);
+    gst_event_unref (event);
+  }
+}
+
+GST_END_TEST;
+
+#ifndef GST_DISABLE_GST_TRACER_HOOKS
+static GstTracer *
+get_leaks_tracer (void)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next) {
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), "arena-leaks") == 0)
+      tracer = gst_object_ref (l->data);
+  }
+  g_list_free_full (tracers, gst_object_unref);
+
+  return tracer;
+}
+
+static void
+get_arena_usage (GstTracer * tracer, guint * blocks, guint64 * bytes)
+{
+  GstStructure *info;
+
+  g_signal_emit_by_name (tracer, "get-live-objects", &info);
+  fail_unless (gst_structure_get_uint (info, "arena-blocks", blocks));
+  fail_unless (gst_structure_get_uint64 (info, "arena-bytes", bytes));
+  gst_structure_free (info);
+}
+
+static gpointer
+free_structures_thread (GPtrArray * structures)
+{
+  g_ptr_array_free (structures, TRUE);
+  return NULL;
+}
+
+GST_START_TEST (test_leaks_tracer)
+{
+  GstTracer *tracer;
+  GPtrArray *structures;
+  GThread *thread;
+  guint blocks, start_blocks;
+  guint64 bytes, start_bytes;
+  guint i;
+
+  tracer = get_leaks_tracer ();
+  fail_unless (tracer != NULL);
+
+  get_arena_usage (tracer, &start_blocks, &start_bytes);
+
+  /* structures are no mini objects, so they don't show up as live objects
+   * and each of them is exactly one block */
+  structures = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_structure_free);
+  for (i = 0; i < N_OBJECTS; i++) {
+    g_ptr_array_add (structures, gst_structure_new ("arena-test",
+            "index", G_TYPE_UINT, i, NULL));
+  }
+
+  get_arena_usage (tracer, &blocks, &bytes);
+  fail_unless_equals_int (blocks, start_blocks + N_OBJECTS);
+  fail_unless (bytes > start_bytes);
+
+  /* frees on another thread are accounted too */
+  thread = g_thread_new ("arena-free", (GThreadFunc) free_structures_thread,
+      structures);
+  g_thread_join (thread);
+
+  get_arena_usage (tracer, &blocks, &bytes);
+  fail_unless_equals_int (blocks, start_blocks);
+  fail_unless_equals_uint64 (bytes, start_bytes);
+
+  gst_object_unref (tracer);
+}
+
+GST_END_TEST;
+#endif
+
+static Suite *
+gst_arena_suite (void)
+{
+  Suite *s = suite_create ("GstArena");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_free_other_thread);
+  tcase_add_test (tc_chain, test_thread_exit);
+#ifndef GST_DISABLE_GST_TRACER_HOOKS
+  tcase_add_test (tc_chain, test_leaks_tracer);
+#endif
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (gst_arena); because the arena and the
+ * tracers are set up from the environment in gst_init() */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_MINIOBJECT_ARENA", ARENA_BLOCKS, TRUE);
+#ifndef GST_DISABLE_GST_TRACER_HOOKS
+  g_setenv ("GST_TRACERS", "leaks(name=arena-leaks,log-leaks-on-deinit=false)",
+      TRUE);
+#endif
+  gst_check_init (&argc, &argv);
+  s = gst_arena_suite ();
+  return gst_check_run_suite (s, "gst_arena", __FILE__);
+}
@@ -1988,6 +1988,116 @@ GST_START_TEST (test_suppressed_flags_when_removing)
 
 GST_END_TEST;
 
+/* runs fakesrc ! fakesink in @inner inside @pipeline and returns the
+ * stream-status ENTER message of the fakesrc task */
+static GstMessage *
+run_and_get_stream_status_enter (GstElement * pipeline, GstElement * inner)
+{
+  GstElement *src, *sink;
+  GstMessage *msg, *enter = NULL;
+  GstBus *bus;
+
+  src = gst_element_factory_make ("fakesrc", NULL);
+  g_object_set (src, "num-buffers", 1, NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  gst_bin_add_many (GST_BIN (inner), src, sink, NULL);
+  fail_unless (gst_element_link (src, sink));
+
+  bus = gst_element_get_bus (pipeline);
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  while ((msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+              GST_MESSAGE_STREAM_STATUS | GST_MESSAGE_EOS))) {
+    GstStreamStatusType type;
+
+    if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS) {
+      gst_message_unref (msg);
+      break;
+    }
+
+    gst_message_parse_stream_status (msg, &type, NULL);
+    if (type == GST_STREAM_STATUS_TYPE_ENTER && enter == NULL)
+      enter = msg;
+    else
+      gst_message_unref (msg);
+  }
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_bin_remove_many (GST_BIN (inner), src, sink, NULL);
+  gst_object_unref (bus);
+
+  fail_unless (enter != NULL);
+  return enter;
+}
+
+GST_START_TEST (test_cpu_affinity)
+{
+  GstElement *pipeline, *inner, *other;
+  const GstStructure *s;
+  GstMessage *msg;
+  gchar *cpus, *first;
+  guint64 cpu;
+  gint node;
+
+  pipeline = gst_pipeline_new (NULL);
+  inner = gst_bin_new (NULL);
+  gst_bin_add (GST_BIN (pipeline), inner);
+
+  /* nothing is reported when no thread is pinned */
+  msg = run_and_get_stream_status_enter (pipeline, inner);
+  s = gst_message_get_structure (msg);
+  fail_if (gst_structure_has_field (s, "cpu-affinity"));
+  fail_if (gst_structure_has_field (s, "numa-node"));
+  gst_message_unref (msg);
+
+  /* a bin with an affinity somewhere else makes the thread report where it
+   * may run */
+  other = gst_object_ref_sink (gst_bin_new (NULL));
+  g_object_set (other, "cpu-affinity", "0", NULL);
+
+  msg = run_and_get_stream_status_enter (pipeline, inner);
+  s = gst_message_get_structure (msg);
+  cpus = g_strdup (gst_structure_get_string (s, "cpu-affinity"));
+  fail_unless (cpus != NULL);
+  fail_unless (gst_structure_has_field_typed (s, "numa-node", G_TYPE_INT));
+  gst_message_unref (msg);
+
+  /* pin the inner bin to the first of those CPUs, the outer pipeline must
+   * not override that */
+  cpu = g_ascii_strtoull (cpus, NULL, 10);
+  first = g_strdup_printf ("%" G_GUINT64_FORMAT, cpu);
+  g_object_set (inner, "cpu-affinity", first, NULL);
+  g_object_set (pipeline, "cpu-affinity", cpus, NULL);
+
+  msg = run_and_get_stream_status_enter (pipeline, inner);
+  s = gst_message_get_structure (msg);
+  fail_unless_equals_string (gst_structure_get_string (s, "cpu-affinity"),
+      first);
+  fail_unless (gst_structure_get_int (s, "numa-node", &node));
+  /* CPUs 0 and 1 are on node 1 of the fake topology, all others on node 0 */
+  fail_unless_equals_int (node, cpu < 2 ? 1 : 0);
+  gst_message_unref (msg);
+
+  /* without any affinity the reused thread is not pinned anymore */
+  g_object_set (inner, "cpu-affinity", NULL, NULL);
+  g_object_set (pipeline, "cpu-affinity", NULL, NULL);
+
+  msg = run_and_get_stream_status_enter (pipeline, inner);
+  s = gst_message_get_structure (msg);
+  fail_unless_equals_string (gst_structure_get_string (s, "cpu-affinity"),
+      cpus);
+  gst_message_unref (msg);
+
+  g_free (first);
+  g_free (cpus);
+  gst_object_unref (other);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_bin_suite (void)
 {
@@ -2023,6 +2133,10 @@ gst_bin_suite (void)
   tcase_add_test (tc_chain, test_deep_added_removed);
   tcase_add_test (tc_chain, test_suppressed_flags);
   tcase_add_test (tc_chain, test_suppressed_flags_when_removing);
+#ifdef HAVE_SCHED_AFFINITY
+  g_setenv ("GST_NUMA_TOPOLOGY", "2-1023;0-1", TRUE);
+  tcase_add_test (tc_chain, test_cpu_affinity);
+#endif
 
   /* fails on OSX build bot for some reason, and is a bit silly anyway */
   if (0)
@@ -336,6 +336,52 @@ GST_START_TEST (test_no_deadlock_for_buffer_discard)
 
 GST_END_TEST;
 
+#define HANDOVER_BUFFERS 10000
+
+static gpointer
+release_bufs (gpointer p)
+{
+  GAsyncQueue *queue = p;
+  gint i;
+
+  for (i = 0; i < HANDOVER_BUFFERS; i++)
+    gst_buffer_unref (g_async_queue_pop (queue));
+
+  return NULL;
+}
+
+/* acquire on one thread and release on another with a pool that is too small
+ * to never wait, no wakeup must get lost */
+GST_START_TEST (test_acquire_release_threads)
+{
+  GstBufferPool *pool;
+  GAsyncQueue *queue;
+  GThread *thread;
+  gint i;
+
+  pool = create_pool (10, 0, 2);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  queue = g_async_queue_new ();
+  thread = g_thread_new (NULL, release_bufs, queue);
+
+  for (i = 0; i < HANDOVER_BUFFERS; i++) {
+    GstBuffer *buf = NULL;
+
+    fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+            NULL) == GST_FLOW_OK);
+    g_async_queue_push (queue, buf);
+  }
+
+  g_thread_join (thread);
+  g_async_queue_unref (queue);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_parent_meta)
 {
   GstBufferPool *pool;
@@ -463,6 +509,7 @@ gst_buffer_pool_suite (void)
   tcase_add_test (tc_chain, test_pool_config_validate);
   tcase_add_test (tc_chain, test_flushing_pool_returns_flushing);
   tcase_add_test (tc_chain, test_no_deadlock_for_buffer_discard);
+  tcase_add_test (tc_chain, test_acquire_release_threads);
   tcase_add_test (tc_chain, test_parent_meta);
   tcase_add_test (tc_chain, test_make_writable_parent_meta);
 
@@ -1040,6 +1040,56 @@ GST_START_TEST (test_intersect_first2)
 
 GST_END_TEST;
 
+static void
+check_intersect_keeps_list_order (const gchar * str, GstCaps * filter,
+    GstCapsIntersectMode mode)
+{
+  GstCaps *caps, *icaps;
+  gchar *istr;
+
+  caps = gst_caps_from_string (str);
+  icaps = gst_caps_intersect_full (caps, filter, mode);
+  istr = gst_caps_to_string (icaps);
+  GST_LOG ("intersected caps: %s", istr);
+  fail_unless_equals_string (istr, str);
+  g_free (istr);
+  gst_caps_unref (icaps);
+  gst_caps_unref (caps);
+}
+
+GST_START_TEST (test_intersect_list_order)
+{
+  GstCaps *filter;
+  gint i;
+
+  /* tests if the order of list values is maintained, also when the
+   * results are cached with GST_CAPS_CACHE, so every intersection is done
+   * twice and with both orders */
+  filter = gst_caps_from_string
+      ("video/x-raw, format=(string){ YV12, NV12, I420 }");
+
+  for (i = 0; i < 2; i++) {
+    check_intersect_keeps_list_order
+        ("video/x-raw, format=(string){ I420, NV12 }", filter,
+        GST_CAPS_INTERSECT_FIRST);
+    check_intersect_keeps_list_order
+        ("video/x-raw, format=(string){ NV12, I420 }", filter,
+        GST_CAPS_INTERSECT_FIRST);
+    check_intersect_keeps_list_order
+        ("video/x-raw, format=(string){ I420, NV12 }", filter,
+        GST_CAPS_INTERSECT_ZIG_ZAG);
+    check_intersect_keeps_list_order
+        ("video/x-raw, format=(string){ NV12, I420 }", filter,
+        GST_CAPS_INTERSECT_ZIG_ZAG);
+
+    fail_unless (gst_caps_is_subset (filter, filter));
+  }
+
+  gst_caps_unref (filter);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_intersect_duplication)
 {
   GstCaps *c1, *c2, *test;
@@ -1867,6 +1917,7 @@ gst_caps_suite (void)
   tcase_add_test (tc_chain, test_intersect_zigzag);
   tcase_add_test (tc_chain, test_intersect_first);
   tcase_add_test (tc_chain, test_intersect_first2);
+  tcase_add_test (tc_chain, test_intersect_list_order);
   tcase_add_test (tc_chain, test_intersect_duplication);
   tcase_add_test (tc_chain, test_intersect_flagset);
   tcase_add_test (tc_chain, test_union);
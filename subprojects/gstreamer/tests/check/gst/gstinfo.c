@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 #include <string.h>
 
@@ -263,6 +264,62 @@ GST_START_TEST (info_log_handler_get_line)
 
 GST_END_TEST;
 
+static gboolean
+data_contains (const gchar * data, gsize size, const gchar * str)
+{
+  gsize i, len = strlen (str);
+
+  for (i = 0; i + len <= size; i++) {
+    if (memcmp (data + i, str, len) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+static gpointer
+binary_logger_thread_func (gpointer data)
+{
+  GST_DEBUG ("message from another thread");
+  return NULL;
+}
+
+GST_START_TEST (info_binary_logger)
+{
+  gchar *filename, *contents;
+  gsize size;
+  gint fd;
+
+  fd = g_file_open_tmp ("gstreamer-binlog-XXXXXX", &filename, NULL);
+  fail_unless (fd >= 0);
+  g_close (fd, NULL);
+
+  fail_unless (gst_debug_add_binary_logger (filename, 0));
+  gst_debug_set_threshold_from_string ("LOG", TRUE);
+
+  GST_DEBUG ("first test message");
+  g_thread_join (g_thread_new ("logger", binary_logger_thread_func, NULL));
+  GST_LOG ("second test message %d", 2);
+
+  /* writes out all pending messages */
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+  gst_debug_remove_binary_logger ();
+
+  fail_unless (g_file_get_contents (filename, &contents, &size, NULL));
+  fail_unless (size > 20);
+  fail_unless (memcmp (contents, "GSTDBGB", 8) == 0);
+  fail_unless (data_contains (contents, size, "first test message"));
+  fail_unless (data_contains (contents, size, "message from another thread"));
+  fail_unless (data_contains (contents, size, "second test message 2"));
+  fail_unless (data_contains (contents, size, "info_binary_logger"));
+  fail_unless (data_contains (contents, size, "check"));
+
+  g_free (contents);
+  g_unlink (filename);
+  g_free (filename);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (info_dump_mem)
 {
   GstDebugCategory *cat = NULL;
@@ -573,6 +630,7 @@ gst_info_suite (void)
   tcase_add_test (tc_chain, info_ptr_format_printf_extension);
   tcase_add_test (tc_chain, info_log_handler);
   tcase_add_test (tc_chain, info_log_handler_get_line);
+  tcase_add_test (tc_chain, info_binary_logger);
   tcase_add_test (tc_chain, info_dump_mem);
   tcase_add_test (tc_chain, info_fixme);
   tcase_add_test (tc_chain, info_old_printf_extensions);
@@ -0,0 +1,250 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gstmemorynuma.c: Unit tests for system memory placed on NUMA nodes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#if defined(HAVE_MBIND) && defined(HAVE_SYS_MMAN_H) && defined(HAVE_SCHED_AFFINITY)
+#define HAVE_NUMA_SYSMEM 1
+#include <errno.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* blocks of at least this size are placed on a NUMA node */
+#define NUMA_MIN_SIZE 65536
+#define NUMA_MIN_SIZE_STR "65536"
+
+/* every CPU is on node 0, so the node of the allocating thread is always
+ * known, also on machines without NUMA information in sysfs */
+#define NUMA_TOPOLOGY "0-1023"
+
+#define MPOL_PREFERRED 1
+#define MPOL_F_ADDR (1 << 1)
+
+#ifdef HAVE_NUMA_SYSMEM
+static gboolean
+is_page_aligned (gconstpointer ptr)
+{
+  return ((guintptr) ptr & (getpagesize () - 1)) == 0;
+}
+
+static void
+check_memory_policy (gpointer ptr)
+{
+  gulong mask[1024 / (8 * sizeof (gulong))] = { 0, };
+  gint mode = -1;
+
+  /* the system call can be filtered out, like mbind() itself */
+  if (syscall (__NR_get_mempolicy, &mode, mask, (gulong) 1024, ptr,
+          (gulong) MPOL_F_ADDR) != 0) {
+    GST_INFO ("can't get the memory policy of %p: %s", ptr,
+        g_strerror (errno));
+    return;
+  }
+
+  fail_unless_equals_int (mode, MPOL_PREFERRED);
+  fail_unless_equals_uint64 (mask[0], 1);
+}
+
+static void
+check_memory_contents (GstMemory * mem, guint8 value)
+{
+  GstMapInfo info;
+  gsize i;
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  for (i = 0; i < info.size; i++) {
+    if (info.data[i] != value)
+      fail ("byte %" G_GSIZE_FORMAT " is %u, expected %u", i, info.data[i],
+          value);
+  }
+  gst_memory_unmap (mem, &info);
+}
+
+static void
+fill_memory (GstMemory * mem, guint8 value)
+{
+  GstMapInfo info;
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  memset (info.data, value, info.size);
+  gst_memory_unmap (mem, &info);
+}
+
+GST_START_TEST (test_large_blocks)
+{
+  GstMemory *mem, *copy, *sub;
+
+  mem = gst_allocator_alloc (NULL, 4 * NUMA_MIN_SIZE, NULL);
+  fail_unless (mem != NULL);
+  fail_unless (gst_memory_is_type (mem, GST_ALLOCATOR_SYSMEM));
+
+  /* mmapped blocks start at a page, blocks from the heap don't */
+  fail_unless (is_page_aligned (mem));
+  check_memory_policy (mem);
+
+  fill_memory (mem, 0x5a);
+  check_memory_contents (mem, 0x5a);
+
+  /* copies are large enough to be placed too */
+  copy = gst_memory_copy (mem, 0, -1);
+  fail_unless (is_page_aligned (copy));
+  check_memory_contents (copy, 0x5a);
+
+  /* sub memories keep the block of the parent alive */
+  sub = gst_memory_share (mem, NUMA_MIN_SIZE, NUMA_MIN_SIZE);
+  fail_unless (sub->parent == mem);
+  check_memory_contents (sub, 0x5a);
+
+  gst_memory_unref (mem);
+  check_memory_contents (sub, 0x5a);
+  gst_memory_unref (sub);
+  gst_memory_unref (copy);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_small_blocks)
+{
+  GstMemory *mem, *copy;
+
+  /* smaller blocks stay on the heap */
+  mem = gst_allocator_alloc (NULL, NUMA_MIN_SIZE / 4, NULL);
+  fail_unless (mem != NULL);
+  fill_memory (mem, 0xa5);
+
+  copy = gst_memory_copy (mem, 0, -1);
+  check_memory_contents (copy, 0xa5);
+
+  gst_memory_unref (mem);
+  gst_memory_unref (copy);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_params)
+{
+  GstAllocationParams params;
+  GstMemory *mem;
+  GstMapInfo info;
+  gsize maxsize, offset, size, i;
+
+  gst_allocation_params_init (&params);
+  params.flags = GST_MEMORY_FLAG_ZERO_PREFIXED | GST_MEMORY_FLAG_ZERO_PADDED;
+  params.align = 255;
+  params.prefix = 100;
+  params.padding = 200;
+
+  mem = gst_allocator_alloc (NULL, NUMA_MIN_SIZE, &params);
+  fail_unless (mem != NULL);
+  fail_unless (is_page_aligned (mem));
+
+  size = gst_memory_get_sizes (mem, &offset, &maxsize);
+  fail_unless_equals_int (size, NUMA_MIN_SIZE);
+  fail_unless_equals_int (offset, 100);
+  fail_unless (maxsize >= 100 + NUMA_MIN_SIZE + 200);
+
+  fill_memory (mem, 0xff);
+
+  gst_memory_resize (mem, -100, maxsize);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  /* the data pointer honours the alignment */
+  fail_unless (((guintptr) info.data & 255) == 0);
+  for (i = 0; i < 100; i++)
+    fail_unless_equals_int (info.data[i], 0);
+  for (i = 100; i < 100 + NUMA_MIN_SIZE; i++)
+    fail_unless_equals_int (info.data[i], 0xff);
+  for (i = 100 + NUMA_MIN_SIZE; i < 100 + NUMA_MIN_SIZE + 200; i++)
+    fail_unless_equals_int (info.data[i], 0);
+  gst_memory_unmap (mem, &info);
+
+  gst_memory_unref (mem);
+}
+
+GST_END_TEST;
+
+static gpointer
+alloc_thread (gpointer data)
+{
+  GstMemory *mem;
+
+  mem = gst_allocator_alloc (NULL, 2 * NUMA_MIN_SIZE, NULL);
+  fill_memory (mem, GPOINTER_TO_UINT (data));
+
+  return mem;
+}
+
+GST_START_TEST (test_free_other_thread)
+{
+  GThread *threads[4];
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (threads); i++)
+    threads[i] = g_thread_new ("numa-alloc", alloc_thread,
+        GUINT_TO_POINTER (i + 1));
+
+  for (i = 0; i < G_N_ELEMENTS (threads); i++) {
+    GstMemory *mem = g_thread_join (threads[i]);
+
+    fail_unless (is_page_aligned (mem));
+    check_memory_policy (mem);
+    check_memory_contents (mem, i + 1);
+    gst_memory_unref (mem);
+  }
+}
+
+GST_END_TEST;
+#endif
+
+static Suite *
+gst_memory_numa_suite (void)
+{
+  Suite *s = suite_create ("GstMemoryNuma");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+#ifdef HAVE_NUMA_SYSMEM
+  tcase_add_test (tc_chain, test_large_blocks);
+  tcase_add_test (tc_chain, test_small_blocks);
+  tcase_add_test (tc_chain, test_params);
+  tcase_add_test (tc_chain, test_free_other_thread);
+#endif
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (gst_memory_numa); because the sysmem
+ * allocator reads GST_SYSMEM_NUMA in gst_init() */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_SYSMEM_NUMA", NUMA_MIN_SIZE_STR, TRUE);
+  g_setenv ("GST_NUMA_TOPOLOGY", NUMA_TOPOLOGY, TRUE);
+  gst_check_init (&argc, &argv);
+  s = gst_memory_numa_suite ();
+  return gst_check_run_suite (s, "gst_memory_numa", __FILE__);
+}
@@ -2233,6 +2233,73 @@ GST_START_TEST (test_pad_probe_handled_and_drop)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+probe_fail_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  fail ("probe for unrelated type called");
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+probe_count_cb (GstPad * pad, GstPadProbeInfo * info, gint * count)
+{
+  (*count)++;
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_pad_probe_unrelated_types)
+{
+  GstPad *src, *sink;
+  gulong id;
+  gint count = 0;
+
+  src = gst_pad_new ("src", GST_PAD_SRC);
+  gst_pad_set_active (src, TRUE);
+  sink = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sink, gst_check_chain_func);
+  gst_pad_set_active (sink, TRUE);
+
+  fail_unless (gst_pad_push_event (src,
+          gst_event_new_stream_start ("test")) == TRUE);
+  fail_unless (gst_pad_push_event (src,
+          gst_event_new_segment (&dummy_segment)) == TRUE);
+
+  fail_unless_equals_int (gst_pad_link (src, sink), GST_PAD_LINK_OK);
+
+  /* probes for other data types and a blocking probe for another type don't
+   * see buffers */
+  gst_pad_add_probe (src, GST_PAD_PROBE_TYPE_EVENT_UPSTREAM, probe_fail_cb,
+      NULL, NULL);
+  gst_pad_add_probe (src, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM, probe_fail_cb,
+      NULL, NULL);
+  gst_pad_add_probe (src, GST_PAD_PROBE_TYPE_BLOCK |
+      GST_PAD_PROBE_TYPE_EVENT_UPSTREAM, probe_fail_cb, NULL, NULL);
+  fail_unless_equals_int (gst_pad_push (src, gst_buffer_new ()), GST_FLOW_OK);
+
+  /* a buffer probe added later is called */
+  id = gst_pad_add_probe (src, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) probe_count_cb, &count, NULL);
+  fail_unless_equals_int (gst_pad_push (src, gst_buffer_new ()), GST_FLOW_OK);
+  fail_unless_equals_int (count, 1);
+
+  /* and not anymore once removed */
+  gst_pad_remove_probe (src, id);
+  fail_unless_equals_int (gst_pad_push (src, gst_buffer_new ()), GST_FLOW_OK);
+  fail_unless_equals_int (count, 1);
+
+  /* probes without a data type see everything */
+  gst_pad_add_probe (src, GST_PAD_PROBE_TYPE_PUSH,
+      (GstPadProbeCallback) probe_count_cb, &count, NULL);
+  fail_unless_equals_int (gst_pad_push (src, gst_buffer_new ()), GST_FLOW_OK);
+  fail_unless_equals_int (count, 2);
+
+  gst_check_drop_buffers ();
+  gst_object_unref (src);
+  gst_object_unref (sink);
+}
+
+GST_END_TEST;
+
 static gboolean got_notify;
 
 static void
@@ -3434,6 +3501,7 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_pad_probe_flush_events_only);
   tcase_add_test (tc_chain, test_pad_probe_call_order);
   tcase_add_test (tc_chain, test_pad_probe_handled_and_drop);
+  tcase_add_test (tc_chain, test_pad_probe_unrelated_types);
   tcase_add_test (tc_chain, test_events_query_unlinked);
   tcase_add_test (tc_chain, test_queue_src_caps_notify_linked);
   tcase_add_test (tc_chain, test_queue_src_caps_notify_not_linked);
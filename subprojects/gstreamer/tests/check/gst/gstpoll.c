@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 
 #ifdef G_OS_WIN32
 #include <winsock2.h>
@@ -325,6 +326,53 @@ GST_START_TEST (test_poll_controllable)
 
 GST_END_TEST;
 
+#ifndef G_OS_WIN32
+GST_START_TEST (test_poll_regular_file)
+{
+  GstPoll *set;
+  GstPollFD fd = GST_POLL_FD_INIT;
+  gchar *filename = NULL;
+
+  fd.fd = g_file_open_tmp ("gstpoll-XXXXXX", &filename, NULL);
+  fail_unless (fd.fd >= 0, "Could not create a temporary file");
+
+  set = gst_poll_new (FALSE);
+  fail_if (set == NULL, "Failed to create a GstPoll");
+
+  /* regular files can't be waited on with epoll but must still be reported
+   * as ready like poll() does */
+  fail_unless (gst_poll_add_fd (set, &fd), "Could not add descriptor");
+  fail_unless (gst_poll_fd_ctl_read (set, &fd, TRUE),
+      "Could not mark the descriptor as readable");
+
+  fail_unless (gst_poll_wait (set, GST_SECOND) == 1,
+      "One descriptor should be available");
+  fail_unless (gst_poll_fd_can_read (set, &fd),
+      "Descriptor should be readable");
+  fail_if (gst_poll_fd_can_write (set, &fd),
+      "Descriptor should not be writeable");
+
+  fail_unless (gst_poll_fd_ctl_write (set, &fd, TRUE),
+      "Could not mark the descriptor as writeable");
+  fail_unless (gst_poll_wait (set, GST_CLOCK_TIME_NONE) == 1,
+      "One descriptor should be available");
+  fail_unless (gst_poll_fd_can_read (set, &fd),
+      "Descriptor should be readable");
+  fail_unless (gst_poll_fd_can_write (set, &fd),
+      "Descriptor should be writeable");
+
+  fail_unless (gst_poll_remove_fd (set, &fd), "Could not remove descriptor");
+  fail_unless (gst_poll_wait (set, 0) == 0, "Waiting did not timeout");
+
+  gst_poll_free (set);
+  close (fd.fd);
+  g_unlink (filename);
+  g_free (filename);
+}
+
+GST_END_TEST;
+#endif
+
 static Suite *
 gst_poll_suite (void)
 {
@@ -343,6 +391,7 @@ gst_poll_suite (void)
   tcase_add_test (tc_chain, test_poll_wait_restart);
   tcase_add_test (tc_chain, test_poll_wait_flush);
   tcase_add_test (tc_chain, test_poll_controllable);
+  tcase_add_test (tc_chain, test_poll_regular_file);
 #else
   tcase_skip_broken_test (tc_chain, test_poll_basic);
 #ifdef HAVE_PIPE
@@ -23,8 +23,18 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 #include <string.h>
 
+#ifndef G_OS_WIN32
+#include <utime.h>
+#endif
+
+/* set in the child processes of test_registry_fast_validate */
+#define CHILD_ENV "GST_REGISTRY_TEST_CHILD"
+
+static const gchar *test_binary;
+
 static gint
 plugin_name_cmp (GstPlugin * a, GstPlugin * b)
 {
@@ -203,6 +213,107 @@ GST_START_TEST (test_registry_update)
 
 GST_END_TEST;
 
+#ifndef G_OS_WIN32
+/* runs gst_init() in a child process that only uses @plugin_dir and
+ * @registry_file, and returns whether it found the identity element */
+static gboolean
+child_has_identity (const gchar * plugin_dir, const gchar * registry_file)
+{
+  gchar *argv[] = { (gchar *) test_binary, NULL };
+  gchar **envp;
+  gchar *out = NULL;
+  gint status;
+  gboolean found;
+
+  envp = g_get_environ ();
+  envp = g_environ_setenv (envp, CHILD_ENV, "1", TRUE);
+  envp = g_environ_setenv (envp, "GST_REGISTRY_FAST_VALIDATE", "yes", TRUE);
+  envp = g_environ_setenv (envp, "GST_REGISTRY", registry_file, TRUE);
+  envp = g_environ_setenv (envp, "GST_PLUGIN_SYSTEM_PATH_1_0", plugin_dir,
+      TRUE);
+  envp = g_environ_unsetenv (envp, "GST_PLUGIN_PATH_1_0");
+  envp = g_environ_unsetenv (envp, "GST_PLUGIN_PATH");
+  envp = g_environ_unsetenv (envp, "GST_REGISTRY_UPDATE");
+
+  fail_unless (g_spawn_sync (NULL, argv, envp, G_SPAWN_DEFAULT, NULL, NULL,
+          &out, NULL, &status, NULL));
+  fail_unless (g_spawn_check_exit_status (status, NULL));
+  found = g_str_has_prefix (out, "found");
+
+  g_free (out);
+  g_strfreev (envp);
+
+  return found;
+}
+
+static void
+set_old_mtime (const gchar * path)
+{
+  struct utimbuf times;
+
+  /* older than the next scan, so that the cache gets a valid manifest */
+  times.actime = times.modtime = time (NULL) - 60;
+  fail_unless (utime (path, &times) == 0);
+}
+
+GST_START_TEST (test_registry_fast_validate)
+{
+  GstPlugin *plugin;
+  gchar *tmp_dir, *plugin_dir, *sub_dir, *new_dir, *registry_file;
+  gchar *basename, *plugin_file, *contents;
+  gsize length;
+
+  plugin = gst_registry_find_plugin (gst_registry_get (), "coreelements");
+  fail_unless (plugin != NULL);
+  fail_unless (gst_plugin_get_filename (plugin) != NULL);
+
+  tmp_dir = g_dir_make_tmp ("gst-registry-XXXXXX", NULL);
+  fail_unless (tmp_dir != NULL);
+  plugin_dir = g_build_filename (tmp_dir, "plugins", NULL);
+  sub_dir = g_build_filename (plugin_dir, "sub", NULL);
+  registry_file = g_build_filename (tmp_dir, "registry.bin", NULL);
+  fail_unless (g_mkdir_with_parents (sub_dir, 0755) == 0);
+  set_old_mtime (sub_dir);
+  set_old_mtime (plugin_dir);
+
+  /* writes the cache with its manifest, then uses it */
+  fail_if (child_has_identity (plugin_dir, registry_file));
+  fail_if (child_has_identity (plugin_dir, registry_file));
+
+  /* a plugin dropped into a new directory inside a subdirectory that did not
+   * hold any plugin yet, which leaves the mtime of the search path
+   * unchanged */
+  new_dir = g_build_filename (sub_dir, "new", NULL);
+  fail_unless (g_mkdir (new_dir, 0755) == 0);
+  basename = g_path_get_basename (gst_plugin_get_filename (plugin));
+  plugin_file = g_build_filename (new_dir, basename, NULL);
+  fail_unless (g_file_get_contents (gst_plugin_get_filename (plugin),
+          &contents, &length, NULL));
+  fail_unless (g_file_set_contents (plugin_file, contents, length, NULL));
+  g_free (contents);
+
+  fail_unless (child_has_identity (plugin_dir, registry_file));
+
+  g_unlink (plugin_file);
+  g_unlink (registry_file);
+  g_rmdir (new_dir);
+  g_rmdir (sub_dir);
+  g_rmdir (plugin_dir);
+  g_rmdir (tmp_dir);
+
+  g_free (plugin_file);
+  g_free (basename);
+  g_free (registry_file);
+  g_free (new_dir);
+  g_free (sub_dir);
+  g_free (plugin_dir);
+  g_free (tmp_dir);
+  gst_object_unref (plugin);
+}
+
+GST_END_TEST;
+#endif
+
 static Suite *
 registry_suite (void)
 {
@@ -212,8 +323,32 @@ registry_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_registry_update);
+#ifndef G_OS_WIN32
+  tcase_add_test (tc_chain, test_registry_fast_validate);
+#endif
 
   return s;
 }
 
-GST_CHECK_MAIN (registry);
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  if (g_getenv (CHILD_ENV)) {
+    GstPluginFeature *feature;
+
+    gst_init (&argc, &argv);
+    feature = gst_registry_lookup_feature (gst_registry_get (), "identity");
+    g_print ("%s\n", feature ? "found" : "missing");
+    if (feature)
+      gst_object_unref (feature);
+    return 0;
+  }
+
+  test_binary = argv[0];
+
+  gst_check_init (&argc, &argv);
+  s = registry_suite ();
+  return gst_check_run_suite (s, "registry", __FILE__);
+}
@@ -1053,6 +1053,103 @@ GST_START_TEST (test_strict)
 
 GST_END_TEST;
 
+GST_START_TEST (test_many_fields)
+{
+  GstStructure *s, *s2;
+  gchar *name, *str;
+  gint i, val;
+
+  /* enough fields to use the hash index for lookups */
+  s = gst_structure_new_empty ("test-struct");
+  for (i = 0; i < 100; i++) {
+    name = g_strdup_printf ("field-%d", i);
+    gst_structure_set (s, name, G_TYPE_INT, i, NULL);
+    g_free (name);
+  }
+  fail_unless_equals_int (gst_structure_n_fields (s), 100);
+
+  for (i = 0; i < 100; i++) {
+    name = g_strdup_printf ("field-%d", i);
+    fail_unless (gst_structure_get_int (s, name, &val));
+    fail_unless_equals_int (val, i);
+    g_free (name);
+  }
+  fail_if (gst_structure_has_field (s, "field-100"));
+
+  /* replacing keeps the number of fields */
+  gst_structure_set (s, "field-50", G_TYPE_INT, -50, NULL);
+  fail_unless_equals_int (gst_structure_n_fields (s), 100);
+  fail_unless (gst_structure_get_int (s, "field-50", &val));
+  fail_unless_equals_int (val, -50);
+
+  /* removing shifts all following fields */
+  gst_structure_remove_field (s, "field-10");
+  fail_if (gst_structure_has_field (s, "field-10"));
+  fail_unless (gst_structure_get_int (s, "field-99", &val));
+  fail_unless_equals_int (val, 99);
+  gst_structure_set (s, "field-10", G_TYPE_INT, 10, NULL);
+  fail_unless_equals_int (gst_structure_n_fields (s), 100);
+  fail_unless (gst_structure_get_int (s, "field-10", &val));
+  fail_unless_equals_int (val, 10);
+  fail_unless_equals_string (gst_structure_nth_field_name (s, 99), "field-10");
+
+  str = gst_structure_to_string (s);
+  s2 = gst_structure_from_string (str, NULL);
+  fail_unless (s2 != NULL);
+  fail_unless (gst_structure_is_equal (s, s2));
+  fail_unless (gst_structure_is_subset (s, s2));
+  g_free (str);
+  gst_structure_free (s2);
+
+  s2 = gst_structure_copy (s);
+  gst_structure_set (s2, "extra", G_TYPE_INT, 1, NULL);
+  fail_unless (gst_structure_is_subset (s2, s));
+  fail_if (gst_structure_is_subset (s, s2));
+  gst_structure_free (s2);
+
+  gst_structure_free (s);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_get_borrowed)
+{
+  GstStructure *s, *nested, *out_nested = NULL;
+  GstCaps *caps, *out_caps = NULL;
+  const gchar *out_str = NULL;
+  gint out_int = 0;
+
+  nested = gst_structure_new ("nested", "a", G_TYPE_INT, 1, NULL);
+  caps = gst_caps_new_empty_simple ("video/x-raw");
+  s = gst_structure_new ("test-struct", "int", G_TYPE_INT, 5,
+      "str", G_TYPE_STRING, "hello", "nested", GST_TYPE_STRUCTURE, nested,
+      "caps", GST_TYPE_CAPS, caps, NULL);
+
+  fail_unless (gst_structure_get_borrowed (s, "int", G_TYPE_INT, &out_int,
+          "str", G_TYPE_STRING, &out_str, "nested", GST_TYPE_STRUCTURE,
+          &out_nested, "caps", GST_TYPE_CAPS, &out_caps, NULL));
+  fail_unless_equals_int (out_int, 5);
+  fail_unless_equals_string (out_str, "hello");
+  fail_unless (out_str == gst_structure_get_string (s, "str"));
+  fail_unless (out_nested == gst_value_get_structure (gst_structure_get_value
+          (s, "nested")));
+  fail_unless (gst_structure_is_equal (out_nested, nested));
+  fail_unless (out_caps == gst_value_get_caps (gst_structure_get_value (s,
+              "caps")));
+  /* no reference was taken */
+  ASSERT_MINI_OBJECT_REFCOUNT (caps, "caps", 2);
+
+  fail_if (gst_structure_get_borrowed (s, "str", G_TYPE_INT, &out_int, NULL));
+  fail_if (gst_structure_get_borrowed (s, "missing", G_TYPE_INT, &out_int,
+          NULL));
+
+  gst_structure_free (s);
+  gst_structure_free (nested);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_structure_suite (void)
 {
@@ -1087,6 +1184,8 @@ gst_structure_suite (void)
   tcase_add_test (tc_chain, test_flagset);
   tcase_add_test (tc_chain, test_flags);
   tcase_add_test (tc_chain, test_strict);
+  tcase_add_test (tc_chain, test_many_fields);
+  tcase_add_test (tc_chain, test_get_borrowed);
   return s;
 }
 
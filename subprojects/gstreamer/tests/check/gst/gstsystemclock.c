@@ -197,6 +197,65 @@ GST_START_TEST (test_async_full)
 
 GST_END_TEST;
 
+static GMutex ao_lock;
+static GCond ao_cond;
+static GArray *ao_order;
+
+static gboolean
+test_async_order_callback (GstClock * clock, GstClockTime time,
+    GstClockID id, gpointer user_data)
+{
+  gint index = GPOINTER_TO_INT (user_data);
+
+  g_mutex_lock (&ao_lock);
+  g_array_append_val (ao_order, index);
+  g_cond_signal (&ao_cond);
+  g_mutex_unlock (&ao_lock);
+
+  return TRUE;
+}
+
+GST_START_TEST (test_async_order)
+{
+  GstClock *clock;
+  GstClockID ids[6];
+  GstClockTime base;
+  gint i;
+
+  clock = gst_system_clock_obtain ();
+  ao_order = g_array_new (FALSE, FALSE, sizeof (gint));
+
+  /* scheduled in reverse order, the last two with the same time */
+  base = gst_clock_get_time (clock) + 50 * GST_MSECOND;
+  for (i = 0; i < 5; i++)
+    ids[i] = gst_clock_new_single_shot_id (clock,
+        base + (5 - i) * 10 * GST_MSECOND);
+  ids[5] = gst_clock_new_single_shot_id (clock, base + 10 * GST_MSECOND);
+
+  for (i = 0; i < 6; i++)
+    fail_unless (gst_clock_id_wait_async (ids[i], test_async_order_callback,
+            GINT_TO_POINTER (i), NULL) == GST_CLOCK_OK);
+  gst_clock_id_unschedule (ids[2]);
+
+  g_mutex_lock (&ao_lock);
+  while (ao_order->len < 5)
+    g_cond_wait (&ao_cond, &ao_lock);
+  g_mutex_unlock (&ao_lock);
+
+  fail_unless_equals_int (g_array_index (ao_order, gint, 0), 4);
+  fail_unless_equals_int (g_array_index (ao_order, gint, 1), 5);
+  fail_unless_equals_int (g_array_index (ao_order, gint, 2), 3);
+  fail_unless_equals_int (g_array_index (ao_order, gint, 3), 1);
+  fail_unless_equals_int (g_array_index (ao_order, gint, 4), 0);
+
+  for (i = 0; i < 6; i++)
+    gst_clock_id_unref (ids[i]);
+  g_array_unref (ao_order);
+  gst_object_unref (clock);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_resolution)
 {
   GstClock *clock;
@@ -396,6 +455,7 @@ gst_systemclock_suite (void)
   tcase_add_test (tc_chain, test_signedness);
   tcase_add_test (tc_chain, test_diff);
   tcase_add_test (tc_chain, test_async_full);
+  tcase_add_test (tc_chain, test_async_order);
   tcase_add_test (tc_chain, test_set_default);
   tcase_add_test (tc_chain, test_resolution);
   tcase_add_test (tc_chain, test_stress_cleanup_unschedule);
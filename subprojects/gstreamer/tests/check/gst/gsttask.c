@@ -464,6 +464,109 @@ GST_START_TEST (test_shared_task_pool_two_threads)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GstTask *task;
+  GRecMutex lock;
+  gint iterations;
+} CooperativeTaskData;
+
+static void
+cooperative_task_func (CooperativeTaskData * data)
+{
+  g_atomic_int_inc (&data->iterations);
+  g_thread_yield ();
+}
+
+#define N_COOPERATIVE_TASKS 16
+
+/* In this test, we run more tasks than there are worker threads in a work
+ * stealing pool and verify that all of them make progress */
+GST_START_TEST (test_work_stealing_task_pool)
+{
+  CooperativeTaskData data[N_COOPERATIVE_TASKS];
+  GstTaskPool *pool;
+  GstStructure *stats;
+  const GValue *workers;
+  guint64 total_jobs = 0;
+  GError *err = NULL;
+  gint paused_iterations;
+  gint i;
+
+  pool = gst_work_stealing_task_pool_new (2);
+  fail_unless_equals_int (gst_work_stealing_task_pool_get_n_threads
+      (GST_WORK_STEALING_TASK_POOL (pool)), 2);
+  gst_task_pool_prepare (pool, &err);
+  fail_unless (err == NULL);
+
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++) {
+    data[i].iterations = 0;
+    g_rec_mutex_init (&data[i].lock);
+    data[i].task = gst_task_new ((GstTaskFunction) cooperative_task_func,
+        &data[i], NULL);
+    gst_task_set_lock (data[i].task, &data[i].lock);
+    gst_task_set_pool (data[i].task, pool);
+    fail_unless (gst_task_start (data[i].task));
+  }
+
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++) {
+    while (g_atomic_int_get (&data[i].iterations) < 100)
+      g_usleep (1000);
+  }
+
+  /* paused tasks don't occupy a worker */
+  fail_unless (gst_task_pause (data[0].task));
+  /* an iteration that was already running finishes with the task lock */
+  g_rec_mutex_lock (&data[0].lock);
+  paused_iterations = g_atomic_int_get (&data[0].iterations);
+  g_rec_mutex_unlock (&data[0].lock);
+
+  for (i = 1; i < N_COOPERATIVE_TASKS; i++) {
+    gint iterations = g_atomic_int_get (&data[i].iterations);
+
+    while (g_atomic_int_get (&data[i].iterations) < iterations + 100)
+      g_usleep (1000);
+  }
+
+  /* and don't iterate anymore until they are resumed */
+  fail_unless_equals_int (g_atomic_int_get (&data[0].iterations),
+      paused_iterations);
+  fail_unless (gst_task_resume (data[0].task));
+  while (g_atomic_int_get (&data[0].iterations) < paused_iterations + 100)
+    g_usleep (1000);
+
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++) {
+    fail_unless (gst_task_join (data[i].task));
+    gst_object_unref (data[i].task);
+    g_rec_mutex_clear (&data[i].lock);
+  }
+
+  stats = gst_work_stealing_task_pool_get_stats (GST_WORK_STEALING_TASK_POOL
+      (pool));
+  workers = gst_structure_get_value (stats, "workers");
+  fail_unless (workers != NULL);
+  fail_unless_equals_int (gst_value_array_get_size (workers), 2);
+  for (i = 0; i < 2; i++) {
+    const GstStructure *ws =
+        gst_value_get_structure (gst_value_array_get_value (workers, i));
+    guint64 jobs;
+    gdouble utilization;
+
+    fail_unless (gst_structure_get_uint64 (ws, "jobs", &jobs));
+    fail_unless (gst_structure_get_double (ws, "utilization", &utilization));
+    fail_unless (utilization >= 0.0 && utilization <= 1.0);
+    total_jobs += jobs;
+  }
+  fail_unless (total_jobs >= 100 * N_COOPERATIVE_TASKS);
+  gst_structure_free (stats);
+
+  gst_task_pool_cleanup (pool);
+
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_task_suite (void)
 {
@@ -480,6 +583,7 @@ gst_task_suite (void)
   tcase_add_test (tc_chain, test_resume);
   tcase_add_test (tc_chain, test_shared_task_pool_shared_thread);
   tcase_add_test (tc_chain, test_shared_task_pool_two_threads);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool);
 
   return s;
 }
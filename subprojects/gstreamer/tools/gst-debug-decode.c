@@ -0,0 +1,316 @@
+/* GStreamer
+ * Copyright (C) <2026> The GStreamer Contributors.
+ *
+ * gst-debug-decode.c: convert binary debug logs to text
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Reads the files written by gst_debug_add_binary_logger() (for example with
+ * GST_DEBUG_BINARY_FILE) and prints them in the format of the default debug
+ * log function. The format is described in gst/gstinfo.c. */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#include "tools.h"
+
+#define BINARY_LOG_VERSION 1
+#define BINARY_LOG_BOM 0x01020304
+
+#define BINARY_LOG_RECORD_STRING 1
+#define BINARY_LOG_RECORD_MESSAGE 2
+#define BINARY_LOG_RECORD_DROPPED 3
+
+#if defined (GLIB_SIZEOF_VOID_P) && GLIB_SIZEOF_VOID_P == 8
+#define PTR_FMT "%14p"
+#else
+#define PTR_FMT "%10p"
+#endif
+
+static gboolean
+read_data (FILE * f, gpointer data, gsize size)
+{
+  return size == 0 || fread (data, 1, size, f) == size;
+}
+
+static gboolean
+read_u8 (FILE * f, guint8 * value)
+{
+  return read_data (f, value, sizeof (*value));
+}
+
+static gboolean
+read_u32 (FILE * f, guint32 * value)
+{
+  return read_data (f, value, sizeof (*value));
+}
+
+static gboolean
+read_u64 (FILE * f, guint64 * value)
+{
+  return read_data (f, value, sizeof (*value));
+}
+
+/* @max_len is the size of the file, a corrupt length can't make us allocate
+ * more than that */
+static gchar *
+read_string (FILE * f, guint32 len, guint64 max_len)
+{
+  gchar *str;
+
+  if (len > max_len)
+    return NULL;
+
+  str = g_malloc ((gsize) len + 1);
+
+  if (!read_data (f, str, len)) {
+    g_free (str);
+    return NULL;
+  }
+  str[len] = '\0';
+
+  return str;
+}
+
+static gboolean
+decode (const gchar * filename, FILE * out)
+{
+  FILE *f;
+  GStatBuf st;
+  guint64 file_size;
+  gchar magic[8];
+  guint32 version, bom, pid;
+  GHashTable *strings;
+  guint8 type;
+  guint64 n_messages = 0, n_dropped = 0;
+  gboolean ret = FALSE;
+
+  if (!(f = g_fopen (filename, "rb"))) {
+    g_printerr ("Could not open '%s': %s\n", filename, g_strerror (errno));
+    return FALSE;
+  }
+
+  if (g_fstat (fileno (f), &st) < 0) {
+    g_printerr ("Could not get the size of '%s': %s\n", filename,
+        g_strerror (errno));
+    fclose (f);
+    return FALSE;
+  }
+  file_size = st.st_size;
+
+  if (!read_data (f, magic, sizeof (magic)) || memcmp (magic, "GSTDBGB", 8)
+      || !read_u32 (f, &version) || !read_u32 (f, &bom)
+      || !read_u32 (f, &pid)) {
+    g_printerr ("'%s' is not a binary GStreamer debug log\n", filename);
+    fclose (f);
+    return FALSE;
+  }
+  if (bom != BINARY_LOG_BOM) {
+    g_printerr ("'%s' was written on a machine with a different byte order\n",
+        filename);
+    fclose (f);
+    return FALSE;
+  }
+  if (version != BINARY_LOG_VERSION) {
+    g_printerr ("'%s' has unsupported version %u\n", filename, version);
+    fclose (f);
+    return FALSE;
+  }
+
+  strings = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free,
+      g_free);
+
+  while (read_u8 (f, &type)) {
+    switch (type) {
+      case BINARY_LOG_RECORD_STRING:{
+        guint64 id, *key;
+        guint32 len;
+        gchar *str;
+
+        if (!read_u64 (f, &id) || !read_u32 (f, &len)
+            || !(str = read_string (f, len, file_size)))
+          goto truncated;
+        key = g_new (guint64, 1);
+        *key = id;
+        g_hash_table_insert (strings, key, str);
+        break;
+      }
+      case BINARY_LOG_RECORD_MESSAGE:{
+        guint64 elapsed, thread, object, category_id;
+        guint32 line, file_len, function_len, id_len, message_len;
+        guint8 level;
+        gchar *file, *function, *object_id, *message;
+        const gchar *category;
+
+        if (!read_u64 (f, &elapsed) || !read_u64 (f, &thread)
+            || !read_u64 (f, &object) || !read_u64 (f, &category_id)
+            || !read_u32 (f, &line) || !read_u8 (f, &level)
+            || !read_u32 (f, &file_len) || !read_u32 (f, &function_len)
+            || !read_u32 (f, &id_len) || !read_u32 (f, &message_len))
+          goto truncated;
+
+        file = read_string (f, file_len, file_size);
+        function = read_string (f, function_len, file_size);
+        object_id = read_string (f, id_len, file_size);
+        message = read_string (f, message_len, file_size);
+        if (!file || !function || !object_id || !message) {
+          g_free (file);
+          g_free (function);
+          g_free (object_id);
+          g_free (message);
+          goto truncated;
+        }
+
+        category = g_hash_table_lookup (strings, &category_id);
+
+        if (id_len > 0) {
+          fprintf (out, "%" GST_TIME_FORMAT " %5u " PTR_FMT
+              " %s %20s %s:%d:%s:<%s> %s\n", GST_TIME_ARGS (elapsed), pid,
+              GSIZE_TO_POINTER (thread), gst_debug_level_get_name (level),
+              GST_STR_NULL (category), file, (gint) line, function,
+              object_id, message);
+        } else {
+          fprintf (out, "%" GST_TIME_FORMAT " %5u " PTR_FMT
+              " %s %20s %s:%d:%s: %s\n", GST_TIME_ARGS (elapsed), pid,
+              GSIZE_TO_POINTER (thread), gst_debug_level_get_name (level),
+              GST_STR_NULL (category), file, (gint) line, function, message);
+        }
+        n_messages++;
+
+        g_free (file);
+        g_free (function);
+        g_free (object_id);
+        g_free (message);
+        break;
+      }
+      case BINARY_LOG_RECORD_DROPPED:{
+        guint64 thread;
+        guint32 count;
+
+        if (!read_u64 (f, &thread) || !read_u32 (f, &count))
+          goto truncated;
+        fprintf (out, "-- %u messages of thread " PTR_FMT " dropped --\n",
+            count, GSIZE_TO_POINTER (thread));
+        n_dropped += count;
+        break;
+      }
+      default:
+        g_printerr ("'%s': unknown record type %u\n", filename, type);
+        goto done;
+    }
+  }
+
+  ret = TRUE;
+
+done:
+  g_printerr ("%" G_GUINT64_FORMAT " messages, %" G_GUINT64_FORMAT
+      " dropped\n", n_messages, n_dropped);
+  g_hash_table_unref (strings);
+  fclose (f);
+
+  return ret;
+
+truncated:
+  /* the writer might have been killed while writing the last record, a
+   * length that doesn't fit in the file ends up here too */
+  g_printerr ("'%s' is truncated or corrupt\n", filename);
+  ret = TRUE;
+  goto done;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gchar **filenames = NULL;
+  gchar *output = NULL;
+  FILE *out = stdout;
+  GError *err = NULL;
+  GOptionContext *ctx;
+  gboolean ret;
+  GOptionEntry options[] = {
+    GST_TOOLS_GOPTION_VERSION,
+    {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output,
+        "Write the text log to this file instead of stdout", "FILE"},
+    {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &filenames, NULL}
+    ,
+    {NULL}
+  };
+
+#ifdef ENABLE_NLS
+  bindtextdomain (GETTEXT_PACKAGE, LOCALEDIR);
+  bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
+  textdomain (GETTEXT_PACKAGE);
+#endif
+
+  g_set_prgname ("gst-debug-decode-" GST_API_VERSION);
+
+  /* decoding a log with the environment of the process that wrote it would
+   * otherwise overwrite the log with the one of this tool */
+  g_unsetenv ("GST_DEBUG_BINARY_FILE");
+
+#ifdef G_OS_WIN32
+  argv = g_win32_get_command_line ();
+#endif
+
+  ctx = g_option_context_new ("FILE");
+  g_option_context_add_main_entries (ctx, options, GETTEXT_PACKAGE);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+#ifdef G_OS_WIN32
+  if (!g_option_context_parse_strv (ctx, &argv, &err))
+#else
+  if (!g_option_context_parse (ctx, &argc, &argv, &err))
+#endif
+  {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    exit (1);
+  }
+  g_option_context_free (ctx);
+
+  gst_tools_print_version ();
+
+  if (filenames == NULL || g_strv_length (filenames) != 1) {
+    g_print ("Please give exactly one filename to %s\n\n", g_get_prgname ());
+    return 1;
+  }
+
+  if (output && !(out = g_fopen (output, "w"))) {
+    g_printerr ("Could not open '%s' for writing: %s\n", output,
+        g_strerror (errno));
+    return 1;
+  }
+
+  ret = decode (filenames[0], out);
+
+  if (out != stdout)
+    fclose (out);
+  g_strfreev (filenames);
+  g_free (output);
+
+#ifdef G_OS_WIN32
+  g_strfreev (argv);
+#endif
+
+  return ret ? 0 : 1;
+}